@@ -1,4 +1,5 @@
 #include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 
 #include <aleph/containers/PointCloud.hh>
@@ -32,7 +33,11 @@
 
 #include <aleph/persistentHomology/Calculation.hh>
 
+#include <algorithm>
+#include <exception>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 namespace py = pybind11;
 
@@ -53,6 +58,136 @@ using StepFunction       = aleph::math::StepFunction<DataType>;
   template <class Distance> using NearestNeighbours = aleph::geometry::BruteForce<PointCloud, Distance>;
 #endif
 
+// The buffer views of persistence diagrams interpret the points of
+// a diagram as a contiguous array of (x,y) coordinates. This is only
+// valid if points do not contain any padding.
+static_assert( sizeof( typename PersistenceDiagram::Point ) == 2 * sizeof( DataType ),
+               "Persistence diagram points must not contain any padding" );
+
+/**
+  Checks whether a buffer can be used directly as the storage of a point
+  cloud, i.e. whether it contains the correct data type and is stored in
+  C-contiguous order.
+*/
+
+bool isContiguous( const py::buffer_info& bufferInfo )
+{
+  return    bufferInfo.format     == py::format_descriptor<DataType>::format()
+         && bufferInfo.ndim       == 2
+         && bufferInfo.strides[1] == static_cast<py::ssize_t>( sizeof(DataType) )
+         && bufferInfo.strides[0] == static_cast<py::ssize_t>( sizeof(DataType) ) * bufferInfo.shape[1];
+}
+
+/**
+  Creates a point cloud from a two-dimensional buffer. If possible, the
+  point cloud only *wraps* the buffer, so the caller is responsible for
+  keeping the buffer alive. Else, the buffer is converted and copied in
+  a single pass.
+*/
+
+PointCloud makePointCloud( py::buffer buffer )
+{
+  py::buffer_info bufferInfo = buffer.request();
+
+  if( bufferInfo.ndim != 2 || bufferInfo.shape.size() != 2 )
+    throw std::runtime_error( "Only two-dimensional buffers are supported" );
+
+  auto n = static_cast<std::size_t>( bufferInfo.shape[0] );
+  auto d = static_cast<std::size_t>( bufferInfo.shape[1] );
+
+  if( isContiguous( bufferInfo ) )
+    return PointCloud( n, d, reinterpret_cast<DataType*>( bufferInfo.ptr ) );
+
+  // Fall back to copying the data into a new point cloud. Any buffer
+  // that can be converted to the correct data type is permitted here.
+  auto array = py::array_t<DataType, py::array::c_style | py::array::forcecast>::ensure( buffer );
+  if( !array )
+    throw std::runtime_error( "Unexpected format" );
+
+  PointCloud pointCloud( n, d );
+  std::copy( array.data(), array.data() + n*d, pointCloud.data() );
+
+  return pointCloud;
+}
+
+/**
+  Extracts references to all persistence diagrams stored in a list. No
+  diagram is copied, so the list has to outlive the references.
+*/
+
+std::vector<const PersistenceDiagram*> getPersistenceDiagrams( py::list diagrams_ )
+{
+  std::vector<const PersistenceDiagram*> diagrams;
+  diagrams.reserve( diagrams_.size() );
+
+  for( auto handle : diagrams_ )
+    diagrams.push_back( &py::cast<const PersistenceDiagram&>( handle ) );
+
+  return diagrams;
+}
+
+/**
+  Evaluates a functor for all pairs of persistence diagrams of a list
+  and stores the results in a symmetric matrix. The evaluation is run
+  in parallel, without holding the GIL. If requested, the diagonal is
+  evaluated as well, which is required for kernels.
+*/
+
+template <class Functor> py::array_t<double> pairwiseMatrix( py::list diagrams_, Functor&& functor, bool evaluateDiagonal )
+{
+  auto diagrams = getPersistenceDiagrams( diagrams_ );
+  auto n        = diagrams.size();
+
+  py::array_t<double> result( { static_cast<py::ssize_t>( n ), static_cast<py::ssize_t>( n ) } );
+  double* matrix = result.mutable_data();
+
+  std::fill( matrix, matrix + n*n, 0.0 );
+
+  // Exceptions must not leave the parallel region, as this terminates
+  // the interpreter. The first one is kept and thrown again afterwards,
+  // when the GIL has been acquired again.
+  std::exception_ptr error;
+
+  {
+    py::gil_scoped_release release;
+
+    std::vector< std::pair<std::size_t, std::size_t> > pairs;
+    pairs.reserve( n * ( n + 1 ) / 2 );
+
+    for( std::size_t i = 0; i < n; i++ )
+      for( std::size_t j = evaluateDiagonal ? i : i+1; j < n; j++ )
+        pairs.push_back( std::make_pair( i, j ) );
+
+    #pragma omp parallel for schedule(dynamic)
+    for( std::size_t k = 0; k < pairs.size(); k++ )
+    {
+      auto i = pairs[k].first;
+      auto j = pairs[k].second;
+
+      try
+      {
+        auto d = functor( *diagrams[i], *diagrams[j] );
+
+        matrix[i*n+j] = d;
+        matrix[j*n+i] = d;
+      }
+      catch( ... )
+      {
+        #pragma omp critical
+        {
+          if( !error )
+            error = std::current_exception();
+        }
+      }
+    }
+  }
+
+  if( error )
+    std::rethrow_exception( error );
+
+  return result;
+}
+
 void wrapSimplex( py::module& m )
 {
   py::class_<Simplex>(m, "Simplex")
@@ -134,8 +269,210 @@ void wrapSimplex( py::module& m )
     .def_property("weight", &Simplex::data, &Simplex::setData );
 }
 
+/**
+  Creates a simplicial complex in bulk from a list of vertex arrays and
+  an optional list of weight arrays. The \f$k\f$th entry of the first
+  list is an array of shape \f$(m,k+1)\f$, containing the vertices of
+  all \f$k\f$-simplices, while the \f$k\f$th entry of the second list
+  is an array of shape \f$(m,)\f$, containing their weights. Simplices
+  are added to the complex in the order in which they are specified.
+*/
+
+SimplicialComplex makeSimplicialComplex( py::list vertices_, py::object weights_ )
+{
+  using VertexArray = py::array_t<VertexType, py::array::c_style | py::array::forcecast>;
+  using WeightArray = py::array_t<DataType,   py::array::c_style | py::array::forcecast>;
+
+  bool useWeights = !weights_.is_none();
+
+  std::vector<VertexArray> vertexArrays;
+  std::vector<WeightArray> weightArrays;
+
+  for( auto handle : vertices_ )
+  {
+    auto array = VertexArray::ensure( handle );
+    if( !array || array.ndim() != 2 || array.shape(1) < 1 )
+      throw std::runtime_error( "Vertices must be specified as two-dimensional arrays" );
+
+    vertexArrays.push_back( array );
+  }
+
+  if( useWeights )
+  {
+    for( auto handle : py::cast<py::list>( weights_ ) )
+    {
+      auto array = WeightArray::ensure( handle );
+      if( !array || array.ndim() != 1 )
+        throw std::runtime_error( "Weights must be specified as one-dimensional arrays" );
+
+      weightArrays.push_back( array );
+    }
+
+    if( weightArrays.size() != vertexArrays.size() )
+      throw std::runtime_error( "Number of weight arrays does not match number of vertex arrays" );
+
+    for( std::size_t k = 0; k < vertexArrays.size(); k++ )
+    {
+      if( weightArrays[k].shape(0) != vertexArrays[k].shape(0) )
+        throw std::runtime_error( "Number of weights does not match number of simplices" );
+    }
+  }
+
+  // The arrays are kept alive by the vectors above, so the remainder
+  // of the construction does not require any Python objects.
+  py::gil_scoped_release release;
+
+  std::size_t numSimplices = 0;
+  for( auto&& array : vertexArrays )
+    numSimplices += static_cast<std::size_t>( array.shape(0) );
+
+  std::vector<Simplex> simplices;
+  simplices.reserve( numSimplices );
+
+  for( std::size_t k = 0; k < vertexArrays.size(); k++ )
+  {
+    auto m = static_cast<std::size_t>( vertexArrays[k].shape(0) );
+    auto n = static_cast<std::size_t>( vertexArrays[k].shape(1) );
+
+    const VertexType* vertices = vertexArrays[k].data();
+    const DataType* weights    = useWeights ? weightArrays[k].data() : nullptr;
+
+    for( std::size_t i = 0; i < m; i++ )
+    {
+      simplices.push_back(
+        Simplex( vertices + i*n, vertices + (i+1)*n,
+                 weights ? weights[i] : DataType() )
+      );
+    }
+  }
+
+  return SimplicialComplex( simplices.begin(), simplices.end() );
+}
+
+/**
+  Creates a simplicial complex in bulk from an edge list of shape
+  \f$(m,2)\f$ and an optional array of edge weights. As for the edge
+  list reader, all vertices are added as well, using the default weight,
+  and they precede the edges in the resulting complex.
+*/
+
+SimplicialComplex makeSimplicialComplexFromEdgeList( py::object edges_, py::object weights_ )
+{
+  using VertexArray = py::array_t<VertexType, py::array::c_style | py::array::forcecast>;
+  using WeightArray = py::array_t<DataType,   py::array::c_style | py::array::forcecast>;
+
+  auto edges = VertexArray::ensure( edges_ );
+  if( !edges || edges.ndim() != 2 || edges.shape(1) != 2 )
+    throw std::runtime_error( "Edges must be specified as an array of shape (m,2)" );
+
+  bool useWeights = !weights_.is_none();
+
+  WeightArray weights;
+  if( useWeights )
+  {
+    weights = WeightArray::ensure( weights_ );
+    if( !weights || weights.ndim() != 1 || weights.shape(0) != edges.shape(0) )
+      throw std::runtime_error( "Weights must be specified as an array of shape (m,)" );
+  }
+
+  auto m               = static_cast<std::size_t>( edges.shape(0) );
+  const VertexType* uv = edges.data();
+  const DataType* w    = useWeights ? weights.data() : nullptr;
+
+  py::gil_scoped_release release;
+
+  // Collect vertices densely instead of using a set; vertex indices of
+  // large graphs are typically contiguous.
+  std::vector<bool> vertices;
+
+  for( std::size_t i = 0; i < 2*m; i++ )
+  {
+    if( uv[i] >= vertices.size() )
+      vertices.resize( std::size_t( uv[i] ) + 1 );
+
+    vertices[ uv[i] ] = true;
+  }
+
+  std::vector<Simplex> simplices;
+  simplices.reserve( m + vertices.size() );
+
+  for( std::size_t v = 0; v < vertices.size(); v++ )
+  {
+    if( vertices[v] )
+      simplices.push_back( Simplex( static_cast<VertexType>( v ) ) );
+  }
+
+  for( std::size_t i = 0; i < m; i++ )
+    simplices.push_back( Simplex( uv + 2*i, uv + 2*(i+1), w ? w[i] : DataType() ) );
+
+  return SimplicialComplex( simplices.begin(), simplices.end() );
+}
+
+/**
+  Exports a simplicial complex to a list of vertex arrays and a list of
+  weight arrays, following the layout of `makeSimplicialComplex()`. The
+  simplices of each dimension are reported in filtration order, and the
+  vertices of each simplex are reported in ascending order.
+*/
+
+py::tuple exportSimplicialComplex( const SimplicialComplex& K )
+{
+  std::vector<std::size_t> counts;
+
+  for( auto&& simplex : K )
+  {
+    auto d = simplex.dimension();
+    if( d >= counts.size() )
+      counts.resize( d+1 );
+
+    ++counts[d];
+  }
+
+  std::vector< py::array_t<VertexType> > vertexArrays;
+  std::vector< py::array_t<DataType> > weightArrays;
+
+  std::vector<VertexType*> vertices;
+  std::vector<DataType*> weights;
+
+  for( std::size_t k = 0; k < counts.size(); k++ )
+  {
+    vertexArrays.push_back( py::array_t<VertexType>( { static_cast<py::ssize_t>( counts[k] ), static_cast<py::ssize_t>( k+1 ) } ) );
+    weightArrays.push_back( py::array_t<DataType>( static_cast<py::ssize_t>( counts[k] ) ) );
+
+    vertices.push_back( vertexArrays.back().mutable_data() );
+    weights.push_back( weightArrays.back().mutable_data() );
+  }
+
+  {
+    py::gil_scoped_release release;
+
+    for( auto&& simplex : K )
+    {
+      // The dimension of a simplex is well-defined here because the
+      // empty simplex cannot be stored in a simplicial complex.
+      auto d = simplex.dimension();
+
+      vertices[d] = std::copy( simplex.rbegin(), simplex.rend(), vertices[d] );
+      *weights[d]++ = simplex.data();
+    }
+  }
+
+  py::list vertexList;
+  py::list weightList;
+
+  for( std::size_t k = 0; k < counts.size(); k++ )
+  {
+    vertexList.append( vertexArrays[k] );
+    weightList.append( weightArrays[k] );
+  }
+
+  return py::make_tuple( vertexList, weightList );
+}
+
 void wrapSimplicialComplex( py::module& m )
 {
+  using namespace pybind11::literals;
+
   py::class_<SimplicialComplex>(m, "SimplicialComplex")
     .def( py::init<>() )
     .def( "__init__",
@@ -243,13 +580,66 @@ void wrapSimplicialComplex( py::module& m )
         return K;
       }
     )
+    .def_static( "fromArrays",
+      [] ( py::list vertices, py::object weights )
+      {
+        return makeSimplicialComplex( vertices, weights );
+      },
+      "vertices"_a,
+      "weights"_a = py::none()
+    )
+    .def_static( "fromEdgeList",
+      [] ( py::object edges, py::object weights )
+      {
+        return makeSimplicialComplexFromEdgeList( edges, weights );
+      },
+      "edges"_a,
+      "weights"_a = py::none()
+    )
+    .def( "toArrays", &exportSimplicialComplex )
     .def_property_readonly( "dimension", &SimplicialComplex::dimension );
 }
 
 void wrapPersistenceDiagram( py::module& m )
 {
-  py::class_<PersistenceDiagram>(m, "PersistenceDiagram")
+  py::class_<PersistenceDiagram>(m, "PersistenceDiagram", py::buffer_protocol() )
     .def( py::init<>() )
+    .def( "__init__",
+      [] ( PersistenceDiagram& instance, py::buffer buffer )
+      {
+        auto array = py::array_t<DataType, py::array::forcecast>::ensure( buffer );
+        if( !array || array.ndim() != 2 || array.shape(1) != 2 )
+          throw std::runtime_error( "Only buffers of shape (n,2) are supported" );
+
+        auto points = array.unchecked<2>();
+
+        new (&instance) PersistenceDiagram();
+
+        // Creating the points natively, without going through a Python
+        // object per point, is what makes this fast.
+        instance.reserve( static_cast<std::size_t>( points.shape(0) ) );
+
+        for( py::ssize_t i = 0; i < points.shape(0); i++ )
+          instance.add( points(i,0), points(i,1) );
+      }
+    )
+    .def_buffer(
+      [] ( PersistenceDiagram& D ) -> py::buffer_info
+      {
+        // Every point is stored as a contiguous (x,y) pair, so the whole
+        // diagram can be exposed as an (n,2) array without copying.
+        auto ptr = D.empty() ? nullptr : reinterpret_cast<DataType*>( &( *D.begin() ) );
+
+        return py::buffer_info(
+          ptr,
+          sizeof(DataType),
+          py::format_descriptor<DataType>::format(),
+          2,
+          { static_cast<py::ssize_t>( D.size() ), py::ssize_t(2) },
+          { static_cast<py::ssize_t>( 2 * sizeof(DataType) ), static_cast<py::ssize_t>( sizeof(DataType) ) }
+        );
+      }
+    )
     .def( "__bool__",
       [] ( const PersistenceDiagram& D )
       {
@@ -298,6 +688,45 @@ void wrapPersistenceDiagram( py::module& m )
     .def_property_readonly( "unpaired"   , &Point::isUnpaired );
 }
 
+void wrapPointCloud( py::module& m )
+{
+  py::class_<PointCloud>(m, "PointCloud", py::buffer_protocol() )
+    .def( py::init<>() )
+    .def( py::init<std::size_t, std::size_t>() )
+    .def( "__init__",
+      [] ( PointCloud& instance, py::buffer buffer )
+      {
+        new (&instance) PointCloud( makePointCloud( buffer ) );
+      },
+      // Since the point cloud may wrap the memory of the buffer, the
+      // buffer has to be kept alive as long as the point cloud.
+      py::keep_alive<1,2>()
+    )
+    .def_buffer(
+      [] ( PointCloud& pointCloud ) -> py::buffer_info
+      {
+        return py::buffer_info(
+          pointCloud.data(),
+          sizeof(DataType),
+          py::format_descriptor<DataType>::format(),
+          2,
+          { static_cast<py::ssize_t>( pointCloud.size() ), static_cast<py::ssize_t>( pointCloud.dimension() ) },
+          { static_cast<py::ssize_t>( sizeof(DataType) * pointCloud.dimension() ), static_cast<py::ssize_t>( sizeof(DataType) ) }
+        );
+      }
+    )
+    .def( "__bool__",
+      [] ( const PointCloud& pointCloud )
+      {
+        return !pointCloud.empty();
+      }
+    )
+    .def( "__getitem__", &PointCloud::operator[] )
+    .def( "__len__", &PointCloud::size )
+    .def_property_readonly( "dimension", &PointCloud::dimension )
+    .def_property_readonly( "owner"    , &PointCloud::owner );
+}
+
 void wrapPersistentHomologyCalculation( py::module& m )
 {
   using namespace pybind11::literals;
@@ -306,32 +735,59 @@ void wrapPersistentHomologyCalculation( py::module& m )
     [] ( const SimplicialComplex& K )
     {
       return aleph::calculatePersistenceDiagrams( K );
-    }
+    },
+    py::call_guard<py::gil_scoped_release>()
   );
 
-  m.def( "calculatePersistenceDiagrams",
-    [] ( py::buffer buffer, DataType epsilon, unsigned dimension )
+  m.def( "calculatePersistenceDiagramsBatch",
+    [] ( py::list complexes_ )
     {
-      py::buffer_info bufferInfo = buffer.request();
+      std::vector<const SimplicialComplex*> complexes;
+      complexes.reserve( complexes_.size() );
 
-      if( bufferInfo.ndim != 2 || bufferInfo.shape.size() != 2 )
-        throw std::runtime_error( "Only two-dimensional buffers are supported" );
+      for( auto handle : complexes_ )
+        complexes.push_back( &py::cast<const SimplicialComplex&>( handle ) );
 
-      if( bufferInfo.format != py::format_descriptor<DataType>::format() )
-        throw std::runtime_error( "Unexpected format" );
+      std::vector< std::vector<PersistenceDiagram> > result( complexes.size() );
+      std::exception_ptr error;
 
-      auto n = bufferInfo.shape[0];
-      auto d = bufferInfo.shape[1];
+      {
+        py::gil_scoped_release release;
 
-      PointCloud pointCloud(
-        static_cast<std::size_t>(n),
-        static_cast<std::size_t>(d)
-      );
+        #pragma omp parallel for schedule(dynamic)
+        for( std::size_t i = 0; i < complexes.size(); i++ )
+        {
+          try
+          {
+            result[i] = aleph::calculatePersistenceDiagrams( *complexes[i] );
+          }
+          catch( ... )
+          {
+            #pragma omp critical
+            {
+              if( !error )
+                error = std::current_exception();
+            }
+          }
+        }
+      }
+
+      // See pairwiseMatrix() for why exceptions are thrown only here
+      if( error )
+        std::rethrow_exception( error );
 
-      DataType* target = pointCloud.data();
-      DataType* source = reinterpret_cast<DataType*>( bufferInfo.ptr );
+      return result;
+    }
+  );
+
+  m.def( "calculatePersistenceDiagrams",
+    [] ( py::buffer buffer, DataType epsilon, unsigned dimension )
+    {
+      // The point cloud only wraps the buffer whenever possible, which
+      // is safe because the buffer outlives this function call.
+      auto pointCloud = makePointCloud( buffer );
 
-      std::copy( source, source + n*d, target );
+      py::gil_scoped_release release;
 
       using Distance = aleph::geometry::distances::Euclidean<DataType>;
       dimension      = dimension > 0 ? dimension : static_cast<unsigned>( pointCloud.dimension() + 1 );
@@ -358,6 +814,20 @@ void wrapDistanceCalculations( py::module& m )
     [] (const PersistenceDiagram& D1, const PersistenceDiagram& D2 )
     {
       return aleph::distances::bottleneckDistance( D1, D2 );
+    },
+    py::call_guard<py::gil_scoped_release>()
+  );
+
+  m.def( "bottleneckDistanceMatrix",
+    [] ( py::list diagrams )
+    {
+      return pairwiseMatrix( diagrams,
+        [] ( const PersistenceDiagram& D1, const PersistenceDiagram& D2 )
+        {
+          return static_cast<double>( aleph::distances::bottleneckDistance( D1, D2 ) );
+        },
+        false
+      );
     }
   );
 
@@ -365,7 +835,8 @@ void wrapDistanceCalculations( py::module& m )
     [] ( const PersistenceDiagram& D1, const PersistenceDiagram& D2 )
     {
       return aleph::distances::hausdorffDistance( D1, D2 );
-    }
+    },
+    py::call_guard<py::gil_scoped_release>()
   );
 
   m.def( "wassersteinDistance",
@@ -375,6 +846,22 @@ void wrapDistanceCalculations( py::module& m )
     },
     "D1"_a,
     "D2"_a,
+    "p"_a = DataType(1),
+    py::call_guard<py::gil_scoped_release>()
+  );
+
+  m.def( "wassersteinDistanceMatrix",
+    [] ( py::list diagrams, DataType p )
+    {
+      return pairwiseMatrix( diagrams,
+        [p] ( const PersistenceDiagram& D1, const PersistenceDiagram& D2 )
+        {
+          return static_cast<double>( aleph::distances::wassersteinDistance( D1, D2, p ) );
+        },
+        false
+      );
+    },
+    "diagrams"_a,
     "p"_a = DataType(1)
   );
 }
@@ -387,6 +874,20 @@ void wrapKernelCalculations( py::module& m )
     [] ( const PersistenceDiagram& D1, const PersistenceDiagram& D2, double sigma )
     {
       return aleph::multiScaleKernel( D1, D2, sigma );
+    },
+    py::call_guard<py::gil_scoped_release>()
+  );
+
+  m.def( "multiScaleKernelMatrix",
+    [] ( py::list diagrams, double sigma )
+    {
+      return pairwiseMatrix( diagrams,
+        [sigma] ( const PersistenceDiagram& D1, const PersistenceDiagram& D2 )
+        {
+          return aleph::multiScaleKernel( D1, D2, sigma );
+        },
+        true
+      );
     }
   );
 
@@ -394,7 +895,8 @@ void wrapKernelCalculations( py::module& m )
     [] ( const PersistenceDiagram& D1, const PersistenceDiagram& D2, double sigma )
     {
       return aleph::multiScalePseudoMetric( D1, D2, sigma );
-    }
+    },
+    py::call_guard<py::gil_scoped_release>()
   );
 }
 
@@ -518,7 +1020,10 @@ PYBIND11_MODULE(aleph, m)
   wrapSimplex(m);
   wrapSimplicialComplex(m);
   wrapPersistenceDiagram(m);
+  wrapPointCloud(m);
   wrapPersistentHomologyCalculation(m);
+  wrapDistanceCalculations(m);
+  wrapKernelCalculations(m);
   wrapRipsExpander(m);
   wrapStepFunction(m);
   wrapInputFunctions(m);
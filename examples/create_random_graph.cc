@@ -25,6 +25,7 @@
 
 #include <fstream>
 #include <iostream>
+#include <random>
 #include <string>
 
 #include <getopt.h>
@@ -46,6 +47,7 @@ int main( int argc, char** argv )
   static option commandLineOptions[] = {
     { "cardinality", required_argument, nullptr, 'n' },
     { "probability", required_argument, nullptr, 'p' },
+    { "seed"       , required_argument, nullptr, 's' },
     { "weighted"   , no_argument      , nullptr, 'w' },
     { nullptr      , 0                , nullptr,  0  }
   };
@@ -53,10 +55,11 @@ int main( int argc, char** argv )
   double p      = 0.25;
   unsigned n    = 100;
   bool weighted = false;
+  unsigned seed = std::random_device()();
 
   {
     int option = 0;
-    while( ( option = getopt_long( argc, argv, "n:p:w", commandLineOptions, nullptr ) ) != -1 )
+    while( ( option = getopt_long( argc, argv, "n:p:s:w", commandLineOptions, nullptr ) ) != -1 )
     {
       switch( option )
       {
@@ -66,6 +69,9 @@ int main( int argc, char** argv )
       case 'p':
         p = std::stod(optarg);
         break;
+      case 's':
+        seed = static_cast<unsigned>( std::stoul(optarg) );
+        break;
       case 'w':
         weighted = true;
         break;
@@ -79,12 +85,12 @@ int main( int argc, char** argv )
 
   if( weighted )
   {
-    auto K = aleph::topology::generateErdosRenyiGraph( n, p );
+    auto K = aleph::topology::generateErdosRenyiGraph( n, p, seed );
     storeGraph(K, std::cout);
   }
   else
   {
-    auto K = aleph::topology::generateWeightedRandomGraph( n, p );
+    auto K = aleph::topology::generateWeightedRandomGraph( n, p, seed );
     storeGraph(K, std::cout);
   }
 
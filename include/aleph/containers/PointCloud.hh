@@ -49,6 +49,24 @@ public:
     std::fill( _points, _points + _n * _d, T() );
   }
 
+  /**
+    Creates a point cloud that wraps an existing array of \f$n \times d\f$
+    values in row-major order. The point cloud does *not* take ownership
+    of the memory, so the caller has to ensure that the array outlives
+    the point cloud. This makes it possible to use external buffers, as
+    provided by the Python bindings, without copying any data.
+
+    Copies of the point cloud will always allocate their own memory.
+  */
+
+  PointCloud( std::size_t n, std::size_t d, T* points )
+    : _n( n )
+    , _d( d )
+    , _points( points )
+    , _owner( false )
+  {
+  }
+
   PointCloud( const PointCloud& other )
     : _n( other._n )
     , _d( other._d )
@@ -71,7 +89,8 @@ public:
 
   ~PointCloud()
   {
-    delete[] _points;
+    if( _owner )
+      delete[] _points;
   }
 
   friend void swap( PointCloud& pc1, PointCloud& pc2 ) noexcept
@@ -81,6 +100,7 @@ public:
     swap( pc1._points, pc2._points );
     swap( pc1._n,      pc2._n );
     swap( pc1._d,      pc2._d );
+    swap( pc1._owner,  pc2._owner );
   }
 
   // Equality comparison -----------------------------------------------
@@ -109,6 +129,16 @@ public:
     return _n == 0;
   }
 
+  /**
+    @returns true if the point cloud owns its memory, and false if it
+    only wraps an external array.
+  */
+
+  bool owner() const noexcept
+  {
+    return _owner;
+  }
+
   // Point access ------------------------------------------------------
 
   // This is slightly evil. The function is not really "bit-wise"
@@ -220,6 +250,9 @@ private:
   std::size_t _d; ///< Dimension
 
   T* _points;
+
+  /** Flag indicating whether the point cloud has to release its memory */
+  bool _owner = true;
 };
 
 /**
@@ -8,6 +8,8 @@
 #include <aleph/topology/Simplex.hh>
 #include <aleph/topology/SimplicialComplex.hh>
 
+#include <aleph/utilities/Profiler.hh>
+
 #include <vector>
 
 namespace aleph
@@ -124,6 +126,8 @@ template <class Distance, class Container, class Index = std::size_t>
   using Simplex           = topology::Simplex<DataType, VertexType>;
   using SimplicialComplex = topology::SimplicialComplex<Simplex>;
 
+  ALEPH_PROFILE_ZONE( "buildBetaSkeleton" );
+
   auto n = container.size();
   auto d = container.dimension();
 
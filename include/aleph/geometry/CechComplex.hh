@@ -1,13 +1,15 @@
 #ifndef ALEPH_GEOMETRY_CECH_COMPLEX_HH__
 #define ALEPH_GEOMETRY_CECH_COMPLEX_HH__
 
-#include <aleph/math/Combinations.hh>
+#include <aleph/math/CombinationRanking.hh>
 
 #include <aleph/topology/Simplex.hh>
 #include <aleph/topology/SimplicialComplex.hh>
 
 #include <aleph/topology/filtrations/Data.hh>
 
+#include <aleph/utilities/Profiler.hh>
+
 #include <aleph/external/Miniball.hpp>
 
 #include <numeric>
@@ -28,6 +30,8 @@ template <class Container> auto buildCechComplex( const Container& container, ty
   using Simplex           = topology::Simplex<ElementType, IndexType>;
   using SimplicialComplex = topology::SimplicialComplex<Simplex>;
 
+  ALEPH_PROFILE_ZONE( "buildCechComplex" );
+
   // Set up vertices for a combinatorial search over *all* potential
   // simplices.
   std::vector<IndexType> vertices( container.size() );
@@ -50,15 +54,21 @@ template <class Container> auto buildCechComplex( const Container& container, ty
   auto D               = container.dimension();
   auto n               = container.size();
   auto R               = r * r;
-  using DifferenceType = typename decltype(vertices)::difference_type;
   using Iterator       = typename decltype(vertices)::const_iterator;
 
-  for( unsigned d = 2; d <= n; d++ )
+  for( IndexType d = 2; d <= n; d++ )
   {
     auto previous_n = simplices.size();
 
-    math::for_each_combination( vertices.begin(), vertices.begin() + DifferenceType(d), vertices.end(),
-      [&container, &simplices, &D, &R] ( Iterator first, Iterator last )
+    // The combinations are enumerated in parallel, and every chunk of
+    // combinations stores its simplices separately. Concatenating them
+    // afterwards yields the same order as a sequential enumeration.
+    auto numChunks = math::numCombinationChunks( n, d );
+
+    std::vector< std::vector<Simplex> > chunks( numChunks );
+
+    math::parallelForEachCombination( n, d, numChunks,
+      [&container, &chunks, &D, &R] ( std::size_t chunk, Iterator first, Iterator last )
       {
         std::vector< std::vector<ElementType> > points;
         for( Iterator it = first; it != last; ++it )
@@ -72,13 +82,16 @@ template <class Container> auto buildCechComplex( const Container& container, ty
         if( mb.squared_radius() <= R )
         {
           Simplex s( first, last, ElementType( 2 * std::sqrt( mb.squared_radius() ) ) );
-          simplices.push_back( s );
+          chunks[chunk].push_back( s );
         }
 
         return false;
       }
     );
 
+    for( auto&& chunk : chunks )
+      simplices.insert( simplices.end(), chunk.begin(), chunk.end() );
+
     // Check whether we can stop adding simplices. If no additional
     // simplices have been created during the last iteration, there
     // is no need to continue the iteration.
@@ -0,0 +1,191 @@
+#ifndef ALEPH_GEOMETRY_DISTANCE_MATRIX_HH__
+#define ALEPH_GEOMETRY_DISTANCE_MATRIX_HH__
+
+#include <aleph/geometry/NearestNeighbours.hh>
+
+#include <algorithm>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+
+namespace aleph
+{
+
+namespace geometry
+{
+
+/**
+  Extracts all edges of a matrix of pairwise distances whose weight is
+  less than a given threshold. The rows of the matrix are processed in
+  parallel. The matrix may be of any type that provides access to its
+  elements via `M(i,j)`, as well as a `numRows()` function, such as a
+  SymmetricMatrix or a MappedSymmetricMatrix.
+
+  @param M         Matrix of pairwise distances
+  @param threshold Upper bound (exclusive) for the weight of an edge
+
+  @returns Sparse list of edges \f$(i,j,w)\f$ with \f$i < j\f$, ordered
+  lexicographically by their vertices
+*/
+
+template <class Matrix, class T> auto thresholdEdges( const Matrix& M, T threshold ) -> std::vector< std::tuple<decltype( M.numRows() ), decltype( M.numRows() ), T> >
+{
+  using IndexType = decltype( M.numRows() );
+  using Edge      = std::tuple<IndexType, IndexType, T>;
+
+  auto n = M.numRows();
+
+  std::vector< std::vector<Edge> > rows( static_cast<std::size_t>( n ) );
+
+  // Rows become shorter towards the end of the matrix, so a dynamic
+  // schedule is required to balance the work between threads.
+  #pragma omp parallel for schedule(dynamic, 64)
+  for( long i = 0; i < long( n ); i++ )
+  {
+    auto u = IndexType( i );
+
+    for( IndexType v = u + 1; v < n; v++ )
+    {
+      auto w = T( M(u,v) );
+      if( w < threshold )
+        rows[ std::size_t(i) ].push_back( std::make_tuple( u, v, w ) );
+    }
+  }
+
+  std::size_t numEdges = 0;
+  for( auto&& row : rows )
+    numEdges += row.size();
+
+  std::vector<Edge> edges;
+  edges.reserve( numEdges );
+
+  for( auto&& row : rows )
+  {
+    edges.insert( edges.end(), row.begin(), row.end() );
+    std::vector<Edge>().swap( row );
+  }
+
+  return edges;
+}
+
+/**
+  @class DistanceMatrix
+  @brief Nearest neighbour queries for a matrix of precomputed distances
+
+  This class uses a matrix of pairwise distances, e.g. dissimilarities
+  that have been calculated by another program, as a metric. Since it
+  provides the same interface as the other wrappers for nearest
+  neighbour calculations, any such matrix may be used to build a
+  Vietoris--Rips complex:
+
+  @code
+  aleph::math::MappedSymmetricMatrix<double> M( "distances.bin" );
+  aleph::geometry::DistanceMatrix< decltype(M) > distances( M );
+
+  auto K = aleph::geometry::buildVietorisRipsComplex( distances, epsilon, dimension );
+  @endcode
+
+  The matrix is only referenced, so it must outlive the wrapper. It may
+  be of any type that provides access to its elements via `M(i,j)`, as
+  well as a `numRows()` function.
+*/
+
+template <class Matrix> class DistanceMatrix : public NearestNeighbours< DistanceMatrix<Matrix>, typename std::decay<decltype( std::declval<Matrix>()(0,0) )>::type, std::size_t >
+{
+public:
+  using IndexType   = std::size_t;
+  using ElementType = typename std::decay<decltype( std::declval<Matrix>()(0,0) )>::type;
+
+  explicit DistanceMatrix( const Matrix& M )
+    : _matrix( M )
+  {
+  }
+
+  /**
+    Determines all neighbours of every point whose distance is less than
+    the given radius. A point is not considered to be its own neighbour.
+  */
+
+  void radiusSearch( ElementType radius,
+                     std::vector< std::vector<IndexType> >& indices,
+                     std::vector< std::vector<ElementType> >& distances ) const
+  {
+    indices.clear();
+    distances.clear();
+
+    indices.resize( this->size() );
+    distances.resize( this->size() );
+
+    auto edges = thresholdEdges( _matrix, radius );
+
+    for( auto&& edge : edges )
+    {
+      auto u = IndexType( std::get<0>( edge ) );
+      auto v = IndexType( std::get<1>( edge ) );
+      auto w = std::get<2>( edge );
+
+      indices[u].push_back( v );
+      indices[v].push_back( u );
+
+      distances[u].push_back( w );
+      distances[v].push_back( w );
+    }
+  }
+
+  /**
+    Determines the k nearest neighbours of every point, including the
+    point itself, in ascending order of their distances.
+  */
+
+  void neighbourSearch( unsigned k,
+                        std::vector< std::vector<IndexType> >& indices,
+                        std::vector< std::vector<ElementType> >& distances ) const
+  {
+    indices.clear();
+    distances.clear();
+
+    indices.resize( this->size() );
+    distances.resize( this->size() );
+
+    auto n = this->size();
+
+    #pragma omp parallel for schedule(static)
+    for( long i = 0; i < long( n ); i++ )
+    {
+      std::vector< std::pair<ElementType, IndexType> > neighbours;
+      neighbours.reserve( n );
+
+      for( IndexType j = 0; j < n; j++ )
+        neighbours.push_back( std::make_pair( ElementType( _matrix( IndexType(i), j ) ), j ) );
+
+      auto m = std::min( std::size_t( k ), neighbours.size() );
+
+      std::partial_sort( neighbours.begin(), neighbours.begin() + long( m ), neighbours.end() );
+
+      for( std::size_t l = 0; l < m; l++ )
+      {
+        indices[ std::size_t(i) ].push_back( neighbours[l].second );
+        distances[ std::size_t(i) ].push_back( neighbours[l].first );
+      }
+    }
+  }
+
+  std::size_t size() const noexcept
+  {
+    return std::size_t( _matrix.numRows() );
+  }
+
+private:
+
+  /** Reference to the original matrix */
+  const Matrix& _matrix;
+};
+
+} // namespace geometry
+
+} // namespace aleph
+
+#endif
@@ -8,6 +8,8 @@
 #include <aleph/topology/Simplex.hh>
 #include <aleph/topology/SimplicialComplex.hh>
 
+#include <aleph/utilities/Profiler.hh>
+
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/graph_traits.hpp>
 
@@ -79,6 +81,8 @@ template <class Matrix, class T> std::vector< detail::Pair<T> > admissiblePairs(
 {
   using namespace detail;
 
+  ALEPH_PROFILE_ZONE( "admissiblePairs" );
+
   // Convert matrix into a graph ---------------------------------------
 
   auto n          = W.size();
@@ -156,6 +160,8 @@ std::pair<
   using Simplex           = topology::Simplex<D, V>;
   using SimplicialComplex = topology::SimplicialComplex<Simplex>;
 
+  ALEPH_PROFILE_ZONE( "buildDowkerSinkSourceComplexes" );
+
   using VertexType     = V;
   VertexType maxVertex = VertexType();
 
@@ -0,0 +1,376 @@
+#ifndef ALEPH_GEOMETRY_MANIFOLD_SAMPLING_HH__
+#define ALEPH_GEOMETRY_MANIFOLD_SAMPLING_HH__
+
+#include <aleph/containers/PointCloud.hh>
+
+#include <aleph/math/CounterBasedRandom.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace aleph
+{
+
+namespace geometry
+{
+
+/*
+  The functions in this file sample points from manifolds and write them
+  directly into a point cloud, in parallel. Every point uses its own
+  stream of a counter-based random number generator, so the samples are
+  the same for every number of threads and only depend on the seed. The
+  surfaces are sampled uniformly with respect to their area, using the
+  rejection sampling method from "Sampling from a manifold" by Diaconis
+  et al. whenever the parametrization does not preserve areas. Rejection
+  is performed separately for every point, so it does not require any
+  synchronization.
+*/
+
+namespace detail
+{
+
+/**
+  Applies a functor to every point of a point cloud in parallel. The
+  functor receives a pointer to the coordinates of the point, as well
+  as a random number generator that is unique to this point.
+*/
+
+template <class T, class Functor> void forEachPoint( aleph::containers::PointCloud<T>& pc, std::uint64_t seed, Functor f )
+{
+  auto n = pc.size();
+  auto d = pc.dimension();
+  auto p = pc.data();
+
+  #pragma omp parallel for schedule(static)
+  for( long i = 0; i < long( n ); i++ )
+  {
+    aleph::math::CounterBasedRandom rng( seed, std::uint64_t(i) );
+    f( p + std::size_t(i) * d, rng );
+  }
+}
+
+/**
+  Samples a point of a torus uniformly with respect to its area. The
+  angle \f$\theta\f$ describes the position on the tube, whereas the
+  angle \f$\psi\f$ describes the position around the central axis.
+*/
+
+template <class T> void samplePointOnTorus( T* x, aleph::math::CounterBasedRandom& rng, double R, double r )
+{
+  double theta = 0.0;
+
+  do
+  {
+    theta = rng.uniform( 0.0, 2 * M_PI );
+  }
+  while( rng.uniform() * ( R + r ) >= R + r * std::cos( theta ) );
+
+  auto psi = rng.uniform( 0.0, 2 * M_PI );
+
+  x[0] = T( ( R + r * std::cos( theta ) ) * std::cos( psi ) );
+  x[1] = T( ( R + r * std::cos( theta ) ) * std::sin( psi ) );
+  x[2] = T(       r * std::sin( theta ) );
+}
+
+} // namespace detail
+
+/**
+  Samples \f$n\f$ points uniformly from a sphere of the given intrinsic
+  dimension and radius. Points are obtained by normalizing vectors of
+  normally-distributed coordinates, so the point cloud has one dimension
+  more than the sphere. For example, a dimension of 2 results in points
+  on the usual sphere in \f$\mathbb{R}^3\f$.
+
+  @param n         Number of points
+  @param dimension Intrinsic dimension of the sphere
+  @param r         Radius
+  @param seed      Seed of the random number generator
+*/
+
+template <class T> aleph::containers::PointCloud<T> sampleSphere( std::size_t n, std::size_t dimension, T r, std::uint64_t seed )
+{
+  aleph::containers::PointCloud<T> pc( n, dimension + 1 );
+
+  auto d = dimension + 1;
+
+  detail::forEachPoint( pc, seed, [d, r] ( T* x, aleph::math::CounterBasedRandom& rng )
+  {
+    double norm = 0.0;
+
+    // Rejecting vectors that are too short prevents divisions by zero
+    // and only happens with a negligible probability.
+    do
+    {
+      norm = 0.0;
+
+      for( std::size_t k = 0; k < d; k++ )
+      {
+        auto y = rng.normal();
+        x[k]   = T( y );
+        norm  += y * y;
+      }
+
+      norm = std::sqrt( norm );
+    }
+    while( norm < 1e-12 );
+
+    for( std::size_t k = 0; k < d; k++ )
+      x[k] = T( double( r ) * double( x[k] ) / norm );
+  } );
+
+  return pc;
+}
+
+/**
+  Samples \f$n\f$ points uniformly from a torus in \f$\mathbb{R}^3\f$.
+  The central axis of the torus is the \f$z\f$-axis.
+
+  @param n    Number of points
+  @param R    Major radius, i.e. the distance of the tube from the centre
+  @param r    Minor radius, i.e. the radius of the tube
+  @param seed Seed of the random number generator
+*/
+
+template <class T> aleph::containers::PointCloud<T> sampleTorus( std::size_t n, T R, T r, std::uint64_t seed )
+{
+  if( R < r )
+    throw std::runtime_error( "Major radius of torus must not be smaller than its minor radius" );
+
+  aleph::containers::PointCloud<T> pc( n, 3 );
+
+  detail::forEachPoint( pc, seed, [R, r] ( T* x, aleph::math::CounterBasedRandom& rng )
+  {
+    detail::samplePointOnTorus( x, rng, double( R ), double( r ) );
+  } );
+
+  return pc;
+}
+
+/**
+  Samples \f$n\f$ points uniformly from two linked tori in
+  \f$\mathbb{R}^3\f$. The first torus lies in the \f$xy\f$-plane,
+  while the second torus lies in the \f$xz\f$-plane and is shifted
+  by the major radius along the \f$x\f$-axis, so that each torus
+  passes through the hole of the other one. The first half of the
+  points belongs to the first torus.
+
+  @param n    Number of points
+  @param R    Major radius of both tori
+  @param r    Minor radius of both tori; must be smaller than half of
+              the major radius for the tori not to intersect
+  @param seed Seed of the random number generator
+*/
+
+template <class T> aleph::containers::PointCloud<T> sampleLinkedTori( std::size_t n, T R, T r, std::uint64_t seed )
+{
+  if( 2 * r >= R )
+    throw std::runtime_error( "Minor radius of linked tori must be smaller than half of their major radius" );
+
+  aleph::containers::PointCloud<T> pc( n, 3 );
+
+  auto p    = pc.data();
+  auto half = n / 2;
+
+  #pragma omp parallel for schedule(static)
+  for( long i = 0; i < long( n ); i++ )
+  {
+    aleph::math::CounterBasedRandom rng( seed, std::uint64_t(i) );
+
+    auto x = p + 3 * std::size_t(i);
+
+    detail::samplePointOnTorus( x, rng, double( R ), double( r ) );
+
+    if( std::size_t(i) >= half )
+    {
+      auto y = x[1];
+      auto z = x[2];
+
+      x[0] = x[0] + R;
+      x[1] = -z;
+      x[2] = y;
+    }
+  }
+
+  return pc;
+}
+
+/**
+  Samples \f$n\f$ points uniformly from a Klein bottle that is embedded
+  in \f$\mathbb{R}^4\f$. The embedding is a torus whose tube is rotated
+  by half a turn while going around the central axis, i.e.
+
+  \f{eqnarray*}{
+    x &=& (R + r \cos v) \cos u\\
+    y &=& (R + r \cos v) \sin u\\
+    z &=& r \sin v \cos(u/2)\\
+    w &=& r \sin v \sin(u/2)
+  \f}
+
+  @param n    Number of points
+  @param R    Major radius
+  @param r    Minor radius
+  @param seed Seed of the random number generator
+*/
+
+template <class T> aleph::containers::PointCloud<T> sampleKleinBottle( std::size_t n, T R, T r, std::uint64_t seed )
+{
+  if( R < r )
+    throw std::runtime_error( "Major radius of Klein bottle must not be smaller than its minor radius" );
+
+  aleph::containers::PointCloud<T> pc( n, 4 );
+
+  detail::forEachPoint( pc, seed, [R, r] ( T* x, aleph::math::CounterBasedRandom& rng )
+  {
+    // The partial derivatives of the embedding are orthogonal, so the
+    // area element is the product of their lengths. Since the length
+    // of the derivative with respect to v is constant, it suffices to
+    // accept samples with a probability that is proportional to the
+    // length of the derivative with respect to u.
+    auto a     = double( R );
+    auto b     = double( r );
+    auto bound = std::sqrt( ( a + b ) * ( a + b ) + b * b / 4 );
+
+    double u = 0.0;
+    double v = 0.0;
+    double l = 0.0;
+
+    do
+    {
+      u = rng.uniform( 0.0, 2 * M_PI );
+      v = rng.uniform( 0.0, 2 * M_PI );
+      l = std::sqrt( ( a + b * std::cos( v ) ) * ( a + b * std::cos( v ) ) + b * b * std::sin( v ) * std::sin( v ) / 4 );
+    }
+    while( rng.uniform() * bound >= l );
+
+    x[0] = T( ( a + b * std::cos( v ) ) * std::cos( u ) );
+    x[1] = T( ( a + b * std::cos( v ) ) * std::sin( u ) );
+    x[2] = T(       b * std::sin( v )   * std::cos( u / 2 ) );
+    x[3] = T(       b * std::sin( v )   * std::sin( u / 2 ) );
+  } );
+
+  return pc;
+}
+
+/**
+  Samples \f$n\f$ points uniformly from a Swiss roll in \f$\mathbb{R}^3\f$.
+  The roll is the surface \f$(t \cos t, h, t \sin t)\f$ for \f$t \in
+  [3\pi/2, 9\pi/2]\f$ and \f$h \in [0, \mathrm{height}]\f$. In contrast
+  to the common definition, which samples \f$t\f$ uniformly, the points
+  are uniformly distributed with respect to the area of the surface.
+
+  @param n      Number of points
+  @param height Height of the roll
+  @param seed   Seed of the random number generator
+*/
+
+template <class T> aleph::containers::PointCloud<T> sampleSwissRoll( std::size_t n, T height, std::uint64_t seed )
+{
+  aleph::containers::PointCloud<T> pc( n, 3 );
+
+  detail::forEachPoint( pc, seed, [height] ( T* x, aleph::math::CounterBasedRandom& rng )
+  {
+    // The length of the spiral's derivative is sqrt(1 + t^2), which
+    // attains its maximum at the largest value of t.
+    auto tMin  = 1.5 * M_PI;
+    auto tMax  = 4.5 * M_PI;
+    auto bound = std::sqrt( 1 + tMax * tMax );
+
+    double t = 0.0;
+
+    do
+    {
+      t = rng.uniform( tMin, tMax );
+    }
+    while( rng.uniform() * bound >= std::sqrt( 1 + t * t ) );
+
+    x[0] = T( t * std::cos( t ) );
+    x[1] = T( rng.uniform( 0.0, double( height ) ) );
+    x[2] = T( t * std::sin( t ) );
+  } );
+
+  return pc;
+}
+
+// Noise models --------------------------------------------------------
+
+/**
+  Adds normally-distributed noise with mean zero and the given standard
+  deviation to every coordinate of a point cloud. The noise only depends
+  on the seed, so it should differ from the seed used for sampling.
+*/
+
+template <class T> void addGaussianNoise( aleph::containers::PointCloud<T>& pc, T sigma, std::uint64_t seed )
+{
+  auto d = pc.dimension();
+
+  detail::forEachPoint( pc, seed, [d, sigma] ( T* x, aleph::math::CounterBasedRandom& rng )
+  {
+    for( std::size_t k = 0; k < d; k++ )
+      x[k] = T( double( x[k] ) + rng.normal( 0.0, double( sigma ) ) );
+  } );
+}
+
+/**
+  Adds uniformly-distributed noise from \f$[-\epsilon,\epsilon]\f$ to
+  every coordinate of a point cloud, i.e. every point is moved within
+  a cube around its original position.
+*/
+
+template <class T> void addUniformNoise( aleph::containers::PointCloud<T>& pc, T epsilon, std::uint64_t seed )
+{
+  auto d = pc.dimension();
+
+  detail::forEachPoint( pc, seed, [d, epsilon] ( T* x, aleph::math::CounterBasedRandom& rng )
+  {
+    for( std::size_t k = 0; k < d; k++ )
+      x[k] = T( double( x[k] ) + rng.uniform( -double( epsilon ), double( epsilon ) ) );
+  } );
+}
+
+/**
+  Replaces a fraction of the points of a point cloud by outliers, which
+  are sampled uniformly from the bounding box of the point cloud. Every
+  point is replaced independently with the given probability.
+*/
+
+template <class T> void addOutliers( aleph::containers::PointCloud<T>& pc, double fraction, std::uint64_t seed )
+{
+  if( pc.empty() )
+    return;
+
+  auto d = pc.dimension();
+  auto n = pc.size();
+  auto p = pc.data();
+
+  std::vector<T> lower( p, p + d );
+  std::vector<T> upper( p, p + d );
+
+  for( std::size_t i = 1; i < n; i++ )
+  {
+    for( std::size_t k = 0; k < d; k++ )
+    {
+      lower[k] = std::min( lower[k], p[i * d + k] );
+      upper[k] = std::max( upper[k], p[i * d + k] );
+    }
+  }
+
+  detail::forEachPoint( pc, seed, [d, fraction, &lower, &upper] ( T* x, aleph::math::CounterBasedRandom& rng )
+  {
+    if( rng.uniform() >= fraction )
+      return;
+
+    for( std::size_t k = 0; k < d; k++ )
+      x[k] = T( rng.uniform( double( lower[k] ), double( upper[k] ) ) );
+  } );
+}
+
+} // namespace geometry
+
+} // namespace aleph
+
+#endif
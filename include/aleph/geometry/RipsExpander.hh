@@ -1,6 +1,8 @@
 #ifndef ALEPH_GEOMETRY_RIPS_EXPANDER_HH__
 #define ALEPH_GEOMETRY_RIPS_EXPANDER_HH__
 
+#include <aleph/utilities/Profiler.hh>
+
 #include <algorithm>
 #include <iterator>
 #include <list>
@@ -52,6 +54,8 @@ public:
 
   SimplicialComplex operator()( const SimplicialComplex& K, unsigned dimension )
   {
+    ALEPH_PROFILE_ZONE( "RipsExpander" );
+
     std::set<VertexType> vertices;
     K.vertices( std::inserter( vertices,
                                vertices.begin() ) );
@@ -6,8 +6,12 @@
 #include <list>
 #include <vector>
 
+#include <aleph/math/CombinationRanking.hh>
+
 #include <aleph/topology/MaximalCliques.hh>
 
+#include <aleph/utilities/Profiler.hh>
+
 namespace aleph
 {
 
@@ -90,6 +94,8 @@ public:
 
   SimplicialComplex operator()( const SimplicialComplex& K, unsigned kMax, unsigned kMin )
   {
+    ALEPH_PROFILE_ZONE( "RipsExpanderTopDown" );
+
     auto maximalCliques = aleph::topology::maximalCliquesKoch( K );
 
     std::list<Simplex> simplices;
@@ -97,14 +103,36 @@ public:
     for( auto&& clique : maximalCliques )
     {
       auto C = std::vector<VertexType>( clique.begin(), clique.end() );
+      auto n = std::size_t( C.size() );
 
-      for( unsigned k = kMin + 1; k <= std::min( kMax + 1, unsigned( C.size() ) ); k++ )
+      for( std::size_t k = kMin + 1; k <= std::min( std::size_t( kMax ) + 1, n ); k++ )
       {
-        do
-        {
-          simplices.push_back( Simplex( C.begin(), C.begin() + k ) );
-        }
-        while( detail::next_combination( C.begin(), C.begin() + k, C.end() ) );
+        // Large cliques contain exponentially many simplices, so their
+        // combinations are enumerated in parallel. Every chunk of them
+        // is stored separately in order to keep the order of simplices
+        // independent of the number of threads.
+        auto numChunks = aleph::math::numCombinationChunks( n, k );
+
+        std::vector< std::vector<Simplex> > chunks( numChunks );
+
+        using Iterator = std::vector<std::size_t>::const_iterator;
+
+        aleph::math::parallelForEachCombination( n, k, numChunks,
+          [&C, &chunks] ( std::size_t chunk, Iterator first, Iterator last )
+          {
+            std::vector<VertexType> vertices;
+            vertices.reserve( std::size_t( std::distance( first, last ) ) );
+
+            for( auto it = first; it != last; ++it )
+              vertices.push_back( C[ *it ] );
+
+            chunks[chunk].push_back( Simplex( vertices.begin(), vertices.end() ) );
+            return false;
+          }
+        );
+
+        for( auto&& chunk : chunks )
+          simplices.insert( simplices.end(), chunk.begin(), chunk.end() );
       }
     }
 
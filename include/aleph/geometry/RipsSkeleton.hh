@@ -4,6 +4,8 @@
 #include <aleph/topology/Simplex.hh>
 #include <aleph/topology/SimplicialComplex.hh>
 
+#include <aleph/utilities/Profiler.hh>
+
 #include <vector>
 
 namespace aleph
@@ -23,6 +25,8 @@ public:
 
   SimplicialComplex operator()( const NearestNeighbours& nn, ElementType epsilon ) const
   {
+    ALEPH_PROFILE_ZONE( "RipsSkeleton" );
+
     auto numVertices = nn.size();
 
     std::vector<Simplex> simplices;
@@ -36,6 +40,8 @@ public:
 
     nn.radiusSearch( epsilon, indices, distances );
 
+    ALEPH_PROFILE_MEMORY( "neighbours", neighboursMemoryUsage( indices, distances ) );
+
     for( std::size_t i = 0; i < indices.size(); i++ )
     {
       IndexType u = IndexType(i);
@@ -52,8 +58,27 @@ public:
       }
     }
 
+    ALEPH_PROFILE_MEMORY( "simplices", simplices.capacity() * sizeof( Simplex ) );
     return SimplicialComplex( simplices.begin(), simplices.end() );
   };
+
+private:
+
+  /** @returns Approximate number of bytes used by the result of a radius search */
+  static std::size_t neighboursMemoryUsage( const std::vector< std::vector<IndexType> >& indices,
+                                            const std::vector< std::vector<ElementType> >& distances )
+  {
+    std::size_t bytes = indices.capacity()   * sizeof( std::vector<IndexType> )
+                      + distances.capacity() * sizeof( std::vector<ElementType> );
+
+    for( auto&& v : indices )
+      bytes += v.capacity() * sizeof( IndexType );
+
+    for( auto&& v : distances )
+      bytes += v.capacity() * sizeof( ElementType );
+
+    return bytes;
+  }
 };
 
 }
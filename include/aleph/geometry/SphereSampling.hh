@@ -25,6 +25,9 @@ namespace geometry
            which are sufficient to describe the sphere. Please use
            aleph::geometry::makeSphere() to create  a point cloud
            from the resulting angles.
+
+  @see aleph::geometry::sampleSphere() for a parallel and reproducible
+       variant that writes directly into a point cloud
 */
 
 template <class T>
@@ -20,9 +20,14 @@
 
 #include <cassert>
 
+#include <algorithm>
+#include <iterator>
 #include <set>
+#include <stdexcept>
 #include <vector>
 
+#include <cmath>
+
 namespace aleph
 {
 
@@ -84,11 +89,46 @@ public:
 
   template <class Container> std::vector<T> operator()( const Container& container, unsigned k )
   {
-    std::vector<double> curvature;
-    curvature.reserve( container.size() );
+    using ElementType = typename Container::ElementType;
+    using Distance    = distances::Euclidean<ElementType>;
 
-    auto lts     = localTangentSpaces( container, k );
-    auto spheres = fitSpheresWithoutNormals( container, lts );
+#ifdef ALEPH_WITH_FLANN
+    using NearestNeighbours = FLANN<Container, Distance>;
+#else
+    using NearestNeighbours = BruteForce<Container, Distance>;
+#endif
+
+    NearestNeighbours nearestNeighbours( container );
+    using IndexType = typename NearestNeighbours::IndexType;
+
+    std::vector< std::vector<IndexType> > indices;
+    std::vector< std::vector<ElementType> > distances;
+
+    nearestNeighbours.neighbourSearch( k,
+                                       indices,
+                                       distances );
+
+    return this->operator()( container, indices );
+  }
+
+  /**
+    Estimates the mean curvature of every point from a neighbourhood
+    graph that has already been calculated, e.g. by a nearest neighbour
+    search whose results are shared with other parts of an analysis.
+    The neighbourhood of every point should contain the point itself.
+
+    @param container  Container
+    @param neighbours Indices of the neighbours of every point
+  */
+
+  template <class Container, class IndexType>
+    std::vector<T> operator()( const Container& container,
+                               const std::vector< std::vector<IndexType> >& neighbours )
+  {
+    auto spheres = fitSpheresWithoutNormals( container, neighbours );
+
+    std::vector<T> curvature;
+    curvature.reserve( spheres.size() );
 
     std::transform( spheres.begin(), spheres.end(), std::back_inserter( curvature ),
       [] ( const Sphere& sphere )
@@ -361,74 +401,174 @@ private:
     return spheres;
   }
 
-  template <class Container>
+  /**
+    Fits an algebraic sphere to the neighbourhood of every point. This
+    does not require any normals, so the local tangent spaces need not
+    be calculated. Neighbourhoods are processed in parallel, and every
+    thread re-uses its own buffers. For points in two or three
+    dimensions, the systems are solved using fixed-size matrices, which
+    do not require any allocations.
+  */
+
+  template <class Container, class IndexType>
     std::vector<Sphere> fitSpheresWithoutNormals( const Container& container,
-                                                  const std::vector<LocalTangentSpace>& localTangentSpaces )
+                                                  const std::vector< std::vector<IndexType> >& neighbours )
   {
-    using namespace detail;
+    auto n = container.size();
+    auto d = container.dimension();
+
+    if( neighbours.size() != n )
+      throw std::runtime_error( "Number of neighbourhoods must match number of points" );
+
+    for( auto&& indices : neighbours )
+    {
+      for( auto&& index : indices )
+      {
+        if( std::size_t( index ) >= n )
+          throw std::runtime_error( "Neighbour index out of range" );
+      }
+    }
+
+    std::vector<T> coefficients( n * ( d+2 ) );
+
+    switch( d )
+    {
+    case 2:
+      fitSpheresWithoutNormals<4>( container, neighbours, coefficients );
+      break;
+    case 3:
+      fitSpheresWithoutNormals<5>( container, neighbours, coefficients );
+      break;
+    default:
+      fitSpheresWithoutNormals<Eigen::Dynamic>( container, neighbours, coefficients );
+      break;
+    }
 
     std::vector<Sphere> spheres;
-    spheres.reserve( container.size() );
+    spheres.reserve( n );
 
-    for( auto&& lts : localTangentSpaces )
+    for( std::size_t i = 0; i < n; i++ )
+      spheres.emplace_back( Sphere( coefficients.begin() + long( i * ( d+2 ) ), coefficients.begin() + long( ( i+1 ) * ( d+2 ) ) ) );
+
+    return spheres;
+  }
+
+  /**
+    Calculates the coefficients of all spheres, using matrices of the
+    given size, i.e. the dimension plus two. The coefficients of every
+    sphere are stored contiguously.
+  */
+
+  template <int Size, class Container, class IndexType>
+    void fitSpheresWithoutNormals( const Container& container,
+                                   const std::vector< std::vector<IndexType> >& neighbours,
+                                   std::vector<T>& coefficients )
+  {
+    using namespace detail;
+
+    using ElementType = typename Container::ElementType;
+    using SmallMatrix = Eigen::Matrix<T, Size, Size>;
+    using SmallVector = Eigen::Matrix<T, Size, 1>;
+
+    auto n = container.size();
+    auto d = Index( container.dimension() );
+
+    #pragma omp parallel
     {
-      auto&& indices = lts.indices;
-      auto d         = Index( container.dimension() );
-      auto k         = Index( indices.size() );
+      std::vector<ElementType> point( static_cast<std::size_t>( d ) );
+      std::vector<T> centre( static_cast<std::size_t>( d ) );
+      std::vector<T> positions;
+      std::vector<T> norms;
 
-      Matrix W = Matrix::Zero(k,k  );
-      Matrix D = Matrix::Zero(k,d+2);
-      Matrix C = Matrix::Identity(d+2,d+2);
+      SmallMatrix A = SmallMatrix::Zero( d+2, d+2 );
+      SmallMatrix C = SmallMatrix::Identity( d+2, d+2 );
+      SmallVector r = SmallVector::Zero( d+2 );
 
       C(0  ,  0) =  0;
       C(0  ,d+1) = -2;
       C(d+1,  0) = -2;
       C(d+1,d+1) =  0;
 
+      Eigen::GeneralizedEigenSolver<SmallMatrix> solver( d+2 );
+
+      #pragma omp for schedule(dynamic, 256)
+      for( long i = 0; i < long( n ); i++ )
       {
-        Index i = Index();
-        for( auto&& index : indices )
+        auto&& indices = neighbours[ std::size_t(i) ];
+        auto k         = indices.size();
+
+        container.get( std::size_t(i), point.begin() );
+        std::copy( point.begin(), point.end(), centre.begin() );
+
+        positions.resize( k * std::size_t(d) );
+        norms.resize( k );
+
+        // Take the *maximum distance* in which we can find all of the
+        // neighbours as a *rough* approximation to the local feature
+        // size.
+        T localFeatureSize = T();
+
+        for( std::size_t j = 0; j < k; j++ )
         {
-          auto neighbour = getPosition( container, index );
-          W(i,  i)       = phi( ( lts.position - neighbour ).norm() / lts.localFeatureSize );
-          D(i,  0)       = 1;
-          D(i,d+1)       = neighbour * neighbour.transpose();
+          container.get( std::size_t( indices[j] ), point.begin() );
 
-          for( Index j = 0; j < d; j++ )
-            D(i,j+1) = neighbour(j);
+          T distance = T();
 
-          ++i;
+          for( std::size_t l = 0; l < std::size_t(d); l++ )
+          {
+            auto x = T( point[l] );
+
+            positions[ j*std::size_t(d) + l ] = x;
+            distance += ( x - centre[l] ) * ( x - centre[l] );
+          }
+
+          norms[j]         = std::sqrt( distance );
+          localFeatureSize = std::max( localFeatureSize, norms[j] );
         }
-      }
 
-      // Solve the linear system ---------------------------------------
-      //
-      // The solution of the system Ax = b is used to obtain the
-      // coefficients of the algebraic sphere.
+        // The system matrix is the weighted sum of the outer products of
+        // the rows (1, x, |x|^2), so there is no need to store the rows
+        // or their weights in a matrix.
+        A.setZero();
 
-      using Solver = Eigen::GeneralizedEigenSolver<Matrix>;
-      Solver solver;
-      solver.compute( D.transpose() * W * D, C );
+        for( std::size_t j = 0; j < k; j++ )
+        {
+          auto w = phi( norms[j] / localFeatureSize );
+          auto x = positions.data() + j*std::size_t(d);
+          T norm = T();
 
-      auto eigenvalues = solver.eigenvalues();
-      Vector u         = Vector::Zero( 1, d+2 );
+          r(0) = 1;
 
-      for( Index i = 0; i < d+2; i++ )
-      {
-        if( eigenvalues(i).real() > 0 && eigenvalues(i).imag() == 0 )
+          for( Index l = 0; l < d; l++ )
+          {
+            r(l+1)  = x[l];
+            norm   += x[l] * x[l];
+          }
+
+          r(d+1) = norm;
+
+          A.noalias() += w * r * r.transpose();
+        }
+
+        solver.compute( A, C );
+
+        auto eigenvalues = solver.eigenvalues();
+        auto u           = coefficients.begin() + long( std::size_t(i) * std::size_t(d+2) );
+
+        for( Index j = 0; j < d+2; j++ )
         {
-          u = solver.eigenvectors().real().col(i);
-          break;
+          if( eigenvalues(j).real() > 0 && eigenvalues(j).imag() == 0 )
+          {
+            for( Index l = 0; l < d+2; l++ )
+              *( u + long(l) ) = solver.eigenvectors()(l, j).real();
+
+            break;
+          }
         }
       }
-
-      spheres.emplace_back( Sphere( u.data(), u.data() + u.size() ) );
     }
-
-    return spheres;
   }
 
-
   void propagateOrientation( std::vector<LocalTangentSpace>& localTangentSpaces )
   {
     using Edge = std::pair<std::size_t, std::size_t>;
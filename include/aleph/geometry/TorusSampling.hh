@@ -27,6 +27,9 @@ namespace geometry
            which are sufficient to describe a torus. Please use
            aleph::geometry::makeTorus() to create a point cloud
            from the resulting angles.
+
+  @see aleph::geometry::sampleTorus() for a parallel and reproducible
+       variant that writes directly into a point cloud
 */
 
 template <class T>
@@ -9,6 +9,8 @@
 
 #include <aleph/topology/filtrations/Data.hh>
 
+#include <aleph/utilities/Profiler.hh>
+
 namespace aleph
 {
 
@@ -41,6 +43,8 @@ template <class NearestNeighbours> auto buildVietorisRipsComplex(
   using Simplex           = topology::Simplex<ElementType, IndexType>;
   using SimplicialComplex = topology::SimplicialComplex<Simplex>;
 
+  ALEPH_PROFILE_ZONE( "buildVietorisRipsComplex" );
+
   geometry::RipsSkeleton<NearestNeighbours> ripsSkeleton;
 
   auto skeleton
@@ -53,6 +57,7 @@ template <class NearestNeighbours> auto buildVietorisRipsComplex(
 
   K.sort( topology::filtrations::Data<Simplex>() );
 
+  ALEPH_PROFILE_MEMORY( "simplicialComplex", K.memoryUsage() );
   return K;
 }
 
@@ -80,6 +85,8 @@ auto buildVietorisRipsComplex(
   using Simplex           = topology::Simplex<ElementType, IndexType>;
   using SimplicialComplex = topology::SimplicialComplex<Simplex>;
 
+  ALEPH_PROFILE_ZONE( "buildVietorisRipsComplex" );
+
   geometry::RipsSkeleton<NearestNeighbours> ripsSkeleton;
 
   auto skeleton
@@ -92,6 +99,7 @@ auto buildVietorisRipsComplex(
 
   K.sort( topology::filtrations::Data<Simplex>() );
 
+  ALEPH_PROFILE_MEMORY( "simplicialComplex", K.memoryUsage() );
   return K;
 }
 
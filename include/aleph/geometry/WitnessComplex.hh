@@ -20,6 +20,8 @@
 
 #include <aleph/topology/filtrations/Data.hh>
 
+#include <aleph/utilities/Profiler.hh>
+
 namespace aleph
 {
 
@@ -110,6 +112,8 @@ template <
   using Simplex           = topology::Simplex<DataType, VertexType>;
   using SimplicialComplex = topology::SimplicialComplex<Simplex>;
 
+  ALEPH_PROFILE_ZONE( "buildWitnessComplex" );
+
   // These are only the *indices* of the landmarks, with respect to the
   // underlying point cloud.
   std::vector<IndexType> landmarkIndices( begin, end );
@@ -149,6 +153,8 @@ template <
     D.push_back( distances );
   }
 
+  ALEPH_PROFILE_MEMORY( "distanceMatrix", N * ( sizeof( std::vector<DataType> ) + n * sizeof( DataType ) ) );
+
   // Get smallest entries of the distance matrix. This is required for
   // deciding whether a specific edge is valid or not, with respect to
   // the given parameters.
@@ -206,6 +212,8 @@ template <
   L                   = ripsExpander.assignMaximumWeight( L );
 
   L.sort( aleph::topology::filtrations::Data<Simplex>() );
+
+  ALEPH_PROFILE_MEMORY( "simplicialComplex", L.memoryUsage() );
   return L;
 }
 
@@ -0,0 +1,243 @@
+#ifndef ALEPH_MATH_COMBINATION_RANKING_HH__
+#define ALEPH_MATH_COMBINATION_RANKING_HH__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace aleph
+{
+
+namespace math
+{
+
+/*
+  The functions in this file operate on k-combinations of the indices
+  {0, 1, ..., n-1}, which are stored as sorted sequences of indices. All
+  combinations are ordered lexicographically, i.e. {0,1,2} < {0,1,3} <
+  ... < {n-3,n-2,n-1}, and the *rank* of a combination is its position
+  in this order. Ranks make it possible to split the enumeration of all
+  combinations into contiguous intervals, each of which may be processed
+  independently, e.g. by a different thread.
+*/
+
+/**
+  Calculates the binomial coefficient \f$\binom{n}{k}\f$ without any
+  intermediate overflows. Throws if the result cannot be represented.
+*/
+
+inline std::uintmax_t binomialCoefficient( std::uintmax_t n, std::uintmax_t k )
+{
+  if( k > n )
+    return 0;
+
+  k = std::min( k, n - k );
+
+  std::uintmax_t result = 1;
+
+  for( std::uintmax_t i = 1; i <= k; i++ )
+  {
+    // Since result * (n - k + i) is divisible by i, dividing by the
+    // greatest common divisor first prevents most overflows.
+    auto a = n - k + i;
+    auto b = i;
+    auto g = result;
+
+    for( auto h = b; h != 0; )
+    {
+      auto t = g % h;
+      g      = h;
+      h      = t;
+    }
+
+    auto r = result / g;
+    b     /= g;
+    a     /= b;
+
+    if( a != 0 && r > std::numeric_limits<std::uintmax_t>::max() / a )
+      throw std::overflow_error( "Overflow in binomial coefficient" );
+
+    result = r * a;
+  }
+
+  return result;
+}
+
+/**
+  Calculates the lexicographical rank of a combination of k indices out
+  of n indices. The indices must be sorted in ascending order.
+
+  @param first Iterator to the beginning of the combination
+  @param last  Iterator to the end of the combination
+  @param n     Number of indices
+*/
+
+template <class InputIterator> std::uintmax_t rankCombination( InputIterator first, InputIterator last, std::uintmax_t n )
+{
+  std::uintmax_t k = std::uintmax_t( std::distance( first, last ) );
+
+  // The rank is calculated using the complementary combination, i.e.
+  // the one obtained by mapping every index i to n-1-i, whose rank in
+  // colexicographical order is a sum of binomial coefficients.
+  std::uintmax_t complement = 0;
+  std::uintmax_t i          = 0;
+
+  for( auto it = first; it != last; ++it, ++i )
+    complement += binomialCoefficient( n - 1 - std::uintmax_t( *it ), k - i );
+
+  return binomialCoefficient( n, k ) - 1 - complement;
+}
+
+/**
+  Calculates the combination of k indices out of n indices that has the
+  given lexicographical rank and stores its indices, in ascending order,
+  in an output iterator. Throws if the rank is out of range.
+*/
+
+template <class Index, class OutputIterator> void unrankCombination( std::uintmax_t rank, Index n, Index k, OutputIterator result )
+{
+  auto total = binomialCoefficient( std::uintmax_t( n ), std::uintmax_t( k ) );
+
+  if( rank >= total )
+    throw std::out_of_range( "Rank of combination is out of range" );
+
+  // Greedily determine the complementary combination in colexicographical
+  // order; its elements are found in descending order, so the indices of
+  // the original combination are found in ascending order.
+  auto complement = total - 1 - rank;
+  auto x          = std::uintmax_t( n );
+
+  for( std::uintmax_t i = 0; i < std::uintmax_t( k ); i++ )
+  {
+    auto j = std::uintmax_t( k ) - i;
+
+    do
+    {
+      --x;
+    }
+    while( binomialCoefficient( x, j ) > complement );
+
+    complement -= binomialCoefficient( x, j );
+    *result++   = Index( std::uintmax_t( n ) - 1 - x );
+  }
+}
+
+/**
+  Advances a combination of k indices out of n indices to its successor
+  in lexicographical order.
+
+  @returns false if the combination was the last one, in which case it
+  remains unchanged; true otherwise
+*/
+
+template <class BidirectionalIterator, class Index> bool nextCombination( BidirectionalIterator first, BidirectionalIterator last, Index n )
+{
+  if( first == last )
+    return false;
+
+  auto k  = Index( std::distance( first, last ) );
+  auto it = last;
+  auto i  = k;
+
+  // Find the last index that has not attained its maximum value, which
+  // is n-k+i for the ith position.
+  do
+  {
+    --it;
+    --i;
+
+    if( *it < n - k + i )
+    {
+      auto value = *it;
+
+      for( ; it != last; ++it )
+        *it = ++value;
+
+      return true;
+    }
+  }
+  while( it != first );
+
+  return false;
+}
+
+/**
+  Calls a function for every combination of k indices out of n indices,
+  in parallel. The lexicographically-ordered combinations are split into
+  a number of contiguous *chunks* of ranks. Every chunk is processed by
+  a single thread, which unranks the first combination of the chunk and
+  enumerates the remaining ones using nextCombination().
+
+  The function is called with the index of the current chunk, as well
+  as the beginning and the end of a range of sorted indices. The index
+  of the chunk makes it possible to store results without locks, e.g.
+  in one container per chunk. Concatenating those containers in the
+  order of their chunks yields the same result as a sequential
+  enumeration, regardless of the number of threads.
+
+  If the function returns true, the enumeration of the current chunk is
+  stopped, while all other chunks are processed as usual. This permits
+  an early exit for every thread.
+
+  @param n         Number of indices
+  @param k         Size of every combination
+  @param numChunks Number of chunks; will be clamped to the number of
+                   combinations
+  @param f         Function to call for every combination
+*/
+
+template <class Index, class Function> void parallelForEachCombination( Index n, Index k, std::size_t numChunks, Function f )
+{
+  if( k > n )
+    return;
+
+  auto total = binomialCoefficient( std::uintmax_t( n ), std::uintmax_t( k ) );
+  numChunks  = std::size_t( std::max( std::uintmax_t( 1 ), std::min( total, std::uintmax_t( numChunks ) ) ) );
+
+  using Iterator = typename std::vector<Index>::const_iterator;
+
+  // Small enumerations are not worth starting any threads for
+  #pragma omp parallel for schedule(dynamic) if( numChunks > 1 )
+  for( long chunk = 0; chunk < long( numChunks ); chunk++ )
+  {
+    auto c     = std::uintmax_t( chunk );
+    auto begin = total / numChunks * c       + std::min( c,     total % numChunks );
+    auto end   = total / numChunks * (c + 1) + std::min( c + 1, total % numChunks );
+
+    std::vector<Index> combination;
+    combination.reserve( std::size_t( k ) );
+
+    unrankCombination( begin, n, k, std::back_inserter( combination ) );
+
+    for( auto rank = begin; rank < end; rank++ )
+    {
+      if( f( std::size_t( chunk ), Iterator( combination.begin() ), Iterator( combination.end() ) ) )
+        break;
+
+      nextCombination( combination.begin(), combination.end(), n );
+    }
+  }
+}
+
+/**
+  Suggests a number of chunks for enumerating all combinations of k
+  indices out of n indices in parallel, such that every chunk contains
+  approximately the given number of combinations. The number does not
+  depend on the number of threads.
+*/
+
+inline std::size_t numCombinationChunks( std::uintmax_t n, std::uintmax_t k, std::uintmax_t grainSize = 1024 )
+{
+  auto total = binomialCoefficient( n, k );
+  return std::size_t( std::min( total / std::max( grainSize, std::uintmax_t( 1 ) ) + 1, std::uintmax_t( 1 ) << 16 ) );
+}
+
+} // namespace math
+
+} // namespace aleph
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef ALEPH_MATH_COUNTER_BASED_RANDOM_HH__
+#define ALEPH_MATH_COUNTER_BASED_RANDOM_HH__
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace aleph
+{
+
+namespace math
+{
+
+/**
+  @class CounterBasedRandom
+  @brief Counter-based random number generator
+
+  Every value of this generator is a pure function of a seed, a stream,
+  and a counter, which is incremented for every value. In contrast to
+  conventional generators, creating a new stream is very cheap, so it
+  is possible to use one stream for every element of a data structure,
+  e.g. for every point of a point cloud. The values of an element then
+  do not depend on the order in which elements are processed, which is
+  required for parallel algorithms that yield reproducible results for
+  any number of threads.
+
+  The values are created by the mixing function of SplitMix64. This is
+  sufficient for sampling and stress tests, but the generator must not
+  be used for cryptographic purposes.
+
+  The class satisfies the requirements of a uniform random bit
+  generator, so it may also be used with the distributions of the
+  standard library. Note that their results are not guaranteed to be
+  the same for different implementations of the standard library, so
+  `uniform()` and `normal()` should be preferred.
+*/
+
+class CounterBasedRandom
+{
+public:
+  using result_type = std::uint64_t;
+
+  CounterBasedRandom( std::uint64_t seed, std::uint64_t stream = 0 )
+    : _key( mix( seed ^ mix( stream + increment ) ) )
+    , _counter( 0 )
+  {
+  }
+
+  static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+  static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+  result_type operator()()
+  {
+    return mix( _key + increment * ++_counter );
+  }
+
+  /** @returns Uniformly distributed value in \f$[0,1)\f$ */
+  double uniform()
+  {
+    // Use the upper 53 bits, i.e. the size of the mantissa of a double
+    return double( (*this)() >> 11 ) * ( 1.0 / double( std::uint64_t(1) << 53 ) );
+  }
+
+  /** @returns Uniformly distributed value in \f$[a,b)\f$ */
+  double uniform( double a, double b )
+  {
+    return a + ( b - a ) * this->uniform();
+  }
+
+  /**
+    @returns Normally distributed value with mean zero and unit variance,
+    created using the Box--Muller transform
+  */
+
+  double normal()
+  {
+    auto u = 1.0 - this->uniform(); // in (0,1], so the logarithm is finite
+    auto v = this->uniform();
+
+    return std::sqrt( -2.0 * std::log( u ) ) * std::cos( 2 * M_PI * v );
+  }
+
+  /** @returns Normally distributed value with given mean and standard deviation */
+  double normal( double mean, double sigma )
+  {
+    return mean + sigma * this->normal();
+  }
+
+private:
+  static constexpr std::uint64_t increment = 0x9E3779B97F4A7C15ull;
+
+  static std::uint64_t mix( std::uint64_t z )
+  {
+    z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+    z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBull;
+    return z ^ ( z >> 31 );
+  }
+
+  std::uint64_t _key;
+  std::uint64_t _counter;
+};
+
+} // namespace math
+
+} // namespace aleph
+
+#endif
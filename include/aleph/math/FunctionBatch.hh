@@ -0,0 +1,354 @@
+#ifndef ALEPH_MATH_FUNCTION_BATCH_HH__
+#define ALEPH_MATH_FUNCTION_BATCH_HH__
+
+#include <aleph/math/KahanSummation.hh>
+#include <aleph/math/SymmetricMatrix.hh>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include <cmath>
+#include <cstddef>
+
+namespace aleph
+{
+
+namespace math
+{
+
+/**
+  @class FunctionBatch
+  @brief Batch of step functions or piecewise linear functions
+
+  Stores the breakpoints of many functions in a single arena instead of
+  using one container per function. The \f$i\f$-th function consists of
+  the breakpoints in the half-open range \f$[offsets[i], offsets[i+1])\f$
+  of the domain values and the image values.
+
+  The breakpoints of every function are sorted by their domain values.
+  Depending on the type of the batch, they are interpreted as follows:
+
+  - Step functions take the value of a breakpoint until the next one is
+    reached; the value of the last breakpoint is always zero.
+  - Piecewise linear functions interpolate between the breakpoints.
+
+  In both cases, a function is zero outside the range of its domain, as
+  for StepFunction and PiecewiseLinearFunction. Distances between two
+  functions are integrated exactly over all segments between the merged
+  breakpoints, splitting segments where the difference changes its sign.
+
+  @tparam D Type of the *domain* of the functions
+  @tparam I Type of the *image* of the functions
+*/
+
+template <class D, class I = D> class FunctionBatch
+{
+public:
+  using Domain = D;
+  using Image  = I;
+
+  enum class Type
+  {
+    Step,
+    PiecewiseLinear
+  };
+
+  /**
+    Creates a new batch of functions, reserving space for the given
+    number of breakpoints per function. All functions are empty until
+    their breakpoints have been stored (see resize()).
+  */
+
+  FunctionBatch( Type type, const std::vector<std::size_t>& capacities )
+    : _type( type ),
+      _offsets( capacities.size() + 1 ),
+      _sizes( capacities.size() )
+  {
+    std::partial_sum( capacities.begin(), capacities.end(), _offsets.begin() + 1 );
+
+    _domain.resize( _offsets.back() );
+    _image.resize( _offsets.back() );
+  }
+
+  /** @returns Type of the functions */
+  Type type() const noexcept
+  {
+    return _type;
+  }
+
+  /** @returns Number of functions */
+  std::size_t size() const noexcept
+  {
+    return _sizes.size();
+  }
+
+  /** @returns Number of breakpoints of a function */
+  std::size_t size( std::size_t i ) const noexcept
+  {
+    return _sizes[i];
+  }
+
+  /** @returns Pointer to the domain values of the breakpoints of a function */
+  const Domain* domain( std::size_t i ) const noexcept { return _domain.data() + _offsets[i]; }
+        Domain* domain( std::size_t i )       noexcept { return _domain.data() + _offsets[i]; }
+
+  /** @returns Pointer to the image values of the breakpoints of a function */
+  const Image* image( std::size_t i ) const noexcept { return _image.data() + _offsets[i]; }
+        Image* image( std::size_t i )       noexcept { return _image.data() + _offsets[i]; }
+
+  /**
+    Sets the number of breakpoints of a function. It must not exceed the
+    space that has been reserved for the function. Since every function
+    only changes its own entries, functions may be filled in parallel.
+  */
+
+  void resize( std::size_t i, std::size_t n ) noexcept
+  {
+    _sizes[i] = n;
+  }
+
+  /**
+    Removes unused space between the functions, so that the breakpoints
+    of all functions are stored contiguously.
+  */
+
+  void compact()
+  {
+    std::size_t offset = 0;
+
+    for( std::size_t i = 0; i < this->size(); i++ )
+    {
+      auto begin = _offsets[i];
+      auto n     = _sizes[i];
+
+      // Functions never move backwards, so copying in ascending order
+      // does not overwrite any breakpoints that are still required.
+      std::copy( _domain.begin() + long( begin ), _domain.begin() + long( begin + n ), _domain.begin() + long( offset ) );
+      std::copy( _image.begin()  + long( begin ), _image.begin()  + long( begin + n ), _image.begin()  + long( offset ) );
+
+      _offsets[i]  = offset;
+      offset      += n;
+    }
+
+    _offsets.back() = offset;
+
+    _domain.resize( offset );
+    _image.resize( offset );
+    _domain.shrink_to_fit();
+    _image.shrink_to_fit();
+  }
+
+  /**
+    Normalizes all functions such that their maximum value is one. Just
+    as for math::normalize(), functions whose values do not vary remain
+    unchanged.
+  */
+
+  void normalize()
+  {
+    #pragma omp parallel for schedule(dynamic, 64)
+    for( long i = 0; i < long( this->size() ); i++ )
+    {
+      auto y = this->image( std::size_t(i) );
+      auto n = this->size( std::size_t(i) );
+
+      // The last breakpoint of a step function does not belong to any
+      // interval, so its value is not part of the image.
+      if( _type == Type::Step && n > 0 )
+        --n;
+
+      if( n == 0 )
+        continue;
+
+      auto max    = *std::max_element( y, y + n );
+      bool varies = std::find_if( y, y + n, [&y] ( Image value ) { return value != y[0]; } ) != y + n;
+
+      if( varies && max != Image() )
+        std::transform( y, y + n, y, [&max] ( Image value ) { return value / max; } );
+    }
+  }
+
+  /**
+    Calculates the \f$L_p\f$ distance between two functions of the batch.
+    The breakpoints of both functions are merged on the fly, so no copy
+    of either function is required.
+  */
+
+  Image distance( std::size_t i, std::size_t j, Image p = Image(1) ) const noexcept
+  {
+    auto x1 = this->domain(i);
+    auto y1 = this->image(i);
+    auto n1 = this->size(i);
+    auto x2 = this->domain(j);
+    auto y2 = this->image(j);
+    auto n2 = this->size(j);
+
+    KahanSummation<Image> sum = Image();
+
+    std::size_t k1 = 0;
+    std::size_t k2 = 0;
+
+    bool   first = true;
+    Domain xPrev = Domain();
+    Image  yPrev = Image();
+    Image  zPrev = Image();
+
+    // Checks whether the segment between two consecutive breakpoints is
+    // contained in the domain of a function.
+    auto contains = [] ( const Domain* x, std::size_t n, Domain a, Domain b )
+    {
+      return n > 0 && x[0] <= a && b <= x[n-1];
+    };
+
+    while( k1 < n1 || k2 < n2 )
+    {
+      Domain x = k1 == n1 ? x2[k2]
+                          : k2 == n2 ? x1[k1]
+                                     : std::min( x1[k1], x2[k2] );
+
+      if( _type == Type::Step )
+      {
+        if( !first )
+          sum += std::pow( std::abs( yPrev - zPrev ), p ) * Image( x - xPrev );
+
+        // Skip all breakpoints at the current position; the values of the
+        // functions are then determined by the last breakpoints before.
+        while( k1 < n1 && x1[k1] == x ) ++k1;
+        while( k2 < n2 && x2[k2] == x ) ++k2;
+
+        yPrev = valueStep( y1, n1, k1 );
+        zPrev = valueStep( y2, n2, k2 );
+      }
+      else
+      {
+        auto y = valueLinear( x1, y1, n1, k1, x );
+        auto z = valueLinear( x2, y2, n2, k2, x );
+
+        if( !first )
+        {
+          bool c1 = contains( x1, n1, xPrev, x );
+          bool c2 = contains( x2, n2, xPrev, x );
+
+          sum += integral( xPrev, ( c1 ? yPrev : Image() ) - ( c2 ? zPrev : Image() ),
+                           x,     ( c1 ? y     : Image() ) - ( c2 ? z     : Image() ),
+                           p );
+        }
+
+        while( k1 < n1 && x1[k1] == x ) ++k1;
+        while( k2 < n2 && x2[k2] == x ) ++k2;
+
+        yPrev = y;
+        zPrev = z;
+      }
+
+      first = false;
+      xPrev = x;
+    }
+
+    return std::pow( Image( sum ), 1 / p );
+  }
+
+private:
+
+  /**
+    Evaluates a step function whose first \p k breakpoints precede the
+    evaluation point
+  */
+
+  static Image valueStep( const Image* y, std::size_t n, std::size_t k ) noexcept
+  {
+    if( k == 0 || k == n )
+      return Image();
+    else
+      return y[k-1];
+  }
+
+  /**
+    Evaluates a piecewise linear function at \p x, where \p k is the
+    index of the first breakpoint that does not precede \p x
+  */
+
+  static Image valueLinear( const Domain* x, const Image* y, std::size_t n, std::size_t k, Domain t ) noexcept
+  {
+    if( k < n && x[k] == t )
+      return y[k];
+    else if( k == 0 || k == n )
+      return Image();
+    else
+      return y[k-1] + ( y[k] - y[k-1] ) * ( t - x[k-1] ) / ( x[k] - x[k-1] );
+  }
+
+  /**
+    Integrates the absolute value, raised to the \f$p\f$-th power, of
+    the line segment between two points. Segments that intersect the
+    x-axis are split at the intersection.
+  */
+
+  static Image integral( Domain x0, Image y0, Domain x1, Image y1, Image p ) noexcept
+  {
+    if( y0 * y1 < Image() )
+    {
+      auto x = x0 + Domain( ( x1 - x0 ) * y0 / ( y0 - y1 ) );
+      return integral( x0, y0, x, Image(), p ) + integral( x, Image(), x1, y1, p );
+    }
+
+    auto a     = std::min( std::abs( y0 ), std::abs( y1 ) );
+    auto b     = std::max( std::abs( y0 ), std::abs( y1 ) );
+    auto width = Image( x1 - x0 );
+
+    if( b == Image() )
+      return Image();
+
+    // The integral of the segment is the width times the average of the
+    // p-th power, i.e. (b^{p+1} - a^{p+1}) / ((p+1)(b-a)). This ratio is
+    // expressed in terms of a/b to avoid cancellation for segments that
+    // are almost horizontal.
+    auto l     = std::log( a / b );
+    auto ratio = l == Image() ? Image(1) : std::expm1( ( p + 1 ) * l ) / ( ( p + 1 ) * std::expm1( l ) );
+
+    return width * std::pow( b, p ) * ratio;
+  }
+
+  /** Type of all functions */
+  Type _type;
+
+  /** Offsets of the functions in the arena */
+  std::vector<std::size_t> _offsets;
+
+  /** Number of breakpoints of every function */
+  std::vector<std::size_t> _sizes;
+
+  /** Domain values of all breakpoints */
+  std::vector<Domain> _domain;
+
+  /** Image values of all breakpoints */
+  std::vector<Image> _image;
+};
+
+/**
+  Calculates the \f$L_p\f$ distances between all pairs of functions of
+  a batch. The rows of the matrix are distributed over all threads.
+*/
+
+template <class D, class I> SymmetricMatrix<I> pairwiseDistances( const FunctionBatch<D, I>& F, I p = I(1) )
+{
+  auto n = F.size();
+
+  SymmetricMatrix<I> M( n );
+
+  #pragma omp parallel for schedule(dynamic, 1)
+  for( long i = 0; i < long( n ); i++ )
+  {
+    for( std::size_t j = std::size_t(i) + 1; j < n; j++ )
+      M( std::size_t(i), j ) = F.distance( std::size_t(i), j, p );
+  }
+
+  return M;
+}
+
+} // namespace math
+
+} // namespace aleph
+
+#endif
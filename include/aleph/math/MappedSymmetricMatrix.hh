@@ -0,0 +1,347 @@
+#ifndef ALEPH_MATH_MAPPED_SYMMETRIC_MATRIX_HH__
+#define ALEPH_MATH_MAPPED_SYMMETRIC_MATRIX_HH__
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cstddef>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace aleph
+{
+
+namespace math
+{
+
+/**
+  @class MappedSymmetricMatrix
+  @brief Symmetric matrix that is backed by a memory-mapped file
+
+  This class provides the same interface as SymmetricMatrix, but its
+  data are stored in a file that is mapped into memory. Hence, opening
+  a matrix does not require any parsing or copying, and the operating
+  system only loads those parts of the matrix that are being accessed.
+  This makes it possible to work with large matrices of precomputed
+  dissimilarities, which would not fit into memory otherwise.
+
+  The file uses the following binary layout, in which all values are
+  stored in the native byte order:
+
+  | Offset | Type        | Contents                                  |
+  |--------|-------------|-------------------------------------------|
+  |      0 | `char[8]`   | Magic string `ALEPHSYM`                   |
+  |      8 | `uint32_t`  | Version of the layout, currently 1        |
+  |     12 | `uint32_t`  | Size of a single element in bytes         |
+  |     16 | `uint64_t`  | Number of rows \f$n\f$                    |
+  |     24 | `T[]`       | \f$n(n+1)/2\f$ elements                   |
+
+  The elements form the upper triangular part of the matrix, including
+  the diagonal, in row-major order. This is the same layout as the one
+  used by SymmetricMatrix, so element \f$(i,j)\f$ with \f$i \leq j\f$ is
+  stored at index \f$i n - i(i+1)/2 + j\f$.
+
+  @tparam T Data type stored in matrix, e.g. `double`
+  @tparam I Index type for accessing the matrix
+*/
+
+template <class T, class I = std::size_t> class MappedSymmetricMatrix
+{
+public:
+
+  /** Size of the header of a file in bytes */
+  static constexpr std::size_t headerSize = 24;
+
+  /** Creates an empty matrix that is not backed by any file */
+  MappedSymmetricMatrix()
+  {
+  }
+
+  /**
+    Opens an existing file and maps it into memory. Throws if the file
+    cannot be opened or does not follow the layout described above.
+
+    @param filename Name of the file
+    @param writable If set, changes to the matrix are written to the file
+  */
+
+  explicit MappedSymmetricMatrix( const std::string& filename, bool writable = false )
+  {
+    this->map( filename, writable ? O_RDWR : O_RDONLY, 0 );
+  }
+
+  /**
+    Creates a new file for a matrix with a given number of rows and maps
+    it into memory for writing. All elements of the matrix are zero. An
+    existing file of the same name will be overwritten.
+  */
+
+  static MappedSymmetricMatrix create( const std::string& filename, I n )
+  {
+    MappedSymmetricMatrix M;
+    M.map( filename, O_RDWR | O_CREAT | O_TRUNC, n );
+    return M;
+  }
+
+  /** Writes the header of a matrix with n rows to a buffer of headerSize bytes */
+  static void writeHeader( char* header, std::uint64_t n )
+  {
+    std::uint32_t version     = 1;
+    std::uint32_t elementSize = sizeof( T );
+
+    std::memcpy( header,      "ALEPHSYM",   8 );
+    std::memcpy( header +  8, &version,     sizeof( version ) );
+    std::memcpy( header + 12, &elementSize, sizeof( elementSize ) );
+    std::memcpy( header + 16, &n,           sizeof( n ) );
+  }
+
+  MappedSymmetricMatrix( const MappedSymmetricMatrix& )            = delete;
+  MappedSymmetricMatrix& operator=( const MappedSymmetricMatrix& ) = delete;
+
+  MappedSymmetricMatrix( MappedSymmetricMatrix&& other )
+    : MappedSymmetricMatrix()
+  {
+    this->swap( other );
+  }
+
+  MappedSymmetricMatrix& operator=( MappedSymmetricMatrix&& other )
+  {
+    this->swap( other );
+    return *this;
+  }
+
+  /** Unmaps the file; changes of writable matrices are kept */
+  ~MappedSymmetricMatrix()
+  {
+    if( _mapping )
+      munmap( _mapping, _mappingSize );
+  }
+
+  /** Swaps two matrices */
+  void swap( MappedSymmetricMatrix& other )
+  {
+    std::swap( _numRows    , other._numRows     );
+    std::swap( _size       , other._size        );
+    std::swap( _data       , other._data        );
+    std::swap( _mapping    , other._mapping     );
+    std::swap( _mappingSize, other._mappingSize );
+  }
+
+  /**
+    Provides element-wise access to the matrix and returns the element
+    at the specified position. The function throws if an invalid index
+    is encountered.
+  */
+
+  const T& operator()( I row, I column ) const
+  {
+    if( row >= _numRows || column >= _numRows )
+      throw std::out_of_range( "Index is out of range" );
+
+    if( row > column )
+      std::swap( row, column );
+
+    return _data[ row * _numRows - row * ( row + 1 ) / 2 + column ];
+  }
+
+  /**
+    Provides writable element-wise access to the matrix. Writing to a
+    matrix that has been opened for reading only results in a crash.
+  */
+
+  T& operator()( I row, I column )
+  {
+    return const_cast<T&>( static_cast<const MappedSymmetricMatrix&>( *this )( row, column ) );
+  }
+
+  /** Returns number of rows */
+  I numRows() const noexcept
+  {
+    return _numRows;
+  }
+
+  /** Returns size of matrix */
+  I size() const noexcept
+  {
+    return _size;
+  }
+
+  /** Returns pointer to the packed elements of the matrix */
+  const T* data() const noexcept
+  {
+    return _data;
+  }
+
+  /**
+    Returns approximate number of bytes that are used by the matrix on
+    the heap. The elements are only mapped into memory, so they are not
+    included.
+  */
+
+  std::size_t memoryUsage() const noexcept
+  {
+    return sizeof( MappedSymmetricMatrix );
+  }
+
+  /** Checks whether the matrix is empty */
+  bool empty() const noexcept
+  {
+    return _numRows == 0;
+  }
+
+private:
+
+  void map( const std::string& filename, int flags, I n )
+  {
+    int fd = open( filename.c_str(), flags, 0644 );
+    if( fd < 0 )
+      throw std::runtime_error( "Unable to open matrix file '" + filename + "'" );
+
+    bool create = ( flags & O_CREAT ) != 0;
+
+    try
+    {
+      if( create )
+      {
+        std::uint64_t rows = std::uint64_t( n );
+        auto size          = headerSize + std::size_t( rows * ( rows + 1 ) / 2 ) * sizeof( T );
+
+        // Enlarging the file creates zero-filled elements, which do not
+        // have to be written explicitly.
+        if( ftruncate( fd, off_t( size ) ) != 0 )
+          throw std::runtime_error( "Unable to resize matrix file '" + filename + "'" );
+      }
+
+      struct stat status;
+      if( fstat( fd, &status ) != 0 )
+        throw std::runtime_error( "Unable to determine size of matrix file '" + filename + "'" );
+
+      _mappingSize = std::size_t( status.st_size );
+
+      if( _mappingSize < headerSize )
+        throw std::runtime_error( "Matrix file '" + filename + "' is too small" );
+
+      int protection = ( flags & O_RDWR ) ? PROT_READ | PROT_WRITE : PROT_READ;
+      void* mapping  = mmap( nullptr, _mappingSize, protection, MAP_SHARED, fd, 0 );
+
+      if( mapping == MAP_FAILED )
+        throw std::runtime_error( "Unable to map matrix file '" + filename + "'" );
+
+      _mapping = mapping;
+    }
+    catch( ... )
+    {
+      close( fd );
+      throw;
+    }
+
+    // The mapping remains valid after closing the file descriptor
+    close( fd );
+
+    auto header = static_cast<char*>( _mapping );
+
+    if( create )
+      writeHeader( header, std::uint64_t( n ) );
+
+    std::uint32_t version     = 0;
+    std::uint32_t elementSize = 0;
+    std::uint64_t rows        = 0;
+
+    std::memcpy( &version,     header +  8, sizeof( version ) );
+    std::memcpy( &elementSize, header + 12, sizeof( elementSize ) );
+    std::memcpy( &rows,        header + 16, sizeof( rows ) );
+
+    std::string error;
+
+    if( std::memcmp( header, "ALEPHSYM", 8 ) != 0 )
+      error = "Matrix file '" + filename + "' does not start with the magic string";
+    else if( version != 1 )
+      error = "Matrix file '" + filename + "' uses an unsupported version";
+    else if( elementSize != sizeof( T ) )
+      error = "Element size of matrix file '" + filename + "' does not match data type";
+    else if( _mappingSize < headerSize + std::size_t( rows * ( rows + 1 ) / 2 ) * sizeof( T ) )
+      error = "Matrix file '" + filename + "' is truncated";
+
+    if( !error.empty() )
+    {
+      munmap( _mapping, _mappingSize );
+      _mapping = nullptr;
+
+      throw std::runtime_error( error );
+    }
+
+    _numRows = I( rows );
+    _size    = I( rows * ( rows + 1 ) / 2 );
+    _data    = reinterpret_cast<T*>( header + headerSize );
+  }
+
+private:
+
+  /** Number of rows (and columns) */
+  I _numRows = I(0);
+
+  /** Total number of elements */
+  I _size = I(0);
+
+  /** Pointer to the elements, i.e. into the mapped file */
+  T* _data = nullptr;
+
+  /** Mapped file, including its header */
+  void* _mapping = nullptr;
+
+  /** Size of the mapped file in bytes */
+  std::size_t _mappingSize = 0;
+};
+
+/**
+  Writes a symmetric matrix to a file that can be opened as a memory-mapped
+  matrix afterwards. The matrix may be of any type that provides access to
+  its elements via `M(i,j)`, as well as a `numRows()` function, e.g. a
+  SymmetricMatrix.
+
+  @tparam T Data type of the elements in the file
+*/
+
+template <class T, class Matrix> void writeMappedSymmetricMatrix( const std::string& filename, const Matrix& M )
+{
+  std::ofstream out( filename, std::ios::binary );
+  if( !out )
+    throw std::runtime_error( "Unable to open matrix file '" + filename + "' for writing" );
+
+  auto n = M.numRows();
+
+  char header[ MappedSymmetricMatrix<T>::headerSize ];
+  MappedSymmetricMatrix<T>::writeHeader( header, std::uint64_t( n ) );
+
+  out.write( header, sizeof( header ) );
+
+  std::vector<T> row;
+  row.reserve( std::size_t( n ) );
+
+  for( decltype(n) i = 0; i < n; i++ )
+  {
+    row.clear();
+
+    for( decltype(n) j = i; j < n; j++ )
+      row.push_back( T( M(i,j) ) );
+
+    out.write( reinterpret_cast<const char*>( row.data() ), std::streamsize( row.size() * sizeof( T ) ) );
+  }
+
+  if( !out )
+    throw std::runtime_error( "Unable to write matrix file '" + filename + "'" );
+}
+
+} // namespace math
+
+} // namespace aleph
+
+#endif
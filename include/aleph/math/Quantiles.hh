@@ -3,6 +3,12 @@
 
 #include <algorithm>
 #include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <cmath>
+#include <cstddef>
 
 namespace aleph
 {
@@ -35,6 +41,178 @@ template <class InputIterator> typename std::iterator_traits<InputIterator>::val
   }
 }
 
+/**
+  @class QuantileSketch
+  @brief Mergeable sketch for approximating quantiles of a stream of values
+
+  Counts non-negative values in logarithmically-spaced buckets, so that
+  every quantile is approximated with a bounded *relative* error. Since
+  the boundaries of the buckets only depend on the accuracy, sketches of
+  different streams can be merged by adding their counts. The memory of
+  the sketch only depends on the ratio of the largest and the smallest
+  non-zero value, but not on the number of values.
+
+  The sketch follows the paper *DDSketch: A Fast and Fully-Mergeable
+  Quantile Sketch with Relative-Error Guarantees* by Masson et al.
+
+  @see https://doi.org/10.14778/3352063.3352135
+*/
+
+template <class T> class QuantileSketch
+{
+public:
+
+  /**
+    Creates a new sketch. Every quantile of the values is approximated
+    by a value whose relative error is at most the given accuracy.
+  */
+
+  explicit QuantileSketch( double accuracy = 0.01 )
+    : _accuracy( accuracy ),
+      _gamma( ( 1 + accuracy ) / ( 1 - accuracy ) ),
+      _logGamma( std::log( _gamma ) )
+  {
+    if( accuracy <= 0.0 || accuracy >= 1.0 )
+      throw std::runtime_error( "Accuracy must be in (0,1)" );
+  }
+
+  /** Adds a value to the sketch; the absolute value is used for negative values */
+  void add( T x )
+  {
+    auto y = std::abs( static_cast<double>( x ) );
+
+    if( std::isnan( y ) )
+      return;
+    else if( y == 0.0 )
+      ++_numZeros;
+    else if( std::isinf( y ) )
+      ++_numInfinite;
+    else
+    {
+      auto k = static_cast<long>( std::ceil( std::log( y ) / _logGamma ) );
+
+      if( _counts.empty() )
+        _offset = k;
+
+      this->reserve( k, k );
+      ++_counts[ std::size_t( k - _offset ) ];
+    }
+  }
+
+  /**
+    Merges another sketch into the current one. Both sketches must have
+    been created with the same accuracy.
+  */
+
+  void merge( const QuantileSketch& other )
+  {
+    if( other._accuracy != _accuracy )
+      throw std::runtime_error( "Sketches with different accuracies cannot be merged" );
+
+    _numZeros    += other._numZeros;
+    _numInfinite += other._numInfinite;
+
+    if( other._counts.empty() )
+      return;
+
+    if( _counts.empty() )
+      _offset = other._offset;
+
+    this->reserve( other._offset, other._offset + long( other._counts.size() ) - 1 );
+
+    for( std::size_t i = 0; i < other._counts.size(); i++ )
+      _counts[ std::size_t( other._offset - _offset ) + i ] += other._counts[i];
+  }
+
+  /** @returns Number of values in the sketch */
+  std::size_t size() const noexcept
+  {
+    std::size_t n = _numZeros + _numInfinite;
+
+    for( auto&& count : _counts )
+      n += count;
+
+    return n;
+  }
+
+  /** @returns Accuracy of the sketch */
+  double accuracy() const noexcept
+  {
+    return _accuracy;
+  }
+
+  /**
+    Approximates the quantile of the given rank, where a rank of 0.5
+    refers to the median. The lower median is used for even sizes. If
+    the sketch is empty, NaN is returned.
+  */
+
+  T quantile( double q ) const
+  {
+    if( q < 0.0 || q > 1.0 )
+      throw std::runtime_error( "Rank of quantile must be in [0,1]" );
+
+    auto n = this->size();
+    if( n == 0 )
+      return static_cast<T>( std::numeric_limits<double>::quiet_NaN() );
+
+    auto rank = static_cast<std::size_t>( q * double( n - 1 ) );
+
+    if( rank < _numZeros )
+      return T();
+
+    std::size_t count = _numZeros;
+
+    for( std::size_t i = 0; i < _counts.size(); i++ )
+    {
+      count += _counts[i];
+
+      // Every value in the bucket is within the relative accuracy of
+      // this estimate.
+      if( rank < count )
+        return static_cast<T>( 2 * std::pow( _gamma, double( long(i) + _offset ) ) / ( _gamma + 1 ) );
+    }
+
+    return static_cast<T>( std::numeric_limits<double>::infinity() );
+  }
+
+private:
+
+  /** Ensures that the given range of buckets exists */
+  void reserve( long first, long last )
+  {
+    if( first < _offset )
+    {
+      _counts.insert( _counts.begin(), std::size_t( _offset - first ), 0 );
+      _offset = first;
+    }
+
+    if( last - _offset >= long( _counts.size() ) )
+      _counts.resize( std::size_t( last - _offset + 1 ) );
+  }
+
+  /** Relative accuracy of all quantiles */
+  double _accuracy;
+
+  /** Ratio of the boundaries of every bucket */
+  double _gamma;
+
+  /** Logarithm of the ratio of the bucket boundaries */
+  double _logGamma;
+
+  /** Index of the first bucket */
+  long _offset = 0;
+
+  /** Number of values in every bucket */
+  std::vector<std::size_t> _counts;
+
+  /** Number of values that are zero */
+  std::size_t _numZeros = 0;
+
+  /** Number of values that are infinite */
+  std::size_t _numInfinite = 0;
+};
+
 } // namespace math
 
 } // namespace aleph
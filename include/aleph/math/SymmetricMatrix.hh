@@ -135,6 +135,12 @@ public:
     return _size;
   }
 
+  /** Returns approximate number of bytes that are used by the matrix */
+  std::size_t memoryUsage() const noexcept
+  {
+    return sizeof( SymmetricMatrix ) + static_cast<std::size_t>( _size ) * sizeof( T );
+  }
+
   /** Checks whether the matrix is empty */
   bool empty() const noexcept
   {
@@ -1,6 +1,7 @@
 #ifndef ALEPH_PERSISTENCE_DIAGRAMS_ENVELOPE_HH__
 #define ALEPH_PERSISTENCE_DIAGRAMS_ENVELOPE_HH__
 
+#include <aleph/math/FunctionBatch.hh>
 #include <aleph/math/PiecewiseLinearFunction.hh>
 
 #include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
@@ -8,6 +9,7 @@
 #include <algorithm>
 #include <iterator>
 #include <set>
+#include <utility>
 #include <vector>
 
 #include <cassert>
@@ -82,7 +84,7 @@ public:
     for( auto&& x : X )
     {
       auto next = std::next( it );
-      while( next->x() == x )
+      while( next != P.end() && next->x() == x )
       {
         ++next;
         ++it;
@@ -96,6 +98,75 @@ public:
     return PiecewiseLinearFunction( coordinates.begin(), coordinates.end() );
   }
 
+  /**
+    Calculates the envelopes of a batch of persistence diagrams. The
+    diagrams are processed in parallel, and the breakpoints of all the
+    envelopes are stored in a single arena. Every envelope coincides
+    with the one calculated for the corresponding diagram above.
+
+    @param diagrams Input persistence diagrams
+    @returns Batch of piecewise linear envelope functions
+  */
+
+  template <class T> aleph::math::FunctionBatch<T> operator()( const std::vector< PersistenceDiagram<T> >& diagrams ) const
+  {
+    using FunctionBatch = aleph::math::FunctionBatch<T>;
+
+    // An envelope has at most one breakpoint per point of the diagram,
+    // so this suffices for reserving space in the arena.
+    std::vector<std::size_t> capacities;
+    capacities.reserve( diagrams.size() );
+
+    for( auto&& D : diagrams )
+      capacities.push_back( D.size() );
+
+    FunctionBatch F( FunctionBatch::Type::PiecewiseLinear, capacities );
+
+    #pragma omp parallel
+    {
+      std::vector< std::pair<T, T> > P;
+
+      #pragma omp for schedule(dynamic, 16)
+      for( long i = 0; i < long( diagrams.size() ); i++ )
+      {
+        auto&& D = diagrams[ std::size_t(i) ];
+
+        P.clear();
+
+        for( auto&& p : D )
+        {
+          if( _removeUnpairedPoints && p.isUnpaired() )
+            continue;
+
+          P.push_back( std::make_pair( p.x() + p.y(), p.y() - p.x() ) );
+        }
+
+        std::sort( P.begin(), P.end() );
+
+        auto x = F.domain( std::size_t(i) );
+        auto y = F.image( std::size_t(i) );
+
+        // Of all points with the same x coordinate, the last one has the
+        // largest y coordinate.
+        std::size_t n = 0;
+        for( std::size_t j = 0; j < P.size(); j++ )
+        {
+          if( j + 1 < P.size() && P[j+1].first == P[j].first )
+            continue;
+
+          x[n] = P[j].first;
+          y[n] = P[j].second;
+          ++n;
+        }
+
+        F.resize( std::size_t(i), n );
+      }
+    }
+
+    F.compact();
+    return F;
+  }
+
   void setRemoveUnpairedPoints( bool value = true ) { _removeUnpairedPoints = value; }
   bool    removeUnpairedPoints() const noexcept     { return _removeUnpairedPoints;  }
 
@@ -52,17 +52,15 @@ void weightedPersistence( const PersistenceDiagram<DataType>& D,
                                                return p.x() < q.x();
                                            } );
 
-  // Get all unique points
-  std::vector<Point> uniquePoints;
-  std::unique_copy( points.begin(), points.end(),
-                    std::back_inserter( uniquePoints ) );
-
-  for( auto&& point : uniquePoints )
+  // Since the points are sorted, all copies of a point form a run
+  for( auto it = points.begin(); it != points.end(); )
   {
-    auto count  = std::count( points.begin(), points.end(), point );
+    auto next   = std::find_if( it, points.end(), [&it] ( const Point& p ) { return !( p == *it ); } );
+    auto count  = std::distance( it, next );
     auto weight = static_cast<double>( count ) / static_cast<double>( points.size() );
 
-    *result++ = weight * point.persistence();
+    *result++ = weight * it->persistence();
+    it        = next;
   }
 }
 
@@ -5,8 +5,8 @@
 #include <aleph/math/KahanSummation.hh>
 
 #include <algorithm>
-#include <vector>
 #include <stdexcept>
+#include <vector>
 
 #include <cmath>
 
@@ -17,6 +17,11 @@ namespace aleph
   Calculates the total persistence of a given persistence diagram. All
   persistence values will be taken to the $k$th power. Kahan summation
   is used to ensure numerical stability.
+
+  If the total persistence is weighted, every unique point is weighted
+  by its multiplicity, relative to the number of points. Since all the
+  copies of a point contribute the same value, this amounts to dividing
+  the total persistence by the number of points.
 */
 
 template <class DataType> double totalPersistence( const PersistenceDiagram<DataType>& D,
@@ -25,51 +30,11 @@ template <class DataType> double totalPersistence( const PersistenceDiagram<Data
 {
   aleph::math::KahanSummation<double> result = 0.0;
 
-  if( !weighted )
-  {
-    for( auto&& point : D )
-      result += std::pow( static_cast<double>( point.persistence() ), k );
-  }
-  else
-  {
-    using Point = typename PersistenceDiagram<DataType>::Point;
-    std::vector<Point> points;
-    points.reserve( D.size() );
-
-    for( auto&& point : D )
-      points.push_back( point );
-
-    std::sort( points.begin(), points.end(), [] ( const Point& p, const Point& q )
-                                             {
-                                               if( p.x() == q.x() )
-                                                 return p.y() < q.y();
-                                               else
-                                                 return p.x() < q.x();
-                                             } );
-
-    std::vector<Point> uniquePoints;
-
-    std::unique_copy( points.begin(), points.end(),
-                      std::back_inserter( uniquePoints ) );
-
-    std::vector<unsigned> counts;
-    counts.reserve( uniquePoints.size() );
-
-    for( auto&& point : uniquePoints )
-    {
-      auto count = static_cast<unsigned>( std::count( points.begin(), points.end(), point ) );
-      counts.push_back( count );
-    }
-
-    auto itPoint = uniquePoints.begin();
-    auto itCount = counts.begin();
-
-    for( ; itPoint != uniquePoints.end() && itCount != counts.end(); ++itPoint, ++itCount )
-    {
-      double weight = *itCount / static_cast<double>( points.size() );
-      result       += weight * std::pow( static_cast<double>( itPoint->persistence() ), k );
-    }
-  }
+  for( auto&& point : D )
+    result += std::pow( static_cast<double>( point.persistence() ), k );
+
+  if( weighted && !D.empty() )
+    result /= static_cast<double>( D.size() );
 
   return result;
 }
@@ -97,6 +97,12 @@ public:
     _points.push_back( Point( x, y ) );
   }
 
+  /** Reserves storage for a given number of points */
+  void reserve( std::size_t n )
+  {
+    _points.reserve( n );
+  }
+
   Iterator erase( Iterator position )
   {
     return _points.erase( position );
@@ -0,0 +1,259 @@
+#ifndef ALEPH_PERSISTENCE_DIAGRAMS_STATISTICS_HH__
+#define ALEPH_PERSISTENCE_DIAGRAMS_STATISTICS_HH__
+
+#include <aleph/math/Quantiles.hh>
+
+#include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include <cmath>
+#include <cstddef>
+
+namespace aleph
+{
+
+/**
+  @class PersistenceDiagramStatistics
+  @brief Accumulates statistics of a stream of persistence diagrams
+
+  Calculates the total persistence, the \f$p\f$-norm, the infinity norm,
+  the average persistence, the persistent entropy, the Betti number, and
+  quantiles of the persistence values in a single pass over the points
+  of every diagram that is added. Diagrams do not need to be kept after
+  they have been added, and accumulators for different diagrams can be
+  merged, so statistics over arbitrarily many diagrams can be computed
+  in parallel.
+
+  The statistics refer to *all* points that have been added so far. For
+  a single diagram, they coincide with the ones calculated by the usual
+  functions, e.g. totalPersistence() and infinityNorm(). Like these, the
+  total persistence, the \f$p\f$-norm, and the average use the signed
+  persistence values, while all other statistics use their absolute
+  values. The quantiles are approximated with a bounded relative error
+  (see math::QuantileSketch).
+*/
+
+template <class T> class PersistenceDiagramStatistics
+{
+public:
+
+  /**
+    Creates a new accumulator
+
+    @param p        Power for the total persistence and the \f$p\f$-norm
+    @param accuracy Relative accuracy of the quantiles
+  */
+
+  explicit PersistenceDiagramStatistics( double p = 2.0, double accuracy = 0.01 )
+    : _p( p ),
+      _sketch( accuracy )
+  {
+    if( p == 0.0 )
+      throw std::runtime_error( "Power must be non-zero" );
+  }
+
+  /** Adds all points of a persistence diagram to the statistics */
+  void operator()( const PersistenceDiagram<T>& D )
+  {
+    // The persistence values are extracted first, so that the loop for
+    // the statistics below only operates on a contiguous array.
+    _values.resize( D.size() );
+
+    double sum = 0.0;
+    std::size_t i = 0;
+
+    for( auto&& point : D )
+    {
+      auto persistence = static_cast<double>( point.persistence() );
+
+      sum          += persistence;
+      _values[i++]  = persistence;
+      _betti       += point.isUnpaired();
+    }
+
+    double sumPower   = 0.0;
+    double sumAbs     = 0.0;
+    double sumEntropy = 0.0;
+    double max        = _max;
+
+    // Common powers do not require calling std::pow().
+    if( _p == 1.0 )
+    {
+      for( auto&& x : _values )
+        sumPower += x;
+    }
+    else if( _p == 2.0 )
+    {
+      for( auto&& x : _values )
+        sumPower += x * x;
+    }
+    else
+    {
+      for( auto&& x : _values )
+        sumPower += std::pow( x, _p );
+    }
+
+    for( auto&& x : _values )
+    {
+      x           = std::abs( x );
+      sumAbs     += x;
+      sumEntropy += x > 0.0 ? x * std::log2( x ) : 0.0;
+      max         = std::max( max, x );
+    }
+
+    for( auto&& x : _values )
+      _sketch.add( static_cast<T>( x ) );
+
+    _numDiagrams += 1;
+    _numPoints   += D.size();
+    _sum         += sum;
+    _sumPower    += sumPower;
+    _sumAbs      += sumAbs;
+    _sumEntropy  += sumEntropy;
+    _max          = max;
+  }
+
+  /**
+    Merges the statistics of another accumulator into the current one.
+    Both accumulators must use the same power.
+  */
+
+  void merge( const PersistenceDiagramStatistics& other )
+  {
+    if( other._p != _p )
+      throw std::runtime_error( "Statistics with different powers cannot be merged" );
+
+    _numDiagrams += other._numDiagrams;
+    _numPoints   += other._numPoints;
+    _betti       += other._betti;
+    _sum         += other._sum;
+    _sumPower    += other._sumPower;
+    _sumAbs      += other._sumAbs;
+    _sumEntropy  += other._sumEntropy;
+    _max          = std::max( _max, other._max );
+
+    _sketch.merge( other._sketch );
+  }
+
+  /** @returns Power for the total persistence and the \f$p\f$-norm */
+  double power() const noexcept
+  {
+    return _p;
+  }
+
+  /** @returns Number of diagrams */
+  std::size_t numDiagrams() const noexcept
+  {
+    return _numDiagrams;
+  }
+
+  /** @returns Number of points */
+  std::size_t numPoints() const noexcept
+  {
+    return _numPoints;
+  }
+
+  /** @returns Number of unpaired points */
+  std::size_t betti() const noexcept
+  {
+    return _betti;
+  }
+
+  /** @returns Sum of all signed persistence values, raised to the \f$p\f$-th power */
+  double totalPersistence() const noexcept
+  {
+    return _sumPower;
+  }
+
+  /** @returns \f$p\f$-norm, i.e. the \f$p\f$-th root of the total persistence */
+  double pNorm() const noexcept
+  {
+    return std::pow( this->totalPersistence(), 1.0 / _p );
+  }
+
+  /** @returns Maximum persistence value, or zero if there are no points */
+  double infinityNorm() const noexcept
+  {
+    return _max;
+  }
+
+  /** @returns Average (signed) persistence value */
+  double averagePersistence() const noexcept
+  {
+    return _sum / static_cast<double>( _numPoints );
+  }
+
+  /**
+    Calculates the persistent entropy of all points, i.e. the entropy of
+    the persistence values, normalized by their sum. This is given by
+
+    \f[
+      H = \log_2 S - \frac{1}{S} \sum_i p_i \log_2 p_i
+    \f]
+
+    where \f$S\f$ denotes the sum of all persistence values, so it is
+    sufficient to accumulate two sums. Points without persistence do not
+    contribute to the entropy.
+  */
+
+  double persistentEntropy() const noexcept
+  {
+    double S = _sumAbs;
+
+    if( S == 0.0 )
+      return 0.0;
+
+    return std::log2( S ) - _sumEntropy / S;
+  }
+
+  /** Approximates a quantile of the persistence values (see math::QuantileSketch) */
+  T quantile( double q ) const
+  {
+    return _sketch.quantile( q );
+  }
+
+private:
+
+  /** Power for the total persistence */
+  double _p;
+
+  /** Number of diagrams */
+  std::size_t _numDiagrams = 0;
+
+  /** Number of points */
+  std::size_t _numPoints = 0;
+
+  /** Number of unpaired points */
+  std::size_t _betti = 0;
+
+  // The sums only receive one term per diagram. Kahan summation is not
+  // used because unpaired points would turn its correction into NaN.
+
+  /** Sum of signed persistence values */
+  double _sum = 0.0;
+
+  /** Sum of signed persistence values, raised to the power */
+  double _sumPower = 0.0;
+
+  /** Sum of absolute persistence values */
+  double _sumAbs = 0.0;
+
+  /** Sum of all terms of the form p log p for the persistent entropy */
+  double _sumEntropy = 0.0;
+
+  /** Maximum persistence value */
+  double _max = 0.0;
+
+  /** Sketch for approximating quantiles */
+  math::QuantileSketch<T> _sketch;
+
+  /** Scratch space for the persistence values of a single diagram */
+  std::vector<double> _values;
+};
+
+} // namespace aleph
+
+#endif
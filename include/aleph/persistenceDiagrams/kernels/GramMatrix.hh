@@ -0,0 +1,250 @@
+#ifndef ALEPH_PERSISTENCE_DIAGRAMS_KERNELS_GRAM_MATRIX_HH__
+#define ALEPH_PERSISTENCE_DIAGRAMS_KERNELS_GRAM_MATRIX_HH__
+
+#include <aleph/math/KahanSummation.hh>
+#include <aleph/math/SymmetricMatrix.hh>
+
+#include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
+
+#include <aleph/persistenceDiagrams/kernels/KernelEmbedding.hh>
+#include <aleph/persistenceDiagrams/kernels/MultiScaleKernel.hh>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <cmath>
+#include <cstddef>
+
+namespace aleph
+{
+
+/**
+  @class GramMatrix
+  @brief Gram matrix of a kernel between persistence diagrams
+
+  Stores the kernel values of all pairs of persistence diagrams that
+  have been added. The kernel between two diagrams is the sum over all
+  pairs of their points, where every pair contributes the product of
+  the weights of both points and the kernel value of the points. This
+  includes linearKernel() and, with unit weights, multiScaleKernel().
+
+  Every diagram is processed once when it is added: its points are
+  copied into a single contiguous array, and their weights are stored
+  alongside, so they are not recalculated for every pair of diagrams.
+
+  Since the matrix is symmetric, only the entries on and below its
+  diagonal are calculated and stored, row by row. Adding diagrams thus
+  only appends new rows, and the existing entries remain valid. This
+  makes it possible to extend a matrix with new diagrams, for example
+  when a classifier is trained again, without recalculating it. New
+  entries are calculated in parallel, in blocks of diagrams, so that
+  the points of the diagrams of a block remain in the cache.
+
+  @tparam T      Data type of persistence diagrams
+  @tparam Weight Functor for calculating weights of persistence points
+  @tparam Kernel Functor for calculating kernel values of persistence points
+*/
+
+template
+<
+  class T,
+  class Weight = detail::DefaultWeightFunction,
+  class Kernel = detail::DefaultKernel
+>
+class GramMatrix
+{
+public:
+  using Point = typename PersistenceDiagram<T>::Point;
+
+  GramMatrix( Weight w, Kernel k )
+    : _w( w ),
+      _k( k ),
+      _offsets( 1, 0 )
+  {
+  }
+
+  /** Adds a persistence diagram and calculates its kernel values */
+  void add( const PersistenceDiagram<T>& D )
+  {
+    this->add( &D, &D + 1 );
+  }
+
+  /**
+    Adds a range of persistence diagrams and calculates their kernel
+    values. The values of all new diagrams with respect to each other
+    and to all existing diagrams are calculated in parallel.
+  */
+
+  template <class InputIterator> void add( InputIterator begin, InputIterator end )
+  {
+    auto m     = this->size();
+    auto first = _points.size();
+
+    for( auto it = begin; it != end; ++it )
+    {
+      _points.insert( _points.end(), it->begin(), it->end() );
+      _offsets.push_back( _points.size() );
+    }
+
+    auto n = this->size();
+
+    _weights.resize( _points.size() );
+
+    #pragma omp parallel for
+    for( long i = long( first ); i < long( _points.size() ); i++ )
+      _weights[ std::size_t(i) ] = _w( _points[ std::size_t(i) ] );
+
+    _values.resize( n * ( n + 1 ) / 2 );
+
+    // Only blocks that contain new rows have to be calculated. Every
+    // entry belongs to exactly one block, so blocks are independent.
+    std::vector< std::pair<std::size_t, std::size_t> > blocks;
+
+    for( std::size_t bi = m / blockSize; bi * blockSize < n; bi++ )
+    {
+      for( std::size_t bj = 0; bj <= bi; bj++ )
+        blocks.push_back( std::make_pair( bi, bj ) );
+    }
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for( long b = 0; b < long( blocks.size() ); b++ )
+    {
+      auto bi = blocks[ std::size_t(b) ].first;
+      auto bj = blocks[ std::size_t(b) ].second;
+
+      for( std::size_t i = std::max( bi * blockSize, m ); i < std::min( ( bi + 1 ) * blockSize, n ); i++ )
+      {
+        for( std::size_t j = bj * blockSize; j < std::min( ( bj + 1 ) * blockSize, i + 1 ); j++ )
+          _values[ index( i, j ) ] = this->evaluate( i, j );
+      }
+    }
+  }
+
+  /** @returns Number of persistence diagrams */
+  std::size_t size() const noexcept
+  {
+    return _offsets.size() - 1;
+  }
+
+  /** @returns Kernel value of two persistence diagrams */
+  double operator()( std::size_t i, std::size_t j ) const
+  {
+    if( i >= this->size() || j >= this->size() )
+      throw std::out_of_range( "Index is out of range" );
+
+    if( i < j )
+      std::swap( i, j );
+
+    return _values[ index( i, j ) ];
+  }
+
+  /**
+    Calculates the pseudo-metric that is induced by the kernel for two
+    persistence diagrams (see pseudoMetric()). This only requires the
+    entries of the matrix.
+  */
+
+  double distance( std::size_t i, std::size_t j ) const
+  {
+    auto kxx = this->operator()( i, i );
+    auto kxy = this->operator()( i, j );
+    auto kyy = this->operator()( j, j );
+
+    return std::sqrt( std::max( kxx + kyy - 2*kxy, 0.0 ) );
+  }
+
+  /** @returns Copy of all kernel values as a symmetric matrix */
+  math::SymmetricMatrix<double> matrix() const
+  {
+    auto n = this->size();
+
+    math::SymmetricMatrix<double> M( n );
+
+    for( std::size_t i = 0; i < n; i++ )
+    {
+      for( std::size_t j = 0; j <= i; j++ )
+        M( i, j ) = _values[ index( i, j ) ];
+    }
+
+    return M;
+  }
+
+private:
+
+  /** Number of diagrams in every block of rows and columns */
+  static constexpr std::size_t blockSize = 16;
+
+  /** Position of an entry on or below the diagonal, i.e. for j <= i */
+  static std::size_t index( std::size_t i, std::size_t j ) noexcept
+  {
+    return i * ( i + 1 ) / 2 + j;
+  }
+
+  /** Calculates the kernel value of two persistence diagrams */
+  double evaluate( std::size_t i, std::size_t j ) const
+  {
+    aleph::math::KahanSummation<double> result = 0.0;
+
+    for( std::size_t p = _offsets[i]; p < _offsets[i+1]; p++ )
+    {
+      for( std::size_t q = _offsets[j]; q < _offsets[j+1]; q++ )
+        result += _weights[p] * _weights[q] * _k( _points[p], _points[q] );
+    }
+
+    return result;
+  }
+
+  /** Weight function */
+  Weight _w;
+
+  /** Kernel function */
+  Kernel _k;
+
+  /** Offsets of the points of every diagram */
+  std::vector<std::size_t> _offsets;
+
+  /** Points of all diagrams */
+  std::vector<Point> _points;
+
+  /** Weights of all points */
+  std::vector<double> _weights;
+
+  /** Kernel values on and below the diagonal, stored row by row */
+  std::vector<double> _values;
+};
+
+template <class T, class Weight, class Kernel> constexpr std::size_t GramMatrix<T, Weight, Kernel>::blockSize;
+
+/**
+  Creates a Gram matrix for the linear version of the
+  persistence-weighted Gaussian kernel (see linearKernel()).
+
+  @param sigma Smoothing parameter for subordinate Gaussian kernel
+  @param C     Scaling parameter for `atan`
+  @param p     Power parameter for `atan`
+*/
+
+template <class T> GramMatrix<T> makeLinearGramMatrix( double sigma, double C, double p )
+{
+  return GramMatrix<T>( detail::DefaultWeightFunction( C, p ),
+                        detail::DefaultKernel( sigma ) );
+}
+
+/**
+  Creates a Gram matrix for the multi-scale kernel (see
+  multiScaleKernel()).
+
+  @param sigma Smoothing parameter
+*/
+
+template <class T> GramMatrix<T, detail::UnitWeightFunction, detail::MultiScalePointKernel> makeMultiScaleGramMatrix( double sigma )
+{
+  return GramMatrix<T, detail::UnitWeightFunction, detail::MultiScalePointKernel>( detail::UnitWeightFunction(),
+                                                                                   detail::MultiScalePointKernel( sigma ) );
+}
+
+} // namespace aleph
+
+#endif
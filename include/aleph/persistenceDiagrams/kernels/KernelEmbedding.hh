@@ -9,8 +9,10 @@
 
 #include <algorithm>
 #include <utility>
+#include <vector>
 
 #include <cmath>
+#include <cstddef>
 
 namespace aleph
 {
@@ -86,12 +88,30 @@ double linearKernel( const PersistenceDiagram<T>& D,
                      Weight w,
                      Kernel k )
 {
+  // The weights only depend on a single point, so they are calculated
+  // once instead of for every pair of points.
+  std::vector<double> wD;
+  std::vector<double> wE;
+
+  wD.reserve( D.size() );
+  wE.reserve( E.size() );
+
+  for( auto&& p : D )
+    wD.push_back( w(p) );
+
+  for( auto&& q : E )
+    wE.push_back( w(q) );
+
   aleph::math::KahanSummation<double> result = 0.0;
 
+  std::size_t i = 0;
   for( auto&& p : D )
   {
+    std::size_t j = 0;
     for( auto&& q : E )
-      result += w(p) * w(q) * k(p,q);
+      result += wD[i] * wE[j++] * k(p,q);
+
+    ++i;
   }
 
   return result;
@@ -128,9 +148,9 @@ double pseudoMetric( const PersistenceDiagram<T>& D,
                      Weight w,
                      Kernel k )
 {
-  auto kxx = linearKernel(D, E, w, k);
+  auto kxx = linearKernel(D, D, w, k);
   auto kxy = linearKernel(D, E, w, k);
-  auto kyy = linearKernel(D, E, w, k);
+  auto kyy = linearKernel(E, E, w, k);
 
   return std::sqrt( kxx + kyy - 2*kxy );
 }
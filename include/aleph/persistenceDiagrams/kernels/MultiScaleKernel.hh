@@ -43,6 +43,46 @@ template <class Point> double squaredEuclideanDistance( const Point& p,
   return static_cast<double>( dx*dx + dy*dy );
 }
 
+/**
+  Weight function that assigns the same weight to all points. This
+  is required for evaluating the multi-scale kernel in a Gram matrix.
+*/
+
+class UnitWeightFunction
+{
+public:
+  template <class Point> double operator()( const Point& ) const
+  {
+    return 1.0;
+  }
+};
+
+/**
+  Contribution of a single pair of points to the multi-scale kernel,
+  including its normalization. Summing over all pairs of points of two
+  persistence diagrams yields multiScaleKernel().
+*/
+
+class MultiScalePointKernel
+{
+public:
+  MultiScalePointKernel( double sigma )
+    : _sigma( sigma )
+  {
+  }
+
+  template <class Point> double operator()( const Point& p, const Point& q ) const
+  {
+    auto d1 = squaredEuclideanDistance( p, q );
+    auto d2 = squaredEuclideanDistance( p, q, true );
+
+    return ( std::exp( -d1 / ( 8.0*M_PI ) ) - std::exp( -d2 / ( 8.0*M_PI ) ) ) / ( 8.0*M_PI*_sigma );
+  }
+
+private:
+  double _sigma;
+};
+
 } // namespace detail
 
 /**
@@ -0,0 +1,281 @@
+#ifndef ALEPH_PERSISTENT_HOMOLOGY_APPARENT_PAIRS_HH__
+#define ALEPH_PERSISTENT_HOMOLOGY_APPARENT_PAIRS_HH__
+
+#include <aleph/persistentHomology/PersistencePairing.hh>
+
+#include <aleph/topology/BoundaryMatrix.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <aleph/utilities/Profiler.hh>
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+
+namespace aleph
+{
+
+/**
+  Converts a simplicial complex into a boundary matrix and eliminates all
+  rows and columns whose persistence pairs are known without reducing the
+  matrix. This concerns
+
+  - all pairs of vertices and edges, which are calculated directly by
+    tracking connected components, and
+  - every *apparent pair* \f$(\sigma, \tau)\f$, i.e. \f$\sigma\f$ is the
+    youngest facet of \f$\tau\f$ and \f$\tau\f$ is the oldest cofacet of
+    \f$\sigma\f$.
+
+  The column of \f$\tau\f$ is reduced from the start, so an apparent pair
+  belongs to the persistence pairing. It is eliminated by adding column
+  \f$\tau\f$ to all other columns that contain \f$\sigma\f$, which are
+  younger than \f$\tau\f$. These additions do not change the pairing,
+  but afterwards, the rows and columns of \f$\sigma\f$ and \f$\tau\f$ do
+  not affect the reduction of any other column, so they can be removed.
+  Apparent pairs are eliminated in ascending order of \f$\sigma\f$; the
+  additions only change rows that have been visited already, so every
+  pair remains apparent until it is eliminated.
+
+  In complexes built from noisy data, most pairs of higher dimensions are
+  apparent pairs of low persistence, so the remaining matrix is usually
+  much smaller.
+
+  @param K        Simplicial complex in filtration order
+  @param pairing  Output parameter for the pairs of the removed simplices,
+                  stored as indices into the simplicial complex; creators
+                  of essential classes are stored as unpaired simplices
+  @param indices  Output parameter for the index of every column of the
+                  boundary matrix in the simplicial complex
+
+  @returns Boundary matrix of the remaining simplices, in filtration order.
+  Its columns are not necessarily boundaries of simplices any more, but
+  the matrix may be reduced as usual. Pairs of the matrix need to be
+  translated using the indices.
+*/
+
+template <class Representation, class Simplex> topology::BoundaryMatrix<Representation> eliminateApparentPairs( const topology::SimplicialComplex<Simplex>& K,
+                                                                                                                PersistencePairing<typename Representation::Index>& pairing,
+                                                                                                                std::vector<typename Representation::Index>& indices )
+{
+  using Index = typename Representation::Index;
+
+  ALEPH_PROFILE_ZONE( "eliminateApparentPairs" );
+
+  auto n = K.size();
+
+  // Columns and rows --------------------------------------------------
+  //
+  // Columns are stored individually because they change during the
+  // elimination. Rows only need to contain the original cofacets of
+  // every simplex, stored consecutively in ascending order.
+
+  std::vector< std::vector<std::size_t> > columns( n );
+
+  std::vector<std::size_t> cofacetOffsets( n + 1 );
+  std::vector<std::size_t> cofacets;
+
+  {
+    std::unordered_map<Simplex, std::size_t> simplex_to_index;
+    simplex_to_index.reserve( n );
+
+    std::size_t j = 0;
+
+    for( auto&& simplex : K )
+    {
+      simplex_to_index[simplex] = j;
+
+      auto&& column = columns[j];
+      column.reserve( simplex.size() );
+
+      for( auto itFacet = simplex.begin_boundary(); itFacet != simplex.end_boundary(); ++itFacet )
+      {
+        auto i = simplex_to_index.at( *itFacet );
+
+        column.push_back( i );
+        cofacetOffsets[i+1] += 1;
+      }
+
+      std::sort( column.begin(), column.end() );
+      ++j;
+    }
+  }
+
+  // Since simplices are visited in ascending order, the cofacets of
+  // every simplex are sorted automatically.
+  {
+    std::partial_sum( cofacetOffsets.begin(), cofacetOffsets.end(), cofacetOffsets.begin() );
+
+    auto positions = cofacetOffsets;
+    cofacets.resize( cofacetOffsets.back() );
+
+    for( std::size_t j = 0; j < n; j++ )
+      for( auto&& i : columns[j] )
+        cofacets[ positions[i]++ ] = j;
+  }
+
+  std::vector<bool> removed( n );
+
+  // Connected components --------------------------------------------
+  //
+  // Pairs of vertices and edges are calculated using a union--find data
+  // structure. An edge that merges two components destroys the younger
+  // one, which is the one whose oldest vertex has the larger index. The
+  // oldest vertex of every component creates an essential class. Since
+  // columns of one dimension are only ever added to columns of the same
+  // dimension, all vertices and destroying edges may be removed.
+
+  {
+    std::vector<std::size_t> parent( n );
+    std::iota( parent.begin(), parent.end(), std::size_t(0) );
+
+    auto find = [&parent] ( std::size_t i )
+    {
+      while( parent[i] != i )
+        i = parent[i] = parent[ parent[i] ];
+
+      return i;
+    };
+
+    std::size_t j = 0;
+
+    for( auto&& simplex : K )
+    {
+      if( simplex.dimension() == 0 )
+        removed[j] = true;
+
+      else if( simplex.dimension() == 1 )
+      {
+        auto u = find( columns[j].front() );
+        auto v = find( columns[j].back()  );
+
+        if( u != v )
+        {
+          // Keeping the older vertex as the root ensures that every root
+          // is the oldest vertex of its component.
+          parent[ std::max( u, v ) ] = std::min( u, v );
+          removed[j]                 = true;
+
+          pairing.add( Index( std::max( u, v ) ), Index( j ) );
+        }
+      }
+
+      ++j;
+    }
+
+    j = 0;
+
+    for( auto&& simplex : K )
+    {
+      if( simplex.dimension() == 0 && find( j ) == j )
+        pairing.add( Index( j ) );
+
+      ++j;
+    }
+  }
+
+  // Apparent pairs ----------------------------------------------------
+
+  std::vector<std::size_t> column;
+  std::vector<std::size_t> sum;
+
+  for( std::size_t sigma = 0; sigma < n; sigma++ )
+  {
+    if( removed[sigma] )
+      continue;
+
+    auto first = cofacets.begin() + long( cofacetOffsets[sigma] );
+    auto last  = cofacets.begin() + long( cofacetOffsets[sigma+1] );
+
+    while( first != last && removed[ *first ] )
+      ++first;
+
+    if( first == last )
+      continue;
+
+    auto tau = *first;
+
+    // Alive entries of the column of tau; the largest one is its pivot
+    column.clear();
+
+    for( auto&& i : columns[tau] )
+      if( !removed[i] )
+        column.push_back( i );
+
+    if( column.empty() || column.back() != sigma )
+      continue;
+
+    for( auto it = first + 1; it != last; ++it )
+    {
+      auto rho = *it;
+
+      if( removed[rho] )
+        continue;
+
+      sum.clear();
+
+      std::set_symmetric_difference( columns[rho].begin(), columns[rho].end(),
+                                     column.begin(), column.end(),
+                                     std::back_inserter( sum ) );
+
+      columns[rho].swap( sum );
+    }
+
+    removed[sigma] = true;
+    removed[tau]   = true;
+
+    std::vector<std::size_t>().swap( columns[sigma] );
+    std::vector<std::size_t>().swap( columns[tau] );
+
+    pairing.add( Index( sigma ), Index( tau ) );
+  }
+
+  // Boundary matrix of the remaining simplices ------------------------
+
+  indices.clear();
+
+  std::vector<Index> index_map( n );
+
+  for( std::size_t j = 0; j < n; j++ )
+  {
+    if( !removed[j] )
+    {
+      index_map[j] = Index( indices.size() );
+      indices.push_back( Index( j ) );
+    }
+  }
+
+  topology::BoundaryMatrix<Representation> M;
+  M.setNumColumns( Index( indices.size() ) );
+
+  std::vector<Index> entries;
+
+  for( std::size_t c = 0; c < indices.size(); c++ )
+  {
+    auto j = std::size_t( indices[c] );
+
+    entries.clear();
+
+    for( auto&& i : columns[j] )
+      if( !removed[i] )
+        entries.push_back( index_map[i] );
+
+    M.setColumn( Index( c ), entries.begin(), entries.end() );
+
+    // The dimension cannot be derived from the number of entries any
+    // more, because the columns have been changed.
+    M.setDimension( Index( c ), Index( K.at(j).dimension() ) );
+
+    std::vector<std::size_t>().swap( columns[j] );
+  }
+
+  return M;
+}
+
+} // namespace aleph
+
+#endif
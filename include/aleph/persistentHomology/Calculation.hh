@@ -6,15 +6,31 @@
 #include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
 #include <aleph/persistenceDiagrams/Calculation.hh>
 
+#include <aleph/persistentHomology/ApparentPairs.hh>
 #include <aleph/persistentHomology/PersistencePairing.hh>
+#include <aleph/persistentHomology/Strategy.hh>
+
+#include <aleph/persistentHomology/algorithms/Automatic.hh>
+#include <aleph/persistentHomology/algorithms/Standard.hh>
+#include <aleph/persistentHomology/algorithms/Traits.hh>
+#include <aleph/persistentHomology/algorithms/Twist.hh>
 
 #include <aleph/topology/Conversions.hh>
 #include <aleph/topology/SimplicialComplex.hh>
 
+#include <aleph/topology/representations/External.hh>
+#include <aleph/topology/representations/Vector.hh>
+
+#include <aleph/utilities/Profiler.hh>
+
 #include <algorithm>
 #include <limits>
+#include <stdexcept>
+#include <string>
 #include <tuple>
+#include <type_traits>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace aleph
@@ -27,7 +43,9 @@ namespace aleph
   especially relevant for intersection homology, which sets upper
   limits for the validity of an index in the matrix.
 
-  @param M                          Boundary matrix to reduce
+  @param B                          Boundary matrix to reduce. The matrix is reduced *in place*, so
+                                    no copy is required. Use the overload below for matrices that
+                                    need to be kept.
 
   @param includeAllUnpairedCreators Flag indicating whether all unpaired creators should
                                     be included (regardless of their dimension). If set,
@@ -56,25 +74,32 @@ namespace aleph
 template <
   class ReductionAlgorithm = aleph::defaults::ReductionAlgorithm,
   class Representation = aleph::defaults::Representation
-> PersistencePairing<typename Representation::Index> calculatePersistencePairing( const topology::BoundaryMatrix<Representation>& M,
+> PersistencePairing<typename Representation::Index> calculatePersistencePairing( topology::BoundaryMatrix<Representation>&& B,
                                                                                   bool includeAllUnpairedCreators    = false,
                                                                                   typename Representation::Index max = std::numeric_limits<typename Representation::Index>::max() )
 {
-  using namespace topology;
-
   using Index              = typename Representation::Index;
   using PersistencePairing = PersistencePairing<Index>;
 
-  BoundaryMatrix<Representation> B = M;
+  ALEPH_PROFILE_ZONE( "calculatePersistencePairing" );
 
-  ReductionAlgorithm reductionAlgorithm;
-  reductionAlgorithm( B );
+  {
+    ALEPH_PROFILE_ZONE( "reduction" );
+
+    ReductionAlgorithm reductionAlgorithm;
+    reductionAlgorithm( B );
+
+    ALEPH_PROFILE_MEMORY( "boundaryMatrix", B.memoryUsage() );
+  }
+
+  ALEPH_PROFILE_ZONE( "pairing" );
 
   PersistencePairing pairing;           // resulting pairing
   std::unordered_set<Index> creators;   // keeps track of (potential) creators
   std::unordered_set<Index> destroyers; // keeps track of destroyers
 
   auto numColumns = B.getNumColumns();
+  auto dimension  = B.getDimension();
 
   for( Index j = Index(0); j < numColumns; j++ )
   {
@@ -118,7 +143,7 @@ template <
       // of the boundary matrix. Else, there will be a lot of spurious
       // features that cannot be destroyed due to their dimensions. If
       // the client wants to have them, however, we let them.
-      if(    ( !B.isDualized() && B.getDimension(j) != B.getDimension() )
+      if(    ( !B.isDualized() && B.getDimension(j) != dimension )
           || (  B.isDualized() && B.getDimension(j) != Index(0) )
           || includeAllUnpairedCreators )
       {
@@ -145,6 +170,242 @@ template <
   return pairing;
 }
 
+/**
+  Variant of the function above that reduces a *copy* of the boundary
+  matrix. Parameters are the same as above.
+*/
+
+template <
+  class ReductionAlgorithm = aleph::defaults::ReductionAlgorithm,
+  class Representation = aleph::defaults::Representation
+> PersistencePairing<typename Representation::Index> calculatePersistencePairing( const topology::BoundaryMatrix<Representation>& M,
+                                                                                  bool includeAllUnpairedCreators    = false,
+                                                                                  typename Representation::Index max = std::numeric_limits<typename Representation::Index>::max() )
+{
+  auto B = M;
+  return calculatePersistencePairing<ReductionAlgorithm>( std::move( B ), includeAllUnpairedCreators, max );
+}
+
+namespace detail
+{
+
+/**
+  Calculates persistence diagrams of a simplicial complex using a fixed
+  representation of the boundary matrix. At most one boundary matrix is
+  kept around at any time: the original matrix is released as soon as
+  its dual has been calculated, and the reduction works in place. The
+  columns are stored in the given, empty, representation.
+*/
+
+template <class ReductionAlgorithm, class Representation, class Simplex>
+std::vector< PersistenceDiagram<typename Simplex::DataType> > calculatePersistenceDiagrams( const topology::SimplicialComplex<Simplex>& K,
+                                                                                             bool dualize,
+                                                                                             bool includeAllUnpairedCreators,
+                                                                                             Representation representation = Representation() )
+{
+  auto boundaryMatrix = topology::makeBoundaryMatrix( K, topology::BoundaryMatrix<Representation>( std::move( representation ) ) );
+
+  if( dualize )
+    boundaryMatrix = boundaryMatrix.dualize();
+
+  auto pairing = calculatePersistencePairing<ReductionAlgorithm>( std::move( boundaryMatrix ), includeAllUnpairedCreators );
+  return makePersistenceDiagrams( pairing, K );
+}
+
+/**
+  Estimates the peak number of bytes required for calculating persistence
+  diagrams of a simplicial complex with a given strategy, including the
+  complex itself. This is the maximum of the memory used during the
+  conversion into a boundary matrix, which requires an index map of all
+  simplices, and the memory used during dualization, which requires two
+  matrices as well as their temporary storage. The elimination of apparent
+  pairs requires the columns and rows of the complete matrix in addition
+  to the index map and the remaining matrix. Additional arguments are
+  passed on to the estimate of the representation.
+*/
+
+template <class Representation, class Simplex, class... Arguments> std::size_t estimateMemoryUsage( const topology::SimplicialComplex<Simplex>& K, const Strategy& strategy, Arguments... arguments )
+{
+  using Index      = typename Representation::Index;
+  using VertexType = typename Simplex::VertexType;
+
+  std::size_t numColumns  = K.size();
+  std::size_t numEntries  = 0;
+  std::size_t numVertices = 0;
+
+  for( auto&& simplex : K )
+  {
+    if( simplex.dimension() != 0 )
+      numEntries += simplex.size();
+
+    numVertices += simplex.size();
+  }
+
+  auto matrix   = topology::BoundaryMatrix<Representation>::estimateMemoryUsage( numColumns, numEntries, arguments... );
+  auto indexMap = numColumns  * ( sizeof( Simplex ) + sizeof( Index ) + 3 * sizeof( void* ) )
+                + numVertices * sizeof( VertexType );
+
+  auto peak     = indexMap + matrix;
+
+  // Pairs and indices of the eliminated columns, which are kept until
+  // the diagrams have been created
+  std::size_t pairs = 0;
+
+  if( strategy.eliminateApparentPairs )
+  {
+    auto elimination = numColumns * ( sizeof( std::vector<std::size_t> ) + 2 * sizeof( std::size_t ) )
+                     + numEntries * 2 * sizeof( std::size_t );
+
+    pairs            = numColumns * ( sizeof( std::pair<Index, Index> ) + sizeof( Index ) );
+    peak             = pairs + elimination + std::max( indexMap, matrix );
+  }
+
+  if( strategy.dualize )
+  {
+    auto dualMatrix = numColumns * sizeof( std::vector<Index> ) + numEntries * sizeof( Index );
+    peak            = std::max( peak, pairs + 2 * matrix + dualMatrix );
+  }
+
+  return K.memoryUsage() + peak;
+}
+
+/**
+  Estimates the peak number of bytes required for calculating persistence
+  diagrams of a simplicial complex without eliminating apparent pairs.
+*/
+
+template <class Representation, class Simplex, class... Arguments> std::size_t estimateMemoryUsage( const topology::SimplicialComplex<Simplex>& K, bool dualize, Arguments... arguments )
+{
+  Strategy strategy;
+  strategy.eliminateApparentPairs = false;
+  strategy.dualize                = dualize;
+
+  return estimateMemoryUsage<Representation>( K, strategy, arguments... );
+}
+
+/**
+  Calculates persistence diagrams of a simplicial complex whose points
+  have a persistence of at least a given threshold. Pairs that are known
+  beforehand are eliminated from the boundary matrix, so only the rest
+  of the matrix has to be reduced. The pairs of all remaining points are
+  exact.
+*/
+
+template <class ReductionAlgorithm, class Representation, class Simplex>
+std::vector< PersistenceDiagram<typename Simplex::DataType> > calculatePersistenceDiagrams( const topology::SimplicialComplex<Simplex>& K,
+                                                                                             bool dualize,
+                                                                                             bool includeAllUnpairedCreators,
+                                                                                             typename Simplex::DataType threshold )
+{
+  using Index = typename Representation::Index;
+
+  PersistencePairing<Index> eliminated;
+  std::vector<Index> indices;
+
+  auto boundaryMatrix = eliminateApparentPairs<Representation>( K, eliminated, indices );
+
+  ALEPH_PROFILE_MEMORY( "boundaryMatrix", boundaryMatrix.memoryUsage() );
+
+  if( dualize )
+    boundaryMatrix = boundaryMatrix.dualize();
+
+  auto remaining = calculatePersistencePairing<ReductionAlgorithm>( std::move( boundaryMatrix ), true );
+
+  // Unpaired creators of the highest dimension are only kept if the
+  // client requested them; see calculatePersistencePairing().
+  auto topDimension = K.dimension();
+
+  PersistencePairing<Index> pairing;
+
+  auto addPair = [&] ( Index i, Index j )
+  {
+    auto&& s = K.at(i);
+
+    if( j < K.size() )
+    {
+      auto&& t = K.at(j);
+
+      if( !( t.data() - s.data() < threshold ) )
+        pairing.add( i, j );
+    }
+    else if( includeAllUnpairedCreators || s.dimension() != topDimension )
+      pairing.add( i );
+  };
+
+  for( auto&& pair : eliminated )
+    addPair( pair.first, pair.second );
+
+  for( auto&& pair : remaining )
+    addPair( indices[ pair.first ], pair.second < indices.size() ? indices[ pair.second ] : pair.second );
+
+  std::sort( pairing.begin(), pairing.end() );
+  return makePersistenceDiagrams( pairing, K );
+}
+
+/**
+  Calculates persistence diagrams of a simplicial complex with a given
+  strategy and a given reduction algorithm. If apparent pairs are
+  eliminated, only points whose persistence is at least the threshold
+  are reported. Otherwise, the columns are stored in the given, empty,
+  representation.
+*/
+
+template <class ReductionAlgorithm, class Representation, class Simplex>
+std::vector< PersistenceDiagram<typename Simplex::DataType> > reduceWithStrategy( ReductionAlgorithm,
+                                                                                   const topology::SimplicialComplex<Simplex>& K,
+                                                                                   const Strategy& strategy,
+                                                                                   bool includeAllUnpairedCreators,
+                                                                                   typename Simplex::DataType threshold,
+                                                                                   Representation representation )
+{
+  if( strategy.eliminateApparentPairs )
+    return calculatePersistenceDiagrams<ReductionAlgorithm, Representation>( K, strategy.dualize, includeAllUnpairedCreators, threshold );
+  else
+    return calculatePersistenceDiagrams<ReductionAlgorithm>( K, strategy.dualize, includeAllUnpairedCreators, std::move( representation ) );
+}
+
+/**
+  Variant of the function above for the automatic selection of the
+  reduction algorithm, which uses the algorithm of the strategy (see
+  selectAlgorithm()).
+*/
+
+template <class Representation, class Simplex>
+std::vector< PersistenceDiagram<typename Simplex::DataType> > reduceWithStrategy( persistentHomology::algorithms::Automatic,
+                                                                                   const topology::SimplicialComplex<Simplex>& K,
+                                                                                   const Strategy& strategy,
+                                                                                   bool includeAllUnpairedCreators,
+                                                                                   typename Simplex::DataType threshold,
+                                                                                   Representation representation )
+{
+  using namespace persistentHomology::algorithms;
+
+  if( strategy.algorithm == Traits<Standard>::name() )
+    return reduceWithStrategy( Standard(), K, strategy, includeAllUnpairedCreators, threshold, std::move( representation ) );
+  else
+    return reduceWithStrategy( Twist(), K, strategy, includeAllUnpairedCreators, threshold, std::move( representation ) );
+}
+
+/**
+  Calculates persistence diagrams of a simplicial complex with a given
+  strategy and reports the strategy as an annotation of the profiler.
+  See reduceWithStrategy() for the parameters.
+*/
+
+template <class ReductionAlgorithm, class Representation, class Simplex>
+std::vector< PersistenceDiagram<typename Simplex::DataType> > calculatePersistenceDiagrams( const topology::SimplicialComplex<Simplex>& K,
+                                                                                             const Strategy& strategy,
+                                                                                             bool includeAllUnpairedCreators,
+                                                                                             typename Simplex::DataType threshold,
+                                                                                             Representation representation = Representation() )
+{
+  ALEPH_PROFILE_ANNOTATION( "strategy", strategy.description() );
+
+  return reduceWithStrategy( ReductionAlgorithm(), K, strategy, includeAllUnpairedCreators, threshold, std::move( representation ) );
+}
+
+} // namespace detail
+
 /**
   Calculates a set of persistence diagrams from a simplicial complex in
   filtration order, while permitting some additional parameters. Notice
@@ -152,14 +413,41 @@ template <
   automatically.
 
   @param K                          Simplicial complex
-  @param dualize                    Indicates that boundary matrix dualization is desired
+  @param dualize                    Indicates that boundary matrix dualization is desired. This flag
+                                    is ignored by the Automatic reduction algorithm, which decides for
+                                    itself.
   @param includeAllUnpairedCreators Indicates that *all* unpaired creators detected during a single pass
                                     of the simplicial complex should be included. This is useful when it
                                     is clear that the simplicial complex models a topological object for
                                     which top-level simplices are meaningful. For Vietoris--Rips complex
                                     calculations, this is usually *not* the case.
-
-  @tparam ReductionAlgorithm Algorithm for reducing the boundary matrix
+  @param memoryBudget               Optional budget, measured in bytes, for the calculation. If set, the
+                                    memory usage of the calculation, including the simplicial complex, is
+                                    estimated beforehand. Should the estimate exceed the budget, leaner
+                                    strategies are used, i.e. skipping the dualization and, if this does
+                                    not suffice, switching to a compact representation of the matrix,
+                                    provided that it is smaller than the requested representation. As
+                                    a last resort, the matrix is stored on disk, using the remainder of
+                                    the budget as a cache of columns (see representations::External).
+                                    If not even the columns' metadata fit into the budget, an exception
+                                    is thrown. The same policy applies if a persistence threshold is set,
+                                    except that the matrix cannot be stored on disk then, because apparent
+                                    pairs are eliminated in memory. The budget is not used by default.
+  @param persistenceThreshold       Optional threshold for the persistence of features. If set, points
+                                    whose persistence is less than the threshold are not reported, while
+                                    all other points remain exact. Prior to the reduction, all pairs that
+                                    are known beforehand are removed from the boundary matrix (see
+                                    eliminateApparentPairs()), which often removes most of the reduction
+                                    work for noisy data. The threshold is not used by default.
+
+  @tparam ReductionAlgorithm Algorithm for reducing the boundary matrix. If set to Automatic,
+                             the strategy of the calculation, i.e. whether to dualize, whether to
+                             eliminate apparent pairs, and which algorithm to use for the reduction,
+                             is selected based on statistics of the simplicial complex (see
+                             selectStrategy()), and the statistics are reported as annotations of
+                             the profiler. The strategy that is being used, including the name of
+                             the reduction algorithm, is reported as an annotation for every
+                             reduction algorithm. It may differ because of the memory budget.
   @tparam Representation     Representation of the boundary matrix
   @tparam Simplex            Simplex data type (usually inferred from the other parameters)
 */
@@ -168,14 +456,106 @@ template <
   class ReductionAlgorithm = defaults::ReductionAlgorithm,
   class Representation     = defaults::Representation,
   class Simplex
-> std::vector< PersistenceDiagram<typename Simplex::DataType> > calculatePersistenceDiagrams( const topology::SimplicialComplex<Simplex>& K, bool dualize = true, bool includeAllUnpairedCreators = false )
+> std::vector< PersistenceDiagram<typename Simplex::DataType> > calculatePersistenceDiagrams( const topology::SimplicialComplex<Simplex>& K,
+                                                                                             bool dualize                                    = true,
+                                                                                             bool includeAllUnpairedCreators                 = false,
+                                                                                             std::size_t memoryBudget                        = 0,
+                                                                                             typename Simplex::DataType persistenceThreshold = typename Simplex::DataType() )
 {
-  using namespace topology;
+  using DataType               = typename Simplex::DataType;
+  using Index                  = typename Representation::Index;
+  using CompactRepresentation  = topology::representations::Vector<Index>;
+  using ExternalRepresentation = topology::representations::External<Index>;
+
+  ALEPH_PROFILE_ZONE( "calculatePersistenceDiagrams" );
+  ALEPH_PROFILE_MEMORY( "simplicialComplex", K.memoryUsage() );
+
+  // A threshold always requires the elimination of apparent pairs
+  bool hasThreshold = DataType() < persistenceThreshold;
+  bool automatic    = std::is_same<ReductionAlgorithm, persistentHomology::algorithms::Automatic>::value;
+
+  Strategy strategy;
+  strategy.eliminateApparentPairs = hasThreshold;
+  strategy.dualize                = dualize;
+  strategy.algorithm              = persistentHomology::algorithms::Traits<ReductionAlgorithm>::name();
+
+  // The automatic selection of the reduction algorithm depends on the
+  // other parts of the strategy, so it has to follow all their changes.
+  auto updateAlgorithm = [&strategy, automatic] ()
+  {
+    if( automatic )
+      strategy.algorithm = selectAlgorithm( strategy );
+  };
 
-  auto boundaryMatrix = makeBoundaryMatrix<Representation>( K );
-  auto pairing        = calculatePersistencePairing<ReductionAlgorithm>( dualize ? boundaryMatrix.dualize() : boundaryMatrix, includeAllUnpairedCreators );
+  if( automatic )
+  {
+    auto statistics = collectStatistics( K );
+    strategy        = selectStrategy( statistics );
 
-  return makePersistenceDiagrams( pairing, K );
+    if( hasThreshold )
+      strategy.eliminateApparentPairs = true;
+
+    updateAlgorithm();
+
+    ALEPH_PROFILE_ANNOTATION( "dimensionProfile",    statistics.profile() );
+    ALEPH_PROFILE_ANNOTATION( "averageColumnLength", std::to_string( statistics.averageColumnLength() ) );
+  }
+
+  if( memoryBudget == 0 )
+    return detail::calculatePersistenceDiagrams<ReductionAlgorithm, Representation>( K, strategy, includeAllUnpairedCreators, persistenceThreshold );
+
+  // The same estimate and the same sequence of leaner strategies is used
+  // regardless of the strategy that was requested. If a strategy fits
+  // into the budget, it is used for the calculation.
+
+  auto estimate = detail::estimateMemoryUsage<Representation>( K, strategy );
+  if( estimate <= memoryBudget )
+    return detail::calculatePersistenceDiagrams<ReductionAlgorithm, Representation>( K, strategy, includeAllUnpairedCreators, persistenceThreshold );
+
+  // Skip the dualization: this removes the need for storing a second
+  // matrix, at the expense of a potentially slower reduction.
+  if( strategy.dualize )
+  {
+    strategy.dualize = false;
+    updateAlgorithm();
+
+    estimate = detail::estimateMemoryUsage<Representation>( K, strategy );
+    if( estimate <= memoryBudget )
+      return detail::calculatePersistenceDiagrams<ReductionAlgorithm, Representation>( K, strategy, includeAllUnpairedCreators, persistenceThreshold );
+  }
+
+  // Switch to the most compact representation that is kept in memory.
+  // This only helps if it is smaller than the current representation,
+  // which is not the case for the default representation.
+  {
+    auto compactEstimate = detail::estimateMemoryUsage<CompactRepresentation>( K, strategy );
+    if( compactEstimate < estimate )
+    {
+      estimate = compactEstimate;
+      if( estimate <= memoryBudget )
+        return detail::calculatePersistenceDiagrams<ReductionAlgorithm, CompactRepresentation>( K, strategy, includeAllUnpairedCreators, persistenceThreshold );
+    }
+  }
+
+  // Store the matrix on disk and use the remainder of the budget as
+  // a cache. This is slower, but only the metadata of every column is
+  // required to fit into memory. The elimination of apparent pairs needs
+  // the complete matrix in memory, so this is only possible without a
+  // threshold.
+  if( !hasThreshold )
+  {
+    strategy.eliminateApparentPairs = false;
+    updateAlgorithm();
+
+    auto fixedCosts = detail::estimateMemoryUsage<ExternalRepresentation>( K, strategy, std::size_t(0) );
+
+    if( fixedCosts < memoryBudget )
+      return detail::calculatePersistenceDiagrams<ReductionAlgorithm>( K, strategy, includeAllUnpairedCreators, persistenceThreshold, ExternalRepresentation( memoryBudget - fixedCosts ) );
+
+    estimate = std::min( estimate, fixedCosts );
+  }
+
+  throw std::runtime_error( "Estimated memory usage of " + std::to_string( estimate ) + " bytes exceeds memory budget of " + std::to_string( memoryBudget ) + " bytes" );
 }
 
 /**
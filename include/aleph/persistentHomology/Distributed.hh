@@ -0,0 +1,442 @@
+#ifndef ALEPH_PERSISTENT_HOMOLOGY_DISTRIBUTED_HH__
+#define ALEPH_PERSISTENT_HOMOLOGY_DISTRIBUTED_HH__
+
+#include <aleph/config/Defaults.hh>
+
+#include <aleph/persistentHomology/PersistencePairing.hh>
+
+#include <aleph/topology/BoundaryMatrix.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <aleph/utilities/Profiler.hh>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+
+namespace aleph
+{
+
+/**
+  Determines the range of columns of a boundary matrix that is assigned
+  to a process in a distributed calculation. Columns are distributed in
+  contiguous ranges of (almost) equal size.
+
+  @param numColumns   Number of columns of the complete matrix
+  @param rank         Rank of the process
+  @param numProcesses Number of processes
+
+  @returns Half-open range of the columns of the process
+*/
+
+template <class Index> std::pair<Index, Index> columnRange( Index numColumns, unsigned rank, unsigned numProcesses )
+{
+  auto n     = static_cast<std::uint64_t>( numColumns );
+  auto begin = n * rank       / numProcesses;
+  auto end   = n * (rank + 1) / numProcesses;
+
+  return std::make_pair( static_cast<Index>( begin ), static_cast<Index>( end ) );
+}
+
+/**
+  Converts a range of simplices of a simplicial complex into the columns
+  of a boundary matrix. The rows of the matrix are indexed with respect
+  to the complete complex, so the matrix is the block of columns that a
+  single process requires for a distributed calculation.
+
+  @param K     Simplicial complex in filtration order
+  @param begin Index of the first simplex
+  @param end   Index after the last simplex
+*/
+
+template <
+  class Representation = aleph::defaults::Representation,
+  class Simplex
+> topology::BoundaryMatrix<Representation> makeLocalBoundaryMatrix( const topology::SimplicialComplex<Simplex>& K,
+                                                                   typename Representation::Index begin,
+                                                                   typename Representation::Index end )
+{
+  using Index = typename Representation::Index;
+
+  ALEPH_PROFILE_ZONE( "makeBoundaryMatrix" );
+
+  topology::BoundaryMatrix<Representation> M;
+  M.setNumColumns( end - begin );
+
+  // Faces always precede their cofaces in a filtration, so only the
+  // simplices up to the end of the range have to be indexed.
+  std::unordered_map<Simplex, Index> simplex_to_index;
+  simplex_to_index.reserve( static_cast<std::size_t>( end ) );
+
+  Index i = Index(0);
+
+  for( auto it = K.begin(); i < end; ++it, ++i )
+  {
+    simplex_to_index[*it] = i;
+
+    if( i < begin )
+      continue;
+
+    std::vector<Index> column;
+    column.reserve( it->size() );
+
+    for( auto itFacet = it->begin_boundary(); itFacet != it->end_boundary(); ++itFacet )
+      column.push_back( simplex_to_index.at( *itFacet ) );
+
+    M.setColumn( i - begin, column.begin(), column.end() );
+  }
+
+  return M;
+}
+
+namespace detail
+{
+
+using Message = std::vector<std::uint64_t>;
+
+/**
+  Sends a message to every process of a higher rank and receives one
+  from every process of a lower rank. Messages are received in order
+  of ascending rank before any message is sent, so the exchange cannot
+  deadlock, even if a transport blocks until the receiver is ready.
+
+  @returns Messages indexed by the rank of their sender
+*/
+
+template <class Transport> std::vector<Message> exchangeUpwards( Transport& transport, const std::vector<Message>& messages )
+{
+  auto rank = transport.rank();
+  auto size = transport.size();
+
+  std::vector<Message> received( size );
+
+  for( unsigned r = 0; r < rank; r++ )
+    received[r] = transport.receive( r );
+
+  for( unsigned r = rank + 1; r < size; r++ )
+    transport.send( r, messages.at(r) );
+
+  return received;
+}
+
+/** Variant of exchangeUpwards() for sending messages to lower ranks */
+template <class Transport> std::vector<Message> exchangeDownwards( Transport& transport, const std::vector<Message>& messages )
+{
+  auto rank = transport.rank();
+  auto size = transport.size();
+
+  std::vector<Message> received( size );
+
+  for( unsigned r = size; r > rank + 1; r-- )
+    received[r-1] = transport.receive( r-1 );
+
+  for( unsigned r = rank; r > 0; r-- )
+    transport.send( r-1, messages.at(r-1) );
+
+  return received;
+}
+
+/** Calculates the maximum of a value over all processes */
+template <class Transport> std::uint64_t allReduceMaximum( Transport& transport, std::uint64_t value )
+{
+  std::vector<Message> messages( transport.size(), Message( 1, value ) );
+
+  auto lower  = exchangeUpwards( transport, messages );
+  auto higher = exchangeDownwards( transport, messages );
+
+  for( unsigned r = 0; r < transport.size(); r++ )
+  {
+    for( auto&& message : { &lower[r], &higher[r] } )
+      if( !message->empty() )
+        value = std::max( value, message->front() );
+  }
+
+  return value;
+}
+
+} // namespace detail
+
+/**
+  Calculates the persistence pairing of a boundary matrix whose columns
+  are distributed over multiple processes. Every process owns a block of
+  contiguous columns, as determined by columnRange(), and communicates
+  with the other processes via a transport, such as UnixSocketTransport.
+  The function has to be called by all processes.
+
+  The reduction follows the spectral sequence algorithm of DIPHA. Rows
+  are partitioned in the same way as columns, which splits the matrix
+  into blocks. In the \f$k\f$th round, process \f$s\f$ reduces its
+  columns with respect to the rows of process \f$s-k\f$. Pivots in
+  these rows are either caused by columns of the process itself, or by
+  columns of processes \f$t < s\f$ that have been finalised in earlier
+  rounds and were sent to all processes of higher rank. After \f$p\f$
+  rounds for \f$p\f$ processes, all columns are reduced. Dimensions are
+  processed in descending order, and pivots are used to clear columns
+  of the next-lower dimension, exactly as in the Twist algorithm.
+
+  Since all column additions go from left to right, the pairing is the
+  same as the one of any other reduction algorithm.
+
+  @param transport                  Transport for communicating with other processes
+  @param B                          Columns of the current process; rows are indexed
+                                    with respect to the complete matrix, which must
+                                    not be dualized
+  @param numColumns                 Number of columns of the complete matrix
+  @param includeAllUnpairedCreators Flag indicating whether all unpaired creators
+                                    should be included; see calculatePersistencePairing()
+
+  @returns Complete persistence pairing for the process of rank 0, and an
+  empty pairing for all other processes
+*/
+
+template <class Representation, class Transport> PersistencePairing<typename Representation::Index> calculatePersistencePairingDistributed( Transport& transport,
+                                                                                                                                            topology::BoundaryMatrix<Representation>&& B,
+                                                                                                                                            typename Representation::Index numColumns,
+                                                                                                                                            bool includeAllUnpairedCreators = false )
+{
+  using Index   = typename Representation::Index;
+  using Message = detail::Message;
+
+  ALEPH_PROFILE_ZONE( "calculatePersistencePairingDistributed" );
+
+  auto rank = transport.rank();
+  auto size = transport.size();
+
+  Index begin, end;
+  std::tie( begin, end ) = columnRange( numColumns, rank, size );
+
+  if( B.getNumColumns() != end - begin )
+    throw std::runtime_error( "Number of columns does not match the range of the process" );
+
+  std::vector<Index> ranges( size + 1 );
+  for( unsigned r = 0; r <= size; r++ )
+    ranges[r] = columnRange( numColumns, r, size ).first;
+
+  ranges[size] = numColumns;
+
+  auto owner = [&ranges] ( Index i )
+  {
+    return static_cast<unsigned>( std::upper_bound( ranges.begin(), ranges.end(), i ) - ranges.begin() - 1 );
+  };
+
+  auto dimension = static_cast<Index>( detail::allReduceMaximum( transport, static_cast<std::uint64_t>( B.getDimension() ) ) );
+
+  // Pivot columns of other processes, indexed by the rank that owns the
+  // row of their pivot and by the pivot itself
+  std::vector< std::unordered_map< Index, std::vector<Index> > > remoteColumns( size );
+
+  std::vector<Index> column;
+
+  for( Index d = dimension; d >= 1; d-- )
+  {
+    ALEPH_PROFILE_ZONE( "dimension" );
+
+    // Rows of pivots that have been found in this dimension, indexed by
+    // the rank that owns the row; these columns can be cleared.
+    std::vector<Message> clearedRows( size );
+
+    for( unsigned k = 0; k < size; k++ )
+    {
+      std::vector<Message> messages( size );
+
+      if( rank >= k )
+      {
+        auto block    = rank - k;
+        auto rowBegin = ranges[block];
+        auto rowEnd   = ranges[block+1];
+
+        auto&& remote = remoteColumns[block];
+
+        // Pivot columns of the current process for this block of rows
+        std::unordered_map<Index, Index> lut;
+
+        Message pivotColumns;
+        Index numPivotColumns = Index(0);
+
+        for( Index j = Index(0); j < B.getNumColumns(); j++ )
+        {
+          if( B.getDimension( j ) != d )
+            continue;
+
+          Index i;
+          bool valid = false;
+
+          std::tie( i, valid ) = B.getMaximumIndex( j );
+
+          while( valid && rowBegin <= i && i < rowEnd )
+          {
+            auto itLocal = lut.find( i );
+
+            if( itLocal != lut.end() )
+              B.addColumns( itLocal->second, j );
+            else
+            {
+              auto itRemote = remote.find( i );
+              if( itRemote == remote.end() )
+                break;
+
+              auto&& source = itRemote->second;
+              auto target   = B.getColumn( j );
+
+              column.clear();
+
+              std::set_symmetric_difference( source.begin(), source.end(),
+                                             target.begin(), target.end(),
+                                             std::back_inserter( column ) );
+
+              B.setColumn( j, column.begin(), column.end() );
+              B.setDimension( j, d );
+            }
+
+            std::tie( i, valid ) = B.getMaximumIndex( j );
+          }
+
+          if( valid && rowBegin <= i && i < rowEnd )
+          {
+            lut[i] = j;
+
+            // The pivot of the column is final, so the column may be
+            // used by processes of higher rank.
+            auto entries = B.getColumn( j );
+
+            pivotColumns.push_back( static_cast<std::uint64_t>( i ) );
+            pivotColumns.push_back( static_cast<std::uint64_t>( entries.size() ) );
+
+            for( auto&& entry : entries )
+              pivotColumns.push_back( static_cast<std::uint64_t>( entry ) );
+
+            ++numPivotColumns;
+
+            if( owner( i ) == rank )
+              B.clearColumn( i - begin );
+            else
+              clearedRows[ owner( i ) ].push_back( static_cast<std::uint64_t>( i ) );
+          }
+        }
+
+        // Remote columns of this block of rows are not required any more
+        // because subsequent rounds only use rows of lower ranks.
+        remote.clear();
+
+        pivotColumns.insert( pivotColumns.begin(), static_cast<std::uint64_t>( numPivotColumns ) );
+
+        for( unsigned r = rank + 1; r < size; r++ )
+          messages[r] = pivotColumns;
+      }
+
+      auto received = detail::exchangeUpwards( transport, messages );
+
+      // Every message contains pivot columns for the block of rows that
+      // its sender has reduced in this round.
+      for( unsigned r = 0; r < rank; r++ )
+      {
+        auto&& message = received[r];
+
+        if( message.empty() || r < k )
+          continue;
+
+        auto&& remote = remoteColumns[r-k];
+        auto it       = message.begin() + 1;
+
+        for( std::uint64_t c = 0; c < message.front(); c++ )
+        {
+          auto pivot = static_cast<Index>( *it++ );
+          auto n     = static_cast<std::ptrdiff_t>( *it++ );
+
+          auto&& entries = remote[pivot];
+
+          entries.reserve( static_cast<std::size_t>( n ) );
+
+          for( auto last = it + n; it != last; ++it )
+            entries.push_back( static_cast<Index>( *it ) );
+        }
+      }
+    }
+
+    // Pivots always lie in rows of the same or a lower rank, so columns
+    // of lower ranks are notified about rows to clear.
+    auto received = detail::exchangeDownwards( transport, clearedRows );
+
+    for( auto&& message : received )
+      for( auto&& i : message )
+        B.clearColumn( static_cast<Index>( i ) - begin );
+  }
+
+  // Merge pairing -------------------------------------------------------
+  //
+  // Every process sends its pairs and its potential creators to the
+  // process of rank 0, which assembles the complete pairing.
+
+  Message pairs;
+  Message creators;
+
+  for( Index j = Index(0); j < B.getNumColumns(); j++ )
+  {
+    Index i;
+    bool valid;
+
+    std::tie( i, valid ) = B.getMaximumIndex( j );
+
+    if( valid )
+    {
+      pairs.push_back( static_cast<std::uint64_t>( i ) );
+      pairs.push_back( static_cast<std::uint64_t>( j + begin ) );
+    }
+    else if( B.getDimension( j ) != dimension || includeAllUnpairedCreators )
+      creators.push_back( static_cast<std::uint64_t>( j + begin ) );
+  }
+
+  PersistencePairing<Index> pairing;
+
+  if( rank != 0 )
+  {
+    transport.send( 0, pairs );
+    transport.send( 0, creators );
+
+    return pairing;
+  }
+
+  std::vector<bool> destroyed( static_cast<std::size_t>( numColumns ) );
+
+  for( unsigned r = 0; r < size; r++ )
+  {
+    if( r != 0 )
+    {
+      pairs    = transport.receive( r );
+      creators = transport.receive( r );
+    }
+
+    for( std::size_t l = 0; l + 1 < pairs.size(); l += 2 )
+    {
+      pairing.add( static_cast<Index>( pairs[l] ), static_cast<Index>( pairs[l+1] ) );
+      destroyed[ static_cast<std::size_t>( pairs[l] ) ] = true;
+    }
+
+    for( auto&& creator : creators )
+      pairing.add( static_cast<Index>( creator ) );
+  }
+
+  // Creators whose class is destroyed by a column of another process
+  // are only known to be paired once all pairs have been received.
+  pairing.erase( std::remove_if( pairing.begin(), pairing.end(),
+                                 [&destroyed] ( const std::pair<Index, Index>& pair )
+                                 {
+                                   return pair.second == std::numeric_limits<Index>::max() && destroyed[ static_cast<std::size_t>( pair.first ) ];
+                                 } ),
+                 pairing.end() );
+
+  std::sort( pairing.begin(), pairing.end() );
+  return pairing;
+}
+
+} // namespace aleph
+
+#endif
@@ -0,0 +1,215 @@
+#ifndef ALEPH_PERSISTENT_HOMOLOGY_FUNCTION_HH__
+#define ALEPH_PERSISTENT_HOMOLOGY_FUNCTION_HH__
+
+#include <aleph/config/Defaults.hh>
+
+#include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
+
+#include <aleph/topology/DenseUnionFind.hh>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <cstddef>
+
+namespace aleph
+{
+
+namespace detail
+{
+
+/**
+  Scratch space for calculating the persistence diagram of a 1D function.
+  It can be reused for many functions in order to avoid allocations.
+*/
+
+template <class Index> struct FunctionScratch
+{
+  /** Vertices in filtration order */
+  std::vector<Index> order;
+
+  /** Vertex whose edge destroys the component created by each vertex */
+  std::vector<Index> destroyer;
+
+  /** Connected components of the current sublevel set */
+  topology::DenseUnionFind<Index> uf;
+};
+
+/**
+  Calculates the persistence diagram of the 1D function that is given by
+  \p n contiguous values, using the scratch space provided by the client.
+*/
+
+template <class DataType, class Compare, class Index>
+PersistenceDiagram<DataType> calculateFunctionPersistenceDiagram( const DataType* values, std::size_t n,
+                                                                  Compare compare,
+                                                                  FunctionScratch<Index>& scratch )
+{
+  PersistenceDiagram<DataType> D;
+  D.setDimension( 0 );
+
+  if( n == 0 )
+    return D;
+
+  if( n > std::size_t( std::numeric_limits<Index>::max() ) )
+    throw std::runtime_error( "Function has too many values for the index type" );
+
+  // Vertices with the same value are ordered by their index. This is
+  // consistent with the lexicographical order that is used when sorting
+  // the corresponding simplicial complex.
+  auto precedes = [&values, &compare] ( Index i, Index j )
+  {
+    if( compare( values[i], values[j] ) )
+      return true;
+    else if( compare( values[j], values[i] ) )
+      return false;
+    else
+      return i < j;
+  };
+
+  auto&& order     = scratch.order;
+  auto&& destroyer = scratch.destroyer;
+  auto&& uf        = scratch.uf;
+
+  order.resize( n );
+  std::iota( order.begin(), order.end(), Index(0) );
+  std::sort( order.begin(), order.end(), precedes );
+
+  // Vertices that are not destroyed keep an invalid index, which is the
+  // same convention as for unpaired simplices in a persistence pairing.
+  destroyer.assign( n, Index( n ) );
+  uf.reset( n );
+
+  // Every edge is created together with the later one of its vertices,
+  // and the root of every set is its oldest vertex because the younger
+  // set is always merged into the older one.
+  auto merge = [&] ( Index u, Index v )
+  {
+    auto ru = uf.find( u );
+    auto rv = uf.find( v );
+
+    if( ru == rv )
+      return;
+
+    if( precedes( ru, rv ) )
+      std::swap( ru, rv );
+
+    destroyer[ru] = u;
+    uf.merge( ru, rv );
+  };
+
+  for( auto&& u : order )
+  {
+    if( u > 0 && precedes( u - 1, u ) )
+      merge( u, u - 1 );
+
+    if( u + 1 < n && precedes( u + 1, u ) )
+      merge( u, u + 1 );
+  }
+
+  // Points are reported in the order of their creators, just like for
+  // a reduced boundary matrix.
+  for( auto&& u : order )
+  {
+    if( destroyer[u] < n )
+      D.add( values[u], values[ destroyer[u] ] );
+    else
+      D.add( values[u] );
+  }
+
+  return D;
+}
+
+} // namespace detail
+
+/**
+  Calculates the zero-dimensional persistence diagram of a 1D function,
+  i.e. of a path graph whose vertices carry the function values. Edges
+  are assigned the value of the later one of their vertices, so for the
+  default comparison functor, this is the sublevel set filtration, and
+  using std::greater results in the superlevel set filtration.
+
+  The diagram coincides with the one that is obtained by converting the
+  function into a simplicial complex (see topology::io::loadFunction())
+  and reducing its boundary matrix, but the values are only sorted once
+  and a single sweep with a Union--Find data structure suffices to pair
+  all vertices. The global extremum forms the only unpaired point.
+
+  @param values  Function values
+  @param compare Comparison functor that determines the filtration
+*/
+
+template <class DataType, class Compare = std::less<DataType> >
+PersistenceDiagram<DataType> calculateFunctionPersistenceDiagram( const std::vector<DataType>& values,
+                                                                  Compare compare = Compare() )
+{
+  using Index = defaults::Index;
+
+  detail::FunctionScratch<Index> scratch;
+  return detail::calculateFunctionPersistenceDiagram( values.data(), values.size(), compare, scratch );
+}
+
+/**
+  Calculates the zero-dimensional persistence diagrams of a batch of 1D
+  functions whose values are stored contiguously. The functions are
+  processed in parallel, while every thread reuses its scratch space.
+
+  @param values  Function values of all functions
+  @param offsets Offsets of the functions in the vector of values. The
+                 i-th function consists of the values in the half-open
+                 range \f$[offsets[i], offsets[i+1])\f$, so the last
+                 offset is the total number of values.
+  @param compare Comparison functor that determines the filtration
+
+  @returns One persistence diagram for each function, in the order of
+  the offsets
+*/
+
+template <class DataType, class Compare = std::less<DataType> >
+std::vector< PersistenceDiagram<DataType> > calculateFunctionPersistenceDiagrams( const std::vector<DataType>& values,
+                                                                                 const std::vector<std::size_t>& offsets,
+                                                                                 Compare compare = Compare() )
+{
+  using Index = defaults::Index;
+
+  if( offsets.empty() )
+    return {};
+
+  if( !std::is_sorted( offsets.begin(), offsets.end() ) || offsets.back() != values.size() )
+    throw std::runtime_error( "Function offsets must be sorted and end with the number of values" );
+
+  // Errors must not be raised in the parallel region below, so the size
+  // of every function is checked beforehand.
+  for( std::size_t i = 0; i + 1 < offsets.size(); i++ )
+  {
+    if( offsets[i+1] - offsets[i] > std::size_t( std::numeric_limits<Index>::max() ) )
+      throw std::runtime_error( "Function has too many values for the index type" );
+  }
+
+  std::vector< PersistenceDiagram<DataType> > diagrams( offsets.size() - 1 );
+
+  #pragma omp parallel
+  {
+    detail::FunctionScratch<Index> scratch;
+
+    #pragma omp for schedule(dynamic, 64)
+    for( long i = 0; i < long( diagrams.size() ); i++ )
+    {
+      auto begin = offsets[ std::size_t(i)     ];
+      auto end   = offsets[ std::size_t(i) + 1 ];
+
+      diagrams[ std::size_t(i) ]
+        = detail::calculateFunctionPersistenceDiagram( values.data() + begin, end - begin, compare, scratch );
+    }
+  }
+
+  return diagrams;
+}
+
+} // namespace aleph
+
+#endif
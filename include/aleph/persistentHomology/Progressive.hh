@@ -0,0 +1,306 @@
+#ifndef ALEPH_PERSISTENT_HOMOLOGY_PROGRESSIVE_HH__
+#define ALEPH_PERSISTENT_HOMOLOGY_PROGRESSIVE_HH__
+
+#include <aleph/config/Defaults.hh>
+
+#include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
+
+#include <aleph/topology/BoundaryMatrix.hh>
+#include <aleph/topology/Conversions.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <aleph/utilities/Profiler.hh>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <set>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+
+namespace aleph
+{
+
+/**
+  @class ProgressivePersistence
+  @brief Calculates persistent homology while the filtration grows
+
+  This class reduces the boundary matrix of a simplicial complex in
+  blocks of columns, following the filtration order. Since the standard
+  reduction algorithm only ever adds columns from the left, the pairs of
+  all columns processed so far do not change any more when subsequent
+  columns are being reduced. Hence, after every block, the class knows
+  the *exact* persistence pairs whose destroyer has a value of at most
+  the current threshold, i.e. the value of the last simplex that has
+  been processed. All other creators belong to *open* classes, which
+  are alive at the threshold and will be destroyed later, if at all.
+
+  This makes it possible to show partial results of a large calculation,
+  or to stop it as soon as the features of interest have been found:
+
+  @code
+  aleph::ProgressivePersistence<Simplex> progressive( K );
+
+  while( progressive.advance( 1024 ) )
+  {
+    auto diagrams = progressive.diagrams();
+    // ... show diagrams up to progressive.threshold() ...
+  }
+  @endcode
+
+  Blocks always end at a change of the filtration value, so no pair is
+  reported before all simplices of its value have been processed. After
+  all blocks have been processed, the diagrams are the same as the ones
+  calculated by calculatePersistenceDiagrams() without dualization.
+
+  The simplicial complex is referenced by the class, so it must outlive
+  any instance. It has to be in filtration order.
+
+  @tparam Simplex        Simplex data type
+  @tparam Representation Representation of the boundary matrix
+*/
+
+template <class Simplex, class Representation = defaults::Representation> class ProgressivePersistence
+{
+public:
+  using DataType           = typename Simplex::DataType;
+  using Index              = typename Representation::Index;
+  using PersistenceDiagram = aleph::PersistenceDiagram<DataType>;
+  using SimplicialComplex  = topology::SimplicialComplex<Simplex>;
+
+  /**
+    Prepares the progressive calculation of persistent homology for
+    a simplicial complex. No columns are reduced yet.
+
+    @param K                          Simplicial complex in filtration order
+    @param includeAllUnpairedCreators Flag indicating whether creators of
+                                      the highest dimension should become
+                                      open classes; see calculatePersistenceDiagrams()
+  */
+
+  explicit ProgressivePersistence( const SimplicialComplex& K, bool includeAllUnpairedCreators = false )
+    : _K( K )
+    , _B( topology::makeBoundaryMatrix<Representation>( K ) )
+    , _lut( K.size(), std::make_pair( Index(0), false ) )
+    , _includeAllUnpairedCreators( includeAllUnpairedCreators )
+  {
+  }
+
+  /**
+    Reduces the next block of columns. A block contains at least the
+    given number of columns and is extended until the next change of
+    the filtration value, or until the end of the filtration.
+
+    @returns true if further columns remain to be reduced, false if the
+    calculation is complete
+  */
+
+  bool advance( std::size_t minColumns )
+  {
+    ALEPH_PROFILE_ZONE( "ProgressivePersistence::advance" );
+
+    auto end = std::min( _next + std::max( minColumns, std::size_t(1) ), _K.size() );
+
+    while( end < _K.size() && _K.at( end ).data() == _K.at( end - 1 ).data() )
+      ++end;
+
+    this->reduce( end );
+    return !this->done();
+  }
+
+  /**
+    Reduces all columns whose simplices have a value of at most the given
+    threshold. Afterwards, all pairs destroyed at this threshold or before
+    are known.
+
+    @returns true if further columns remain to be reduced, false if the
+    calculation is complete
+  */
+
+  bool advanceTo( DataType threshold )
+  {
+    ALEPH_PROFILE_ZONE( "ProgressivePersistence::advanceTo" );
+
+    auto end = _next;
+
+    while( end < _K.size() && !( threshold < _K.at( end ).data() ) )
+      ++end;
+
+    this->reduce( end );
+    return !this->done();
+  }
+
+  /** Checks whether all columns have been reduced */
+  bool done() const noexcept
+  {
+    return _next >= _K.size();
+  }
+
+  /** @returns Number of columns, i.e. simplices, that have been reduced */
+  std::size_t numProcessed() const noexcept
+  {
+    return _next;
+  }
+
+  /**
+    @returns Value of the last simplex that has been reduced, i.e. the
+    value up to which all pairs are known. Prior to any reduction, the
+    lowest value of the data type is returned.
+  */
+
+  DataType threshold() const
+  {
+    if( _next == 0 )
+      return std::numeric_limits<DataType>::lowest();
+
+    return _K.at( _next - 1 ).data();
+  }
+
+  /** @returns Number of classes that are alive at the current threshold */
+  std::size_t numOpenClasses() const noexcept
+  {
+    return _open.size();
+  }
+
+  /**
+    Creates the current persistence diagrams, sorted by their dimension.
+    They contain all pairs that have been finalised so far, as well as a
+    point at infinity for every open class. The death of an open class
+    is only known to be larger than the current threshold.
+  */
+
+  std::vector<PersistenceDiagram> diagrams() const
+  {
+    ALEPH_PROFILE_ZONE( "ProgressivePersistence::diagrams" );
+
+    auto persistenceDiagrams = _diagrams;
+
+    for( auto&& creator : _open )
+    {
+      auto&& s = _K.at( creator );
+      persistenceDiagrams[ s.dimension() ].add( s.data() );
+    }
+
+    std::vector<PersistenceDiagram> result;
+    result.reserve( persistenceDiagrams.size() );
+
+    // The map is ordered by dimension already, so no sorting is required
+    for( auto&& pair : persistenceDiagrams )
+    {
+      auto&& diagram = pair.second;
+      diagram.setDimension( pair.first );
+
+      result.push_back( diagram );
+    }
+
+    return result;
+  }
+
+private:
+
+  /** Reduces all columns up to, but not including, the given index */
+  void reduce( std::size_t end )
+  {
+    auto topDimension = _B.getDimension();
+
+    for( ; _next < end; _next++ )
+    {
+      auto j = static_cast<Index>( _next );
+
+      Index i;
+      bool valid = false;
+
+      std::tie( i, valid ) = _B.getMaximumIndex( j );
+      while( valid && _lut[ static_cast<std::size_t>(i) ].second )
+      {
+        _B.addColumns( _lut[ static_cast<std::size_t>(i) ].first, j );
+        std::tie( i, valid ) = _B.getMaximumIndex( j );
+      }
+
+      if( valid )
+      {
+        _lut[ static_cast<std::size_t>(i) ] = std::make_pair( j, true );
+        _open.erase( i );
+
+        auto&& s = _K.at( static_cast<std::size_t>(i) );
+        auto&& t = _K.at( _next );
+
+        _diagrams[ s.dimension() ].add( s.data(), t.data() );
+      }
+
+      // Creators of the highest dimension can never be destroyed, so
+      // they are skipped, unless the client requested them.
+      else if( _B.getDimension(j) != topDimension || _includeAllUnpairedCreators )
+        _open.insert( j );
+    }
+  }
+
+  /** Simplicial complex whose persistent homology is calculated */
+  const SimplicialComplex& _K;
+
+  /** Boundary matrix; only its first _next columns are reduced */
+  topology::BoundaryMatrix<Representation> _B;
+
+  /** Look-up table for the column that has a given pivot */
+  std::vector< std::pair<Index, bool> > _lut;
+
+  /** Index of the next column to reduce */
+  std::size_t _next = 0;
+
+  /** Creators that have not been destroyed so far */
+  std::set<Index> _open;
+
+  /** Finalised pairs, stored by dimension */
+  std::map<std::size_t, PersistenceDiagram> _diagrams;
+
+  /** Flag indicating whether creators of the highest dimension are kept */
+  bool _includeAllUnpairedCreators;
+};
+
+/**
+  Calculates persistence diagrams of a simplicial complex progressively,
+  i.e. in blocks of columns of its boundary matrix, and calls a function
+  after every block. The function receives the ProgressivePersistence
+  instance, so it may query the current threshold as well as the current
+  persistence diagrams. If it returns true, the calculation is stopped.
+
+  @param K                          Simplicial complex in filtration order
+  @param callback                   Function to call after every block
+  @param blockSize                  Minimum number of columns per block
+  @param includeAllUnpairedCreators Flag indicating whether all unpaired creators should be included
+
+  @returns Persistence diagrams at the time the calculation stopped. If it
+  ran until completion, these are the same diagrams that are calculated by
+  calculatePersistenceDiagrams() without dualization.
+*/
+
+template <
+  class Representation = defaults::Representation,
+  class Simplex,
+  class Callback
+> std::vector< PersistenceDiagram<typename Simplex::DataType> > calculatePersistenceDiagramsProgressively( const topology::SimplicialComplex<Simplex>& K,
+                                                                                                           Callback callback,
+                                                                                                           std::size_t blockSize           = 1024,
+                                                                                                           bool includeAllUnpairedCreators = false )
+{
+  ALEPH_PROFILE_ZONE( "calculatePersistenceDiagramsProgressively" );
+
+  ProgressivePersistence<Simplex, Representation> progressive( K, includeAllUnpairedCreators );
+
+  while( !progressive.done() )
+  {
+    progressive.advance( blockSize );
+
+    if( callback( static_cast<const ProgressivePersistence<Simplex, Representation>&>( progressive ) ) )
+      break;
+  }
+
+  return progressive.diagrams();
+}
+
+} // namespace aleph
+
+#endif
@@ -0,0 +1,213 @@
+#ifndef ALEPH_PERSISTENT_HOMOLOGY_STRATEGY_HH__
+#define ALEPH_PERSISTENT_HOMOLOGY_STRATEGY_HH__
+
+#include <aleph/persistentHomology/algorithms/Standard.hh>
+#include <aleph/persistentHomology/algorithms/Traits.hh>
+#include <aleph/persistentHomology/algorithms/Twist.hh>
+
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cstddef>
+
+namespace aleph
+{
+
+/**
+  @class ComplexStatistics
+  @brief Cheap statistics of a simplicial complex
+
+  These statistics can be collected in a single pass over a simplicial
+  complex. They are used to select a strategy for calculating persistent
+  homology; see selectStrategy().
+*/
+
+struct ComplexStatistics
+{
+  /** Number of simplices of every dimension */
+  std::vector<std::size_t> numSimplices;
+
+  /** Number of non-zero entries of the boundary matrix */
+  std::size_t numEntries = 0;
+
+  /** @returns Total number of simplices */
+  std::size_t size() const
+  {
+    std::size_t n = 0;
+    for( auto&& count : numSimplices )
+      n += count;
+
+    return n;
+  }
+
+  /** @returns Dimension of the complex, i.e. of its largest simplex */
+  std::size_t dimension() const
+  {
+    return numSimplices.empty() ? 0 : numSimplices.size() - 1;
+  }
+
+  /** @returns Average number of non-zero entries per column */
+  double averageColumnLength() const
+  {
+    auto n = this->size();
+    return n == 0 ? 0.0 : double( numEntries ) / double( n );
+  }
+
+  /**
+    @returns Ratio between the number of simplices of the highest and the
+    second-highest dimension. For complexes that are built from dense
+    data, e.g. Vietoris--Rips complexes, this ratio is large, whereas it
+    is small for meshes, whose simplices are glued along few facets.
+  */
+
+  double density() const
+  {
+    if( numSimplices.size() < 2 || numSimplices[ numSimplices.size() - 2 ] == 0 )
+      return 0.0;
+
+    return double( numSimplices.back() ) / double( numSimplices[ numSimplices.size() - 2 ] );
+  }
+
+  /** @returns Number of simplices per dimension, separated by spaces */
+  std::string profile() const
+  {
+    std::ostringstream stream;
+
+    for( std::size_t d = 0; d < numSimplices.size(); d++ )
+      stream << ( d == 0 ? "" : " " ) << numSimplices[d];
+
+    return stream.str();
+  }
+};
+
+/** Collects statistics of a simplicial complex */
+template <class Simplex> ComplexStatistics collectStatistics( const topology::SimplicialComplex<Simplex>& K )
+{
+  ComplexStatistics statistics;
+
+  for( auto&& simplex : K )
+  {
+    auto d = static_cast<std::size_t>( simplex.dimension() );
+
+    if( statistics.numSimplices.size() <= d )
+      statistics.numSimplices.resize( d + 1 );
+
+    statistics.numSimplices[d] += 1;
+
+    if( d != 0 )
+      statistics.numEntries += simplex.size();
+  }
+
+  return statistics;
+}
+
+/**
+  @class Strategy
+  @brief Strategy for calculating persistent homology of a complex
+*/
+
+struct Strategy
+{
+  /**
+    Flag indicating whether pairs that are known without any reduction
+    are eliminated from the boundary matrix first; see
+    eliminateApparentPairs()
+  */
+
+  bool eliminateApparentPairs = false;
+
+  /** Flag indicating whether the boundary matrix is dualized */
+  bool dualize = true;
+
+  /**
+    Name of the algorithm for reducing the boundary matrix, as given by
+    the traits of the algorithm (see persistentHomology::algorithms::Traits)
+  */
+
+  std::string algorithm = persistentHomology::algorithms::Traits<persistentHomology::algorithms::Twist>::name();
+
+  /** @returns Human-readable description of the strategy */
+  std::string description() const
+  {
+    std::string result = eliminateApparentPairs ? "apparent pairs, " + algorithm : algorithm;
+    return result + ( dualize ? ", dualized" : ", not dualized" );
+  }
+};
+
+/**
+  Selects a reduction algorithm for a strategy, depending on whether it
+  eliminates apparent pairs and dualizes the boundary matrix:
+
+  - If apparent pairs are eliminated and the matrix is not dualized, the
+    standard algorithm is used. Almost all columns that clearing would
+    remove have been eliminated already, so the additional passes of the
+    Twist algorithm over the columns of every dimension do not pay off.
+    It was 3--30% faster for graphs, meshes, and sparse Vietoris--Rips
+    complexes.
+
+  - Otherwise, the Twist algorithm is used. Clearing removes most of the
+    columns of a dualized matrix, making it up to twice as fast as the
+    standard algorithm for dense complexes. For complete matrices that
+    are not dualized, both algorithms are about equally fast.
+
+  @returns Name of the selected algorithm (see Strategy::algorithm)
+*/
+
+inline std::string selectAlgorithm( const Strategy& strategy )
+{
+  using namespace persistentHomology::algorithms;
+
+  if( strategy.eliminateApparentPairs && !strategy.dualize )
+    return Traits<Standard>::name();
+  else
+    return Traits<Twist>::name();
+}
+
+/**
+  Selects a strategy for calculating persistent homology of a simplicial
+  complex, based on its statistics. The rules have been derived from
+  measurements of different types of complexes:
+
+  - For graphs, i.e. 1-dimensional complexes, all pairs are determined
+    by tracking connected components during the apparent pair
+    elimination, so no reduction is required at all.
+
+  - For complexes with few top-dimensional simplices in relation to the
+    number of their facets, such as meshes or sparse Vietoris--Rips
+    complexes, most columns form apparent pairs, and eliminating them is
+    cheaper than dualizing the matrix.
+
+  - For dense complexes, such as Vietoris--Rips complexes at large
+    scales, the dualized matrix reduces fastest, because clearing then
+    removes most of the numerous top-dimensional columns.
+
+  The reduction algorithm depends on these decisions; see selectAlgorithm().
+  The vector representation of the boundary matrix was the fastest one
+  for all types of complexes, so the representation is not changed.
+*/
+
+inline Strategy selectStrategy( const ComplexStatistics& statistics )
+{
+  Strategy strategy;
+
+  if( statistics.dimension() <= 1 || statistics.density() < 4.0 )
+  {
+    strategy.eliminateApparentPairs = true;
+    strategy.dualize                = false;
+  }
+  else
+  {
+    strategy.eliminateApparentPairs = false;
+    strategy.dualize                = true;
+  }
+
+  strategy.algorithm = selectAlgorithm( strategy );
+  return strategy;
+}
+
+} // namespace aleph
+
+#endif
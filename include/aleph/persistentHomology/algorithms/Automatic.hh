@@ -0,0 +1,49 @@
+#ifndef ALEPH_PERSISTENT_HOMOLOGY_ALGORITHMS_AUTOMATIC_HH__
+#define ALEPH_PERSISTENT_HOMOLOGY_ALGORITHMS_AUTOMATIC_HH__
+
+#include <aleph/persistentHomology/algorithms/Traits.hh>
+#include <aleph/persistentHomology/algorithms/Twist.hh>
+
+#include <string>
+
+namespace aleph
+{
+
+namespace persistentHomology
+{
+
+namespace algorithms
+{
+
+/**
+  @class Automatic
+  @brief Selects a reduction strategy based on the simplicial complex
+
+  When used with calculatePersistenceDiagrams(), this algorithm makes the
+  function inspect the simplicial complex in order to decide whether to
+  dualize the boundary matrix, whether to eliminate apparent pairs prior
+  to the reduction, and which reduction algorithm to use for the rest of
+  the matrix; see selectStrategy(). When used to reduce an existing
+  boundary matrix, there is nothing left to decide, so it works exactly
+  like the Twist algorithm.
+*/
+
+class Automatic : public Twist
+{
+};
+
+template <> struct Traits<Automatic>
+{
+  static std::string name()
+  {
+    return Traits<Twist>::name();
+  }
+};
+
+} // namespace algorithms
+
+} // namespace persistentHomology
+
+} // namespace aleph
+
+#endif
@@ -1,8 +1,11 @@
 #ifndef ALEPH_PERSISTENT_HOMOLOGY_ALGORITHMS_STANDARD_HH__
 #define ALEPH_PERSISTENT_HOMOLOGY_ALGORITHMS_STANDARD_HH__
 
+#include <aleph/persistentHomology/algorithms/Traits.hh>
+
 #include <aleph/topology/BoundaryMatrix.hh>
 
+#include <string>
 #include <tuple>
 #include <vector>
 
@@ -79,6 +82,22 @@ public:
   }
 };
 
+template <> struct Traits<Standard>
+{
+  static std::string name()
+  {
+    return "Standard";
+  }
+};
+
+template <> struct Traits<StandardRectangular>
+{
+  static std::string name()
+  {
+    return "Standard (rectangular)";
+  }
+};
+
 } // namespace algorithms
 
 } // namespace persistentHomology
@@ -0,0 +1,36 @@
+#ifndef ALEPH_PERSISTENT_HOMOLOGY_ALGORITHMS_TRAITS_HH__
+#define ALEPH_PERSISTENT_HOMOLOGY_ALGORITHMS_TRAITS_HH__
+
+#include <string>
+
+namespace aleph
+{
+
+namespace persistentHomology
+{
+
+namespace algorithms
+{
+
+/**
+  A generic traits class for reduction algorithms. Every traits class
+  provides a human-readable name of its algorithm, which is used when
+  reporting the strategy of a calculation (see Strategy). Algorithms
+  that do not specialize this class are reported by a generic name.
+*/
+
+template <class T> struct Traits
+{
+  static std::string name()
+  {
+    return "custom";
+  }
+};
+
+} // namespace algorithms
+
+} // namespace persistentHomology
+
+} // namespace aleph
+
+#endif
@@ -1,8 +1,11 @@
 #ifndef ALEPH_PERSISTENT_HOMOLOGY_ALGORITHMS_TWIST_HH__
 #define ALEPH_PERSISTENT_HOMOLOGY_ALGORITHMS_TWIST_HH__
 
+#include <aleph/persistentHomology/algorithms/Traits.hh>
+
 #include <aleph/topology/BoundaryMatrix.hh>
 
+#include <string>
 #include <tuple>
 #include <vector>
 
@@ -55,6 +58,14 @@ public:
   }
 };
 
+template <> struct Traits<Twist>
+{
+  static std::string name()
+  {
+    return "Twist";
+  }
+};
+
 } // namespace algorithms
 
 } // namespace persistentHomology
@@ -1,6 +1,8 @@
 #ifndef ALEPH_BOUNDARY_MATRIX_HH__
 #define ALEPH_BOUNDARY_MATRIX_HH__
 
+#include <aleph/utilities/Profiler.hh>
+
 #include <algorithm>
 #include <fstream>
 #include <istream>
@@ -9,6 +11,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 // Depending on the index type of the representation, conversions
@@ -29,6 +32,21 @@ template <class Representation> class BoundaryMatrix
 public:
   using Index = typename Representation::Index;
 
+  BoundaryMatrix() = default;
+
+  /**
+    Creates a boundary matrix that stores its columns in a given, usually
+    empty, representation. This permits configuring the representation,
+    e.g. the cache size of an external representation. Matrices that are
+    derived from this one, such as its dual, use a default-constructed
+    representation.
+  */
+
+  explicit BoundaryMatrix( Representation representation )
+    : _representation( std::move( representation ) )
+  {
+  }
+
   void setNumColumns( Index numColumns )
   {
     _representation.setNumColumns( numColumns );
@@ -86,6 +104,26 @@ public:
     return _isDualized;
   }
 
+  // Memory usage ------------------------------------------------------
+
+  /** @returns Approximate number of bytes that are used by the matrix */
+  std::size_t memoryUsage() const
+  {
+    return sizeof( BoundaryMatrix ) + _representation.memoryUsage();
+  }
+
+  /**
+    Estimates the number of bytes that a boundary matrix with the given
+    number of columns and non-zero entries will use. This permits taking
+    decisions *before* a matrix is being created. Additional arguments
+    are passed on to the estimate of the representation.
+  */
+
+  template <class... Arguments> static std::size_t estimateMemoryUsage( std::size_t numColumns, std::size_t numEntries, Arguments... arguments )
+  {
+    return sizeof( BoundaryMatrix ) + Representation::estimateMemoryUsage( numColumns, numEntries, arguments... );
+  }
+
   // Comparison --------------------------------------------------------
 
   bool operator==( const BoundaryMatrix& other ) const
@@ -112,6 +150,8 @@ public:
 
   BoundaryMatrix dualize() const
   {
+    ALEPH_PROFILE_ZONE( "dualize" );
+
     auto&& numColumns = this->getNumColumns();
 
     std::vector< std::vector<Index> > dualMatrix( numColumns );
@@ -129,8 +169,15 @@ public:
         ++dualColumnSizes[ numColumns - 1 - i ];
     }
 
+    std::size_t numEntries = 0;
+
     for( Index j = 0; j < numColumns; j++ )
+    {
       dualMatrix[j].reserve( dualColumnSizes[j] );
+      numEntries += dualColumnSizes[j];
+    }
+
+    ALEPH_PROFILE_MEMORY( "dualMatrix", numColumns * sizeof( std::vector<Index> ) + numEntries * sizeof( Index ) );
 
     // Calculate the actual anti-transpose of the matrix. Since the
     // vectors have been properly resized, this operation should be
@@ -163,8 +210,14 @@ public:
                    dualMatrix.at(j).begin(), dualMatrix.at(j).end() );
 
       M.setDimension( j, dualDimensions.at(j) );
+
+      // Release the temporary column right away; else, the dual matrix
+      // would be stored twice until the function ends.
+      std::vector<Index>().swap( dualMatrix.at(j) );
     }
 
+    ALEPH_PROFILE_MEMORY( "boundaryMatrix", M.memoryUsage() );
+
     M._isDualized = !this->isDualized();
     return M;
   }
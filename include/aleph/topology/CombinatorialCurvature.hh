@@ -36,13 +36,17 @@ template <class SimplicialComplex, class OutputIterator> void angleDefectCurvatu
   const SimplicialComplex& K,
   OutputIterator result )
 {
-  auto n         = K.dimension();
-  auto iterators = K.range( n-2 );
+  auto n = K.dimension();
 
-  for( auto&& it = iterators.first; it != iterators.second; ++it )
+  // The degrees are reported in the order of the simplices of dimension
+  // n-2, so there is no need to look up individual simplices.
+  std::vector<unsigned> degrees;
+  aleph::topology::filtrations::n_degrees( K, n-2, std::back_inserter( degrees ) );
+
+  for( auto&& degree : degrees )
   {
     double theta  = std::acos( 1.0 / double(n) );
-    double defect = 2*M_PI - theta * aleph::topology::filtrations::n_degree( K, *it );
+    double defect = 2*M_PI - theta * degree;
 
     *result++ = defect;
   }
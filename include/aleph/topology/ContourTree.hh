@@ -0,0 +1,250 @@
+#ifndef ALEPH_TOPOLOGY_CONTOUR_TREE_HH__
+#define ALEPH_TOPOLOGY_CONTOUR_TREE_HH__
+
+#include <aleph/topology/MergeTree.hh>
+#include <aleph/topology/ScalarGraph.hh>
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+
+namespace aleph
+{
+
+namespace topology
+{
+
+/**
+  @class ContourTree
+  @brief Contour tree of a scalar field on a graph
+
+  The contour tree describes how the connected components of the level
+  sets of a scalar field appear, merge, split, and vanish. Like the merge
+  trees it is calculated from, its nodes are *all* vertices of a scalar
+  graph, and every arc connects a lower vertex to a higher one.
+*/
+
+template <class DataType, class Index = unsigned> class ContourTree
+{
+public:
+  using ValueType = DataType;
+  using IndexType = Index;
+  using Arc       = std::pair<Index, Index>;
+
+  ContourTree( std::size_t size, std::vector<Arc> arcs )
+    : _size( size ),
+      _arcs( std::move( arcs ) )
+  {
+  }
+
+  /** @returns Number of vertices */
+  std::size_t size() const noexcept
+  {
+    return _size;
+  }
+
+  /** @returns All arcs of the tree, each of them from a lower to a higher vertex */
+  const std::vector<Arc>& arcs() const noexcept
+  {
+    return _arcs;
+  }
+
+  /**
+    @returns Arcs of the tree after removing all regular vertices, i.e.
+    all vertices with exactly one lower and one higher neighbour, so that
+    only critical vertices are connected to each other
+  */
+
+  std::vector<Arc> reducedArcs() const
+  {
+    std::vector<Index> numLower( _size );
+    std::vector<Index> numUpper( _size );
+    std::vector<Index> upper( _size );
+
+    for( auto&& arc : _arcs )
+    {
+      ++numUpper[ arc.first  ];
+      ++numLower[ arc.second ];
+
+      upper[ arc.first ] = arc.second;
+    }
+
+    auto regular = [&] ( Index v )
+    {
+      return numLower[v] == 1 && numUpper[v] == 1;
+    };
+
+    std::vector<Arc> result;
+
+    for( auto&& arc : _arcs )
+    {
+      if( regular( arc.first ) )
+        continue;
+
+      auto v = arc.second;
+      while( regular(v) )
+        v = upper[v];
+
+      result.push_back( std::make_pair( arc.first, v ) );
+    }
+
+    return result;
+  }
+
+private:
+
+  /** Number of vertices */
+  std::size_t _size;
+
+  /** Arcs of the augmented tree */
+  std::vector<Arc> _arcs;
+};
+
+/**
+  Calculates the contour tree of a scalar field on a graph from its join
+  tree and its split tree. Leaves of the contour tree are removed from
+  both trees, one after the other, using the algorithm by Carr et al.:
+
+    Computing Contour Trees in All Dimensions
+    Hamish Carr, Jack Snoeyink, and Ulrike Axen
+    Computational Geometry 24(2), pp. 75--94, 2003
+
+  The merge trees are calculated in parallel (see calculateMergeTree()),
+  while their combination requires linear time.
+
+  @param G          Scalar graph
+  @param numDomains Number of domains for calculating the merge trees
+*/
+
+template <class DataType, class Index>
+ContourTree<DataType, Index> calculateContourTree( const ScalarGraph<DataType, Index>& G, unsigned numDomains = 0 )
+{
+  auto joinTree  = calculateJoinTree( G, numDomains );
+  auto splitTree = calculateSplitTree( G, numDomains );
+
+  auto n = G.size();
+
+  // The trees are modified while removing leaves. Since this requires
+  // only the unique child of a vertex, the children of every vertex are
+  // stored as the XOR of their indices, along with their number.
+  std::vector<Index> joinParent( n );
+  std::vector<Index> splitParent( n );
+  std::vector<Index> numJoinChildren( n );
+  std::vector<Index> numSplitChildren( n );
+  std::vector<Index> joinChildren( n );
+  std::vector<Index> splitChildren( n );
+
+  for( std::size_t i = 0; i < n; i++ )
+  {
+    auto v = Index(i);
+
+    joinParent[v]  = joinTree.parent(v);
+    splitParent[v] = splitTree.parent(v);
+
+    if( !joinTree.isRoot(v) )
+    {
+      ++numJoinChildren[ joinParent[v] ];
+      joinChildren[ joinParent[v] ] ^= v;
+    }
+
+    if( !splitTree.isRoot(v) )
+    {
+      ++numSplitChildren[ splitParent[v] ];
+      splitChildren[ splitParent[v] ] ^= v;
+    }
+  }
+
+  // A vertex is an upper leaf of the contour tree if it is a maximum,
+  // i.e. a leaf of the split tree, and is connected to a single vertex
+  // in the join tree. Lower leaves are defined analogously.
+  auto isUpperLeaf = [&] ( Index v )
+  {
+    return numSplitChildren[v] == 0 && numJoinChildren[v] == 1;
+  };
+
+  auto isLowerLeaf = [&] ( Index v )
+  {
+    return numJoinChildren[v] == 0 && numSplitChildren[v] == 1;
+  };
+
+  std::vector<Index> leaves;
+
+  for( std::size_t i = 0; i < n; i++ )
+  {
+    if( isUpperLeaf( Index(i) ) || isLowerLeaf( Index(i) ) )
+      leaves.push_back( Index(i) );
+  }
+
+  std::vector< std::pair<Index, Index> > arcs;
+  arcs.reserve( n );
+
+  // Removes a vertex with one child from a tree by connecting the child
+  // to the parent of the vertex directly
+  auto contract = [] ( Index v, std::vector<Index>& parent, std::vector<Index>& children )
+  {
+    auto c = children[v];
+    auto p = parent[v];
+
+    if( p != v )
+    {
+      parent[c]    = p;
+      children[p] ^= v ^ c;
+    }
+    else
+      parent[c] = c;
+  };
+
+  // Removes a leaf from a tree and reports whether its parent has become
+  // a leaf of the contour tree
+  auto remove = [&] ( Index v, std::vector<Index>& parent, std::vector<Index>& numChildren, std::vector<Index>& children )
+  {
+    auto p = parent[v];
+
+    if( p != v )
+    {
+      --numChildren[p];
+      children[p] ^= v;
+
+      if( isUpperLeaf(p) || isLowerLeaf(p) )
+        leaves.push_back(p);
+    }
+  };
+
+  while( !leaves.empty() )
+  {
+    auto v = leaves.back();
+    leaves.pop_back();
+
+    // The arc of an upper leaf leads to its parent in the split tree, in
+    // which it is a leaf, while it is a regular vertex of the join tree.
+    if( isUpperLeaf(v) )
+    {
+      arcs.push_back( std::make_pair( splitParent[v], v ) );
+
+      contract( v, joinParent, joinChildren );
+      numJoinChildren[v] = 0;
+
+      remove( v, splitParent, numSplitChildren, splitChildren );
+    }
+    else if( isLowerLeaf(v) )
+    {
+      arcs.push_back( std::make_pair( v, joinParent[v] ) );
+
+      contract( v, splitParent, splitChildren );
+      numSplitChildren[v] = 0;
+
+      remove( v, joinParent, numJoinChildren, joinChildren );
+    }
+  }
+
+  return ContourTree<DataType, Index>( n, std::move( arcs ) );
+}
+
+} // namespace topology
+
+} // namespace aleph
+
+#endif
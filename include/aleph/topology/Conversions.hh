@@ -5,6 +5,8 @@
 
 #include <aleph/topology/BoundaryMatrix.hh>
 
+#include <aleph/utilities/Profiler.hh>
+
 #include <algorithm>
 #include <unordered_map>
 
@@ -23,17 +25,21 @@ namespace topology
   function are suitable for (persistent) homology. If a maximum index is
   given, however, the matrices are particularly suitable for calculating
   (persistent) intersection homology.
+
+  The columns are stored in a given, typically empty, boundary matrix.
+  This permits configuring its representation beforehand.
 */
 
 template <
-  class Representation = aleph::defaults::Representation,
+  class Representation,
   class SimplicialComplex
-> BoundaryMatrix<Representation> makeBoundaryMatrix( const SimplicialComplex& K, std::size_t max = 0 )
+> BoundaryMatrix<Representation> makeBoundaryMatrix( const SimplicialComplex& K, BoundaryMatrix<Representation> M, std::size_t max = 0 )
 {
   using Simplex = typename SimplicialComplex::ValueType;
   using Index   = typename BoundaryMatrix<Representation>::Index;
 
-  BoundaryMatrix<Representation> M;
+  ALEPH_PROFILE_ZONE( "makeBoundaryMatrix" );
+
   M.setNumColumns( static_cast<Index>( K.size() ) );
 
   // Prepare index map -------------------------------------------------
@@ -74,9 +80,24 @@ template <
     ++j;
   }
 
+  ALEPH_PROFILE_MEMORY( "boundaryMatrix", M.memoryUsage() );
   return M;
 }
 
+/**
+  Converts a simplicial complex into its boundary matrix representation,
+  using a default-constructed representation. See above for the meaning
+  of the optional maximum index.
+*/
+
+template <
+  class Representation = aleph::defaults::Representation,
+  class SimplicialComplex
+> BoundaryMatrix<Representation> makeBoundaryMatrix( const SimplicialComplex& K, std::size_t max = 0 )
+{
+  return makeBoundaryMatrix( K, BoundaryMatrix<Representation>(), max );
+}
+
 } // namespace topology
 
 } // namespace aleph
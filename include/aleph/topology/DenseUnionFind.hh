@@ -0,0 +1,92 @@
+#ifndef ALEPH_TOPOLOGY_DENSE_UNION_FIND_HH__
+#define ALEPH_TOPOLOGY_DENSE_UNION_FIND_HH__
+
+#include <numeric>
+#include <vector>
+
+#include <cstddef>
+
+namespace aleph
+{
+
+namespace topology
+{
+
+/**
+  @class DenseUnionFind
+  @brief Union--Find data structure for the vertices \f$0,\dots,n-1\f$
+
+  In contrast to UnionFind, which permits arbitrary vertex labels, this
+  variant stores the parent of every vertex in a contiguous array. This
+  is preferable whenever the vertices of a complex are numbered densely,
+  as every operation merely requires an array access instead of a hash
+  table lookup. The data structure may be reused for several complexes
+  by calling reset().
+*/
+
+template <class Vertex> class DenseUnionFind
+{
+public:
+
+  /** Creates a new data structure with \p n singleton sets */
+  explicit DenseUnionFind( std::size_t n = 0 )
+  {
+    this->reset( n );
+  }
+
+  /** Resets the data structure to \p n singleton sets */
+  void reset( std::size_t n )
+  {
+    _parent.resize( n );
+    std::iota( _parent.begin(), _parent.end(), Vertex(0) );
+  }
+
+  /**
+    Merges a given vertex $u$ into the set corresponding to vertex $v$. Note
+    that the merge is directional, i.e. the root of $v$ remains the root of
+    the merged set.
+  */
+
+  void merge( Vertex u, Vertex v ) noexcept
+  {
+    auto ru = this->find( u );
+    auto rv = this->find( v );
+
+    if( ru != rv )
+      _parent[ru] = rv;
+  }
+
+  /**
+    Finds the root of a given vertex. Every vertex on the path to the root
+    is linked to its grandparent (path halving), which keeps paths short
+    without requiring recursion.
+  */
+
+  Vertex find( Vertex u ) noexcept
+  {
+    while( _parent[u] != u )
+    {
+      _parent[u] = _parent[ _parent[u] ];
+      u          = _parent[u];
+    }
+
+    return u;
+  }
+
+  /** @returns Number of vertices */
+  std::size_t size() const noexcept
+  {
+    return _parent.size();
+  }
+
+private:
+
+  /** Stores the parent of every vertex */
+  std::vector<Vertex> _parent;
+};
+
+} // namespace topology
+
+} // namespace aleph
+
+#endif
@@ -0,0 +1,421 @@
+#ifndef ALEPH_TOPOLOGY_MERGE_TREE_HH__
+#define ALEPH_TOPOLOGY_MERGE_TREE_HH__
+
+#include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
+
+#include <aleph/topology/DenseUnionFind.hh>
+#include <aleph/topology/ScalarGraph.hh>
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+
+namespace aleph
+{
+
+namespace topology
+{
+
+/**
+  @class MergeTree
+  @brief Merge tree of a scalar field on a graph
+
+  The merge tree describes how the connected components of the sublevel
+  sets of a scalar field appear and merge. Its nodes are the vertices of
+  a scalar graph, and every vertex is connected to the vertex at which
+  its component is extended next. Hence, this is the *augmented* merge
+  tree; its leaves are the minima of the field, and vertices with more
+  than one child are the saddles at which components merge.
+
+  The order of the vertices is determined by the comparison functor,
+  with ties being broken by comparing the indices of the vertices. For
+  the default functors, the merge tree is known as the *join tree*. The
+  *split tree*, which tracks superlevel sets, reverses both comparisons,
+  so that it sweeps over the vertices in exactly the opposite order.
+*/
+
+template <
+  class DataType,
+  class Compare      = std::less<DataType>,
+  class Index        = unsigned,
+  class IndexCompare = std::less<Index>
+> class MergeTree
+{
+public:
+  using ValueType = DataType;
+  using IndexType = Index;
+  using Arc       = std::pair<Index, Index>;
+
+  /** Creates a new merge tree for the given values in which every vertex is a root */
+  explicit MergeTree( std::vector<DataType> values = std::vector<DataType>() )
+    : _values( std::move( values ) ),
+      _parent( _values.size() )
+  {
+    std::iota( _parent.begin(), _parent.end(), Index(0) );
+  }
+
+  /** @returns Number of vertices */
+  std::size_t size() const noexcept
+  {
+    return _values.size();
+  }
+
+  /** @returns Value of a vertex */
+  DataType value( Index v ) const noexcept
+  {
+    return _values[v];
+  }
+
+  /** @returns Parent of a vertex, or the vertex itself for a root */
+  Index parent( Index v ) const noexcept
+  {
+    return _parent[v];
+  }
+
+  /** Checks whether a vertex is the root of its connected component */
+  bool isRoot( Index v ) const noexcept
+  {
+    return _parent[v] == v;
+  }
+
+  /**
+    Checks whether a vertex precedes another vertex in the order that
+    is used for sweeping over the vertices.
+  */
+
+  bool precedes( Index u, Index v ) const noexcept
+  {
+    if( _compare( _values[u], _values[v] ) )
+      return true;
+    else if( _compare( _values[v], _values[u] ) )
+      return false;
+    else
+      return _indexCompare( u, v );
+  }
+
+  /** @returns Number of children of every vertex */
+  std::vector<Index> numChildren() const
+  {
+    std::vector<Index> result( this->size() );
+
+    for( std::size_t v = 0; v < this->size(); v++ )
+    {
+      if( !this->isRoot( Index(v) ) )
+        ++result[ _parent[v] ];
+    }
+
+    return result;
+  }
+
+  /**
+    @returns Critical vertices of the tree, i.e. all vertices that do
+    not have exactly one child, as well as all roots
+  */
+
+  std::vector<Index> criticalVertices() const
+  {
+    auto children = this->numChildren();
+
+    std::vector<Index> result;
+
+    for( std::size_t v = 0; v < this->size(); v++ )
+    {
+      if( children[v] != 1 || this->isRoot( Index(v) ) )
+        result.push_back( Index(v) );
+    }
+
+    return result;
+  }
+
+  /** @returns All arcs of the tree, from a vertex to its parent */
+  std::vector<Arc> arcs() const
+  {
+    std::vector<Arc> result;
+
+    for( std::size_t v = 0; v < this->size(); v++ )
+    {
+      if( !this->isRoot( Index(v) ) )
+        result.push_back( std::make_pair( Index(v), _parent[v] ) );
+    }
+
+    return result;
+  }
+
+  /**
+    @returns Arcs of the tree after removing all regular vertices, i.e.
+    all vertices that have one child, so that only critical vertices are
+    connected to each other
+  */
+
+  std::vector<Arc> reducedArcs() const
+  {
+    auto children = this->numChildren();
+    auto critical = [&] ( Index v )
+    {
+      return children[v] != 1 || this->isRoot(v);
+    };
+
+    std::vector<Arc> result;
+
+    for( std::size_t v = 0; v < this->size(); v++ )
+    {
+      if( !critical( Index(v) ) || this->isRoot( Index(v) ) )
+        continue;
+
+      auto p = _parent[v];
+      while( !critical(p) )
+        p = _parent[p];
+
+      result.push_back( std::make_pair( Index(v), p ) );
+    }
+
+    return result;
+  }
+
+  /**
+    Calculates the zero-dimensional persistence diagram of the filtration
+    that is described by the tree. Whenever components merge, the younger
+    ones are destroyed (elder rule). Every root results in an unpaired
+    point, while points on the diagonal are not reported.
+  */
+
+  PersistenceDiagram<DataType> persistenceDiagram() const
+  {
+    PersistenceDiagram<DataType> D;
+    D.setDimension( 0 );
+
+    auto n         = this->size();
+    auto remaining = this->numChildren();
+
+    // Oldest creator of all components that have been merged into every
+    // vertex so far; vertices without children create a component.
+    std::vector<Index> creator( n );
+    std::iota( creator.begin(), creator.end(), Index(0) );
+
+    std::vector<Index> stack;
+
+    for( std::size_t v = 0; v < n; v++ )
+    {
+      if( remaining[v] == 0 )
+        stack.push_back( Index(v) );
+    }
+
+    // Since every vertex precedes its parent, it suffices to process the
+    // vertices once all of their children have been processed.
+    while( !stack.empty() )
+    {
+      auto v = stack.back();
+      stack.pop_back();
+
+      auto c = creator[v];
+
+      if( this->isRoot(v) )
+      {
+        D.add( _values[c] );
+        continue;
+      }
+
+      auto p = _parent[v];
+
+      if( creator[p] == p )
+        creator[p] = c;
+      else
+      {
+        auto older   = this->precedes( c, creator[p] ) ? c : creator[p];
+        auto younger = older == c ? creator[p] : c;
+
+        if( _values[younger] != _values[p] )
+          D.add( _values[younger], _values[p] );
+
+        creator[p] = older;
+      }
+
+      if( --remaining[p] == 0 )
+        stack.push_back( p );
+    }
+
+    return D;
+  }
+
+  /**
+    Adds an edge between two vertices to the tree. The paths from both
+    vertices to their roots are merged above the later vertex of the
+    edge, so that the result is the merge tree of the graph that also
+    contains the edge. This is used for combining the merge trees of
+    different parts of a graph.
+  */
+
+  void addEdge( Index u, Index v ) noexcept
+  {
+    while( u != v )
+    {
+      if( this->precedes( v, u ) )
+        std::swap( u, v );
+
+      auto p = _parent[u];
+
+      if( p == u )
+      {
+        _parent[u] = v;
+        break;
+      }
+      else if( this->precedes( v, p ) )
+      {
+        _parent[u] = v;
+        u          = v;
+        v          = p;
+      }
+      else
+        u = p;
+    }
+  }
+
+  /** Sets the parent of a vertex */
+  void setParent( Index v, Index p ) noexcept
+  {
+    _parent[v] = p;
+  }
+
+private:
+
+  /** Values of all vertices */
+  std::vector<DataType> _values;
+
+  /** Parent of every vertex; roots are their own parents */
+  std::vector<Index> _parent;
+
+  /** Comparison functor for values */
+  Compare _compare;
+
+  /** Comparison functor for indices, used to break ties */
+  IndexCompare _indexCompare;
+};
+
+/**
+  Calculates the merge tree of a scalar field on a graph. The vertices
+  are split into contiguous ranges of indices (domains), whose merge
+  trees are calculated in parallel, by sorting the vertices of every
+  domain once and sweeping over them with a Union--Find data structure.
+  Afterwards, the trees are stitched together along the edges between
+  different domains (see MergeTree::addEdge()).
+
+  Since neighbouring vertices often have similar indices, e.g. for grids
+  and for most meshes, only few edges connect different domains.
+
+  @param G          Scalar graph
+  @param numDomains Number of domains; if zero, the number of hardware
+                    threads is used, unless this results in domains
+                    with only few vertices
+
+  @tparam Compare      Comparison functor that determines the order of
+                       the vertices; std::less results in the join tree,
+                       while std::greater results in the split tree
+  @tparam IndexCompare Comparison functor for breaking ties
+*/
+
+template <class Compare, class IndexCompare, class DataType, class Index>
+MergeTree<DataType, Compare, Index, IndexCompare> calculateMergeTree( const ScalarGraph<DataType, Index>& G, unsigned numDomains = 0 )
+{
+  MergeTree<DataType, Compare, Index, IndexCompare> T( G.values() );
+
+  auto n = G.size();
+
+  // Domains that are too small are not worth their stitching costs, so
+  // the automated choice ensures that they contain sufficiently many
+  // vertices.
+  if( numDomains == 0 )
+  {
+    std::size_t minimumDomainSize = 4096;
+
+    numDomains = std::max( 1u, std::thread::hardware_concurrency() );
+    numDomains = unsigned( std::min( std::size_t( numDomains ), std::max( std::size_t(1), n / minimumDomainSize ) ) );
+  }
+  else
+    numDomains = unsigned( std::min( std::size_t( numDomains ), std::max( std::size_t(1), n ) ) );
+
+  // Since the components of every domain only contain vertices of that
+  // domain, all domains may use the same Union--Find data structure.
+  DenseUnionFind<Index> uf( n );
+
+  std::vector< std::vector< std::pair<Index, Index> > > boundaryEdges( numDomains );
+
+  #pragma omp parallel for schedule(dynamic)
+  for( long d = 0; d < long( numDomains ); d++ )
+  {
+    auto begin = Index( n *   std::size_t(d)       / numDomains );
+    auto end   = Index( n * ( std::size_t(d) + 1 ) / numDomains );
+
+    std::vector<Index> order( end - begin );
+    std::iota( order.begin(), order.end(), begin );
+
+    std::sort( order.begin(), order.end(),
+               [&T] ( Index u, Index v )
+               {
+                 return T.precedes( u, v );
+               } );
+
+    // Every component is represented by the vertex that has been added
+    // last; all other components are merged into the current vertex.
+    for( auto&& v : order )
+    {
+      for( auto it = G.beginNeighbours(v); it != G.endNeighbours(v); ++it )
+      {
+        auto u = *it;
+
+        if( !T.precedes( u, v ) )
+          continue;
+
+        if( u < begin || u >= end )
+        {
+          boundaryEdges[ std::size_t(d) ].push_back( std::make_pair( u, v ) );
+          continue;
+        }
+
+        auto r = uf.find( u );
+
+        if( r != v )
+        {
+          T.setParent( r, v );
+          uf.merge( r, v );
+        }
+      }
+    }
+  }
+
+  for( auto&& edges : boundaryEdges )
+  {
+    for( auto&& edge : edges )
+      T.addEdge( edge.first, edge.second );
+  }
+
+  return T;
+}
+
+/** Calculates the join tree, i.e. the merge tree of the sublevel sets */
+template <class DataType, class Index>
+MergeTree<DataType, std::less<DataType>, Index, std::less<Index> > calculateJoinTree( const ScalarGraph<DataType, Index>& G, unsigned numDomains = 0 )
+{
+  return calculateMergeTree< std::less<DataType>, std::less<Index> >( G, numDomains );
+}
+
+/**
+  Calculates the split tree, i.e. the merge tree of the superlevel sets.
+  Ties are broken in the opposite direction of the join tree.
+*/
+
+template <class DataType, class Index>
+MergeTree<DataType, std::greater<DataType>, Index, std::greater<Index> > calculateSplitTree( const ScalarGraph<DataType, Index>& G, unsigned numDomains = 0 )
+{
+  return calculateMergeTree< std::greater<DataType>, std::greater<Index> >( G, numDomains );
+}
+
+} // namespace topology
+
+} // namespace aleph
+
+#endif
@@ -384,6 +384,38 @@ public:
     return result;
   }
 
+  /**
+    Traverses the link of a vertex without allocating any memory. The
+    functor is called for every neighbour of the vertex, in the order
+    that is also used by link(), with two arguments: the neighbouring
+    vertex, and a flag that indicates whether the neighbour is part of
+    the same face as the next neighbour, i.e. whether the two of them
+    are connected in the link of a triangulated mesh.
+  */
+
+  template <class Functor> void traverseLink( Index id, Functor f ) const
+  {
+    auto&& vertex = this->getVertex( id );
+    auto start    = vertex->edge.get();
+    auto edge     = start;
+
+    if( !edge )
+      return;
+
+    for( ;; )
+    {
+      auto next      = edge->prev->pair.get();
+      bool continues = next != start && next->pair->vertex->id == id;
+
+      f( static_cast<const Vertex&>( *edge->vertex ), edge->face && ( continues || next == start ) );
+
+      if( !continues )
+        break;
+
+      edge = next;
+    }
+  }
+
   std::vector<Index> getLowerNeighbours( Index id ) const noexcept
   {
     auto&& vertex     = this->getVertex( id );
@@ -2,12 +2,10 @@
 #define ALEPH_TOPOLOGY_MORSE_SMALE_COMPLEX__
 
 #include <algorithm>
+#include <stdexcept>
 #include <vector>
 
-// TODO: Remove after debugging
-#include <iostream>
-
-#include <aleph/topology/UnionFind.hh>
+#include <cstddef>
 
 namespace aleph
 {
@@ -15,103 +13,248 @@ namespace aleph
 namespace topology
 {
 
+/**
+  @class MorseSmaleComplex
+  @brief Critical points and manifolds of a scalar field on a mesh
+
+  Classifies all vertices of a triangulated mesh according to the data
+  stored at them and calculates the ascending and descending manifolds
+  of the extremal points, whose intersections are the cells of the
+  Morse--Smale complex.
+
+  Vertices are ordered by their data, with ties being broken by their
+  IDs, so that no two vertices have the same value. A vertex is then
+  classified by counting the connected components of its lower link
+  and its upper link, i.e. the neighbours that precede or succeed the
+  vertex. Since the vertices are independent of each other, they are
+  classified in parallel, and the links are traversed without creating
+  any additional containers (see Mesh::traverseLink()).
+
+  The manifolds follow the steepest neighbour of every vertex, i.e. the
+  lowest or highest neighbour, respectively, until an extremal point is
+  reached. Path compression ensures that every path is traversed once.
+*/
+
 template <class Mesh> class MorseSmaleComplex
 {
 public:
+  using Index = typename Mesh::Index;
+
+  enum class Type
+  {
+    Regular,
+    Minimum,
+    Maximum,
+    Saddle
+  };
+
   void operator()( const Mesh& M )
   {
-    std::cerr << "\n";
+    _vertices = M.vertices();
+    std::sort( _vertices.begin(), _vertices.end() );
+
+    auto n = _vertices.size();
 
-    auto&& vertices = M.vertices();
+    _types.assign( n, Type::Regular );
+    _multiplicities.assign( n, 0 );
+    _minima.resize( n );
+    _maxima.resize( n );
 
-    for( auto&& vertex : vertices )
+    #pragma omp parallel for
+    for( long i = 0; i < long( n ); i++ )
     {
-      auto higherNeigbours = M.getHigherNeighbours( vertex );
-      auto lowerNeighbours = M.getLowerNeighbours( vertex );
+      auto id   = _vertices[ std::size_t(i) ];
+      auto data = M.data( id );
 
+      auto precedes = [&data, &id] ( const typename Mesh::Vertex& v )
+      {
+        return v.data < data || ( !( data < v.data ) && v.id < id );
+      };
+
+      // Number of runs of lower and upper neighbours in the link. Since
+      // the link is a cycle for interior vertices, the first neighbour
+      // is handled after all other neighbours have been visited.
       std::size_t nl = 0;
       std::size_t nu = 0;
 
-      std::tie( nl, nu ) = contiguousSegments( M, vertex );
+      bool first         = true;
+      bool firstLower    = false;
+      bool previousLower = false;
+      bool adjacent      = false;
 
-      std::cerr << "[" << vertex << "]: ";
+      const typename Mesh::Vertex* lowest  = nullptr;
+      const typename Mesh::Vertex* highest = nullptr;
 
-      if( higherNeigbours.empty() )
-        std::cerr << "Maximum\n";
-      else if( lowerNeighbours.empty() )
-        std::cerr << "Minimum\n";
-      else
+      M.traverseLink( id, [&] ( const typename Mesh::Vertex& v, bool adjacentToNext )
       {
-        std::cerr << "Saddle\n";
-        std::cerr << "  +: ";
-        for( auto&& n : higherNeigbours )
-          std::cerr << n << " " ;
-        std::cerr << "\n";
-
-        std::cerr << "  -: ";
-        for( auto&& n : lowerNeighbours )
-          std::cerr << n << " " ;
-        std::cerr << "\n";
+        bool lower = precedes( v );
+
+        if( first )
+        {
+          first      = false;
+          firstLower = lower;
+        }
+        else if( !adjacent || lower != previousLower )
+        {
+          if( lower )
+            ++nl;
+          else
+            ++nu;
+        }
+
+        if( lower && ( !lowest || v.data < lowest->data || ( !( lowest->data < v.data ) && v.id < lowest->id ) ) )
+          lowest = &v;
+        else if( !lower && ( !highest || highest->data < v.data || ( !( v.data < highest->data ) && highest->id < v.id ) ) )
+          highest = &v;
+
+        previousLower = lower;
+        adjacent      = adjacentToNext;
+      } );
+
+      if( !first && ( !adjacent || firstLower != previousLower ) )
+      {
+        if( firstLower )
+          ++nl;
+        else
+          ++nu;
       }
 
-      std::cerr << "  nl: " << nl << "\n"
-                << "  nu: " << nu << "\n\n";
+      // A link that consists of a single run is not split anywhere, so
+      // the previous loop does not count it.
+      if( nl == 0 && lowest )
+        nl = 1;
+
+      if( nu == 0 && highest )
+        nu = 1;
+
+      auto& type = _types[ std::size_t(i) ];
 
+      if( nl == 0 )
+        type = Type::Minimum;
+      else if( nu == 0 )
+        type = Type::Maximum;
+      else if( nl != 1 || nu != 1 )
+      {
+        type                              = Type::Saddle;
+        _multiplicities[ std::size_t(i) ] = std::max( nl, nu ) - 1;
+      }
+
+      _minima[ std::size_t(i) ] = lowest  ? this->index( lowest->id  ) : std::size_t(i);
+      _maxima[ std::size_t(i) ] = highest ? this->index( highest->id ) : std::size_t(i);
     }
+
+    compress( _minima );
+    compress( _maxima );
+  }
+
+  /** @returns IDs of all vertices, in ascending order */
+  const std::vector<Index>& vertices() const noexcept
+  {
+    return _vertices;
+  }
+
+  /** @returns Type of a vertex */
+  Type type( Index id ) const
+  {
+    return _types[ this->index( id ) ];
+  }
+
+  /**
+    @returns Multiplicity of a saddle, i.e. the number of components by
+    which its lower or upper link is split, minus one. For all other
+    vertices, the multiplicity is zero.
+  */
+
+  std::size_t multiplicity( Index id ) const
+  {
+    return _multiplicities[ this->index( id ) ];
+  }
+
+  /** @returns IDs of all vertices of the given type, in ascending order */
+  std::vector<Index> criticalPoints( Type type ) const
+  {
+    std::vector<Index> result;
+
+    for( std::size_t i = 0; i < _vertices.size(); i++ )
+    {
+      if( _types[i] == type )
+        result.push_back( _vertices[i] );
+    }
+
+    return result;
   }
-private:
 
   /**
-    Calculates the number of contiguous segments in the link of
-    a vertex, with respect to the given mesh.
+    @returns ID of the minimum whose ascending manifold contains the
+    vertex, i.e. the minimum that is reached by steepest descent
   */
 
-  static std::pair<std::size_t, std::size_t> contiguousSegments( const Mesh& M, typename Mesh::Index id )
+  Index ascendingManifold( Index id ) const
   {
-    using Index = typename Mesh::Index;
+    return _vertices[ _minima[ this->index( id ) ] ];
+  }
 
-    auto data = M.data(id);
-    auto link = M.link(id);
+  /**
+    @returns ID of the maximum whose descending manifold contains the
+    vertex, i.e. the maximum that is reached by steepest ascent
+  */
 
-    std::vector<Index> upperLink;
-    std::vector<Index> lowerLink;
+  Index descendingManifold( Index id ) const
+  {
+    return _vertices[ _maxima[ this->index( id ) ] ];
+  }
 
-    std::copy_if( link.begin(), link.end(), std::back_inserter( upperLink ), [&data, &M] ( Index& u ) { return M.data(u) >= data; } );
-    std::copy_if( link.begin(), link.end(), std::back_inserter( lowerLink ), [&data, &M] ( Index& u ) { return M.data(u) <= data; } );
+private:
 
-    auto&& numConnectedComponents = [&M, &id] ( const std::vector<Index>& link )
-    {
-      auto curr = link.begin();
-      auto next = std::next( curr );
+  /** Maps a vertex ID to its position in the sorted list of IDs */
+  std::size_t index( Index id ) const
+  {
+    auto it = std::lower_bound( _vertices.begin(), _vertices.end(), id );
+    if( it == _vertices.end() || *it != id )
+      throw std::runtime_error( "Unknown vertex ID" );
 
-      UnionFind<Index> uf( link.begin(), link.end() );
+    return std::size_t( std::distance( _vertices.begin(), it ) );
+  }
 
-      for( ; curr != link.end(); )
-      {
-        if( next == link.end() )
-          next = link.begin();
+  /**
+    Replaces the target of every vertex by the end of the path that is
+    formed by following the targets, i.e. by a vertex whose target is
+    the vertex itself. Every path is shortened while traversing it, so
+    the total costs are linear in the number of vertices.
+  */
 
-        auto u    = id;
-        auto v    = *curr++;
-        auto w    = *next++;
+  static void compress( std::vector<std::size_t>& targets )
+  {
+    for( std::size_t i = 0; i < targets.size(); i++ )
+    {
+      auto root = i;
+      while( targets[root] != root )
+        root = targets[root];
 
-        if( M.hasEdge(u,v) )
-        {
-          if( M.hasEdge(v,w) )
-            uf.merge(v,w);
-        }
-        else
-          throw std::runtime_error( "Edge to link centre vertex does not exist" );
+      auto v = i;
+      while( targets[v] != root )
+      {
+        auto next  = targets[v];
+        targets[v] = root;
+        v          = next;
       }
+    }
+  }
 
-      std::vector<Index> roots;
-      uf.roots( std::back_inserter(roots) );
+  /** IDs of all vertices in ascending order */
+  std::vector<Index> _vertices;
 
-      return roots.size();
-    };
+  /** Type of every vertex */
+  std::vector<Type> _types;
 
-    return std::make_pair( numConnectedComponents( lowerLink ), numConnectedComponents( upperLink ) );
-  }
+  /** Multiplicity of every vertex; only non-zero for saddles */
+  std::vector<std::size_t> _multiplicities;
+
+  /** Minimum that is reached from every vertex by steepest descent */
+  std::vector<std::size_t> _minima;
+
+  /** Maximum that is reached from every vertex by steepest ascent */
+  std::vector<std::size_t> _maxima;
 };
 
 } // namespace topology
@@ -7,7 +7,13 @@
 #include <aleph/topology/SimplicialComplex.hh>
 
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
 #include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace aleph
@@ -16,30 +22,242 @@ namespace aleph
 namespace topology
 {
 
+namespace detail
+{
+
+/**
+  Desired amount of work, i.e. the number of rows, points, or expected
+  edges, that is processed by a single chunk of the parallel generators.
+  This is a constant, so that the results only depend on the seed, but
+  not on the number of threads.
+*/
+
+constexpr std::uint64_t workPerChunk = std::uint64_t(1) << 16;
+
+/** Creates an independent random number stream for a chunk of a generator */
+inline std::mt19937_64 makeStream( unsigned seed, unsigned stream, unsigned chunk )
+{
+  std::seed_seq sequence = { seed, stream, chunk };
+  return std::mt19937_64( sequence );
+}
+
+/**
+  Partitions a range of rows of a matrix of vertex pairs into chunks of
+  roughly equal amounts of work. The work of a row consists of visiting
+  the row itself and of creating the expected number of sampled pairs,
+  so sparse graphs do not result in a large number of chunks.
+
+  @param begin     First row
+  @param end       Row after the last row
+  @param p         Probability of every pair
+  @param rowLength Functor for determining the number of pairs in a row
+
+  @returns Boundaries of the chunks, including the beginning and the end
+  of the range
+*/
+
+template <class RowLength> std::vector<unsigned> makeChunks( unsigned begin, unsigned end, double p, RowLength rowLength )
+{
+  std::vector<unsigned> boundaries = { begin };
+  double work                      = 0.0;
+
+  p = std::max( 0.0, std::min( p, 1.0 ) );
+
+  for( unsigned u = begin; u < end; u++ )
+  {
+    work += 1.0 + p * double( rowLength( u ) );
+
+    if( work >= double( workPerChunk ) && u + 1 < end )
+    {
+      boundaries.push_back( u + 1 );
+      work = 0.0;
+    }
+  }
+
+  boundaries.push_back( end );
+  return boundaries;
+}
+
+/**
+  Samples every pair of a range of rows with probability \f$p\f$, using
+  the geometric skipping approach by Batagelj and Brandes. Instead of
+  performing a Bernoulli trial for every pair, the number of pairs that
+  are skipped until the next success is drawn directly. Hence, the run
+  time is linear in the number of rows and the number of sampled pairs.
+
+  @param begin       First row
+  @param end         Row after the last row
+  @param p           Success probability for every pair
+  @param rng         Random number generator
+  @param rowLength   Functor for determining the number of pairs in a row
+  @param firstColumn Functor for determining the first column of a row
+  @param callback    Functor that is called for every sampled pair
+
+  @see V. Batagelj and U. Brandes: "Efficient generation of large random networks"
+*/
+
+template <class RNG, class RowLength, class FirstColumn, class Callback>
+void sampleRows( unsigned begin, unsigned end,
+                 double p,
+                 RNG& rng,
+                 RowLength rowLength,
+                 FirstColumn firstColumn,
+                 Callback callback )
+{
+  if( p <= 0.0 )
+    return;
+
+  std::uniform_real_distribution<double> uniform( 0.0, 1.0 );
+
+  auto logq = std::log1p( -p );
+  auto u    = begin;
+
+  std::uint64_t position = 0;
+
+  while( u < end )
+  {
+    if( p < 1.0 )
+    {
+      auto skip = std::floor( std::log1p( -uniform( rng ) ) / logq );
+
+      // Very large skips always leave the range, but they must not
+      // overflow the position.
+      if( skip >= double( std::numeric_limits<std::uint32_t>::max() ) )
+        skip = double( std::numeric_limits<std::uint32_t>::max() );
+
+      position += static_cast<std::uint64_t>( skip );
+    }
+
+    while( u < end && position >= rowLength( u ) )
+    {
+      position -= rowLength( u );
+      ++u;
+    }
+
+    if( u >= end )
+      break;
+
+    callback( u, static_cast<unsigned>( firstColumn( u ) + position ) );
+    ++position;
+  }
+}
+
+/**
+  Samples all pairs \f$(u,v)\f$ with \f$u < v\f$ of a set of vertices in
+  parallel. The vertices are assumed to have consecutive indices.
+
+  @param offset Index of the first vertex
+  @param n      Number of vertices
+  @param p      Probability of every pair
+  @param seed   Seed of the generator
+  @param stream Index of the random number stream; different streams
+                yield independent samples for the same seed
+
+  @returns Sampled pairs, in lexicographical order
+*/
+
+inline std::vector< std::pair<unsigned, unsigned> > samplePairs( unsigned offset, unsigned n, double p, unsigned seed, unsigned stream = 0 )
+{
+  auto rowLength   = [n]      ( unsigned u ) { return std::uint64_t( n - 1 - u ); };
+  auto firstColumn = [offset] ( unsigned u ) { return std::uint64_t( offset + u + 1 ); };
+  auto chunks      = makeChunks( 0, n, p, rowLength );
+
+  std::vector< std::vector< std::pair<unsigned, unsigned> > > pairs( chunks.size() - 1 );
+
+  #pragma omp parallel for schedule(dynamic)
+  for( long c = 0; c < long( pairs.size() ); c++ )
+  {
+    auto rng = makeStream( seed, stream, unsigned(c) );
+
+    sampleRows( chunks[ std::size_t(c) ], chunks[ std::size_t(c) + 1 ], p, rng,
+                rowLength, firstColumn,
+                [&pairs, offset, c] ( unsigned u, unsigned v )
+                {
+                  pairs[ std::size_t(c) ].push_back( std::make_pair( offset + u, v ) );
+                } );
+  }
+
+  std::vector< std::pair<unsigned, unsigned> > result;
+
+  for( auto&& chunk : pairs )
+    result.insert( result.end(), chunk.begin(), chunk.end() );
+
+  return result;
+}
+
+/**
+  Samples all pairs \f$(u,v)\f$ of two disjoint sets of vertices in
+  parallel. The vertices of each set are assumed to have consecutive
+  indices.
+
+  @returns Sampled pairs, in lexicographical order
+*/
+
+inline std::vector< std::pair<unsigned, unsigned> > samplePairs( unsigned offsetU, unsigned m,
+                                                                 unsigned offsetV, unsigned n,
+                                                                 double p, unsigned seed, unsigned stream = 0 )
+{
+  auto rowLength   = [n]       ( unsigned )   { return std::uint64_t( n ); };
+  auto firstColumn = [offsetV] ( unsigned )   { return std::uint64_t( offsetV ); };
+  auto chunks      = makeChunks( 0, m, p, rowLength );
+
+  std::vector< std::vector< std::pair<unsigned, unsigned> > > pairs( chunks.size() - 1 );
+
+  #pragma omp parallel for schedule(dynamic)
+  for( long c = 0; c < long( pairs.size() ); c++ )
+  {
+    auto rng = makeStream( seed, stream, unsigned(c) );
+
+    sampleRows( chunks[ std::size_t(c) ], chunks[ std::size_t(c) + 1 ], p, rng,
+                rowLength, firstColumn,
+                [&pairs, offsetU, c] ( unsigned u, unsigned v )
+                {
+                  pairs[ std::size_t(c) ].push_back( std::make_pair( offsetU + u, v ) );
+                } );
+  }
+
+  std::vector< std::pair<unsigned, unsigned> > result;
+
+  for( auto&& chunk : pairs )
+    result.insert( result.end(), chunk.begin(), chunk.end() );
+
+  return result;
+}
+
+/** @returns Non-deterministic seed for generators that do not get one */
+inline unsigned randomSeed()
+{
+  std::random_device rd;
+  return rd();
+}
+
+} // namespace detail
+
 /**
   Generates an Erdős--Rényi graph with n vertices and a link probability
   of p. Note that the graph will be returned as an unweighted simplicial
   complex.
+
+  The graph is generated in time proportional to the number of vertices
+  and edges, in parallel. For a given seed, the graph is the same for
+  every number of threads.
 */
 
-auto generateErdosRenyiGraph( unsigned n, double p ) -> SimplicialComplex< Simplex<short, unsigned> >
+inline auto generateErdosRenyiGraph( unsigned n, double p, unsigned seed = detail::randomSeed() ) -> SimplicialComplex< Simplex<short, unsigned> >
 {
   using S = Simplex<short, unsigned>;
   using K = SimplicialComplex<S>;
 
-  std::vector<S> simplices;
+  auto edges = detail::samplePairs( 0, n, p, seed );
 
-  std::random_device rd;
-  std::mt19937 mt( rd() );
-  std::uniform_real_distribution<> distribution( 0.0, 1.0 );
+  std::vector<S> simplices;
+  simplices.reserve( n + edges.size() );
 
   for( unsigned i = 0; i < n; i++ )
     simplices.push_back( S( i ) );
 
-  for( unsigned u = 0; u < n; u++ )
-    for( unsigned v = u+1; v < n; v++ )
-      if( distribution( mt ) < p )
-        simplices.push_back( S( {u,v} ) );
+  for( auto&& edge : edges )
+    simplices.push_back( S( {edge.first, edge.second} ) );
 
   return K( simplices.begin(), simplices.end() );
 }
@@ -49,42 +267,337 @@ auto generateErdosRenyiGraph( unsigned n, double p ) -> SimplicialComplex< Simpl
   probability of p. In contrast to Erdős--Rényi graphs, here a
   weight is assigned according to a number of Bernoulli trials
   with success probability p.
+
+  Since the weight of an edge follows a geometric distribution, it is
+  drawn directly for every edge, so the graph is generated in time
+  proportional to the number of vertices and edges.
 */
 
-auto generateWeightedRandomGraph( unsigned n, double p ) -> SimplicialComplex< Simplex<unsigned, unsigned> >
+inline auto generateWeightedRandomGraph( unsigned n, double p, unsigned seed = detail::randomSeed() ) -> SimplicialComplex< Simplex<unsigned, unsigned> >
 {
   using S = Simplex<unsigned, unsigned>;
   using K = SimplicialComplex<S>;
 
-  std::vector<S> simplices;
+  if( p >= 1.0 )
+    throw std::runtime_error( "Link probability of weighted random graph must be less than one" );
 
-  std::random_device rd;
-  std::mt19937 mt( rd() );
-  std::uniform_real_distribution<> distribution( 0.0, 1.0 );
+  auto edges = detail::samplePairs( 0, n, p, seed );
+
+  std::vector<S> simplices( n + edges.size() );
+
+  for( unsigned i = 0; i < n; i++ )
+    simplices[i] = S( i );
+
+  // Repeated Bernoulli trials: until the first failure occurs, the
+  // edge weight is increased. The first trial is successful because
+  // the edge exists.
+  #pragma omp parallel
+  {
+    std::geometric_distribution<unsigned> geometric( 1.0 - p );
+
+    #pragma omp for schedule(static)
+    for( long c = 0; c < long( edges.size() / detail::workPerChunk + 1 ); c++ )
+    {
+      auto rng   = detail::makeStream( seed, 1, unsigned(c) );
+      auto begin = std::size_t(c) * detail::workPerChunk;
+      auto end   = std::min( edges.size(), begin + detail::workPerChunk );
+
+      for( auto i = begin; i < end; i++ )
+        simplices[n + i] = S( {edges[i].first, edges[i].second}, 1 + geometric( rng ) );
+    }
+  }
+
+  std::sort( simplices.begin(), simplices.end(), aleph::topology::filtrations::Data<S>() );
+
+  return K( simplices.begin(), simplices.end() );
+}
+
+/**
+  Generates a random geometric graph. The graph contains n vertices that
+  are distributed uniformly in the unit cube of the given dimension. Two
+  vertices are connected if their Euclidean distance is at most r. The
+  distance is used as the weight of the edge, and the simplicial complex
+  is sorted accordingly.
+
+  Neighbours are determined using a grid of cells whose side length is
+  at least r, so the graph is generated in time proportional to the
+  number of vertices and edges for a fixed dimension.
+*/
+
+inline auto generateRandomGeometricGraph( unsigned n, double r, unsigned dimension = 2, unsigned seed = detail::randomSeed() ) -> SimplicialComplex< Simplex<double, unsigned> >
+{
+  using S = Simplex<double, unsigned>;
+  using K = SimplicialComplex<S>;
+
+  if( dimension == 0 )
+    throw std::runtime_error( "Dimension of random geometric graph must be positive" );
+
+  // Sample points -----------------------------------------------------
+
+  std::vector<double> points( std::size_t( n ) * dimension );
+
+  auto numChunks = long( std::size_t( n ) / detail::workPerChunk + 1 );
+
+  #pragma omp parallel for schedule(static)
+  for( long c = 0; c < numChunks; c++ )
+  {
+    auto rng   = detail::makeStream( seed, 0, unsigned(c) );
+    auto begin = std::size_t(c) * detail::workPerChunk * dimension;
+    auto end   = std::min( points.size(), begin + detail::workPerChunk * dimension );
+
+    std::uniform_real_distribution<double> uniform( 0.0, 1.0 );
+
+    for( auto i = begin; i < end; i++ )
+      points[i] = uniform( rng );
+  }
+
+  std::vector<S> simplices;
+  simplices.reserve( n );
 
   for( unsigned i = 0; i < n; i++ )
     simplices.push_back( S( i ) );
 
-  for( unsigned u = 0; u < n; u++ )
+  if( r <= 0.0 )
+    return K( simplices.begin(), simplices.end() );
+
+  // Assign points to cells --------------------------------------------
+
+  auto m = std::uint64_t( std::max( 1.0, std::floor( 1.0 / r ) ) );
+
+  {
+    double numCells = std::pow( double( m ), double( dimension ) );
+    if( numCells >= double( std::numeric_limits<std::uint64_t>::max() ) )
+      throw std::runtime_error( "Radius of random geometric graph is too small for the given dimension" );
+  }
+
+  auto cellCoordinate = [&points, dimension, m] ( unsigned i, unsigned k )
+  {
+    return std::min( m - 1, std::uint64_t( points[ std::size_t(i) * dimension + k ] * double( m ) ) );
+  };
+
+  auto cellIndex = [&cellCoordinate, dimension, m] ( unsigned i )
+  {
+    std::uint64_t index = 0;
+    for( unsigned k = 0; k < dimension; k++ )
+      index = index * m + cellCoordinate( i, k );
+
+    return index;
+  };
+
+  std::vector< std::pair<std::uint64_t, unsigned> > cells( n );
+
+  for( unsigned i = 0; i < n; i++ )
+    cells[i] = std::make_pair( cellIndex(i), i );
+
+  std::sort( cells.begin(), cells.end() );
+
+  std::unordered_map< std::uint64_t, std::pair<std::size_t, std::size_t> > cellRanges;
+
+  for( std::size_t i = 0; i < cells.size(); )
+  {
+    auto j = i;
+    while( j < cells.size() && cells[j].first == cells[i].first )
+      ++j;
+
+    cellRanges[ cells[i].first ] = std::make_pair( i, j );
+    i = j;
+  }
+
+  // Connect points of adjacent cells ----------------------------------
+
+  std::size_t numOffsets = 1;
+  for( unsigned k = 0; k < dimension; k++ )
+    numOffsets *= 3;
+
+  std::vector< std::vector<S> > edges( static_cast<std::size_t>( numChunks ) );
+
+  #pragma omp parallel for schedule(dynamic)
+  for( long c = 0; c < numChunks; c++ )
   {
-    for( unsigned v = u+1; v < n; v++ )
+    auto begin = unsigned( std::size_t(c) * detail::workPerChunk );
+    auto end   = unsigned( std::min( std::size_t( n ), std::size_t( begin ) + detail::workPerChunk ) );
+
+    std::vector<std::uint64_t> neighbour( dimension );
+
+    for( unsigned i = begin; i < end; i++ )
     {
-      unsigned w = 0;
+      for( std::size_t offset = 0; offset < numOffsets; offset++ )
+      {
+        bool valid = true;
+        auto o     = offset;
 
-      // Repeated Bernoulli trials: until the first failure occurs, the
-      // edge weight is increased.
-      while( distribution( mt ) < p )
-        ++w;
+        for( unsigned k = 0; k < dimension; k++, o /= 3 )
+        {
+          auto coordinate = std::int64_t( cellCoordinate( i, k ) ) + std::int64_t( o % 3 ) - 1;
+          valid           = valid && coordinate >= 0 && coordinate < std::int64_t( m );
+          neighbour[k]    = std::uint64_t( coordinate );
+        }
 
-      if( w != 0 )
-        simplices.push_back( S( {u,v}, w ) );
+        if( !valid )
+          continue;
+
+        std::uint64_t index = 0;
+        for( unsigned k = 0; k < dimension; k++ )
+          index = index * m + neighbour[k];
+
+        auto it = cellRanges.find( index );
+        if( it == cellRanges.end() )
+          continue;
+
+        for( auto l = it->second.first; l < it->second.second; l++ )
+        {
+          auto j = cells[l].second;
+          if( j <= i )
+            continue;
+
+          double d = 0.0;
+          for( unsigned k = 0; k < dimension; k++ )
+          {
+            auto x = points[ std::size_t(i) * dimension + k ] - points[ std::size_t(j) * dimension + k ];
+            d     += x * x;
+          }
+
+          d = std::sqrt( d );
+
+          if( d <= r )
+            edges[ std::size_t(c) ].push_back( S( {i,j}, d ) );
+        }
+      }
     }
   }
 
+  for( auto&& chunk : edges )
+    simplices.insert( simplices.end(), chunk.begin(), chunk.end() );
+
   std::sort( simplices.begin(), simplices.end(), aleph::topology::filtrations::Data<S>() );
 
   return K( simplices.begin(), simplices.end() );
+}
+
+/**
+  Generates a graph according to the Barabási--Albert model of
+  preferential attachment. Vertices are added one after the other and
+  connected to m existing vertices, which are chosen with a probability
+  that is proportional to their degree. Multiple edges and self-loops,
+  which the model may create, are merged and removed, respectively.
+
+  Every simplex is weighted by the time at which it has been added to
+  the graph, i.e. the index of its largest vertex. Hence, the simplicial
+  complex describes the growth of the graph.
+
+  The graph is generated in time proportional to the number of edges,
+  using the approach by Batagelj and Brandes. Preferential attachment
+  is inherently sequential, so this generator does not run in parallel.
+*/
 
+inline auto generateBarabasiAlbertGraph( unsigned n, unsigned m, unsigned seed = detail::randomSeed() ) -> SimplicialComplex< Simplex<unsigned, unsigned> >
+{
+  using S = Simplex<unsigned, unsigned>;
+  using K = SimplicialComplex<S>;
+
+  if( m == 0 )
+    throw std::runtime_error( "Number of edges per vertex must be positive" );
+
+  auto rng = detail::makeStream( seed, 0, 0 );
+
+  // Every entry of this vector corresponds to one end of an edge, so a
+  // uniformly chosen entry is a vertex chosen proportional to its degree.
+  std::vector<unsigned> ends( 2 * std::size_t( n ) * m );
+
+  for( unsigned v = 0; v < n; v++ )
+  {
+    for( unsigned i = 0; i < m; i++ )
+    {
+      auto k = 2 * ( std::size_t( v ) * m + i );
+
+      std::uniform_int_distribution<std::size_t> uniform( 0, k );
+
+      ends[k]     = v;
+      ends[k + 1] = ends[ uniform( rng ) ];
+    }
+  }
+
+  std::vector< std::pair<unsigned, unsigned> > edges;
+  edges.reserve( ends.size() / 2 );
+
+  for( std::size_t k = 0; k < ends.size(); k += 2 )
+  {
+    auto u = std::min( ends[k], ends[k + 1] );
+    auto v = std::max( ends[k], ends[k + 1] );
+
+    if( u != v )
+      edges.push_back( std::make_pair( u, v ) );
+  }
+
+  std::sort( edges.begin(), edges.end() );
+  edges.erase( std::unique( edges.begin(), edges.end() ), edges.end() );
+
+  std::vector<S> simplices;
+  simplices.reserve( n + edges.size() );
+
+  for( unsigned i = 0; i < n; i++ )
+    simplices.push_back( S( i, i ) );
+
+  for( auto&& edge : edges )
+    simplices.push_back( S( {edge.first, edge.second}, edge.second ) );
+
+  std::sort( simplices.begin(), simplices.end(), aleph::topology::filtrations::Data<S>() );
+
+  return K( simplices.begin(), simplices.end() );
+}
+
+/**
+  Generates a graph according to a stochastic block model. Vertices are
+  partitioned into blocks of the given sizes, and numbered consecutively
+  block by block. Two vertices of blocks a and b are connected with the
+  probability that is stored in the corresponding entry of the matrix of
+  probabilities. Only the upper triangular part of the matrix is used.
+
+  Every block pair is sampled using geometric skipping, in parallel, so
+  the graph is generated in time proportional to the number of vertices
+  and edges. Note that the graph will be returned as an unweighted
+  simplicial complex.
+*/
+
+inline auto generateStochasticBlockModel( const std::vector<unsigned>& blockSizes,
+                                          const std::vector< std::vector<double> >& probabilities,
+                                          unsigned seed = detail::randomSeed() ) -> SimplicialComplex< Simplex<short, unsigned> >
+{
+  using S = Simplex<short, unsigned>;
+  using K = SimplicialComplex<S>;
+
+  auto numBlocks = unsigned( blockSizes.size() );
+
+  if( probabilities.size() != numBlocks )
+    throw std::runtime_error( "Number of rows of probability matrix does not match number of blocks" );
+
+  for( auto&& row : probabilities )
+    if( row.size() != numBlocks )
+      throw std::runtime_error( "Number of columns of probability matrix does not match number of blocks" );
+
+  std::vector<unsigned> offsets( numBlocks + 1 );
+  for( unsigned a = 0; a < numBlocks; a++ )
+    offsets[a + 1] = offsets[a] + blockSizes[a];
+
+  std::vector<S> simplices;
+
+  for( unsigned i = 0; i < offsets.back(); i++ )
+    simplices.push_back( S( i ) );
+
+  for( unsigned a = 0; a < numBlocks; a++ )
+  {
+    for( unsigned b = a; b < numBlocks; b++ )
+    {
+      auto stream = a * numBlocks + b;
+      auto edges  = a == b ? detail::samplePairs( offsets[a], blockSizes[a], probabilities[a][b], seed, stream )
+                           : detail::samplePairs( offsets[a], blockSizes[a], offsets[b], blockSizes[b], probabilities[a][b], seed, stream );
+
+      for( auto&& edge : edges )
+        simplices.push_back( S( {edge.first, edge.second} ) );
+    }
+  }
+
+  return K( simplices.begin(), simplices.end() );
 }
 
 } // namespace topology
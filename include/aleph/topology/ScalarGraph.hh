@@ -0,0 +1,267 @@
+#ifndef ALEPH_TOPOLOGY_SCALAR_GRAPH_HH__
+#define ALEPH_TOPOLOGY_SCALAR_GRAPH_HH__
+
+#include <aleph/topology/Mesh.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+
+namespace aleph
+{
+
+namespace topology
+{
+
+/**
+  @class ScalarGraph
+  @brief Graph whose vertices carry the values of a scalar field
+
+  The vertices are numbered densely, i.e. \f$0,\dots,n-1\f$, and the
+  neighbours of every vertex are stored contiguously (compressed sparse
+  row format). This is the input of all algorithms that analyse the
+  sublevel or superlevel sets of a scalar field by sweeping over its
+  vertices, such as calculateMergeTree().
+
+  The original labels of the vertices are kept, so that the results of
+  these algorithms can be related to the input again.
+*/
+
+template <class DataType, class Index = unsigned> class ScalarGraph
+{
+public:
+  using ValueType = DataType;
+  using IndexType = Index;
+
+  ScalarGraph() = default;
+
+  /**
+    Creates a new graph from a set of values and a set of edges. The
+    edges refer to the indices of the values; self-loops are ignored.
+
+    @param values Values of the vertices
+    @param edges  Edges of the graph, each of them stored only once
+    @param labels Original labels of the vertices (optional)
+  */
+
+  ScalarGraph( std::vector<DataType> values,
+               const std::vector< std::pair<Index, Index> >& edges,
+               std::vector<std::size_t> labels = std::vector<std::size_t>() )
+    : _values( std::move( values ) ),
+      _labels( std::move( labels ) )
+  {
+    auto n = _values.size();
+
+    if( n > std::size_t( std::numeric_limits<Index>::max() ) )
+      throw std::runtime_error( "Graph has too many vertices for the index type" );
+
+    if( _labels.empty() )
+    {
+      _labels.resize( n );
+
+      for( std::size_t i = 0; i < n; i++ )
+        _labels[i] = i;
+    }
+    else if( _labels.size() != n )
+      throw std::runtime_error( "Number of labels must match number of vertices" );
+
+    _offsets.assign( n + 1, 0 );
+
+    for( auto&& edge : edges )
+    {
+      if( edge.first >= n || edge.second >= n )
+        throw std::runtime_error( "Edge refers to an unknown vertex" );
+
+      if( edge.first == edge.second )
+        continue;
+
+      ++_offsets[ std::size_t( edge.first )  + 1 ];
+      ++_offsets[ std::size_t( edge.second ) + 1 ];
+    }
+
+    std::partial_sum( _offsets.begin(), _offsets.end(), _offsets.begin() );
+
+    _neighbours.resize( _offsets.back() );
+
+    {
+      std::vector<std::size_t> positions( _offsets.begin(), _offsets.end() - 1 );
+
+      for( auto&& edge : edges )
+      {
+        if( edge.first == edge.second )
+          continue;
+
+        _neighbours[ positions[ edge.first  ]++ ] = edge.second;
+        _neighbours[ positions[ edge.second ]++ ] = edge.first;
+      }
+    }
+  }
+
+  /** @returns Number of vertices */
+  std::size_t size() const noexcept
+  {
+    return _values.size();
+  }
+
+  /** @returns Number of edges */
+  std::size_t numEdges() const noexcept
+  {
+    return _neighbours.size() / 2;
+  }
+
+  /** @returns Value of a vertex */
+  DataType value( Index v ) const noexcept
+  {
+    return _values[v];
+  }
+
+  /** @returns Values of all vertices */
+  const std::vector<DataType>& values() const noexcept
+  {
+    return _values;
+  }
+
+  /** @returns Original label of a vertex */
+  std::size_t label( Index v ) const noexcept
+  {
+    return _labels[v];
+  }
+
+  /** @returns Pointer to the first neighbour of a vertex */
+  const Index* beginNeighbours( Index v ) const noexcept
+  {
+    return _neighbours.data() + _offsets[v];
+  }
+
+  /** @returns Pointer behind the last neighbour of a vertex */
+  const Index* endNeighbours( Index v ) const noexcept
+  {
+    return _neighbours.data() + _offsets[ std::size_t(v) + 1 ];
+  }
+
+private:
+
+  /** Values of all vertices */
+  std::vector<DataType> _values;
+
+  /** Original labels of all vertices */
+  std::vector<std::size_t> _labels;
+
+  /** Offsets of the neighbours of every vertex, plus the total number */
+  std::vector<std::size_t> _offsets;
+
+  /** Neighbours of all vertices, stored contiguously */
+  std::vector<Index> _neighbours;
+};
+
+/**
+  Creates a scalar graph from the 1-skeleton of a simplicial complex.
+  The values of the vertices are taken from the data of the 0-simplices,
+  and the vertices are numbered in the order of their labels. Simplices
+  of higher dimensions are ignored, since the connectivity of sublevel
+  sets of a lower-star filtration only depends on the 1-skeleton.
+*/
+
+template <class Simplex, class Index = unsigned>
+ScalarGraph<typename Simplex::DataType, Index> makeScalarGraph( const SimplicialComplex<Simplex>& K )
+{
+  using DataType   = typename Simplex::DataType;
+  using VertexType = typename Simplex::VertexType;
+
+  std::vector< std::pair<VertexType, DataType> > vertices;
+
+  for( auto&& simplex : K )
+  {
+    if( simplex.dimension() == 0 )
+      vertices.push_back( std::make_pair( *simplex.begin(), simplex.data() ) );
+  }
+
+  std::sort( vertices.begin(), vertices.end(),
+             [] ( const std::pair<VertexType, DataType>& a, const std::pair<VertexType, DataType>& b )
+             {
+               return a.first < b.first;
+             } );
+
+  std::vector<DataType> values;
+  std::vector<std::size_t> labels;
+
+  values.reserve( vertices.size() );
+  labels.reserve( vertices.size() );
+
+  for( auto&& vertex : vertices )
+  {
+    labels.push_back( std::size_t( vertex.first ) );
+    values.push_back( vertex.second );
+  }
+
+  auto index = [&labels] ( VertexType v )
+  {
+    auto it = std::lower_bound( labels.begin(), labels.end(), std::size_t(v) );
+    if( it == labels.end() || *it != std::size_t(v) )
+      throw std::runtime_error( "Edge refers to a vertex that is not part of the simplicial complex" );
+
+    return Index( std::distance( labels.begin(), it ) );
+  };
+
+  std::vector< std::pair<Index, Index> > edges;
+
+  for( auto&& simplex : K )
+  {
+    if( simplex.dimension() == 1 )
+      edges.push_back( std::make_pair( index( *simplex.begin() ), index( *( simplex.begin() + 1 ) ) ) );
+  }
+
+  return ScalarGraph<DataType, Index>( std::move( values ), edges, std::move( labels ) );
+}
+
+/**
+  Creates a scalar graph from the vertices and edges of a mesh, using
+  the data stored at every vertex. The vertices are numbered in the
+  order of their IDs.
+*/
+
+template <class Position, class Data, class Index = unsigned>
+ScalarGraph<Data, Index> makeScalarGraph( const Mesh<Position, Data>& M )
+{
+  auto labels = M.vertices();
+  std::sort( labels.begin(), labels.end() );
+
+  auto index = [&labels] ( std::size_t v )
+  {
+    return Index( std::distance( labels.begin(), std::lower_bound( labels.begin(), labels.end(), v ) ) );
+  };
+
+  std::vector<Data> values( labels.size() );
+  std::vector< std::pair<Index, Index> > edges;
+
+  for( std::size_t i = 0; i < labels.size(); i++ )
+  {
+    values[i] = M.data( labels[i] );
+
+    for( auto&& neighbour : M.link( labels[i] ) )
+    {
+      auto j = index( neighbour );
+      edges.push_back( std::make_pair( std::min( Index(i), j ), std::max( Index(i), j ) ) );
+    }
+  }
+
+  // Every edge is reported twice, once in the link of each of its
+  // vertices, so only one copy is kept.
+  std::sort( edges.begin(), edges.end() );
+  edges.erase( std::unique( edges.begin(), edges.end() ), edges.end() );
+
+  return ScalarGraph<Data, Index>( std::move( values ), edges, std::move( labels ) );
+}
+
+} // namespace topology
+
+} // namespace aleph
+
+#endif
@@ -8,6 +8,8 @@
 #include <boost/multi_index/ordered_index.hpp>
 #include <boost/multi_index/random_access_index.hpp>
 
+#include <aleph/utilities/Profiler.hh>
+
 #include <algorithm>
 #include <functional>
 #include <initializer_list>
@@ -381,6 +383,27 @@ public:
     return _simplices.size();
   }
 
+  /**
+    @returns Approximate number of bytes that are used by the simplicial
+    complex. Every simplex is stored in a node of the container, which
+    additionally requires links for each of its indices.
+  */
+
+  std::size_t memoryUsage() const
+  {
+    // One link for the random access index, three links for each of
+    // the two ordered indices, and one entry in the pointer array of
+    // the random access index.
+    constexpr std::size_t overhead = 8 * sizeof( void* );
+
+    std::size_t bytes = sizeof( SimplicialComplex ) + this->size() * ( sizeof( Simplex ) + overhead );
+
+    for( auto&& simplex : *this )
+      bytes += simplex.size() * sizeof( typename Simplex::vertex_type );
+
+    return bytes;
+  }
+
   /**
     @returns true if the simplicial is empty, i.e. if it does not contain any
     simplices.
@@ -450,12 +473,16 @@ public:
 
   template <class Comparison> void sort( Comparison&& comparison )
   {
+    ALEPH_PROFILE_ZONE( "sort" );
+
     _simplices.sort( std::ref( comparison ) );
   }
 
   /** Sorts simplices according to their builtin comparison function */
   void sort()
   {
+    ALEPH_PROFILE_ZONE( "sort" );
+
     _simplices.sort();
   }
 
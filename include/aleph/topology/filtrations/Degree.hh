@@ -1,9 +1,15 @@
 #ifndef ALEPH_TOPOLOGY_FILTRATIONS_DEGREE_HH__
 #define ALEPH_TOPOLOGY_FILTRATIONS_DEGREE_HH__
 
+#include <aleph/topology/filtrations/Data.hh>
+
+#include <algorithm>
 #include <iterator>
-#include <map>
 #include <set>
+#include <stdexcept>
+#include <vector>
+
+#include <cstddef>
 
 namespace aleph
 {
@@ -14,18 +20,75 @@ namespace topology
 namespace filtrations
 {
 
+namespace detail
+{
+
+/**
+  @class VertexIndex
+  @brief Dense numbering of the vertices of a simplicial complex
+
+  Maps every vertex that occurs in a simplicial complex to its position
+  among all vertices in ascending order. This is the order that is used
+  by SimplicialComplex::vertices(). If the vertices are contiguous, the
+  position of a vertex is calculated in constant time.
+*/
+
+template <class VertexType> class VertexIndex
+{
+public:
+  template <class SimplicialComplex> explicit VertexIndex( const SimplicialComplex& K )
+  {
+    for( auto&& simplex : K )
+      _vertices.insert( _vertices.end(), simplex.begin(), simplex.end() );
+
+    std::sort( _vertices.begin(), _vertices.end() );
+    _vertices.erase( std::unique( _vertices.begin(), _vertices.end() ), _vertices.end() );
+
+    _contiguous = _vertices.empty() || std::size_t( _vertices.back() - _vertices.front() ) + 1 == _vertices.size();
+  }
+
+  /** @returns Number of vertices */
+  std::size_t size() const noexcept
+  {
+    return _vertices.size();
+  }
+
+  /** @returns Position of a vertex that occurs in the simplicial complex */
+  std::size_t operator()( VertexType v ) const noexcept
+  {
+    if( _contiguous )
+      return std::size_t( v - _vertices.front() );
+    else
+      return std::size_t( std::distance( _vertices.begin(), std::lower_bound( _vertices.begin(), _vertices.end(), v ) ) );
+  }
+
+private:
+
+  /** All vertices in ascending order */
+  std::vector<VertexType> _vertices;
+
+  /** Flag indicating whether the vertices are contiguous */
+  bool _contiguous = true;
+};
+
+} // namespace detail
+
 /**
   Calculates *all* vertex degrees of the given simplicial complex. The
   degree of a vertex in a simplicial complex is just the number of its
   co-faces. If the simplicial complex is one-dimensional, degrees in a
   graph-theoretical sense are being calculated.
 
+  The degrees are counted in a single parallel pass over all simplices,
+  using a dense array instead of an associative container.
+
   @param K      Simplicial complex
 
   @param result Output iterator for storing the results. The order in
                 which degrees are being reported follows the order of
                 vertices when calculating them via `vertices()`. Note
-                that all degrees are reported as unsigned values.
+                that all degrees are reported as unsigned values, and
+                isolated vertices have a degree of zero.
 
   @tparam SimplicialComplex Simplicial complex class
   @tparam OutputIterator    Output iterator for storing the results
@@ -37,19 +100,27 @@ template <class SimplicialComplex, class OutputIterator> void degrees( const Sim
   using VertexType = typename Simplex::VertexType;
   using DegreeType = unsigned;
 
-  std::map<VertexType, DegreeType> degrees;
+  detail::VertexIndex<VertexType> index( K );
+  std::vector<DegreeType> degrees( index.size() );
 
-  for( auto&& simplex : K )
+  #pragma omp parallel for
+  for( long i = 0; i < long( K.size() ); i++ )
   {
-    if( simplex.dimension() != 0 )
+    auto&& simplex = K[ std::size_t(i) ];
+
+    if( simplex.dimension() == 0 )
+      continue;
+
+    for( auto&& vertex : simplex )
     {
-      for( auto&& vertex : simplex )
-        degrees[vertex] += 1;
+      auto& degree = degrees[ index( vertex ) ];
+
+      #pragma omp atomic
+      ++degree;
     }
   }
 
-  for( auto&& pair : degrees )
-    *result++ = pair.second;
+  std::copy( degrees.begin(), degrees.end(), result );
 }
 
 /**
@@ -97,6 +168,134 @@ template <class SimplicialComplex> unsigned n_degree( const SimplicialComplex& K
   return d;
 }
 
+/**
+  Calculates the \f$n\f$-degrees of all simplices of a given dimension,
+  where \f$n\f$ is the dimension of the simplicial complex (see
+  n_degree()). Instead of scanning the complex for every simplex, the
+  faces of all \f$n\f$-simplices are enumerated once, in parallel.
+
+  @param K         Simplicial complex
+  @param dimension Dimension of the simplices whose degrees are required
+  @param result    Output iterator for storing the results. The degrees
+                   are reported in the order of `K.range( dimension )`.
+*/
+
+template <class SimplicialComplex, class OutputIterator> void n_degrees( const SimplicialComplex& K, std::size_t dimension, OutputIterator result )
+{
+  using Simplex    = typename SimplicialComplex::ValueType;
+  using VertexType = typename Simplex::VertexType;
+
+  auto n = K.dimension();
+
+  std::vector<unsigned> counts( K.size() );
+
+  if( dimension <= n && !K.empty() )
+  {
+    std::vector<const Simplex*> simplices;
+
+    {
+      auto iterators = K.range( n );
+      for( auto it = iterators.first; it != iterators.second; ++it )
+        simplices.push_back( &( *it ) );
+    }
+
+    #pragma omp parallel for
+    for( long i = 0; i < long( simplices.size() ); i++ )
+    {
+      auto&& simplex = *simplices[ std::size_t(i) ];
+
+      std::vector<VertexType> vertices( simplex.begin(), simplex.end() );
+      std::vector<VertexType> face;
+      std::vector<bool> mask( vertices.size() );
+
+      std::fill( mask.begin(), mask.begin() + long( dimension + 1 ), true );
+
+      // Every selection of vertices corresponds to one face of the
+      // simplex of the requested dimension.
+      do
+      {
+        face.clear();
+
+        for( std::size_t j = 0; j < vertices.size(); j++ )
+        {
+          if( mask[j] )
+            face.push_back( vertices[j] );
+        }
+
+        auto it = K.find( Simplex( face.begin(), face.end() ) );
+
+        if( it != K.end() )
+        {
+          auto& count = counts[ std::size_t( std::distance( K.begin(), it ) ) ];
+
+          #pragma omp atomic
+          ++count;
+        }
+      }
+      while( std::prev_permutation( mask.begin(), mask.end() ) );
+    }
+  }
+
+  auto iterators = K.range( dimension );
+  for( auto it = iterators.first; it != iterators.second; ++it )
+    *result++ = counts[ K.index( *it ) ];
+}
+
+/**
+  Creates a degree-based filtration of a simplicial complex. Every
+  simplex is assigned a weight by combining the weights of its vertices
+  using the functor, starting from an initial value. Typically, the
+  weights are the degrees of the vertices (see degrees()), while the
+  functor calculates their maximum or their sum.
+
+  All simplices are weighted in parallel and sorted before creating
+  the new simplicial complex at once, so no simplex of an existing
+  complex needs to be replaced.
+
+  @param K       Simplicial complex
+  @param begin   Input iterator to begin of vertex weights
+  @param end     Input iterator to end of vertex weights
+  @param init    Initial value for combining weights
+  @param functor Functor for combining weights
+
+  @returns Simplicial complex with assigned weights, sorted according
+           to a filtration by weights
+*/
+
+template <class SimplicialComplex, class InputIterator, class Functor>
+SimplicialComplex degreeFiltration( const SimplicialComplex& K,
+                                    InputIterator begin, InputIterator end,
+                                    typename SimplicialComplex::ValueType::DataType init,
+                                    Functor functor )
+{
+  using Simplex    = typename SimplicialComplex::ValueType;
+  using DataType   = typename Simplex::DataType;
+  using VertexType = typename Simplex::VertexType;
+
+  detail::VertexIndex<VertexType> index( K );
+  std::vector<DataType> weights( begin, end );
+
+  if( weights.size() != index.size() )
+    throw std::runtime_error( "Number of weights must match number of vertices" );
+
+  std::vector<Simplex> simplices( K.begin(), K.end() );
+
+  #pragma omp parallel for
+  for( long i = 0; i < long( simplices.size() ); i++ )
+  {
+    auto&& simplex = simplices[ std::size_t(i) ];
+    auto data      = init;
+
+    for( auto&& vertex : simplex )
+      data = functor( data, weights[ index( vertex ) ] );
+
+    simplex.setData( data );
+  }
+
+  std::sort( simplices.begin(), simplices.end(), Data<Simplex>() );
+  return SimplicialComplex( simplices.begin(), simplices.end() );
+}
+
 } // namespace filtrations
 
 } // namespace topology
@@ -9,7 +9,6 @@
 #include <numeric>
 #include <sstream>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 #include <iostream>
@@ -48,26 +47,30 @@ template <
   if( functionValues.empty() )
     throw std::runtime_error( "Unable to load any function values" );
 
-  std::vector<Index> indices( 2*functionValues.size() - 1 );
+  // Extend function values with edge weights. Since the i-th edge will use
+  // vertices i and i+1, this can be done in one sweep. The weights are
+  // calculated once, prior to sorting.
+  {
+    std::size_t n = functionValues.size();
+    functionValues.reserve( 2*n - 1 );
+
+    for( std::size_t i = 0; i < n - 1; i++ )
+    {
+      auto w1 = functionValues[i  ];
+      auto w2 = functionValues[i+1];
+      functionValues.push_back( std::max( w1, w2 ) );
+    }
+  }
+
+  std::size_t numVertices = ( functionValues.size() + 1 ) / 2;
+
+  std::vector<Index> indices( functionValues.size() );
   std::iota( indices.begin(), indices.end(), Index(0) );
 
   std::stable_sort( indices.begin(), indices.end(),
              [&functionValues] ( Index i, Index j )
              {
-               auto weight = [&] ( Index i )
-               {
-                 if( i < functionValues.size() )
-                   return functionValues.at(i);
-                 else
-                 {
-                   auto l = functionValues.at( i - functionValues.size()     );
-                   auto r = functionValues.at( i - functionValues.size() + 1 );
-
-                   return std::max( l, r );
-                 }
-               };
-
-               return weight(i) < weight(j);
+               return functionValues[i] < functionValues[j];
              } );
 
   boundaryMatrix.setNumColumns( static_cast<Index>( indices.size() ) );
@@ -75,13 +78,13 @@ template <
   // Maps a vertex in the original function to its place in the current
   // filtration order. The map is filled while creating the matrix below,
   // which is possible because faces need to precede cofcaces.
-  std::unordered_map<Index, Index> vertexIndexMap;
+  std::vector<Index> vertexIndexMap( numVertices );
 
   for( Index j = 0; j < static_cast<Index>( indices.size() ); j++ )
   {
-    auto&& index = indices.at(j);
+    auto&& index = indices[j];
 
-    if( index < functionValues.size() )
+    if( index < numVertices )
     {
       boundaryMatrix.clearColumn( j );
 
@@ -89,27 +92,15 @@ template <
     }
     else
     {
-      Index k = static_cast<Index>( index - functionValues.size() );
+      Index k = static_cast<Index>( index - numVertices );
 
-      std::vector<Index> vertexIndices = { vertexIndexMap.at(k), vertexIndexMap.at(k+1) };
+      std::vector<Index> vertexIndices = { vertexIndexMap[k], vertexIndexMap[k+1] };
 
       boundaryMatrix.setColumn(j,
                                vertexIndices.begin(), vertexIndices.end() );
     }
   }
 
-  // Extend function values with edge weights. Since the i-th edge will use
-  // vertices i and i+1, this can be done in one sweep.
-  {
-    std::size_t n = functionValues.size();
-    for( std::size_t i = 0; i < n - 1; i++ )
-    {
-      auto w1 = functionValues.at(i  );
-      auto w2 = functionValues.at(i+1);
-      functionValues.push_back( std::max( w1, w2 ) );
-    }
-  }
-
   // Sort the function values to reflect the order of vertex indices. Else, we
   // will be unable to add the proper weights to the corresponding pairing.
 
@@ -118,7 +109,7 @@ template <
     newFunctionValues.reserve( functionValues.size() );
 
     for( auto&& index : indices )
-      newFunctionValues.push_back( functionValues.at( index ) );
+      newFunctionValues.push_back( functionValues[index] );
 
     functionValues.swap( newFunctionValues );
   }
@@ -0,0 +1,699 @@
+#ifndef ALEPH_REPRESENTATIONS_EXTERNAL_HH__
+#define ALEPH_REPRESENTATIONS_EXTERNAL_HH__
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+
+#include <stdlib.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace aleph
+{
+
+namespace topology
+{
+
+namespace representations
+{
+
+/**
+  @class External
+  @brief Out-of-core representation of a boundary matrix
+
+  This representation stores the columns of a boundary matrix in a file
+  and only keeps a cache of recently-used columns in memory. It is meant
+  for matrices that do not fit into memory, even in compact form. Since
+  it provides the same interface as all other representations, it works
+  with all reduction algorithms:
+
+  @code
+  using Representation = aleph::topology::representations::External<unsigned>;
+
+  auto diagrams = aleph::calculatePersistenceDiagrams<Twist, Representation>( K, false );
+  @endcode
+
+  The size of the cache is set per instance, upon construction. To use
+  a different size for a calculation, create the boundary matrix from a
+  configured representation:
+
+  @code
+  aleph::topology::BoundaryMatrix<Representation> M( Representation( 512 * 1024 * 1024 ) );
+  @endcode
+
+  The file is divided into blocks whose sizes are powers of two. Every
+  column occupies a single block, which is only replaced by a larger one
+  if the column outgrows it. Blocks that are not used any more are kept
+  in a free list, so the file does not grow without bounds during the
+  reduction.
+
+  The cache uses a segmented LRU strategy: columns enter the cache in
+  a probationary segment. Once a column has been used repeatedly as a
+  pivot column, i.e. as the source of a column addition, it is moved to
+  a protected segment that may take up half of the cache. Columns are
+  evicted from the probationary segment first, so frequently-used pivot
+  columns stay in memory while columns that are only reduced once pass
+  through the cache quickly. Dirty columns are written when they are
+  evicted.
+
+  The maximum index and the dimension of every column are always kept
+  in memory, so querying pivots or dimensions never touches the file.
+
+  Nothing is written to disk as long as all columns fit into the cache.
+  If the file cannot be created or written to, an exception is thrown.
+
+  Since even reading a column changes the cache, a single instance must
+  not be used by multiple threads at the same time, not even for const
+  operations. Different instances are independent of each other.
+
+  @tparam IndexType Index type of the matrix
+*/
+
+template <class IndexType = unsigned> class External
+{
+public:
+  using Index = IndexType;
+
+  /** @returns Cache size, measured in bytes, of default-constructed instances */
+  static constexpr std::size_t defaultCacheSize()
+  {
+    return std::size_t(64) << 20;
+  }
+
+  /**
+    @returns Reference to the directory in which new instances store
+    their files. If empty, the system's default directory for temporary
+    files is used. Files are removed automatically.
+  */
+
+  static std::string& defaultDirectory()
+  {
+    static std::string directory;
+    return directory;
+  }
+
+  External() = default;
+
+  /**
+    Creates an empty representation with a given cache size
+
+    @param cacheSize Maximum number of bytes of the columns that are kept
+                     in memory. If zero, every column is written to disk
+                     as soon as it is not used any more.
+  */
+
+  explicit External( std::size_t cacheSize )
+    : _cacheSize( cacheSize )
+  {
+  }
+
+  External( const External& other )
+    : _cacheSize( other._cacheSize )
+    , _directory( other._directory )
+  {
+    this->setNumColumns( other.getNumColumns() );
+
+    for( std::size_t j = 0; j < other._columns.size(); j++ )
+    {
+      auto column = other.getColumn( static_cast<Index>( j ) );
+      this->setColumn( static_cast<Index>( j ), column.begin(), column.end() );
+
+      _columns[j].dimension = other._columns[j].dimension;
+    }
+  }
+
+  External( External&& other ) noexcept
+  {
+    this->swap( other );
+  }
+
+  External& operator=( External other ) noexcept
+  {
+    this->swap( other );
+    return *this;
+  }
+
+  ~External()
+  {
+    if( _file )
+      std::fclose( _file );
+  }
+
+  void swap( External& other ) noexcept
+  {
+    std::swap( _columns,       other._columns );
+    std::swap( _cache,         other._cache );
+    std::swap( _probation,     other._probation );
+    std::swap( _protected,     other._protected );
+    std::swap( _cachedBytes,   other._cachedBytes );
+    std::swap( _protectedBytes,other._protectedBytes );
+    std::swap( _cacheSize,     other._cacheSize );
+    std::swap( _directory,     other._directory );
+    std::swap( _file,          other._file );
+    std::swap( _fileSize,      other._fileSize );
+    std::swap( _freeBlocks,    other._freeBlocks );
+    std::swap( _numReads,      other._numReads );
+    std::swap( _numWrites,     other._numWrites );
+  }
+
+  void setNumColumns( Index numColumns )
+  {
+    auto n = static_cast<std::size_t>( numColumns );
+
+    for( std::size_t j = n; j < _columns.size(); j++ )
+    {
+      this->erase( static_cast<Index>( j ) );
+      this->releaseBlock( _columns[j] );
+    }
+
+    _columns.resize( n );
+  }
+
+  Index getNumColumns() const
+  {
+    return static_cast<Index>( _columns.size() );
+  }
+
+  std::pair<Index, bool> getMaximumIndex( Index column ) const
+  {
+    auto&& info = _columns.at( static_cast<std::size_t>( column ) );
+
+    if( info.size == 0 )
+      return std::make_pair( Index(0), false );
+    else
+      return std::make_pair( info.maximum, true );
+  }
+
+  void addColumns( Index source, Index target )
+  {
+    auto&& sourceEntry = this->fetch( source );
+    this->markAsPivot( source, sourceEntry );
+
+    auto&& targetEntry = this->fetch( target );
+
+    std::vector<Index> result;
+    result.reserve( sourceEntry.data.size() + targetEntry.data.size() );
+
+    std::set_symmetric_difference( sourceEntry.data.begin(), sourceEntry.data.end(),
+                                   targetEntry.data.begin(), targetEntry.data.end(),
+                                   std::back_inserter( result ) );
+
+    this->update( target, targetEntry, result );
+    this->evict( source, target );
+  }
+
+  template <class InputIterator> void setColumn( Index column,
+                                                 InputIterator begin, InputIterator end )
+  {
+    std::vector<Index> data( begin, end );
+
+    // Ensures proper sorting order. Else, the reduction algorithm will
+    // not be able to reduce the matrix.
+    std::sort( data.begin(), data.end() );
+
+    auto it = _cache.find( column );
+    if( it == _cache.end() )
+      it = this->insert( column );
+
+    this->update( column, it->second, data );
+
+    // Upon initialization, the column must by necessity have the dimension
+    // that is indicated by the amount of indices in its boundary. The case
+    // of 0-simplices needs special handling.
+    _columns.at( static_cast<std::size_t>( column ) ).dimension
+      = begin == end ? 0
+                     : static_cast<Index>( std::distance( begin, end ) - 1 );
+
+    this->evict( column, column );
+  }
+
+  std::vector<Index> getColumn( Index column ) const
+  {
+    // Fetching a column only changes the cache, but never the contents
+    // of the matrix.
+    auto data = this->fetch( column ).data;
+
+    this->evict( column, column );
+    return data;
+  }
+
+  void clearColumn( Index column )
+  {
+    auto&& info = _columns.at( static_cast<std::size_t>( column ) );
+
+    this->erase( column );
+    this->releaseBlock( info );
+
+    info.size = 0;
+  }
+
+  void setDimension( Index column, Index dimension )
+  {
+    _columns.at( static_cast<std::size_t>( column ) ).dimension = dimension;
+  }
+
+  Index getDimension( Index column ) const
+  {
+    return _columns.at( static_cast<std::size_t>( column ) ).dimension;
+  }
+
+  Index getDimension() const
+  {
+    Index dimension = Index(0);
+
+    for( auto&& info : _columns )
+      dimension = std::max( dimension, info.dimension );
+
+    return dimension;
+  }
+
+  /**
+    @returns Approximate number of bytes that are used by the representation
+    in memory, i.e. without the columns that are only stored on disk
+  */
+
+  std::size_t memoryUsage() const
+  {
+    std::size_t bytes = _columns.capacity() * sizeof( ColumnInfo ) + _cachedBytes;
+
+    for( auto&& blocks : _freeBlocks )
+      bytes += blocks.capacity() * sizeof( std::uint64_t );
+
+    return bytes;
+  }
+
+  /** @returns Maximum number of bytes of the columns that are kept in memory */
+  std::size_t cacheSize() const noexcept
+  {
+    return _cacheSize;
+  }
+
+  /**
+    @returns Approximate number of bytes that a representation with the
+    given number of columns and non-zero entries will use in memory if
+    its cache has the given size
+  */
+
+  static std::size_t estimateMemoryUsage( std::size_t numColumns, std::size_t numEntries, std::size_t cacheSize = defaultCacheSize() )
+  {
+    auto cache = numColumns * entryOverhead() + numEntries * sizeof( Index );
+
+    return numColumns * sizeof( ColumnInfo )
+         + std::min( cache, cacheSize );
+  }
+
+  /** @returns Number of bytes that are used by the file of the representation */
+  std::size_t diskUsage() const noexcept
+  {
+    return static_cast<std::size_t>( _fileSize );
+  }
+
+  /** @returns Number of columns that have been read from disk */
+  std::size_t numReads() const noexcept
+  {
+    return _numReads;
+  }
+
+  /** @returns Number of columns that have been written to disk */
+  std::size_t numWrites() const noexcept
+  {
+    return _numWrites;
+  }
+
+  bool operator==( const External& other ) const
+  {
+    if( _columns.size() != other._columns.size() )
+      return false;
+
+    for( std::size_t j = 0; j < _columns.size(); j++ )
+    {
+      if( _columns[j].dimension != other._columns[j].dimension || _columns[j].size != other._columns[j].size )
+        return false;
+    }
+
+    for( std::size_t j = 0; j < _columns.size(); j++ )
+    {
+      if( this->getColumn( static_cast<Index>( j ) ) != other.getColumn( static_cast<Index>( j ) ) )
+        return false;
+    }
+
+    return true;
+  }
+
+private:
+
+  /**
+    Information about a column that is always kept in memory. The block
+    of a column only describes where the column is stored, so it may be
+    changed when the column is written upon eviction.
+  */
+
+  struct ColumnInfo
+  {
+    mutable std::uint64_t offset   = 0; // offset of the block in the file, in bytes
+    mutable std::uint32_t capacity = 0; // capacity of the block, in indices
+    std::uint32_t size             = 0; // number of indices in the column
+    Index maximum                  = Index(0);
+    Index dimension                = Index(0);
+  };
+
+  /** Column in the cache */
+  struct CacheEntry
+  {
+    std::vector<Index> data;
+
+    bool dirty       = false; // column differs from its block on disk
+    bool isProtected = false; // column is in the protected segment
+    unsigned uses    = 0;     // number of times the column was a pivot
+
+    typename std::list<Index>::iterator position;
+  };
+
+  using Cache = std::unordered_map<Index, CacheEntry>;
+
+  /** Approximate memory used by a cache entry, not counting its indices */
+  static constexpr std::size_t entryOverhead()
+  {
+    return sizeof( CacheEntry ) + sizeof( Index ) + 6 * sizeof( void* );
+  }
+
+  static std::size_t entrySize( const CacheEntry& entry )
+  {
+    return entryOverhead() + entry.data.capacity() * sizeof( Index );
+  }
+
+  /** Creates an empty cache entry in the probationary segment */
+  typename Cache::iterator insert( Index column ) const
+  {
+    auto it = _cache.insert( std::make_pair( column, CacheEntry() ) ).first;
+
+    _probation.push_front( column );
+    it->second.position = _probation.begin();
+
+    _cachedBytes += entrySize( it->second );
+    return it;
+  }
+
+  /** Removes a column from the cache without writing it */
+  void erase( Index column ) const
+  {
+    auto it = _cache.find( column );
+    if( it == _cache.end() )
+      return;
+
+    auto&& entry = it->second;
+    auto bytes   = entrySize( entry );
+
+    if( entry.isProtected )
+    {
+      _protected.erase( entry.position );
+      _protectedBytes -= bytes;
+    }
+    else
+      _probation.erase( entry.position );
+
+    _cachedBytes -= bytes;
+    _cache.erase( it );
+  }
+
+  /** Replaces the contents of a cached column */
+  void update( Index column, CacheEntry& entry, std::vector<Index>& data )
+  {
+    auto bytes = entrySize( entry );
+
+    entry.data.swap( data );
+    entry.dirty = true;
+
+    _cachedBytes += entrySize( entry );
+    _cachedBytes -= bytes;
+
+    if( entry.isProtected )
+    {
+      _protectedBytes += entrySize( entry );
+      _protectedBytes -= bytes;
+    }
+
+    auto&& info   = _columns.at( static_cast<std::size_t>( column ) );
+    info.size     = static_cast<std::uint32_t>( entry.data.size() );
+    info.maximum  = entry.data.empty() ? Index(0) : entry.data.back();
+  }
+
+  /**
+    Returns the cache entry of a column, reading it from disk if it is not
+    in the cache, and marks it as being the most recently used column of
+    its segment.
+  */
+
+  CacheEntry& fetch( Index column ) const
+  {
+    auto&& info = _columns.at( static_cast<std::size_t>( column ) );
+    auto it     = _cache.find( column );
+
+    if( it != _cache.end() )
+    {
+      auto&& entry   = it->second;
+      auto&& segment = entry.isProtected ? _protected : _probation;
+
+      segment.splice( segment.begin(), segment, entry.position );
+      return entry;
+    }
+
+    it = this->insert( column );
+
+    auto&& entry = it->second;
+
+    // Empty columns never need to be read. Every other column that is
+    // not in the cache has been written to its block upon eviction.
+    if( info.size != 0 )
+    {
+      std::vector<Index> data( info.size );
+
+      if(    fseeko( _file, static_cast<off_t>( info.offset ), SEEK_SET ) != 0
+          || std::fread( data.data(), sizeof( Index ), data.size(), _file ) != data.size() )
+      {
+        this->erase( column );
+        throw std::runtime_error( "Unable to read column from external storage" );
+      }
+
+      _cachedBytes -= entrySize( entry );
+      entry.data.swap( data );
+      _cachedBytes += entrySize( entry );
+
+      ++_numReads;
+    }
+
+    return entry;
+  }
+
+  /**
+    Counts a use of a column as a pivot. Columns that are used more than
+    once are moved to the protected segment. If the segment exceeds its
+    share of the cache, its least recently used columns are moved back
+    to the probationary segment.
+  */
+
+  void markAsPivot( Index column, CacheEntry& entry )
+  {
+    if( ++entry.uses < 2 || entry.isProtected )
+      return;
+
+    _probation.erase( entry.position );
+    _protected.push_front( column );
+
+    entry.position     = _protected.begin();
+    entry.isProtected  = true;
+    _protectedBytes   += entrySize( entry );
+
+    while( _protectedBytes > _cacheSize / 2 && _protected.size() > 1 )
+    {
+      auto demoted  = _protected.back();
+      auto&& victim = _cache.at( demoted );
+
+      _protected.pop_back();
+      _probation.push_front( demoted );
+
+      victim.position     = _probation.begin();
+      victim.isProtected  = false;
+      _protectedBytes    -= entrySize( victim );
+    }
+  }
+
+  /**
+    Evicts columns until the cache is within its size. The two columns
+    that are currently being used are never evicted, so the cache may
+    exceed its size temporarily if they are large.
+  */
+
+  void evict( Index first, Index second ) const
+  {
+    while( _cachedBytes > _cacheSize )
+    {
+      Index column   = Index(0);
+      bool  hasVictim = false;
+
+      for( auto&& segment : { &_probation, &_protected } )
+      {
+        for( auto it = segment->rbegin(); it != segment->rend() && !hasVictim; ++it )
+        {
+          if( *it != first && *it != second )
+          {
+            column    = *it;
+            hasVictim = true;
+          }
+        }
+      }
+
+      if( !hasVictim )
+        break;
+
+      this->write( column, _cache.at( column ) );
+      this->erase( column );
+    }
+  }
+
+  /** Writes a dirty column to its block, allocating a new one if necessary */
+  void write( Index column, CacheEntry& entry ) const
+  {
+    if( !entry.dirty )
+      return;
+
+    auto&& info = _columns.at( static_cast<std::size_t>( column ) );
+
+    if( info.size != 0 )
+    {
+      if( info.capacity < info.size )
+      {
+        this->releaseBlock( info );
+        this->allocateBlock( info );
+      }
+
+      if(    fseeko( _file, static_cast<off_t>( info.offset ), SEEK_SET ) != 0
+          || std::fwrite( entry.data.data(), sizeof( Index ), entry.data.size(), _file ) != entry.data.size() )
+      {
+        throw std::runtime_error( "Unable to write column to external storage" );
+      }
+
+      ++_numWrites;
+    }
+
+    entry.dirty = false;
+  }
+
+  /**
+    Assigns a block to a column that is large enough to store all of its
+    indices. Blocks are re-used if possible; else, the file is extended.
+  */
+
+  void allocateBlock( const ColumnInfo& info ) const
+  {
+    std::size_t blockClass = 2;
+    while( ( std::size_t(1) << blockClass ) < info.size )
+      ++blockClass;
+
+    if( _freeBlocks.size() <= blockClass )
+      _freeBlocks.resize( blockClass + 1 );
+
+    info.capacity = static_cast<std::uint32_t>( std::size_t(1) << blockClass );
+
+    if( !_freeBlocks[blockClass].empty() )
+    {
+      info.offset = _freeBlocks[blockClass].back();
+      _freeBlocks[blockClass].pop_back();
+    }
+    else
+    {
+      if( !_file )
+        this->open();
+
+      info.offset  = _fileSize;
+      _fileSize   += info.capacity * sizeof( Index );
+    }
+  }
+
+  /** Returns the block of a column to the free list */
+  void releaseBlock( const ColumnInfo& info ) const
+  {
+    if( info.capacity == 0 )
+      return;
+
+    std::size_t blockClass = 0;
+    while( ( std::uint32_t(1) << blockClass ) < info.capacity )
+      ++blockClass;
+
+    _freeBlocks.at( blockClass ).push_back( info.offset );
+
+    info.offset   = 0;
+    info.capacity = 0;
+  }
+
+  /** Creates an anonymous file that is removed once it is closed */
+  void open() const
+  {
+    if( _directory.empty() )
+      _file = std::tmpfile();
+    else
+    {
+      std::string pattern = _directory + "/aleph-XXXXXX";
+      std::vector<char> filename( pattern.begin(), pattern.end() );
+      filename.push_back( '\0' );
+
+      int fd = mkstemp( filename.data() );
+      if( fd >= 0 )
+      {
+        unlink( filename.data() );
+        _file = fdopen( fd, "w+b" );
+
+        if( !_file )
+          close( fd );
+      }
+    }
+
+    if( !_file )
+      throw std::runtime_error( "Unable to create file for external storage" );
+  }
+
+  /** Columns of the matrix */
+  std::vector<ColumnInfo> _columns;
+
+  /**
+    Cached columns and their segments, ordered by recency of use. Since
+    reading a column changes the cache, all of these are mutable.
+  */
+
+  mutable Cache _cache;
+  mutable std::list<Index> _probation;
+  mutable std::list<Index> _protected;
+
+  mutable std::size_t _cachedBytes    = 0;
+  mutable std::size_t _protectedBytes = 0;
+  std::size_t _cacheSize              = defaultCacheSize();
+
+  /** Directory of the file; the file is only created when required */
+  std::string _directory              = defaultDirectory();
+  mutable std::FILE* _file            = nullptr;
+  mutable std::uint64_t _fileSize     = 0;
+
+  /** Free blocks of the file, indexed by the logarithm of their capacity */
+  mutable std::vector< std::vector<std::uint64_t> > _freeBlocks;
+
+  mutable std::size_t _numReads  = 0;
+  mutable std::size_t _numWrites = 0;
+};
+
+} // namespace representations
+
+} // namespace topology
+
+} // namespace aleph
+
+#endif
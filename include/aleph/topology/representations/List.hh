@@ -98,12 +98,43 @@ public:
       return *std::max_element( _dimensions.begin(), _dimensions.end() );
   }
 
+  /** @returns Approximate number of bytes that are used by the representation */
+  std::size_t memoryUsage() const
+  {
+    std::size_t numEntries = 0;
+
+    for( auto&& column : _data )
+      numEntries += column.size();
+
+    return _data.capacity() * sizeof( std::list<Index> )
+         + _dimensions.capacity() * sizeof( Index )
+         + numEntries * nodeSize();
+  }
+
+  /**
+    @returns Approximate number of bytes that a representation with the
+    given number of columns and non-zero entries will use
+  */
+
+  static std::size_t estimateMemoryUsage( std::size_t numColumns, std::size_t numEntries )
+  {
+    return numColumns * ( sizeof( std::list<Index> ) + sizeof( Index ) )
+         + numEntries * nodeSize();
+  }
+
   bool operator==( const List& other ) const
   {
     return _data == other._data && _dimensions == other._dimensions;
   }
 
 private:
+
+  /** @returns Approximate size of a single node of a column, i.e. two links plus the index */
+  static std::size_t nodeSize()
+  {
+    return 2 * sizeof( void* ) + ( ( sizeof( Index ) + sizeof( void* ) - 1 ) / sizeof( void* ) ) * sizeof( void* );
+  }
+
   std::vector< std::list<Index> > _data;
   std::vector<Index> _dimensions;
 };
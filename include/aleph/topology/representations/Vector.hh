@@ -50,7 +50,12 @@ public:
                                    targetColumn.begin(), targetColumn.end(),
                                    std::back_inserter( result ) );
 
-    targetColumn.swap( result );
+    // Columns that have been reduced to zero remain empty, so they do
+    // not need to keep any memory.
+    if( result.empty() )
+      std::vector<Index>().swap( targetColumn );
+    else
+      targetColumn.swap( result );
   }
 
   template <class InputIterator> void setColumn( Index column,
@@ -77,7 +82,9 @@ public:
 
   void clearColumn( Index column )
   {
-    _data.at( static_cast<std::size_t>( column ) ).clear();
+    // Cleared columns are not filled again by the reduction, so their
+    // memory is released right away.
+    std::vector<Index>().swap( _data.at( static_cast<std::size_t>( column ) ) );
   }
 
   void setDimension( Index column, Index dimension )
@@ -98,6 +105,29 @@ public:
       return *std::max_element( _dimensions.begin(), _dimensions.end() );
   }
 
+  /** @returns Approximate number of bytes that are used by the representation */
+  std::size_t memoryUsage() const
+  {
+    std::size_t bytes = _data.capacity() * sizeof( std::vector<Index> )
+                      + _dimensions.capacity() * sizeof( Index );
+
+    for( auto&& column : _data )
+      bytes += column.capacity() * sizeof( Index );
+
+    return bytes;
+  }
+
+  /**
+    @returns Approximate number of bytes that a representation with the
+    given number of columns and non-zero entries will use
+  */
+
+  static std::size_t estimateMemoryUsage( std::size_t numColumns, std::size_t numEntries )
+  {
+    return numColumns * ( sizeof( std::vector<Index> ) + sizeof( Index ) )
+         + numEntries * sizeof( Index );
+  }
+
   bool operator==( const Vector& other ) const
   {
     return _data == other._data && _dimensions == other._dimensions;
@@ -0,0 +1,331 @@
+#ifndef ALEPH_UTILITIES_PIPELINE_HH__
+#define ALEPH_UTILITIES_PIPELINE_HH__
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+
+namespace aleph
+{
+
+namespace utilities
+{
+
+/**
+  @class BoundedQueue
+  @brief Queue with a fixed capacity for passing values between threads
+
+  Adding a value blocks while the queue is full, and removing a value
+  blocks while the queue is empty. After the queue has been closed, no
+  more values can be added, while the remaining values can still be
+  removed.
+*/
+
+template <class T> class BoundedQueue
+{
+public:
+  explicit BoundedQueue( std::size_t capacity )
+    : _capacity( std::max( capacity, std::size_t(1) ) )
+  {
+  }
+
+  /**
+    Adds a value to the queue, waiting until there is space for it
+
+    @returns false if the queue has been closed, in which case the value
+    has not been added
+  */
+
+  bool push( T value )
+  {
+    std::unique_lock<std::mutex> lock( _mutex );
+    _notFull.wait( lock, [this] { return _closed || _values.size() < _capacity; } );
+
+    if( _closed )
+      return false;
+
+    _values.push_back( std::move( value ) );
+    _notEmpty.notify_one();
+
+    return true;
+  }
+
+  /**
+    Removes the first value from the queue, waiting until there is one
+
+    @returns false if the queue has been closed and is empty, in which
+    case no value has been removed
+  */
+
+  bool pop( T& value )
+  {
+    std::unique_lock<std::mutex> lock( _mutex );
+    _notEmpty.wait( lock, [this] { return _closed || !_values.empty(); } );
+
+    if( _values.empty() )
+      return false;
+
+    value = std::move( _values.front() );
+    _values.pop_front();
+    _notFull.notify_one();
+
+    return true;
+  }
+
+  /** Closes the queue and wakes all threads that are waiting for it */
+  void close()
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    _closed = true;
+    _notEmpty.notify_all();
+    _notFull.notify_all();
+  }
+
+  /** @returns Maximum number of values in the queue */
+  std::size_t capacity() const noexcept
+  {
+    return _capacity;
+  }
+
+private:
+  std::size_t _capacity;
+  bool _closed = false;
+
+  std::deque<T> _values;
+
+  std::mutex _mutex;
+  std::condition_variable _notEmpty;
+  std::condition_variable _notFull;
+};
+
+/**
+  @class Pipeline
+  @brief Overlaps reading, processing, and writing of many inputs
+
+  Processes a sequence of inputs, typically files, in three stages. A
+  single thread *reads* the inputs in order, a pool of worker threads
+  *computes* results from them, and the calling thread *writes* these
+  results in the order of the inputs. The stages are connected by two
+  bounded queues, so that reading, e.g. waiting for the disk, overlaps
+  with computing, and all cores can be used for the calculations.
+
+  The number of inputs that have been read but not written yet is
+  limited by the capacity of the pipeline. Hence, the memory usage is
+  bounded even if a single input takes very long, and results that are
+  completed early are kept until they can be written.
+
+  If any stage throws an exception, the pipeline is stopped, and the
+  first exception is thrown again after all threads have finished.
+
+  Inputs and results are passed by moving them, and both types must be
+  default-constructible.
+*/
+
+class Pipeline
+{
+public:
+
+  /**
+    Creates a new pipeline
+
+    @param numWorkers Number of worker threads; if zero, the number of
+                      hardware threads is used
+    @param capacity   Maximum number of inputs that are processed at
+                      the same time; if zero, four inputs per worker
+                      thread are used
+  */
+
+  explicit Pipeline( std::size_t numWorkers = 0, std::size_t capacity = 0 )
+    : _numWorkers( numWorkers )
+    , _capacity( capacity )
+  {
+    if( _numWorkers == 0 )
+      _numWorkers = std::max( std::size_t( std::thread::hardware_concurrency() ), std::size_t(1) );
+
+    if( _capacity == 0 )
+      _capacity = 4 * _numWorkers;
+  }
+
+  /** @returns Number of worker threads */
+  std::size_t numWorkers() const noexcept
+  {
+    return _numWorkers;
+  }
+
+  /** @returns Maximum number of inputs that are processed at the same time */
+  std::size_t capacity() const noexcept
+  {
+    return _capacity;
+  }
+
+  /**
+    Runs the pipeline for a number of inputs
+
+    @param n       Number of inputs
+    @param read    Functor for reading an input, given its index
+    @param compute Functor for computing the result of an input, which
+                   receives a reference to the value read before. This
+                   functor is called from several threads at once.
+    @param write   Functor for writing a result, which receives the index
+                   of the input and a reference to its result. Results
+                   are written in the order of their indices.
+  */
+
+  template <class Read, class Compute, class Write> void operator()( std::size_t n, Read read, Compute compute, Write write ) const
+  {
+    using Input  = typename std::decay<decltype( read( std::size_t() ) )>::type;
+    using Output = typename std::decay<decltype( compute( std::declval<Input&>() ) )>::type;
+
+    if( n == 0 )
+      return;
+
+    BoundedQueue< std::pair<std::size_t, Input > > inputs( _capacity );
+    BoundedQueue< std::pair<std::size_t, Output> > outputs( _capacity );
+
+    std::mutex mutex;
+    std::condition_variable notFull;
+    std::exception_ptr error;
+
+    std::size_t numPending = 0;
+    std::size_t numWorkers = _numWorkers;
+    bool failed            = false;
+
+    // Records the first error and stops all stages. Values that are in
+    // the queues already will still be processed.
+    auto fail = [&] ( std::exception_ptr e )
+    {
+      {
+        std::lock_guard<std::mutex> lock( mutex );
+
+        if( !error )
+          error = e;
+
+        failed = true;
+        notFull.notify_all();
+      }
+
+      inputs.close();
+      outputs.close();
+    };
+
+    std::thread reader( [&] ()
+    {
+      try
+      {
+        for( std::size_t i = 0; i < n; i++ )
+        {
+          {
+            std::unique_lock<std::mutex> lock( mutex );
+            notFull.wait( lock, [&] { return failed || numPending < _capacity; } );
+
+            if( failed )
+              break;
+
+            ++numPending;
+          }
+
+          if( !inputs.push( std::make_pair( i, read( i ) ) ) )
+            break;
+        }
+      }
+      catch( ... )
+      {
+        fail( std::current_exception() );
+      }
+
+      inputs.close();
+    } );
+
+    std::vector<std::thread> workers;
+    workers.reserve( _numWorkers );
+
+    for( std::size_t k = 0; k < _numWorkers; k++ )
+    {
+      workers.emplace_back( [&] ()
+      {
+        try
+        {
+          std::pair<std::size_t, Input> input;
+
+          while( inputs.pop( input ) )
+          {
+            if( !outputs.push( std::make_pair( input.first, compute( input.second ) ) ) )
+              break;
+          }
+        }
+        catch( ... )
+        {
+          fail( std::current_exception() );
+        }
+
+        // The last worker signals that no more results will follow
+        bool last = false;
+
+        {
+          std::lock_guard<std::mutex> lock( mutex );
+          last = --numWorkers == 0;
+        }
+
+        if( last )
+          outputs.close();
+      } );
+    }
+
+    // Results that are completed before their predecessors are kept
+    // until they can be written.
+    std::map<std::size_t, Output> completed;
+    std::size_t next = 0;
+
+    try
+    {
+      std::pair<std::size_t, Output> output;
+
+      while( outputs.pop( output ) )
+      {
+        completed.emplace( output.first, std::move( output.second ) );
+
+        for( auto it = completed.begin(); it != completed.end() && it->first == next; it = completed.erase( it ) )
+        {
+          write( it->first, it->second );
+          ++next;
+
+          std::lock_guard<std::mutex> lock( mutex );
+          --numPending;
+          notFull.notify_one();
+        }
+      }
+    }
+    catch( ... )
+    {
+      fail( std::current_exception() );
+    }
+
+    reader.join();
+
+    for( auto&& worker : workers )
+      worker.join();
+
+    if( error )
+      std::rethrow_exception( error );
+  }
+
+private:
+  std::size_t _numWorkers;
+  std::size_t _capacity;
+};
+
+} // namespace utilities
+
+} // namespace aleph
+
+#endif
@@ -0,0 +1,521 @@
+#ifndef ALEPH_UTILITIES_PROFILER_HH__
+#define ALEPH_UTILITIES_PROFILER_HH__
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace aleph
+{
+
+namespace utilities
+{
+
+/**
+  @class Profiler
+  @brief Hierarchical profiler for scoped zones
+
+  The profiler keeps track of nested *zones*, i.e. named scopes, which
+  are typically created using the `ALEPH_PROFILE_ZONE` macro. Zones are
+  identified by their *path*, consisting of the names of all enclosing
+  zones. Timings are aggregated separately for every thread, so zones
+  that are run within parallel sections only lock the data of their own
+  thread. This lock is only contended while the data of all threads is
+  being queried, cleared, or written.
+
+  Profiling is disabled by default. Setting the environment variable
+  `ALEPH_PROFILE` to a file prefix enables it for every program, and
+  the results will be written to `<prefix>.json`, containing a summary
+  of all zones, and `<prefix>.trace.json`, containing a trace that can
+  be loaded in Chrome's `about:tracing` view, upon exit.
+
+  In addition to timings, the profiler keeps track of the peak memory
+  usage of named data structures, which are reported with respect to
+  the zone in which they have been recorded. This is typically done by
+  the `ALEPH_PROFILE_MEMORY` macro, which does not evaluate its memory
+  estimate unless profiling is enabled.
+
+  Decisions that are taken at runtime, such as the strategy that has
+  been selected for a calculation, can be recorded as *annotations*,
+  i.e. named strings, using the `ALEPH_PROFILE_ANNOTATION` macro. They
+  are reported with respect to their zone as well.
+
+  Zones can be removed completely at compile time by defining the macro
+  `ALEPH_DISABLE_PROFILING`.
+*/
+
+class Profiler
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /** Aggregated timings of a single zone, measured in milliseconds */
+  struct Statistics
+  {
+    std::size_t count = 0;
+    double total      = 0.0;
+    double min        = 0.0;
+    double max        = 0.0;
+
+    void add( double duration )
+    {
+      min    = count == 0 ? duration : std::min( min, duration );
+      max    = count == 0 ? duration : std::max( max, duration );
+      total += duration;
+
+      ++count;
+    }
+  };
+
+  /** Single completed zone, measured in microseconds since the start of the profiler */
+  struct Event
+  {
+    const char* name;
+    double start;
+    double duration;
+  };
+
+  /**
+    Profiling data of a single thread. The mutex protects all data of
+    the thread, since they may be queried by other threads.
+  */
+
+  struct ThreadData
+  {
+    unsigned id;
+    std::mutex mutex;
+
+    std::vector< std::pair<std::string, double> > stack; // paths and start times of open zones
+    std::vector<Event> events;
+    std::map<std::string, Statistics> statistics;
+    std::map<std::string, std::size_t> memory; // peak number of bytes
+    std::map<std::string, std::string> annotations;
+  };
+
+  /** @returns Global profiler instance */
+  static Profiler& instance()
+  {
+    static Profiler profiler;
+    return profiler;
+  }
+
+  Profiler( const Profiler& )            = delete;
+  Profiler& operator=( const Profiler& ) = delete;
+
+  ~Profiler()
+  {
+    if( !_enabled || _prefix.empty() )
+      return;
+
+    {
+      std::ofstream out( _prefix + ".json" );
+      this->writeJSON( out );
+    }
+
+    {
+      std::ofstream out( _prefix + ".trace.json" );
+      this->writeChromeTrace( out );
+    }
+  }
+
+  bool enabled() const noexcept
+  {
+    return _enabled;
+  }
+
+  void setEnabled( bool value = true ) noexcept
+  {
+    _enabled = value;
+  }
+
+  // Zones -------------------------------------------------------------
+
+  /** Opens a new zone in the current thread */
+  void begin( const char* name )
+  {
+    auto&& data = this->threadData();
+    std::lock_guard<std::mutex> lock( data.mutex );
+
+    auto path   = data.stack.empty() ? std::string( name ) : data.stack.back().first + "/" + name;
+
+    data.stack.push_back( std::make_pair( path, this->now() ) );
+  }
+
+  /** Closes the innermost open zone of the current thread */
+  void end( const char* name )
+  {
+    auto&& data = this->threadData();
+    std::lock_guard<std::mutex> lock( data.mutex );
+
+    if( data.stack.empty() )
+      return;
+
+    auto end      = this->now();
+    auto start    = data.stack.back().second;
+    auto duration = end - start;
+
+    data.statistics[ data.stack.back().first ].add( duration / 1000.0 );
+    data.events.push_back( { name, start, duration } );
+    data.stack.pop_back();
+  }
+
+  /**
+    Records the number of bytes that are used by a named data structure
+    in the current zone. Only the peak value is kept.
+  */
+
+  void recordMemory( const char* name, std::size_t bytes )
+  {
+    auto&& data = this->threadData();
+    std::lock_guard<std::mutex> lock( data.mutex );
+
+    auto path   = data.stack.empty() ? std::string( name ) : data.stack.back().first + "/" + name;
+    auto&& peak = data.memory[ path ];
+    peak        = std::max( peak, bytes );
+  }
+
+  /**
+    Records an annotation in the current zone. Annotations of the same
+    name replace each other.
+  */
+
+  void recordAnnotation( const char* name, const std::string& value )
+  {
+    auto&& data = this->threadData();
+    std::lock_guard<std::mutex> lock( data.mutex );
+
+    auto path   = data.stack.empty() ? std::string( name ) : data.stack.back().first + "/" + name;
+
+    data.annotations[ path ] = value;
+  }
+
+  // Queries -----------------------------------------------------------
+
+  /** @returns Statistics of all zones, merged over all threads */
+  std::map<std::string, Statistics> statistics() const
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    std::map<std::string, Statistics> result;
+
+    for( auto&& data : _threads )
+    {
+      std::lock_guard<std::mutex> threadLock( data->mutex );
+
+      for( auto&& pair : data->statistics )
+      {
+        auto&& s = result[ pair.first ];
+        auto&& t = pair.second;
+
+        s.min    = s.count == 0 ? t.min : std::min( s.min, t.min );
+        s.max    = s.count == 0 ? t.max : std::max( s.max, t.max );
+        s.total += t.total;
+        s.count += t.count;
+      }
+    }
+
+    return result;
+  }
+
+  /** @returns Peak memory usage of all data structures, merged over all threads */
+  std::map<std::string, std::size_t> memory() const
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    std::map<std::string, std::size_t> result;
+
+    for( auto&& data : _threads )
+    {
+      std::lock_guard<std::mutex> threadLock( data->mutex );
+
+      for( auto&& pair : data->memory )
+      {
+        auto&& peak = result[ pair.first ];
+        peak        = std::max( peak, pair.second );
+      }
+    }
+
+    return result;
+  }
+
+  /** @returns Annotations of all threads */
+  std::map<std::string, std::string> annotations() const
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    std::map<std::string, std::string> result;
+
+    for( auto&& data : _threads )
+    {
+      std::lock_guard<std::mutex> threadLock( data->mutex );
+
+      for( auto&& pair : data->annotations )
+        result[ pair.first ] = pair.second;
+    }
+
+    return result;
+  }
+
+  /** Removes all profiling data that has been collected so far */
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    for( auto&& data : _threads )
+    {
+      std::lock_guard<std::mutex> threadLock( data->mutex );
+
+      data->events.clear();
+      data->statistics.clear();
+      data->memory.clear();
+      data->annotations.clear();
+    }
+  }
+
+  // Output ------------------------------------------------------------
+
+  /**
+    Writes a summary of all zones in JSON format. Zones are reported
+    per thread; all times are specified in milliseconds, while memory
+    usage is specified in bytes. Annotations are reported as strings.
+  */
+
+  void writeJSON( std::ostream& out ) const
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    out << "{\n"
+        << "  \"threads\": [\n";
+
+    for( auto itThread = _threads.begin(); itThread != _threads.end(); ++itThread )
+    {
+      auto&& data = *itThread;
+      std::lock_guard<std::mutex> threadLock( data->mutex );
+
+      if( itThread != _threads.begin() )
+        out << ",\n";
+
+      out << "    {\n"
+          << "      \"id\": " << data->id << ",\n"
+          << "      \"zones\": {\n";
+
+      for( auto it = data->statistics.begin(); it != data->statistics.end(); ++it )
+      {
+        if( it != data->statistics.begin() )
+          out << ",\n";
+
+        out << "        \"" << escape( it->first ) << "\": { "
+            << "\"count\": " << it->second.count << ", "
+            << "\"total\": " << it->second.total << ", "
+            << "\"min\": "   << it->second.min   << ", "
+            << "\"max\": "   << it->second.max   << " }";
+      }
+
+      out << "\n"
+          << "      },\n"
+          << "      \"memory\": {\n";
+
+      for( auto it = data->memory.begin(); it != data->memory.end(); ++it )
+      {
+        if( it != data->memory.begin() )
+          out << ",\n";
+
+        out << "        \"" << escape( it->first ) << "\": " << it->second;
+      }
+
+      out << "\n"
+          << "      },\n"
+          << "      \"annotations\": {\n";
+
+      for( auto it = data->annotations.begin(); it != data->annotations.end(); ++it )
+      {
+        if( it != data->annotations.begin() )
+          out << ",\n";
+
+        out << "        \"" << escape( it->first ) << "\": \"" << escape( it->second ) << "\"";
+      }
+
+      out << "\n"
+          << "      }\n"
+          << "    }";
+    }
+
+    out << "\n"
+        << "  ]\n"
+        << "}\n";
+  }
+
+  /**
+    Writes all zones as complete events of the Chrome trace format.
+    Nesting is reconstructed by the viewer from the timestamps.
+  */
+
+  void writeChromeTrace( std::ostream& out ) const
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    out << "{\n"
+        << "  \"traceEvents\": [\n";
+
+    bool first = true;
+
+    for( auto&& data : _threads )
+    {
+      std::lock_guard<std::mutex> threadLock( data->mutex );
+
+      for( auto&& event : data->events )
+      {
+        if( !first )
+          out << ",\n";
+
+        out << "    { "
+            << "\"name\": \"" << escape( event.name ) << "\", "
+            << "\"ph\": \"X\", "
+            << "\"pid\": 0, "
+            << "\"tid\": " << data->id << ", "
+            << "\"ts\": "  << event.start << ", "
+            << "\"dur\": " << event.duration << " }";
+
+        first = false;
+      }
+    }
+
+    out << "\n"
+        << "  ],\n"
+        << "  \"displayTimeUnit\": \"ms\"\n"
+        << "}\n";
+  }
+
+private:
+  Profiler()
+    : _start( Clock::now() )
+  {
+    auto prefix = std::getenv( "ALEPH_PROFILE" );
+    if( prefix && *prefix )
+    {
+      _prefix  = prefix;
+      _enabled = true;
+    }
+  }
+
+  /** @returns Microseconds since the start of the profiler */
+  double now() const
+  {
+    return std::chrono::duration<double, std::micro>( Clock::now() - _start ).count();
+  }
+
+  /**
+    @returns Profiling data of the current thread. The data are shared
+    with the profiler, so they remain valid after the thread finished.
+  */
+
+  ThreadData& threadData()
+  {
+    thread_local std::shared_ptr<ThreadData> data;
+
+    if( !data )
+    {
+      data = std::make_shared<ThreadData>();
+
+      std::lock_guard<std::mutex> lock( _mutex );
+
+      data->id = static_cast<unsigned>( _threads.size() );
+      _threads.push_back( data );
+    }
+
+    return *data;
+  }
+
+  static std::string escape( const std::string& s )
+  {
+    std::string result;
+    result.reserve( s.size() );
+
+    for( auto&& c : s )
+    {
+      if( c == '"' || c == '\\' )
+        result.push_back( '\\' );
+
+      result.push_back( c );
+    }
+
+    return result;
+  }
+
+  Clock::time_point _start;
+
+  std::atomic<bool> _enabled{ false };
+  std::string _prefix;
+
+  mutable std::mutex _mutex;
+  std::vector< std::shared_ptr<ThreadData> > _threads;
+};
+
+/**
+  @class ProfilerZone
+  @brief Scoped zone of the profiler
+
+  Opens a zone upon construction and closes it upon destruction. If the
+  profiler is disabled, the zone does not do anything.
+*/
+
+class ProfilerZone
+{
+public:
+  explicit ProfilerZone( const char* name )
+    : _name( Profiler::instance().enabled() ? name : nullptr )
+  {
+    if( _name )
+      Profiler::instance().begin( _name );
+  }
+
+  ~ProfilerZone()
+  {
+    if( _name )
+      Profiler::instance().end( _name );
+  }
+
+  ProfilerZone( const ProfilerZone& )            = delete;
+  ProfilerZone& operator=( const ProfilerZone& ) = delete;
+
+private:
+  const char* _name;
+};
+
+} // namespace utilities
+
+} // namespace aleph
+
+#ifndef ALEPH_DISABLE_PROFILING
+  #define ALEPH_PROFILE_CONCATENATE_DETAIL( x, y ) x##y
+  #define ALEPH_PROFILE_CONCATENATE( x, y ) ALEPH_PROFILE_CONCATENATE_DETAIL( x, y )
+
+  #define ALEPH_PROFILE_ZONE( name ) aleph::utilities::ProfilerZone ALEPH_PROFILE_CONCATENATE( profilerZone, __LINE__ )( name )
+
+  #define ALEPH_PROFILE_MEMORY( name, bytes )                               \
+    do                                                                      \
+    {                                                                       \
+      if( aleph::utilities::Profiler::instance().enabled() )                \
+        aleph::utilities::Profiler::instance().recordMemory( name, bytes ); \
+    }                                                                       \
+    while( false )
+
+  #define ALEPH_PROFILE_ANNOTATION( name, value )                               \
+    do                                                                          \
+    {                                                                           \
+      if( aleph::utilities::Profiler::instance().enabled() )                    \
+        aleph::utilities::Profiler::instance().recordAnnotation( name, value ); \
+    }                                                                           \
+    while( false )
+#else
+  #define ALEPH_PROFILE_ZONE( name )
+  #define ALEPH_PROFILE_MEMORY( name, bytes ) do {} while( false )
+  #define ALEPH_PROFILE_ANNOTATION( name, value ) do {} while( false )
+#endif
+
+#endif
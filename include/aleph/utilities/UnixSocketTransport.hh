@@ -0,0 +1,310 @@
+#ifndef ALEPH_UTILITIES_UNIX_SOCKET_TRANSPORT_HH__
+#define ALEPH_UTILITIES_UNIX_SOCKET_TRANSPORT_HH__
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace aleph
+{
+
+namespace utilities
+{
+
+/**
+  @class UnixSocketTransport
+  @brief Message transport between processes on a single host
+
+  This class connects a fixed number of processes, which are identified
+  by their *rank*, via pairs of Unix domain sockets. It provides the
+  interface that distributed algorithms require from a transport:
+
+  - `rank()` returns the rank of the current process,
+  - `size()` returns the number of processes, and
+  - `send()` and `receive()` exchange messages, i.e. sequences of 64-bit
+    words, with another process.
+
+  Both operations block until the message has been transferred to, or
+  from, the socket. Messages between two processes arrive in the order
+  in which they have been sent. Errors, including processes that exit
+  prematurely, result in an exception.
+
+  Other transports, e.g. one based on MPI, may be used instead of this
+  class as long as they provide the same interface. The function
+  runLocalProcesses() sets up the sockets for a group of processes.
+*/
+
+class UnixSocketTransport
+{
+public:
+  using Message = std::vector<std::uint64_t>;
+
+  /**
+    Creates a new transport for a given process.
+
+    @param rank    Rank of the current process
+    @param sockets Connected sockets to all processes, indexed by their
+                   rank. The entry of the current process is ignored.
+                   The transport takes ownership of all sockets.
+  */
+
+  UnixSocketTransport( unsigned rank, std::vector<int> sockets )
+    : _rank( rank )
+    , _sockets( std::move( sockets ) )
+  {
+    if( _rank >= _sockets.size() )
+      throw std::runtime_error( "Rank of process exceeds number of processes" );
+
+    _sockets[_rank] = -1;
+  }
+
+  ~UnixSocketTransport()
+  {
+    for( auto&& socket : _sockets )
+      if( socket >= 0 )
+        close( socket );
+  }
+
+  UnixSocketTransport( const UnixSocketTransport& )            = delete;
+  UnixSocketTransport& operator=( const UnixSocketTransport& ) = delete;
+
+  unsigned rank() const noexcept
+  {
+    return _rank;
+  }
+
+  unsigned size() const noexcept
+  {
+    return static_cast<unsigned>( _sockets.size() );
+  }
+
+  /** Sends a message to another process */
+  void send( unsigned destination, const Message& message )
+  {
+    auto socket       = this->socket( destination );
+    std::uint64_t n   = message.size();
+
+    this->write( socket, &n, sizeof( n ) );
+    this->write( socket, message.data(), message.size() * sizeof( std::uint64_t ) );
+  }
+
+  /** Receives the next message from another process */
+  Message receive( unsigned source )
+  {
+    auto socket     = this->socket( source );
+    std::uint64_t n = 0;
+
+    this->read( socket, &n, sizeof( n ) );
+
+    Message message( static_cast<std::size_t>( n ) );
+    this->read( socket, message.data(), message.size() * sizeof( std::uint64_t ) );
+
+    return message;
+  }
+
+private:
+  int socket( unsigned rank ) const
+  {
+    if( rank >= _sockets.size() || rank == _rank )
+      throw std::runtime_error( "Invalid rank for communication: " + std::to_string( rank ) );
+
+    return _sockets[rank];
+  }
+
+  static void write( int socket, const void* data, std::size_t n )
+  {
+    auto bytes = static_cast<const char*>( data );
+
+    // Writing to a socket whose peer has exited must not terminate the
+    // process; an exception is thrown instead.
+#ifdef MSG_NOSIGNAL
+    int flags = MSG_NOSIGNAL;
+#else
+    int flags = 0;
+#endif
+
+    while( n > 0 )
+    {
+      auto result = ::send( socket, bytes, n, flags );
+
+      if( result < 0 && errno == EINTR )
+        continue;
+      else if( result <= 0 )
+        throw std::runtime_error( "Unable to send message to process" );
+
+      bytes += result;
+      n     -= static_cast<std::size_t>( result );
+    }
+  }
+
+  static void read( int socket, void* data, std::size_t n )
+  {
+    auto bytes = static_cast<char*>( data );
+
+    while( n > 0 )
+    {
+      auto result = ::recv( socket, bytes, n, 0 );
+
+      if( result < 0 && errno == EINTR )
+        continue;
+      else if( result <= 0 )
+        throw std::runtime_error( "Unable to receive message from process" );
+
+      bytes += result;
+      n     -= static_cast<std::size_t>( result );
+    }
+  }
+
+  unsigned _rank;
+  std::vector<int> _sockets;
+};
+
+/**
+  Runs a function in a group of processes on the local host. This is a
+  stand-in for launching a distributed program on multiple hosts, which
+  permits testing distributed algorithms on a single machine.
+
+  The current process becomes the process of rank 0, while all other
+  processes are forked from it and exit after the function has been
+  evaluated. Every process receives its own UnixSocketTransport.
+
+  @param numProcesses Number of processes, including the current one
+  @param f            Function to evaluate with the transport of every
+                      process; it must not return `void`
+
+  @returns Result of the function in the process of rank 0. If any of
+  the processes fails, e.g. by throwing an exception, an exception is
+  thrown after all processes have exited.
+*/
+
+template <class Function> auto runLocalProcesses( unsigned numProcesses, Function f ) -> decltype( f( std::declval<UnixSocketTransport&>() ) )
+{
+  if( numProcesses == 0 )
+    throw std::runtime_error( "Number of processes must be positive" );
+
+  // sockets[i][j] is the end of the connection between processes i and
+  // j that belongs to process i.
+  std::vector< std::vector<int> > sockets( numProcesses, std::vector<int>( numProcesses, -1 ) );
+
+  auto closeAll = [&sockets] ( unsigned keep )
+  {
+    for( unsigned i = 0; i < sockets.size(); i++ )
+      for( auto&& socket : sockets[i] )
+        if( i != keep && socket >= 0 )
+          close( socket );
+  };
+
+  for( unsigned i = 0; i < numProcesses; i++ )
+  {
+    for( unsigned j = i + 1; j < numProcesses; j++ )
+    {
+      int pair[2];
+
+      if( socketpair( AF_UNIX, SOCK_STREAM, 0, pair ) != 0 )
+      {
+        closeAll( numProcesses );
+        throw std::runtime_error( "Unable to create sockets for local processes" );
+      }
+
+      sockets[i][j] = pair[0];
+      sockets[j][i] = pair[1];
+    }
+  }
+
+  // Pending output must not be duplicated in the child processes.
+  std::fflush( nullptr );
+
+  std::vector<pid_t> children;
+
+  for( unsigned rank = 1; rank < numProcesses; rank++ )
+  {
+    auto pid = fork();
+
+    if( pid == 0 )
+    {
+      int status = 0;
+
+      try
+      {
+        closeAll( rank );
+
+        UnixSocketTransport transport( rank, sockets[rank] );
+        f( transport );
+      }
+      catch( ... )
+      {
+        status = 1;
+      }
+
+      _exit( status );
+    }
+    else if( pid < 0 )
+    {
+      closeAll( numProcesses );
+      break;
+    }
+
+    children.push_back( pid );
+  }
+
+  bool failed = children.size() + 1 != numProcesses;
+
+  using Result = decltype( f( std::declval<UnixSocketTransport&>() ) );
+
+  Result result {};
+  std::exception_ptr error;
+
+  if( !failed )
+  {
+    closeAll( 0 );
+
+    // The transport is destroyed before waiting for the other processes,
+    // so they are notified if this process fails.
+    try
+    {
+      UnixSocketTransport transport( 0, sockets[0] );
+      result = f( transport );
+    }
+    catch( ... )
+    {
+      error = std::current_exception();
+    }
+  }
+
+  for( auto&& pid : children )
+  {
+    int status = 0;
+
+    while( waitpid( pid, &status, 0 ) < 0 && errno == EINTR )
+      ;
+
+    if( !WIFEXITED( status ) || WEXITSTATUS( status ) != 0 )
+      failed = true;
+  }
+
+  if( error )
+    std::rethrow_exception( error );
+
+  if( failed )
+    throw std::runtime_error( "Local process failed" );
+
+  return result;
+}
+
+} // namespace utilities
+
+} // namespace aleph
+
+#endif
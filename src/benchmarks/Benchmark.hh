@@ -0,0 +1,285 @@
+#ifndef ALEPH_BENCHMARKS_BENCHMARK_HH__
+#define ALEPH_BENCHMARKS_BENCHMARK_HH__
+
+#include <aleph/utilities/Profiler.hh>
+#include <aleph/utilities/Timer.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include <unistd.h>
+
+namespace aleph
+{
+
+namespace benchmarks
+{
+
+/**
+  @returns Peak resident set size of the current process in bytes, i.e.
+  the maximum amount of physical memory used since the process started.
+
+  This is a high-water mark of the whole process. It never decreases, so
+  it includes the memory of all previous measurements and of any inputs
+  that are still being held. Values of consecutive measurements are thus
+  cumulative and cannot be attributed to a single function. For this,
+  use structureMemoryUsage(), or run the measurement in its own process.
+*/
+
+inline std::size_t processPeakMemoryUsage()
+{
+  rusage usage;
+  getrusage( RUSAGE_SELF, &usage );
+
+  // Linux reports the value in kilobytes
+  return static_cast<std::size_t>( usage.ru_maxrss ) * 1024;
+}
+
+/** Result of measuring a single function */
+struct Measurement
+{
+  double time                   = 0.0; // median run time in milliseconds
+  std::size_t processPeakMemory = 0;   // peak resident set size of the process so far
+};
+
+/**
+  Measures the run time of a function over a number of repetitions and
+  reports the median. The function is assumed to have no side effects,
+  so it may be called multiple times.
+*/
+
+template <class Function> Measurement measure( Function f, unsigned repetitions )
+{
+  std::vector<double> times;
+  times.reserve( repetitions );
+
+  for( unsigned i = 0; i < std::max( repetitions, 1u ); i++ )
+  {
+    aleph::utilities::Timer timer;
+    f();
+    times.push_back( timer.elapsed_ms() );
+  }
+
+  std::nth_element( times.begin(), times.begin() + long( times.size() / 2 ), times.end() );
+
+  Measurement m;
+  m.time              = times.at( times.size() / 2 );
+  m.processPeakMemory = processPeakMemoryUsage();
+
+  return m;
+}
+
+namespace detail
+{
+
+/** Writes a buffer to a file descriptor, even if this requires multiple calls */
+inline bool writeAll( int fd, const void* data, std::size_t size )
+{
+  auto bytes = static_cast<const char*>( data );
+
+  while( size > 0 )
+  {
+    auto n = ::write( fd, bytes, size );
+    if( n <= 0 )
+      return false;
+
+    bytes += n;
+    size  -= std::size_t( n );
+  }
+
+  return true;
+}
+
+/** Reads a buffer from a file descriptor, even if this requires multiple calls */
+inline bool readAll( int fd, void* data, std::size_t size )
+{
+  auto bytes = static_cast<char*>( data );
+
+  while( size > 0 )
+  {
+    auto n = ::read( fd, bytes, size );
+    if( n <= 0 )
+      return false;
+
+    bytes += n;
+    size  -= std::size_t( n );
+  }
+
+  return true;
+}
+
+} // namespace detail
+
+/**
+  Runs a function in a child process and returns the values that it
+  calculates. The child is a copy of the current process, so it can use
+  all data that are available here, but any memory that it allocates is
+  released when it exits. Hence, its peak memory usage only refers to a
+  single function and is independent of all previous measurements. It
+  includes the memory that the current process uses when calling this
+  function, though, e.g. the inputs of the function.
+
+  The current process should not have used OpenMP before, because its
+  threads are not available in the child process.
+
+  @param f          Function that returns a vector of values
+  @param peakMemory Peak resident set size of the child process in bytes
+*/
+
+template <class Function> std::vector<double> runInChildProcess( Function f, std::size_t& peakMemory )
+{
+  int fd[2];
+
+  if( pipe( fd ) != 0 )
+    throw std::runtime_error( "Unable to create pipe for child process" );
+
+  auto pid = fork();
+
+  if( pid < 0 )
+  {
+    close( fd[0] );
+    close( fd[1] );
+
+    throw std::runtime_error( "Unable to create child process" );
+  }
+
+  if( pid == 0 )
+  {
+    close( fd[0] );
+
+    int status = EXIT_FAILURE;
+
+    try
+    {
+      std::vector<double> values = f();
+      std::size_t n              = values.size();
+
+      if( detail::writeAll( fd[1], &n, sizeof(n) ) && detail::writeAll( fd[1], values.data(), n * sizeof(double) ) )
+        status = EXIT_SUCCESS;
+    }
+    catch( ... )
+    {
+    }
+
+    close( fd[1] );
+
+    // Exit without flushing the output buffers, which still contain the
+    // output of the parent process
+    _exit( status );
+  }
+
+  close( fd[1] );
+
+  std::vector<double> values;
+  std::size_t n = 0;
+
+  bool success = detail::readAll( fd[0], &n, sizeof(n) );
+
+  if( success )
+  {
+    values.resize( n );
+    success = detail::readAll( fd[0], values.data(), n * sizeof(double) );
+  }
+
+  close( fd[0] );
+
+  int status = 0;
+  rusage usage;
+
+  if( wait4( pid, &status, 0, &usage ) != pid )
+    throw std::runtime_error( "Unable to wait for child process" );
+
+  if( !success || !WIFEXITED( status ) || WEXITSTATUS( status ) != EXIT_SUCCESS )
+    throw std::runtime_error( "Child process failed" );
+
+  // Linux reports the value in kilobytes
+  peakMemory = static_cast<std::size_t>( usage.ru_maxrss ) * 1024;
+
+  return values;
+}
+
+/**
+  Predicts whether a method is going to exceed a time limit for a given
+  input size, based on its previous run time and the exponent of its
+  asymptotic complexity. This permits skipping sizes that are infeasible
+  without having to run (and abort) them.
+*/
+
+inline bool exceedsTimeLimit( double time, std::size_t size, std::size_t newSize, double exponent, double limit )
+{
+  if( time <= 0.0 || size == 0 )
+    return false;
+
+  auto predicted = time * std::pow( double( newSize ) / double( size ), exponent );
+  return predicted > limit;
+}
+
+/**
+  Generates a sequence of input sizes that grow by powers of ten, from
+  the minimum size up to and including the maximum size.
+*/
+
+inline std::vector<std::size_t> sizes( std::size_t minimum, std::size_t maximum )
+{
+  std::vector<std::size_t> result;
+
+  for( std::size_t n = minimum; n <= maximum; n *= 10 )
+    result.push_back( n );
+
+  return result;
+}
+
+/**
+  Summarizes the zones that have been recorded by the profiler, i.e. the
+  stages of a calculation. Every zone is reported with its mean run time
+  in milliseconds. Zones are separated by semicolons, so the summary can
+  be stored in a single column of a CSV file.
+*/
+
+inline std::string stages()
+{
+  std::ostringstream stream;
+
+  auto statistics = aleph::utilities::Profiler::instance().statistics();
+
+  for( auto it = statistics.begin(); it != statistics.end(); ++it )
+  {
+    if( it != statistics.begin() )
+      stream << ";";
+
+    stream << it->first << "=" << it->second.total / double( std::max( it->second.count, std::size_t(1) ) );
+  }
+
+  return stream.str();
+}
+
+/**
+  @returns Largest peak memory usage of any data structure that has been
+  recorded by the profiler, measured in bytes
+*/
+
+inline std::size_t structureMemoryUsage()
+{
+  std::size_t peak = 0;
+
+  for( auto&& pair : aleph::utilities::Profiler::instance().memory() )
+    peak = std::max( peak, pair.second );
+
+  return peak;
+}
+
+} // namespace benchmarks
+
+} // namespace aleph
+
+#endif
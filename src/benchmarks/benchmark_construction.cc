@@ -0,0 +1,511 @@
+/*
+  This is a benchmark shipped by 'Aleph - A Library for Exploring
+  Persistent Homology'.
+
+  It measures the construction of simplicial complexes from point
+  clouds and graphs. The following builders are being compared:
+
+  - Vietoris--Rips complexes, using brute-force neighbourhood queries
+    and, if available, FLANN
+  - the bottom-up and top-down Rips expansions of a given skeleton
+  - witness complexes
+  - Čech complexes
+  - Dowker complexes
+  - beta-skeletons
+
+  Inputs are samples of a sphere and of a torus, as well as random
+  graphs, whose sizes grow by powers of ten. The parameters are chosen
+  such that every vertex has roughly the same number of neighbours,
+  regardless of the number of vertices.
+
+  For every builder, input, and size, the benchmark reports the median
+  run time, the throughput in simplices per second, the peak memory of
+  the process so far, the peak memory of the largest data structure,
+  and the mean run time of every stage of the construction. The output
+  is a CSV file that is written to STDOUT.
+
+  The peak memory of the process is a high-water mark. As it never
+  decreases, it is cumulative over all previous rows; the memory of a
+  single builder is given by the peak memory of its data structure.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <getopt.h>
+
+#include <aleph/containers/PointCloud.hh>
+
+#include <aleph/geometry/BetaSkeleton.hh>
+#include <aleph/geometry/BruteForce.hh>
+#include <aleph/geometry/CechComplex.hh>
+#include <aleph/geometry/DowkerComplex.hh>
+#include <aleph/geometry/FLANN.hh>
+#include <aleph/geometry/ManifoldSampling.hh>
+#include <aleph/geometry/RipsExpander.hh>
+#include <aleph/geometry/RipsExpanderTopDown.hh>
+#include <aleph/geometry/RipsSkeleton.hh>
+#include <aleph/geometry/VietorisRipsComplex.hh>
+#include <aleph/geometry/WitnessComplex.hh>
+
+#include <aleph/geometry/distances/Euclidean.hh>
+
+#include <aleph/topology/RandomGraph.hh>
+
+#include <aleph/utilities/Profiler.hh>
+
+#include "Benchmark.hh"
+
+using DataType   = double;
+using PointCloud = aleph::containers::PointCloud<DataType>;
+using Distance   = aleph::geometry::distances::Euclidean<DataType>;
+using BruteForce = aleph::geometry::BruteForce<PointCloud, Distance>;
+
+#ifdef ALEPH_WITH_FLANN
+  using FLANN    = aleph::geometry::FLANN<PointCloud, Distance>;
+#endif
+
+struct Options
+{
+  std::size_t minSize  = 10;
+  std::size_t maxSize  = 100000;
+  unsigned dimension   = 2;
+  unsigned neighbours  = 10;
+  unsigned repetitions = 3;
+  double timeLimit     = 10000.0; // in milliseconds
+};
+
+/**
+  A single builder of the benchmark. Its preparation function performs
+  all calculations that should not be measured, such as the creation
+  of a skeleton, and returns the function that is going to be measured.
+  This function in turn reports the number of simplices it created.
+
+  Builders whose run time cannot be predicted from smaller inputs, such
+  as an exhaustive enumeration of simplices, may specify a maximum size
+  of the input.
+*/
+
+template <class Input> struct Builder
+{
+  using Function = std::function<std::size_t()>;
+
+  std::string name;
+  double exponent;
+  std::function<Function( const Input& )> prepare;
+  std::size_t maxSize;
+};
+
+template <class Input> void benchmark( const std::string& inputName,
+                                       std::function<Input( std::size_t )> makeInput,
+                                       const std::vector< Builder<Input> >& builders,
+                                       const Options& options )
+{
+  std::vector<double> previousTimes( builders.size() );
+  std::vector<std::size_t> previousSizes( builders.size() );
+  std::vector<bool> skipped( builders.size() );
+
+  auto&& profiler = aleph::utilities::Profiler::instance();
+
+  for( auto n : aleph::benchmarks::sizes( options.minSize, options.maxSize ) )
+  {
+    for( std::size_t i = 0; i < builders.size(); i++ )
+    {
+      if( skipped[i] )
+        continue;
+
+      if( aleph::benchmarks::exceedsTimeLimit( previousTimes[i], previousSizes[i], n, builders[i].exponent, options.timeLimit ) )
+      {
+        std::cerr << "* Skipping " << builders[i].name << " (" << inputName << ") for n >= " << n << " because it would exceed the time limit\n";
+        skipped[i] = true;
+      }
+      else if( builders[i].maxSize != 0 && n > builders[i].maxSize )
+      {
+        std::cerr << "* Skipping " << builders[i].name << " (" << inputName << ") for n >= " << n << " because it exceeds the maximum size of the builder\n";
+        skipped[i] = true;
+      }
+    }
+
+    if( std::find( skipped.begin(), skipped.end(), false ) == skipped.end() )
+      break;
+
+    auto input = makeInput( n );
+
+    for( std::size_t i = 0; i < builders.size(); i++ )
+    {
+      if( skipped[i] )
+        continue;
+
+      auto&& builder = builders[i];
+      auto f         = builder.prepare( input );
+
+      std::size_t numSimplices = 0;
+
+      profiler.clear();
+      profiler.setEnabled();
+
+      auto measurement = aleph::benchmarks::measure( [&] () { numSimplices = f(); }, options.repetitions );
+
+      profiler.setEnabled( false );
+
+      std::cout << builder.name << ","
+                << inputName << ","
+                << n << ","
+                << numSimplices << ","
+                << measurement.time << ","
+                << ( measurement.time > 0 ? double( numSimplices ) / ( measurement.time / 1000.0 ) : 0.0 ) << ","
+                << double( measurement.processPeakMemory ) / ( 1024.0 * 1024.0 ) << ","
+                << double( aleph::benchmarks::structureMemoryUsage() ) / ( 1024.0 * 1024.0 ) << ","
+                << "\"" << aleph::benchmarks::stages() << "\"\n"
+                << std::flush;
+
+      previousTimes[i] = measurement.time;
+      previousSizes[i] = n;
+    }
+  }
+}
+
+// Builders ------------------------------------------------------------
+
+std::vector< Builder<PointCloud> > pointCloudBuilders( std::function<DataType( std::size_t )> epsilon, const Options& options )
+{
+  using Function = Builder<PointCloud>::Function;
+
+  using RipsSkeleton      = aleph::geometry::RipsSkeleton<BruteForce>;
+  using SimplicialComplex = typename RipsSkeleton::SimplicialComplex;
+
+  std::vector< Builder<PointCloud> > builders;
+
+  auto dimension = options.dimension;
+
+  builders.push_back( {
+    "vietoris-rips-brute-force", 2.0,
+    [epsilon, dimension] ( const PointCloud& pc ) -> Function
+    {
+      auto e = epsilon( pc.size() );
+      return [&pc, e, dimension] ()
+      {
+        BruteForce nn( pc );
+        return aleph::geometry::buildVietorisRipsComplex( nn, e, dimension ).size();
+      };
+    },
+    0
+  } );
+
+#ifdef ALEPH_WITH_FLANN
+  builders.push_back( {
+    "vietoris-rips-flann", 1.5,
+    [epsilon, dimension] ( const PointCloud& pc ) -> Function
+    {
+      auto e = epsilon( pc.size() );
+      return [&pc, e, dimension] ()
+      {
+        FLANN nn( pc );
+        return aleph::geometry::buildVietorisRipsComplex( nn, e, dimension ).size();
+      };
+    },
+    0
+  } );
+#endif
+
+  // The expansions share the same skeleton, which is calculated during
+  // the preparation. Prepared data are shared with the measured function
+  // instead of being copied into it.
+
+  builders.push_back( {
+    "rips-expander", 1.5,
+    [epsilon, dimension] ( const PointCloud& pc ) -> Function
+    {
+      BruteForce nn( pc );
+      auto skeleton = std::make_shared<SimplicialComplex>( RipsSkeleton()( nn, epsilon( pc.size() ) ) );
+
+      return [skeleton, dimension] ()
+      {
+        aleph::geometry::RipsExpander<SimplicialComplex> ripsExpander;
+
+        auto K = ripsExpander( *skeleton, dimension );
+        K      = ripsExpander.assignMaximumWeight( K );
+
+        return K.size();
+      };
+    },
+    0
+  } );
+
+  builders.push_back( {
+    "rips-expander-top-down", 1.5,
+    [epsilon, dimension] ( const PointCloud& pc ) -> Function
+    {
+      BruteForce nn( pc );
+      auto skeleton = std::make_shared<SimplicialComplex>( RipsSkeleton()( nn, epsilon( pc.size() ) ) );
+
+      return [skeleton, dimension] ()
+      {
+        aleph::geometry::RipsExpanderTopDown<SimplicialComplex> ripsExpander;
+
+        auto K = ripsExpander( *skeleton, dimension );
+        K      = ripsExpander.assignMaximumWeight( K, *skeleton );
+
+        return K.size();
+      };
+    },
+    0
+  } );
+
+  // Every tenth point is used as a landmark; this keeps the results
+  // comparable between different runs. The construction requires at
+  // least two landmarks, though.
+  builders.push_back( {
+    "witness", 3.0,
+    [dimension] ( const PointCloud& pc ) -> Function
+    {
+      auto n = pc.size();
+      auto m = std::max( n / 10, std::size_t( 2 ) );
+
+      auto landmarks = std::make_shared< std::vector<std::size_t> >();
+      for( std::size_t i = 0; i < m; i++ )
+        landmarks->push_back( i * n / m );
+
+      return [&pc, landmarks, dimension] ()
+      {
+        return aleph::geometry::buildWitnessComplex<Distance>( pc, landmarks->begin(), landmarks->end(), dimension ).size();
+      };
+    },
+    0
+  } );
+
+  // The construction enumerates *all* subsets of points, so the run time
+  // depends on the size of the largest simplex and cannot be predicted.
+  builders.push_back( {
+    "cech", 4.0,
+    [epsilon] ( const PointCloud& pc ) -> Function
+    {
+      auto r = epsilon( pc.size() ) / 2;
+      return [&pc, r] ()
+      {
+        return aleph::geometry::buildCechComplex( pc, r ).size();
+      };
+    },
+    10
+  } );
+
+  // The distance matrix is calculated during the preparation, whereas
+  // the admissible pairs are deliberately calculated as part of the
+  // construction. They are reported as a separate stage, though.
+  builders.push_back( {
+    "dowker", 3.0,
+    [epsilon, dimension] ( const PointCloud& pc ) -> Function
+    {
+      auto n = pc.size();
+      auto d = pc.dimension();
+
+      auto W = std::make_shared< std::vector< std::vector<DataType> > >( n, std::vector<DataType>( n ) );
+
+      Distance distance;
+      aleph::geometry::distances::Traits<Distance> traits;
+
+      for( std::size_t i = 0; i < n; i++ )
+        for( std::size_t j = i+1; j < n; j++ )
+          (*W)[i][j] = (*W)[j][i] = traits.from( distance( pc[i].begin(), pc[j].begin(), d ) );
+
+      auto e = epsilon( n );
+
+      return [W, e, dimension] ()
+      {
+        auto pairs     = aleph::geometry::admissiblePairs( *W, e );
+        auto complexes = aleph::geometry::buildDowkerSinkSourceComplexes<std::size_t, DataType>( pairs, dimension );
+
+        return complexes.first.size() + complexes.second.size();
+      };
+    },
+    0
+  } );
+
+  builders.push_back( {
+    "beta-skeleton", 3.0,
+    [] ( const PointCloud& pc ) -> Function
+    {
+      return [&pc] ()
+      {
+        return aleph::geometry::buildBetaSkeletonNaive<Distance>( pc, 1.0 ).size();
+      };
+    },
+    0
+  } );
+
+  return builders;
+}
+
+using RandomGraph = decltype( aleph::topology::generateWeightedRandomGraph( 0, 0.0 ) );
+
+std::vector< Builder<RandomGraph> > graphBuilders( const Options& options )
+{
+  using Function = Builder<RandomGraph>::Function;
+
+  std::vector< Builder<RandomGraph> > builders;
+
+  auto dimension = options.dimension;
+
+  builders.push_back( {
+    "rips-expander", 1.5,
+    [dimension] ( const RandomGraph& G ) -> Function
+    {
+      return [&G, dimension] ()
+      {
+        aleph::geometry::RipsExpander<RandomGraph> ripsExpander;
+
+        auto K = ripsExpander( G, dimension );
+        K      = ripsExpander.assignMaximumWeight( K );
+
+        return K.size();
+      };
+    },
+    0
+  } );
+
+  builders.push_back( {
+    "rips-expander-top-down", 1.5,
+    [dimension] ( const RandomGraph& G ) -> Function
+    {
+      return [&G, dimension] ()
+      {
+        aleph::geometry::RipsExpanderTopDown<RandomGraph> ripsExpander;
+
+        auto K = ripsExpander( G, dimension );
+        K      = ripsExpander.assignMaximumWeight( K, G );
+
+        return K.size();
+      };
+    },
+    0
+  } );
+
+  return builders;
+}
+
+// ---------------------------------------------------------------------
+
+void usage()
+{
+  std::cerr << "Usage: benchmark_construction [--min-size N] [--max-size N] [--dimension D]\n"
+            << "                              [--neighbours K] [--repetitions R]\n"
+            << "                              [--time-limit T]\n"
+            << "\n"
+            << "Benchmarks the construction of simplicial complexes from samples\n"
+            << "of a sphere and a torus, as well as from random graphs. Results\n"
+            << "are written to STDOUT in CSV format.\n"
+            << "\n"
+            << "Optional arguments:\n"
+            << "\n"
+            << " --min-size N     : Minimum number of points or vertices (10)\n"
+            << " --max-size N     : Maximum number of points or vertices (100000)\n"
+            << " --dimension D    : Maximum dimension for expansions (2)\n"
+            << " --neighbours K   : Expected number of neighbours of a vertex (10)\n"
+            << " --repetitions R  : Number of repetitions per measurement (3)\n"
+            << " --time-limit T   : Time limit in seconds for a single construction;\n"
+            << "                    larger sizes are skipped for a builder if its\n"
+            << "                    predicted run time exceeds this limit (10)\n"
+            << "\n";
+}
+
+int main( int argc, char** argv )
+{
+  static option commandLineOptions[] =
+  {
+    { "dimension"  , required_argument, nullptr, 'd' },
+    { "help"       , no_argument      , nullptr, 'h' },
+    { "neighbours" , required_argument, nullptr, 'k' },
+    { "max-size"   , required_argument, nullptr, 'N' },
+    { "min-size"   , required_argument, nullptr, 'n' },
+    { "repetitions", required_argument, nullptr, 'r' },
+    { "time-limit" , required_argument, nullptr, 't' },
+    { nullptr      , 0                , nullptr,  0  }
+  };
+
+  Options options;
+
+  int option = 0;
+  while( ( option = getopt_long( argc, argv, "d:hk:N:n:r:t:", commandLineOptions, nullptr ) ) != -1 )
+  {
+    switch( option )
+    {
+    case 'd':
+      options.dimension = unsigned( std::stoul( optarg ) );
+      break;
+
+    case 'h':
+      usage();
+      return 0;
+
+    case 'k':
+      options.neighbours = unsigned( std::stoul( optarg ) );
+      break;
+
+    case 'N':
+      options.maxSize = std::stoul( optarg );
+      break;
+
+    case 'n':
+      options.minSize = std::stoul( optarg );
+      break;
+
+    case 'r':
+      options.repetitions = unsigned( std::stoul( optarg ) );
+      break;
+
+    case 't':
+      options.timeLimit = 1000.0 * std::stod( optarg );
+      break;
+
+    default:
+      usage();
+      return -1;
+    }
+  }
+
+  if( options.minSize == 0 )
+  {
+    std::cerr << "* Minimum size must be positive\n";
+    return -1;
+  }
+
+  std::cout << "builder,input,n,simplices,time_ms,simplices_per_s,process_peak_memory_mib,structure_memory_mib,stages\n";
+
+  // Chooses the radius of a disk on a surface of the given area such
+  // that it contains the desired number of neighbours on average.
+  auto k       = double( options.neighbours );
+  auto epsilon = [k] ( double area )
+  {
+    return [k, area] ( std::size_t n )
+    {
+      return DataType( std::sqrt( k * area / ( M_PI * double( n ) ) ) );
+    };
+  };
+
+  DataType R = 2;
+  DataType r = 1;
+
+  // Inputs use fixed seeds so that the same samples are used for every
+  // run of the benchmark.
+  benchmark<PointCloud>( "sphere",
+                         [] ( std::size_t n ) { return aleph::geometry::sampleSphere<DataType>( n, 2, DataType(1), 42 ); },
+                         pointCloudBuilders( epsilon( 4 * M_PI ), options ),
+                         options );
+
+  benchmark<PointCloud>( "torus",
+                         [R, r] ( std::size_t n ) { return aleph::geometry::sampleTorus<DataType>( n, R, r, 42 ); },
+                         pointCloudBuilders( epsilon( 4 * M_PI * M_PI * R * r ), options ),
+                         options );
+
+  // Weights are determined by repeated Bernoulli trials, which requires
+  // the link probability to be less than one.
+  benchmark<RandomGraph>( "random-graph",
+                          [k] ( std::size_t n ) { return aleph::topology::generateWeightedRandomGraph( unsigned( n ), std::min( 0.5, k / double( n ) ), 42 ); },
+                          graphBuilders( options ),
+                          options );
+}
@@ -0,0 +1,390 @@
+/*
+  This is a benchmark shipped by 'Aleph - A Library for Exploring
+  Persistent Homology'.
+
+  It compares the distances and kernels for persistence diagrams that
+  are provided by Aleph. To this end, pairs of random diagrams with a
+  controlled size and structure are being generated:
+
+  - uniform:       births and persistence values are uniformly
+                   distributed
+  - clustered:     points are distributed around a few centres
+  - near-diagonal: most points have a small persistence, while a
+                   few points have a large persistence
+
+  For every method, structure, and size, the benchmark reports the
+  median run time, the peak memory usage, as well as two measures of
+  numerical agreement:
+
+  - asymmetry: the relative difference between d(D1,D2) and d(D2,D1)
+  - precision: the relative difference between evaluating a method in
+               single and in double precision
+
+  Every method is evaluated in a separate process for every structure
+  and size, so that its peak memory usage does not depend on any other
+  evaluation. This includes the memory of the diagrams themselves.
+
+  The output is a CSV file that is written to STDOUT. It is meant to be
+  compared between different versions of Aleph in order to detect any
+  regressions, and for choosing a method that fits the data at hand.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <getopt.h>
+
+#include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
+
+#include <aleph/persistenceDiagrams/distances/Bottleneck.hh>
+#include <aleph/persistenceDiagrams/distances/Hausdorff.hh>
+#include <aleph/persistenceDiagrams/distances/NearestNeighbour.hh>
+#include <aleph/persistenceDiagrams/distances/Wasserstein.hh>
+
+#include <aleph/persistenceDiagrams/kernels/KernelEmbedding.hh>
+#include <aleph/persistenceDiagrams/kernels/MultiScaleKernel.hh>
+
+#include "Benchmark.hh"
+
+// Diagram generation --------------------------------------------------
+
+enum class Structure
+{
+  Uniform,
+  Clustered,
+  NearDiagonal
+};
+
+std::string name( Structure structure )
+{
+  switch( structure )
+  {
+  case Structure::Uniform:
+    return "uniform";
+  case Structure::Clustered:
+    return "clustered";
+  case Structure::NearDiagonal:
+    return "near-diagonal";
+  }
+
+  return std::string();
+}
+
+aleph::PersistenceDiagram<double> makeDiagram( Structure structure, std::size_t n, unsigned seed )
+{
+  std::mt19937 rng( seed );
+  std::uniform_real_distribution<double> uniform( 0.0, 1.0 );
+
+  aleph::PersistenceDiagram<double> D;
+  D.reserve( n );
+
+  switch( structure )
+  {
+  case Structure::Uniform:
+    for( std::size_t i = 0; i < n; i++ )
+    {
+      auto x = uniform( rng );
+      auto y = x + uniform( rng );
+
+      D.add( x, y );
+    }
+    break;
+
+  case Structure::Clustered:
+    {
+      unsigned numCentres = 5;
+
+      std::vector< std::pair<double, double> > centres;
+      for( unsigned i = 0; i < numCentres; i++ )
+      {
+        auto x = uniform( rng );
+        auto y = x + 0.1 + uniform( rng );
+
+        centres.push_back( std::make_pair( x, y ) );
+      }
+
+      std::normal_distribution<double> normal( 0.0, 0.02 );
+      std::uniform_int_distribution<unsigned> centre( 0, numCentres - 1 );
+
+      for( std::size_t i = 0; i < n; i++ )
+      {
+        auto&& c = centres.at( centre( rng ) );
+        auto x   = c.first  + normal( rng );
+        auto y   = c.second + normal( rng );
+
+        D.add( x, std::max( x, y ) );
+      }
+    }
+    break;
+
+  case Structure::NearDiagonal:
+    {
+      std::exponential_distribution<double> exponential( 100.0 );
+
+      for( std::size_t i = 0; i < n; i++ )
+      {
+        auto x = uniform( rng );
+        auto y = uniform( rng ) < 0.9 ? x + exponential( rng ) : x + uniform( rng );
+
+        D.add( x, y );
+      }
+    }
+    break;
+  }
+
+  return D;
+}
+
+aleph::PersistenceDiagram<float> toSinglePrecision( const aleph::PersistenceDiagram<double>& D )
+{
+  aleph::PersistenceDiagram<float> E;
+  E.reserve( D.size() );
+
+  for( auto&& p : D )
+    E.add( float( p.x() ), float( p.y() ) );
+
+  return E;
+}
+
+// Methods -------------------------------------------------------------
+//
+// Every method is a functor that is able to handle diagrams in single
+// and in double precision. The exponent describes the growth of their
+// run time in terms of the number of points; it is used to skip sizes
+// that are not going to finish in time.
+
+struct Bottleneck
+{
+  static const char* name() { return "bottleneck"; }
+  static double exponent()  { return 2.5; }
+
+  template <class T> double operator()( const aleph::PersistenceDiagram<T>& D1, const aleph::PersistenceDiagram<T>& D2 ) const
+  {
+    return double( aleph::distances::bottleneckDistance( D1, D2 ) );
+  }
+};
+
+struct Wasserstein
+{
+  static const char* name() { return "wasserstein"; }
+  static double exponent()  { return 3.0; }
+
+  template <class T> double operator()( const aleph::PersistenceDiagram<T>& D1, const aleph::PersistenceDiagram<T>& D2 ) const
+  {
+    return double( aleph::distances::wassersteinDistance( D1, D2 ) );
+  }
+};
+
+struct Hausdorff
+{
+  static const char* name() { return "hausdorff"; }
+  static double exponent()  { return 2.0; }
+
+  template <class T> double operator()( const aleph::PersistenceDiagram<T>& D1, const aleph::PersistenceDiagram<T>& D2 ) const
+  {
+    return double( aleph::distances::hausdorffDistance( D1, D2 ) );
+  }
+};
+
+struct NearestNeighbour
+{
+  static const char* name() { return "nearest-neighbour"; }
+  static double exponent()  { return 2.0; }
+
+  template <class T> double operator()( const aleph::PersistenceDiagram<T>& D1, const aleph::PersistenceDiagram<T>& D2 ) const
+  {
+    return double( aleph::distances::nearestNeighbourDistance( D1, D2 ) );
+  }
+};
+
+struct MultiScaleKernel
+{
+  static const char* name() { return "multi-scale-kernel"; }
+  static double exponent()  { return 2.0; }
+
+  template <class T> double operator()( const aleph::PersistenceDiagram<T>& D1, const aleph::PersistenceDiagram<T>& D2 ) const
+  {
+    return aleph::multiScaleKernel( D1, D2, 1.0 );
+  }
+};
+
+struct LinearKernel
+{
+  static const char* name() { return "linear-kernel"; }
+  static double exponent()  { return 2.0; }
+
+  template <class T> double operator()( const aleph::PersistenceDiagram<T>& D1, const aleph::PersistenceDiagram<T>& D2 ) const
+  {
+    return aleph::linearKernel( D1, D2,
+                                aleph::detail::DefaultWeightFunction( 1.0, 1.0 ),
+                                aleph::detail::DefaultKernel( 1.0 ) );
+  }
+};
+
+// Benchmark -----------------------------------------------------------
+
+struct Options
+{
+  std::size_t minSize  = 10;
+  std::size_t maxSize  = 100000;
+  unsigned repetitions = 3;
+  unsigned seed        = 42;
+  double timeLimit     = 10000.0; // in milliseconds
+};
+
+double relativeDifference( double x, double y )
+{
+  auto scale = std::max( std::abs( x ), std::abs( y ) );
+  if( scale == 0.0 )
+    return 0.0;
+
+  return std::abs( x - y ) / scale;
+}
+
+template <class Method> void benchmark( const Options& options )
+{
+  Method method;
+
+  for( auto structure : { Structure::Uniform, Structure::Clustered, Structure::NearDiagonal } )
+  {
+    double previousTime      = 0.0;
+    std::size_t previousSize = 0;
+
+    for( auto n : aleph::benchmarks::sizes( options.minSize, options.maxSize ) )
+    {
+      if( aleph::benchmarks::exceedsTimeLimit( previousTime, previousSize, n, Method::exponent(), options.timeLimit ) )
+      {
+        std::cerr << "* Skipping " << Method::name() << " (" << name( structure ) << ") for n = " << n << " because it would exceed the time limit\n";
+        break;
+      }
+
+      auto D1 = makeDiagram( structure, n, options.seed );
+      auto D2 = makeDiagram( structure, n, options.seed + 1 );
+      auto E1 = toSinglePrecision( D1 );
+      auto E2 = toSinglePrecision( D2 );
+
+      // The method is only ever evaluated in a child process. Evaluating
+      // it for the numerical agreement uses inputs of the same size, so
+      // it does not increase the peak memory usage.
+      std::size_t peakMemory = 0;
+
+      auto values = aleph::benchmarks::runInChildProcess( [&] ()
+      {
+        double result    = 0.0;
+        auto measurement = aleph::benchmarks::measure( [&] () { result = method( D1, D2 ); }, options.repetitions );
+
+        return std::vector<double>( { measurement.time, result, method( D2, D1 ), method( E1, E2 ) } );
+      }, peakMemory );
+
+      auto time      = values.at(0);
+      auto result    = values.at(1);
+      auto asymmetry = relativeDifference( result, values.at(2) );
+      auto precision = relativeDifference( result, values.at(3) );
+
+      std::cout << Method::name() << ","
+                << name( structure ) << ","
+                << n << ","
+                << time << ","
+                << double( peakMemory ) / ( 1024.0 * 1024.0 ) << ","
+                << result << ","
+                << asymmetry << ","
+                << precision << "\n"
+                << std::flush;
+
+      previousTime = time;
+      previousSize = n;
+    }
+  }
+}
+
+void usage()
+{
+  std::cerr << "Usage: benchmark_distances [--min-size N] [--max-size N] [--repetitions R]\n"
+            << "                           [--seed S] [--time-limit T]\n"
+            << "\n"
+            << "Benchmarks distances and kernels for persistence diagrams of\n"
+            << "different sizes and structures. The results are written to\n"
+            << "STDOUT in CSV format.\n"
+            << "\n"
+            << "Optional arguments:\n"
+            << "\n"
+            << " --min-size N     : Minimum number of points in a diagram (10)\n"
+            << " --max-size N     : Maximum number of points in a diagram (100000)\n"
+            << " --repetitions R  : Number of repetitions per measurement (3)\n"
+            << " --seed S         : Seed for the random number generator (42)\n"
+            << " --time-limit T   : Time limit in seconds for a single evaluation;\n"
+            << "                    larger sizes are skipped for a method if its\n"
+            << "                    predicted run time exceeds this limit (10)\n"
+            << "\n";
+}
+
+int main( int argc, char** argv )
+{
+  static option commandLineOptions[] =
+  {
+    { "help"       , no_argument      , nullptr, 'h' },
+    { "max-size"   , required_argument, nullptr, 'N' },
+    { "min-size"   , required_argument, nullptr, 'n' },
+    { "repetitions", required_argument, nullptr, 'r' },
+    { "seed"       , required_argument, nullptr, 's' },
+    { "time-limit" , required_argument, nullptr, 't' },
+    { nullptr      , 0                , nullptr,  0  }
+  };
+
+  Options options;
+
+  int option = 0;
+  while( ( option = getopt_long( argc, argv, "hN:n:r:s:t:", commandLineOptions, nullptr ) ) != -1 )
+  {
+    switch( option )
+    {
+    case 'h':
+      usage();
+      return 0;
+
+    case 'N':
+      options.maxSize = std::stoul( optarg );
+      break;
+
+    case 'n':
+      options.minSize = std::stoul( optarg );
+      break;
+
+    case 'r':
+      options.repetitions = unsigned( std::stoul( optarg ) );
+      break;
+
+    case 's':
+      options.seed = unsigned( std::stoul( optarg ) );
+      break;
+
+    case 't':
+      options.timeLimit = 1000.0 * std::stod( optarg );
+      break;
+
+    default:
+      usage();
+      return -1;
+    }
+  }
+
+  if( options.minSize == 0 )
+  {
+    std::cerr << "* Minimum size must be positive\n";
+    return -1;
+  }
+
+  std::cout << "method,structure,n,time_ms,peak_memory_mib,value,asymmetry,precision\n";
+
+  benchmark<Bottleneck>( options );
+  benchmark<Wasserstein>( options );
+  benchmark<Hausdorff>( options );
+  benchmark<NearestNeighbour>( options );
+  benchmark<MultiScaleKernel>( options );
+  benchmark<LinearKernel>( options );
+}
@@ -23,13 +23,17 @@
 #include <aleph/topology/SimplicialComplex.hh>
 
 #include <aleph/utilities/Filesystem.hh>
+#include <aleph/utilities/Pipeline.hh>
 
 #include <iostream>
 #include <map>
 #include <regex>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
+#include <cstddef>
+
 int main( int argc, char** argv )
 {
   if( argc <= 1 )
@@ -47,52 +51,64 @@ int main( int argc, char** argv )
   for( int i = 1; i < argc; i++ )
     filenames.push_back( argv[i] );
 
-  aleph::topology::io::GMLReader reader;
-
   // Maps a data set ID to its corresponding Betti number. This is
   // required in order to generate a curve that measures how these
   // numbers change.
   std::map<unsigned, unsigned> id_to_betti;
 
-  for( auto&& filename : filenames )
-  {
-    if( verbose )
-      std::cerr << "* Processing " << filename << "...";
-
-    SimplicialComplex K;
-    reader( filename, K );
-
-    K.sort();
-
-    bool dualize                    = true;
-    bool includeAllUnpairedCreators = true;
-
-    auto diagrams
-      = aleph::calculatePersistenceDiagrams( K,
-                                             dualize,
-                                             includeAllUnpairedCreators );
-
-    if( verbose )
-      std::cerr << "finished\n";
-
-    auto basename
-      = aleph::utilities::basename( filename );
-
-    std::regex reDataSetSuffix( "\\D*([[:digit:]]+).*" );
-    std::smatch matches;
-
-    if( std::regex_match( basename, matches, reDataSetSuffix ) )
-    {
-      unsigned id = static_cast<unsigned>( std::stoull( matches[1] ) );
-
-      if( diagrams.size() >= 2 )
-        id_to_betti[id] = static_cast<unsigned>( diagrams[1].betti() );
-      else
-        id_to_betti[id] = static_cast<unsigned>( 0 );
-    }
-    else
-      throw std::runtime_error( "Unable to identify ID" );
-  }
+  // Files are read while the Betti numbers of the previous ones are
+  // being calculated in parallel.
+  aleph::utilities::Pipeline pipeline;
+
+  pipeline( filenames.size(),
+            [&] ( std::size_t i )
+            {
+              if( verbose )
+                std::cerr << "* Processing " << filenames[i] << "...";
+
+              aleph::topology::io::GMLReader reader;
+
+              SimplicialComplex K;
+              reader( filenames[i], K );
+
+              if( verbose )
+                std::cerr << "finished\n";
+
+              return K;
+            },
+            [] ( SimplicialComplex& K )
+            {
+              K.sort();
+
+              bool dualize                    = true;
+              bool includeAllUnpairedCreators = true;
+
+              auto diagrams
+                = aleph::calculatePersistenceDiagrams( K,
+                                                       dualize,
+                                                       includeAllUnpairedCreators );
+
+              if( diagrams.size() >= 2 )
+                return static_cast<unsigned>( diagrams[1].betti() );
+              else
+                return static_cast<unsigned>( 0 );
+            },
+            [&] ( std::size_t i, unsigned betti )
+            {
+              auto basename
+                = aleph::utilities::basename( filenames[i] );
+
+              std::regex reDataSetSuffix( "\\D*([[:digit:]]+).*" );
+              std::smatch matches;
+
+              if( std::regex_match( basename, matches, reDataSetSuffix ) )
+              {
+                unsigned id     = static_cast<unsigned>( std::stoull( matches[1] ) );
+                id_to_betti[id] = betti;
+              }
+              else
+                throw std::runtime_error( "Unable to identify ID" );
+            } );
 
   if( verbose )
     std::cerr << "* Obtained " << id_to_betti.size() << " data sets\n";
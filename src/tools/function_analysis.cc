@@ -3,18 +3,13 @@
 #include <aleph/persistenceDiagrams/Norms.hh>
 #include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
 
-#include <aleph/persistentHomology/Calculation.hh>
-
-#include <aleph/topology/filtrations/Data.hh>
-
-#include <aleph/topology/io/Function.hh>
-
-#include <aleph/topology/Simplex.hh>
-#include <aleph/topology/SimplicialComplex.hh>
+#include <aleph/persistentHomology/Function.hh>
 
 #include <aleph/utilities/String.hh>
 
+#include <algorithm>
 #include <fstream>
+#include <functional>
 #include <istream>
 #include <iostream>
 #include <limits>
@@ -28,9 +23,6 @@
 #include <getopt.h>
 
 using DataType           = double;
-using VertexType         = unsigned;
-using Simplex            = aleph::topology::Simplex<DataType, VertexType>;
-using SimplicialComplex  = aleph::topology::SimplicialComplex<Simplex>;
 using PersistenceDiagram = aleph::PersistenceDiagram<DataType>;
 
 /**
@@ -69,28 +61,32 @@ std::vector<DataType> condensePersistenceDiagram( const PersistenceDiagram& D )
 }
 
 /**
-  Auxiliary function for extracting the minimum and maximum data value
-  of a given simplicial complex.
+  Auxiliary function for extracting the minimum and maximum value of
+  a range of function values.
 */
 
-std::pair<DataType, DataType> minmaxData( const SimplicialComplex& K )
+template <class InputIterator> std::pair<DataType, DataType> minmaxData( InputIterator begin, InputIterator end )
 {
   DataType min = std::numeric_limits<DataType>::max();
   DataType max = std::numeric_limits<DataType>::lowest();
 
-  for( auto&& s : K )
+  for( auto it = begin; it != end; ++it )
   {
-    auto d = s.data();
-    min    = std::min( min, d );
-    max    = std::max( max, d );
+    min = std::min( min, *it );
+    max = std::max( max, *it );
   }
 
   return std::make_pair( min, max );
 }
 
-std::vector<SimplicialComplex> readData( std::istream& in, bool useSublevelSetFiltration )
+/**
+  Reads functions from an input stream, one function per line, and
+  appends their values to a contiguous vector. The offset of every
+  function in this vector is stored as well.
+*/
+
+void readData( std::istream& in, std::vector<DataType>& values, std::vector<std::size_t>& offsets )
 {
-  std::vector<SimplicialComplex> complexes;
   std::string line;
 
   while( std::getline( in, line ) )
@@ -101,9 +97,6 @@ std::vector<SimplicialComplex> readData( std::istream& in, bool useSublevelSetFi
           std::string( "[:;,[:space:]]+" )
     );
 
-    std::vector<DataType> values;
-    values.reserve( tokens.size() );
-
     for( auto&& token : tokens )
     {
       bool success = false;
@@ -115,40 +108,8 @@ std::vector<SimplicialComplex> readData( std::istream& in, bool useSublevelSetFi
       values.emplace_back( value );
     }
 
-    complexes.push_back(
-      aleph::topology::io::loadFunction<SimplicialComplex>(
-        values.begin(), values.end(),
-        [&useSublevelSetFiltration] ( DataType x, DataType y )
-        {
-          if( useSublevelSetFiltration )
-            return std::max(x,y);
-          else
-            return std::min(x,y);
-        }
-      )
-    );
-
-    auto&& K = complexes.back();
-
-    // Establish filtration order of the simplicial complex. For the
-    // sublevel set filtration, regular sorting is sufficient, while
-    // for the superlevel set filtration, the comparison functor has
-    // to be swapped out.
-    if( useSublevelSetFiltration )
-    {
-      K.sort(
-        aleph::topology::filtrations::Data< Simplex, std::less<DataType> >()
-      );
-    }
-    else
-    {
-      K.sort(
-        aleph::topology::filtrations::Data< Simplex, std::greater<DataType> >()
-      );
-    }
+    offsets.push_back( values.size() );
   }
-
-  return complexes;
 }
 
 void usage()
@@ -216,7 +177,10 @@ int main( int argc, char** argv )
     return -1;
   }
 
-  std::vector<SimplicialComplex> complexes;
+  // Values of all functions, stored contiguously, and the offsets of
+  // every function in this vector.
+  std::vector<DataType> values;
+  std::vector<std::size_t> offsets = { 0 };
 
   for( int i = optind; i < argc; i++ )
   {
@@ -232,22 +196,19 @@ int main( int argc, char** argv )
       in = &fin;
     }
 
-    auto localComplexes
-      = readData( *in, useSublevelSetFiltration );
+    readData( *in, values, offsets );
 
     std::cerr << "finished\n";
-
-    complexes.insert( complexes.end(),
-      localComplexes.begin(), localComplexes.end()
-    );
   }
 
-  std::cerr << "* Read " << complexes.size() << " simplicial complexes\n";
+  std::cerr << "* Read " << offsets.size() - 1 << " functions\n";
 
   // Persistent homology calculation -----------------------------------
   //
   // Calculate the zero-dimensional persistent homology of every stored
-  // complex.
+  // function. For the sublevel set filtration, edges are assigned the
+  // maximum of their vertices, and vice versa for the superlevel set
+  // filtration.
 
   std::cerr << "* Calculating persistent homology...";
 
@@ -259,15 +220,17 @@ int main( int argc, char** argv )
     out = &fout;
   }
 
-  for( auto&& K : complexes )
-  {
-    auto diagrams = aleph::calculatePersistenceDiagrams( K );
-    auto minmax   = minmaxData( K );
+  auto diagrams
+    = useSublevelSetFiltration
+      ? aleph::calculateFunctionPersistenceDiagrams( values, offsets )
+      : aleph::calculateFunctionPersistenceDiagrams( values, offsets, std::greater<DataType>() );
 
-    if( diagrams.size() != 1 )
-      throw std::runtime_error( "Unexpected number of persistence diagrams" );
+  for( std::size_t i = 0; i < diagrams.size(); i++ )
+  {
+    auto minmax = minmaxData( values.begin() + long( offsets[i] ),
+                              values.begin() + long( offsets[i+1] ) );
 
-    auto&& D    = diagrams.front();
+    auto&& D    = diagrams[i];
     using Point = typename PersistenceDiagram::Point;
 
     if( D.betti() != 1 )
@@ -9,34 +9,34 @@
   Original author: Bastian Rieck
 */
 
-#include <aleph/persistenceDiagrams/Extraction.hh>
-#include <aleph/persistenceDiagrams/Norms.hh>
 #include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
+#include <aleph/persistenceDiagrams/Statistics.hh>
 
 #include <aleph/persistenceDiagrams/io/Raw.hh>
 
+#include <aleph/utilities/Pipeline.hh>
+
+#include <algorithm>
+#include <exception>
 #include <iostream>
 #include <limits>
-#include <numeric>
+#include <sstream>
 #include <string>
 #include <vector>
 
 #include <getopt.h>
 
 #include <cmath>
+#include <cstddef>
 
 using DataType           = double;
 using PersistenceDiagram = aleph::PersistenceDiagram<DataType>;
-
-struct Input
-{
-  std::string filename;
-  PersistenceDiagram persistenceDiagram;
-};
+using Statistics         = aleph::PersistenceDiagramStatistics<DataType>;
 
 void usage()
 {
-  std::cerr << "Usage: persistence_diagram_statistics FILES\n"
+  std::cerr << "Usage: persistence_diagram_statistics [--invalid=VALUE] [--power=POWER]\n"
+            << "                                      [--summary] FILES\n"
             << "\n"
             << "Given a set of persistence diagrams, calculates numerous statistics\n"
             << "and writes them to STDOUT in CSV format.\n"
@@ -45,6 +45,10 @@ void usage()
             << "  - Average persistence\n"
             << "  - Infinity norm\n"
             << "  - Total persistence\n"
+            << "  - p-norm\n"
+            << "  - Persistent entropy\n"
+            << "  - Betti number\n"
+            << "  - Quartiles of persistence (approximated up to 1%)\n"
             << "\n"
             << "Optional arguments:\n"
             << "\n"
@@ -55,24 +59,50 @@ void usage()
             << " --power  : Use the specified power as an exponent during persistence\n"
             << "            calculations. This does not apply to the infinity norm of\n"
             << "            a persistence diagram.\n"
+            << "\n"
+            << " --summary: Only report a single row of statistics over the points of\n"
+            << "            all persistence diagrams.\n"
             << "\n\n";
 }
 
+/* Formats a row of the output for the given statistics */
+std::string format( const std::string& name, const Statistics& statistics )
+{
+  std::ostringstream stream;
+
+  stream << "'" << name                                                         << "'" << ","
+         << statistics.power()                                                        << ","
+         << statistics.totalPersistence()                                             << ","
+         << statistics.totalPersistence() / double( statistics.numPoints() )          << ","
+         << statistics.infinityNorm()                                                 << ","
+         << statistics.averagePersistence()                                           << ","
+         << statistics.pNorm()                                                        << ","
+         << statistics.persistentEntropy()                                            << ","
+         << statistics.betti()                                                        << ","
+         << statistics.quantile( 0.25 )                                               << ","
+         << statistics.quantile( 0.50 )                                               << ","
+         << statistics.quantile( 0.75 )                                               << "\n";
+
+  return stream.str();
+}
+
 int main( int argc, char** argv )
 {
   static option commandLineOptions[] =
   {
     { "invalid"       , required_argument, nullptr, 'i' },
     { "power"         , required_argument, nullptr, 'p' },
+    { "summary"       , no_argument      , nullptr, 's' },
     { nullptr         , 0                , nullptr,  0  }
   };
 
   DataType invalid = std::numeric_limits<DataType>::has_quiet_NaN ? std::numeric_limits<DataType>::quiet_NaN() : std::numeric_limits<DataType>::max();
   double p         = 2.0;
+  bool summary     = false;
 
   {
     int option = 0;
-    while( ( option = getopt_long( argc, argv, "i:p:", commandLineOptions, nullptr ) ) != -1 )
+    while( ( option = getopt_long( argc, argv, "i:p:s", commandLineOptions, nullptr ) ) != -1 )
     {
       switch( option )
       {
@@ -80,9 +110,16 @@ int main( int argc, char** argv )
         invalid = static_cast<DataType>( std::stod( optarg ) );
         break;
 
-      default:
+      case 'p':
         p = std::stod( optarg );
         break;
+
+      case 's':
+        summary = true;
+        break;
+
+      default:
+        break;
       }
     }
   }
@@ -93,8 +130,7 @@ int main( int argc, char** argv )
     return -1;
   }
 
-  std::vector<Input> inputs;
-  inputs.reserve( argc - optind );
+  std::vector<std::string> filenames( argv + optind, argv + argc );
 
   std::vector<std::string> columns = {
     "file" ,
@@ -102,25 +138,15 @@ int main( int argc, char** argv )
     "total_persistence",
     "total_persistence_normalized",
     "infinity_norm",
-    "average_persistence"
+    "average_persistence",
+    "p_norm",
+    "persistent_entropy",
+    "betti",
+    "persistence_q25",
+    "persistence_median",
+    "persistence_q75"
   };
 
-  for( int i = optind; i < argc; i++ )
-  {
-    std::string filename = argv[i];
-
-    std::cerr << "* Loading '" << filename << "'...";
-
-    Input input = {
-      filename,
-      aleph::io::load<DataType>( filename )
-    };
-
-    inputs.push_back( input );
-
-    std::cerr << "finished\n";
-  }
-
   // Header ------------------------------------------------------------
 
   {
@@ -134,43 +160,69 @@ int main( int argc, char** argv )
     std::cout << "\n";
   }
 
-  for( auto&& input : inputs )
-  {
-    if( !std::isnan( invalid ) && invalid != std::numeric_limits<DataType>::max() )
-    {
-      std::cerr << "* Filtering all persistence pairs that contain '" << invalid << "'...";
+  bool filter = !std::isnan( invalid ) && invalid != std::numeric_limits<DataType>::max();
 
-      using Point = typename PersistenceDiagram::Point;
+  if( filter )
+    std::cerr << "* Filtering all persistence pairs that contain '" << invalid << "'\n";
 
-      std::transform( input.persistenceDiagram.begin(), input.persistenceDiagram.end(),
-                      input.persistenceDiagram.begin(),
-                      [&invalid] ( const Point& p )
-                      {
-                        if( p.x() == invalid || p.y() == invalid )
-                          return Point( DataType(), DataType() );
-                        else
-                          return Point( p );
-                      } );
+  std::cerr << "* Processing " << filenames.size() << " persistence diagrams...";
 
-      input.persistenceDiagram.removeDiagonal();
+  // Every diagram is only required for calculating its statistics, so
+  // diagrams are loaded while the statistics of the previous ones are
+  // being calculated in parallel. Rows are written as soon as all rows
+  // before them are available. If a diagram cannot be loaded, the other
+  // threads are stopped and the error is reported here.
+  aleph::utilities::Pipeline pipeline;
+  Statistics total( p );
 
-      std::cerr << "\n";
-    }
-
-    auto totalPersistence           = aleph::totalPersistence( input.persistenceDiagram, p, false );
-    auto totalPersistenceNormalized = totalPersistence / static_cast<decltype(totalPersistence)>( input.persistenceDiagram.size() );
-    auto infinityNorm               = aleph::infinityNorm( input.persistenceDiagram );
+  try
+  {
+    pipeline( filenames.size(),
+              [&] ( std::size_t i )
+              {
+                return aleph::io::load<DataType>( filenames[i] );
+              },
+              [&] ( PersistenceDiagram& D )
+              {
+                if( filter )
+                {
+                  using Point = typename PersistenceDiagram::Point;
+
+                  std::transform( D.begin(), D.end(), D.begin(),
+                                  [&invalid] ( const Point& p )
+                                  {
+                                    if( p.x() == invalid || p.y() == invalid )
+                                      return Point( DataType(), DataType() );
+                                    else
+                                      return Point( p );
+                                  } );
+
+                  D.removeDiagonal();
+                }
+
+                Statistics statistics( p );
+                statistics( D );
+
+                return statistics;
+              },
+              [&] ( std::size_t i, const Statistics& statistics )
+              {
+                if( summary )
+                  total.merge( statistics );
+                else
+                  std::cout << format( filenames[i], statistics );
+              } );
+  }
+  catch( std::exception& e )
+  {
+    std::cerr << "failed\n"
+              << "* Unable to process persistence diagrams: " << e.what() << "\n";
 
-    std::vector<DataType> persistence;
-    aleph::persistence( input.persistenceDiagram, std::back_inserter( persistence ) );
+    return -1;
+  }
 
-    auto averagePersistence         = std::accumulate( persistence.begin(), persistence.end(), 0.0 ) / static_cast<double>( input.persistenceDiagram.size() );
+  std::cerr << "finished\n";
 
-    std::cout << "'" << input.filename      << "'" << ","
-              << p                          << ","
-              << totalPersistence           << ","
-              << totalPersistenceNormalized << ","
-              << infinityNorm               << ","
-              << averagePersistence         << "\n";
-  }
+  if( summary )
+    std::cout << format( "*", total );
 }
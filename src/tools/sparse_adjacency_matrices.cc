@@ -20,7 +20,6 @@
 #include <aleph/topology/Simplex.hh>
 #include <aleph/topology/SimplicialComplex.hh>
 
-#include <aleph/topology/filtrations/Data.hh>
 #include <aleph/topology/filtrations/Degree.hh>
 
 #include <aleph/topology/io/GML.hh>
@@ -28,6 +27,7 @@
 
 #include <aleph/utilities/Filesystem.hh>
 #include <aleph/utilities/Format.hh>
+#include <aleph/utilities/Pipeline.hh>
 #include <aleph/utilities/String.hh>
 
 #include <getopt.h>
@@ -37,9 +37,11 @@
 #include <iostream>
 #include <limits>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <cmath>
+#include <cstddef>
 
 using DataType          = float;
 using VertexType        = std::size_t;
@@ -124,131 +126,132 @@ int main( int argc, char** argv )
   std::cerr << "finished\n"
             << "* Read " << simplicialComplexes.size() << " simplicial complexes\n";
 
-  // Calculate closeness centrality ------------------------------------
+  // Prepare simplicial complexes -------------------------------------
 
-  if( calculateClosenessCentrality )
-  {
-    std::size_t index = 0;
-
-    for( auto&& K : simplicialComplexes )
-    {
-      K.sort();
-      auto cc     = closenessCentrality( K );
-      auto output = "/tmp/"
-                    + aleph::utilities::format( index, simplicialComplexes.size() )
-                    + "_closeness_centrality.txt";
+  auto n = simplicialComplexes.size();
 
-      std::ofstream out( output );
-      for( auto&& value : cc )
-        out << value << "\n";
+  std::vector< std::vector<DataType> > closenessCentralities( n );
+  std::vector< std::vector<DataType> > degrees( n );
 
-      ++index;
-    }
-  }
-
-  // Expand simplicial complexes ---------------------------------------
+  DataType maxDegree = 0;
 
-  aleph::geometry::RipsExpander<SimplicialComplex> expander;
+  std::cerr << "* Calculating degrees";
 
   if( dimension != 0 )
-  {
-    std::cerr << "* Expanding simplicial complexes to dimension " << dimension << "...";
-
-    for( auto&& K : simplicialComplexes )
-      expander( K, dimension );
-
-    std::cerr << "finished\n";
-  }
-
-  // Calculate degrees -------------------------------------------------
-
-  DataType maxDegree = 0;
+    std::cerr << " of simplicial complexes expanded to dimension " << dimension;
 
-  std::cerr << "* Calculating degree-based filtration...";
+  std::cerr << "...";
 
-  for( auto&& K : simplicialComplexes )
+  // The maximum degree over all graphs is required before any diagram
+  // can be written, so the degrees of all graphs are calculated first.
+  #pragma omp parallel for schedule(dynamic) reduction(max: maxDegree)
+  for( long i = 0; i < long( n ); i++ )
   {
-    std::vector<unsigned> degrees_;
-    aleph::topology::filtrations::degrees( K, std::back_inserter( degrees_ ) );
+    auto&& K = simplicialComplexes[ std::size_t(i) ];
 
-    std::vector<DataType> degrees( degrees_.begin(), degrees_.end() );
+    if( calculateClosenessCentrality )
+    {
+      K.sort();
+      closenessCentralities[ std::size_t(i) ] = closenessCentrality( K );
+    }
 
-    if( !degrees.empty() )
+    if( dimension != 0 )
     {
-      maxDegree
-        = std::max( maxDegree,
-                    *std::max_element( degrees.begin(), degrees.end() ) );
+      aleph::geometry::RipsExpander<SimplicialComplex> expander;
+      K = expander( K, dimension );
     }
 
-    if( useSumOfDegrees )
-      K = expander.assignData( K, degrees.begin(), degrees.end(), DataType(0), [] ( DataType a, DataType b ) { return a+b; } );
-    else
-      K = expander.assignMaximumData( K, degrees.begin(), degrees.end() );
+    std::vector<unsigned> degrees_;
+    aleph::topology::filtrations::degrees( K, std::back_inserter( degrees_ ) );
 
-    K.sort( aleph::topology::filtrations::Data<Simplex>() );
+    auto&& D = degrees[ std::size_t(i) ];
+    D.assign( degrees_.begin(), degrees_.end() );
+
+    if( !D.empty() )
+      maxDegree = std::max( maxDegree, *std::max_element( D.begin(), D.end() ) );
   }
 
   std::cerr << "finished\n"
             << "* Identified maximum degree as D=" << maxDegree << "\n";
 
-  // Store graphs ------------------------------------------------------
-
-  {
-    aleph::topology::io::GMLWriter writer;
-
-    for( std::size_t i = 0; i < simplicialComplexes.size(); i++ )
-    {
-      auto filename = "/tmp/"
-                      + aleph::utilities::format( i, simplicialComplexes.size() )
-                      + ".gml";
-
-      std::cerr << "* Storing graph in '" << filename << "'...";
-
-      writer( filename, simplicialComplexes[i] );
-
-      std::cerr << "finished\n";
-    }
-  }
-
   // Calculate persistent homology -------------------------------------
 
-  {
-    std::size_t index = 0;
-
-    for( auto&& K : simplicialComplexes )
-    {
-      bool dualize                    = true;
-      bool includeAllUnpairedCreators = true;
-
-      auto diagrams
-        = aleph::calculatePersistenceDiagrams( K,
-                                               dualize,
-                                               includeAllUnpairedCreators );
-
-      for( auto&& diagram : diagrams )
-      {
-        diagram.removeDiagonal();
-
-        auto output = "/tmp/"
-                      + aleph::utilities::format( index, simplicialComplexes.size() )
-                      + "_d"
-                      + std::to_string( diagram.dimension() )
-                      + ".txt";
-
-        std::ofstream out( output );
-
-        for( auto&& point : diagram )
-        {
-          if( point.isUnpaired() )
-            out << point.x() << "\t" << infinity * maxDegree << "\n";
-          else
-            out << point.x() << "\t" << point.y() << "\n";
-        }
-      }
-
-      ++index;
-    }
-  }
+  // Every graph is weighted independently, and the filtration builder
+  // creates a sorted complex at once, so no complex needs to be sorted
+  // afterwards. The persistent homology of all graphs is calculated in
+  // parallel, while the results of previous graphs are being stored.
+  using PersistenceDiagram = aleph::PersistenceDiagram<DataType>;
+  using Result             = std::pair< SimplicialComplex, std::vector<PersistenceDiagram> >;
+
+  aleph::utilities::Pipeline pipeline;
+  aleph::topology::io::GMLWriter writer;
+
+  pipeline( n,
+            [] ( std::size_t i )
+            {
+              return i;
+            },
+            [&] ( std::size_t i )
+            {
+              // Every index is only processed by a single thread, so the
+              // complex can be released afterwards.
+              auto K                 = std::move( simplicialComplexes[i] );
+              simplicialComplexes[i] = SimplicialComplex();
+
+              auto&& D = degrees[i];
+
+              if( useSumOfDegrees )
+                K = aleph::topology::filtrations::degreeFiltration( K, D.begin(), D.end(), DataType(0), [] ( DataType a, DataType b ) { return a+b; } );
+              else
+                K = aleph::topology::filtrations::degreeFiltration( K, D.begin(), D.end(), std::numeric_limits<DataType>::lowest(), [] ( DataType a, DataType b ) { return std::max( a, b ); } );
+
+              bool dualize                    = true;
+              bool includeAllUnpairedCreators = true;
+
+              auto diagrams
+                = aleph::calculatePersistenceDiagrams( K,
+                                                       dualize,
+                                                       includeAllUnpairedCreators );
+
+              return Result( std::move( K ), std::move( diagrams ) );
+            },
+            [&] ( std::size_t i, Result& result )
+            {
+              auto prefix = "/tmp/" + aleph::utilities::format( i, n );
+
+              if( calculateClosenessCentrality )
+              {
+                std::ofstream out( prefix + "_closeness_centrality.txt" );
+                for( auto&& value : closenessCentralities[i] )
+                  out << value << "\n";
+              }
+
+              std::cerr << "* Storing graph in '" << prefix << ".gml'...";
+
+              writer( prefix + ".gml", result.first );
+
+              std::cerr << "finished\n";
+
+              for( auto&& diagram : result.second )
+              {
+                diagram.removeDiagonal();
+
+                auto output = prefix
+                              + "_d"
+                              + std::to_string( diagram.dimension() )
+                              + ".txt";
+
+                std::ofstream out( output );
+
+                for( auto&& point : diagram )
+                {
+                  if( point.isUnpaired() )
+                    out << point.x() << "\t" << infinity * maxDegree << "\n";
+                  else
+                    out << point.x() << "\t" << point.y() << "\n";
+                }
+              }
+            } );
 
   // Store labels ------------------------------------------------------
 
@@ -43,12 +43,16 @@
 #include <map>
 #include <regex>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <cmath>
+#include <cstddef>
 
 #include <getopt.h>
 
+#include <aleph/math/SymmetricMatrix.hh>
+
 #include <aleph/persistenceDiagrams/Envelope.hh>
 #include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
 #include <aleph/persistenceDiagrams/PersistenceIndicatorFunction.hh>
@@ -56,15 +60,16 @@
 #include <aleph/persistenceDiagrams/distances/Hausdorff.hh>
 #include <aleph/persistenceDiagrams/distances/Wasserstein.hh>
 
+#include <aleph/persistenceDiagrams/kernels/GramMatrix.hh>
+
 #include <aleph/persistenceDiagrams/io/JSON.hh>
 #include <aleph/persistenceDiagrams/io/Raw.hh>
 
 #include <aleph/utilities/Filesystem.hh>
+#include <aleph/utilities/Pipeline.hh>
 
-using DataType                     = double;
-using PersistenceDiagram           = aleph::PersistenceDiagram<DataType>;
-using PersistenceIndicatorFunction = aleph::math::StepFunction<DataType>;
-using EnvelopeFunction             = aleph::math::PiecewiseLinearFunction<DataType>;
+using DataType           = double;
+using PersistenceDiagram = aleph::PersistenceDiagram<DataType>;
 
 /*
   Auxiliary structure for describing a data set. I need this in order to
@@ -78,15 +83,13 @@ struct DataSet
   unsigned dimension;
 
   PersistenceDiagram persistenceDiagram;
-  PersistenceIndicatorFunction persistenceIndicatorFunction;
-  EnvelopeFunction envelopeFunction;
 };
 
 /* Usage information */
 void usage()
 {
   std::cerr << "Usage: topological_distance [--power=POWER] [--kernel] [--exp] [--sigma]\n"
-            << "                            [--hausdorff|envelope|indicator|wasserstein]\n"
+            << "                            [--hausdorff|envelope|indicator|multi-scale|wasserstein]\n"
             << "                            [--clean] [--factor=FACTOR] FILES\n"
             << "\n"
             << "Calculates distances between a set of persistence diagrams, stored\n"
@@ -96,7 +99,8 @@ void usage()
             << "If no other value is given, all distances are weighted using $p=2$\n"
             << "during the construction of a pairwise distance matrix. Furthermore\n"
             << "this tool can calculate kernels for use in kernel-based methods in\n"
-            << "machine learning.\n"
+            << "machine learning. The multi-scale kernel is calculated directly and\n"
+            << "summed over all dimensions, instead of being derived from distances.\n"
             << "\n"
             << "Use --factor=FACTOR to specify the factor that will be used in the\n"
             << "treatment of unpaired points. If set to any non-zero value, all of\n"
@@ -117,179 +121,37 @@ void usage()
             << "  -h: calculate Hausdorff distances\n"
             << "  -i: calculate persistence indicator function distances\n"
             << "  -k: calculate kernel values instead of distances\n"
+            << "  -m: calculate multi-scale kernel values\n"
             << "  -n: normalize the persistence indicator function\n"
             << "  -s: use sigma as a scale parameter for the kernel\n"
             << "  -w: calculate Wasserstein distances\n"
             << "\n";
 }
 
-/*
-  Stores a matrix in an output stream. The matrix is formatted such that
-  individual values are separated by spaces and each row ends with '\n'.
-
-  This format can be easily parsed by auxiliary programs such as gnuplot
-  or R.
-*/
-
-void storeMatrix( const std::vector< std::vector<double> >& M, std::ostream& out )
-{
-  if( M.empty() )
-    return;
-
-  auto rows = M.size();
-  auto cols = M.front().size();
-
-  for( decltype(rows) row = 0; row < rows; row++ )
-  {
-    for( decltype(cols) col = 0; col < cols; col++ )
-    {
-      if( col != 0 )
-        out << " ";
-
-      out << M[row][col];
-    }
-
-    out << "\n";
-  }
-}
-
-/*
-  Calculates the topological distance between two data sets using persistence
-  indicator functions. This requires enumerating all dimensions and finding a
-  corresponding persistence indicator function. If no suitable function could
-  be found, the calculation defaults to calculating the norm.
-*/
-
-double distancePIF( const std::vector<DataSet>& dataSet1,
-                    const std::vector<DataSet>& dataSet2,
-                    unsigned minDimension,
-                    unsigned maxDimension,
-                    double power,
-                    bool normalize )
-{
-  auto getPersistenceIndicatorFunction = [] ( const std::vector<DataSet>& dataSet, unsigned dimension )
-  {
-    auto it = std::find_if( dataSet.begin(), dataSet.end(),
-                            [&dimension] ( const DataSet& dataSet )
-                            {
-                              return dataSet.dimension == dimension;
-                            } );
-
-    if( it != dataSet.end() )
-      return PersistenceIndicatorFunction( it->persistenceIndicatorFunction );
-    else
-      return PersistenceIndicatorFunction();
-  };
-
-  double d = 0.0;
-
-  for( unsigned dimension = minDimension; dimension <= maxDimension; dimension++ )
-  {
-    auto f = getPersistenceIndicatorFunction( dataSet1, dimension );
-    auto g = getPersistenceIndicatorFunction( dataSet2, dimension );
-
-    if( normalize )
-    {
-      f = aleph::math::normalize( f );
-      g = aleph::math::normalize( g );
-    }
-
-    g = -g;
-    if( power == 1.0 )
-      d = d + (f+g).abs().integral();
-    else
-      d = d + (f+g).abs().pow( power ).integral();
-  }
-
-  return d;
-}
-
-/*
-  Calculates the topological distance between two data sets using
-  envelope functions. This requires enumerating all dimensions in
-  order to find the corresponding envelope function. If no proper
-  function is found, the method defaults to calculating the norm.
-*/
-
-double distanceEnvelopeFunctions( const std::vector<DataSet>& dataSet1,
-                                  const std::vector<DataSet>& dataSet2,
-                                  unsigned minDimension,
-                                  unsigned maxDimension,
-                                  double power )
-{
-  auto getEnvelopeFunction = [] ( const std::vector<DataSet>& dataSet, unsigned dimension )
-  {
-    auto it = std::find_if( dataSet.begin(), dataSet.end(),
-                            [&dimension] ( const DataSet& dataSet )
-                            {
-                              return dataSet.dimension == dimension;
-                            } );
-
-    if( it != dataSet.end() )
-      return EnvelopeFunction( it->envelopeFunction );
-    else
-      return EnvelopeFunction();
-  };
-
-  double d = 0.0;
-
-  for( unsigned dimension = minDimension; dimension <= maxDimension; dimension++ )
-  {
-    auto f = getEnvelopeFunction( dataSet1, dimension );
-    auto g = getEnvelopeFunction( dataSet2, dimension );
-
-    g = -g;
-    if( power == 1.0 )
-      d = d + (f+g).abs().integral();
-    else
-      d = d + (f+g).abs().integral( power );
-  }
-
-  return d;
-}
-
 /*
   Calculates the topological distance between two data sets, using
   a standard distance between two persistence diagrams, for example
-  the Hausdorff, Wasserstein, or bottleneck distance.
+  the Hausdorff, Wasserstein, or bottleneck distance. The diagrams of
+  every dimension are stored in a table whose columns correspond to
+  the data sets.
 
   By default, the Wasserstein distance is calculated.
 */
 
 template <class Functor>
-double persistenceDiagramDistance( const std::vector<DataSet>& dataSet1,
-                                   const std::vector<DataSet>& dataSet2,
-                                   unsigned minDimension,
-                                   unsigned maxDimension,
+double persistenceDiagramDistance( const std::vector< std::vector<PersistenceDiagram> >& diagrams,
+                                   std::size_t index1,
+                                   std::size_t index2,
                                    double power,
                                    Functor functor = [] ( const PersistenceDiagram& D1, const PersistenceDiagram& D2, double power )
                                    {
                                      return aleph::distances::wassersteinDistance( D1, D2, power );
                                    } )
 {
-  auto getPersistenceDiagram = [] ( const std::vector<DataSet>& dataSet, unsigned dimension )
-  {
-    auto it = std::find_if( dataSet.begin(), dataSet.end(),
-                            [&dimension] ( const DataSet& dataSet )
-                            {
-                              return dataSet.dimension == dimension;
-                            } );
-
-    if( it != dataSet.end() )
-      return PersistenceDiagram( it->persistenceDiagram );
-    else
-      return PersistenceDiagram();
-  };
-
   double d = 0.0;
 
-  for( unsigned dimension = minDimension; dimension <= maxDimension; dimension++ )
-  {
-    auto D1 = getPersistenceDiagram( dataSet1, dimension );
-    auto D2 = getPersistenceDiagram( dataSet2, dimension );
-
-    d += functor( D1, D2, power );
-  }
+  for( auto&& row : diagrams )
+    d += functor( row[index1], row[index2], power );
 
   d = std::pow( d, 1.0 / power );
   return d;
@@ -350,6 +212,7 @@ int main( int argc, char** argv )
     { "indicator"  , no_argument      , nullptr, 'i' },
     { "normalize"  , no_argument      , nullptr, 'n' },
     { "kernel"     , no_argument      , nullptr, 'k' },
+    { "multi-scale", no_argument      , nullptr, 'm' },
     { "wasserstein", no_argument      , nullptr, 'w' },
     { nullptr      , 0                , nullptr,  0  }
   };
@@ -363,10 +226,11 @@ int main( int argc, char** argv )
   bool useIndicatorFunctionDistance = false;
   bool normalize                    = false;
   bool calculateKernel              = false;
+  bool useMultiScaleKernel          = false;
   bool useWassersteinDistance       = false;
 
   int option = 0;
-  while( ( option = getopt_long( argc, argv, "f:p:s:ceEhinkw", commandLineOptions, nullptr ) ) != -1 )
+  while( ( option = getopt_long( argc, argv, "f:p:s:ceEhinkmw", commandLineOptions, nullptr ) ) != -1 )
   {
     switch( option )
     {
@@ -386,6 +250,7 @@ int main( int argc, char** argv )
       useEnvelopeFunctionDistance  = true;
       useWassersteinDistance       = false;
       useIndicatorFunctionDistance = false;
+      useMultiScaleKernel          = false;
       break;
     case 'e':
       useExponentialFunction = true;
@@ -394,15 +259,23 @@ int main( int argc, char** argv )
       useWassersteinDistance       = false;
       useIndicatorFunctionDistance = false;
       useEnvelopeFunctionDistance  = false;
+      useMultiScaleKernel          = false;
       break;
     case 'i':
       useIndicatorFunctionDistance = true;
       useEnvelopeFunctionDistance  = false;
       useWassersteinDistance       = false;
+      useMultiScaleKernel          = false;
       break;
     case 'k':
       calculateKernel = true;
       break;
+    case 'm':
+      useMultiScaleKernel          = true;
+      useEnvelopeFunctionDistance  = false;
+      useIndicatorFunctionDistance = false;
+      useWassersteinDistance       = false;
+      break;
     case 'n':
       normalize = true;
       break;
@@ -410,6 +283,7 @@ int main( int argc, char** argv )
       useEnvelopeFunctionDistance  = false;
       useIndicatorFunctionDistance = false;
       useWassersteinDistance       = true;
+      useMultiScaleKernel          = false;
       break;
     default:
       break;
@@ -484,82 +358,92 @@ int main( int argc, char** argv )
           dimension = unsigned( std::stoul( matches[2] ) );
         }
 
-        dataSets.at( filenameMap[name] ).push_back( { name, filename, dimension, {}, {}, {} } );
+        dataSets.at( filenameMap[name] ).push_back( { name, filename, dimension, {} } );
 
         minDimension = std::min( minDimension, dimension );
         maxDimension = std::max( maxDimension, dimension );
       }
 
-      // Load persistence diagrams & calculate indicator functions -----
+      // Load persistence diagrams ------------------------------------
+
+      std::vector<DataSet*> pointers;
 
       for( auto&& sets : dataSets )
       {
         for( auto&& dataSet : sets )
-        {
-          std::cerr << "* Processing '" << dataSet.filename << "'...";
-
-          dataSet.persistenceDiagram
-            = postprocess( aleph::io::load<DataType>( dataSet.filename ),
-                           cleanPersistenceDiagrams,
-                           infinityFactor );
-
-          // FIXME: This is only required in order to ensure that the
-          // persistence indicator function has a finite integral; it
-          // can be solved more elegantly by using a special value to
-          // indicate infinite intervals.
-          auto pd = dataSet.persistenceDiagram;
-          pd.removeUnpaired();
-
-          dataSet.persistenceIndicatorFunction = aleph::persistenceIndicatorFunction( pd );
-          dataSet.envelopeFunction             = aleph::Envelope()( pd );
-
-          std::cerr << "finished\n";
-        }
+          pointers.push_back( &dataSet );
       }
+
+      // Diagrams are loaded while the previous ones are being processed
+      // in parallel.
+      aleph::utilities::Pipeline pipeline;
+
+      pipeline( pointers.size(),
+                [&] ( std::size_t i )
+                {
+                  return aleph::io::load<DataType>( pointers[i]->filename );
+                },
+                [&] ( PersistenceDiagram& diagram )
+                {
+                  return postprocess( diagram,
+                                      cleanPersistenceDiagrams,
+                                      infinityFactor );
+                },
+                [&] ( std::size_t i, PersistenceDiagram& diagram )
+                {
+                  std::cerr << "* Processed '" << pointers[i]->filename << "'\n";
+
+                  pointers[i]->persistenceDiagram = std::move( diagram );
+                } );
     }
     else if( aleph::utilities::extension( filenames.front() ) == ".json" )
     {
       dataSets.reserve( filenames.size() );
 
-      for( auto&& filename : filenames )
-      {
-        auto persistenceDiagrams= aleph::io::readJSON<DataType>( filename );
-
-        std::vector<DataSet> dataSet;
-        dataSet.reserve( persistenceDiagrams.size() );
-
-        for( auto&& diagram : persistenceDiagrams )
-        {
-          diagram
-            = postprocess( diagram,
-                           cleanPersistenceDiagrams,
-                           infinityFactor );
-
-          auto dimension = static_cast<unsigned>( diagram.dimension() );
-          minDimension   = std::min( minDimension, dimension );
-          maxDimension   = std::max( maxDimension, dimension );
-
-          auto name  = aleph::utilities::stem( filename );
-          name      += "_";
-          name      += "d" + std::to_string( diagram.dimension() );
-
-          // FIXME: This is only required in order to ensure that the
-          // persistence indicator function has a finite integral; it
-          // can be solved more elegantly by using a special value to
-          // indicate infinite intervals.
-          auto pd = diagram;
-          pd.removeUnpaired();
-
-          dataSet.push_back( { name,
-                               filename,
-                               dimension,
-                               diagram,
-                               aleph::persistenceIndicatorFunction( pd ),
-                               aleph::Envelope()( pd ) } );
-        }
+      aleph::utilities::Pipeline pipeline;
 
-        dataSets.push_back( dataSet );
-      }
+      pipeline( filenames.size(),
+                [&] ( std::size_t i )
+                {
+                  return aleph::io::readJSON<DataType>( filenames[i] );
+                },
+                [&] ( std::vector<PersistenceDiagram>& persistenceDiagrams )
+                {
+                  for( auto&& diagram : persistenceDiagrams )
+                  {
+                    diagram
+                      = postprocess( diagram,
+                                     cleanPersistenceDiagrams,
+                                     infinityFactor );
+                  }
+
+                  return persistenceDiagrams;
+                },
+                [&] ( std::size_t i, std::vector<PersistenceDiagram>& persistenceDiagrams )
+                {
+                  auto&& filename = filenames[i];
+
+                  std::vector<DataSet> dataSet;
+                  dataSet.reserve( persistenceDiagrams.size() );
+
+                  for( auto&& diagram : persistenceDiagrams )
+                  {
+                    auto dimension = static_cast<unsigned>( diagram.dimension() );
+                    minDimension   = std::min( minDimension, dimension );
+                    maxDimension   = std::max( maxDimension, dimension );
+
+                    auto name  = aleph::utilities::stem( filename );
+                    name      += "_";
+                    name      += "d" + std::to_string( diagram.dimension() );
+
+                    dataSet.push_back( { name,
+                                         filename,
+                                         dimension,
+                                         std::move( diagram ) } );
+                  }
+
+                  dataSets.push_back( std::move( dataSet ) );
+                } );
     }
   }
 
@@ -584,22 +468,102 @@ int main( int argc, char** argv )
   // Calculate all distances -------------------------------------------
 
   {
-    auto name = useEnvelopeFunctionDistance ? "envelope function"
-                                            : useIndicatorFunctionDistance
-                                              ? "persistence indicator function"
-                                              : useWassersteinDistance
-                                                ? "Wasserstein"
-                                                : "Hausdorff";
+    auto name = useMultiScaleKernel ? "multi-scale kernel"
+                                    : useEnvelopeFunctionDistance
+                                      ? "envelope function"
+                                      : useIndicatorFunctionDistance
+                                        ? "persistence indicator function"
+                                        : useWassersteinDistance
+                                          ? "Wasserstein"
+                                          : "Hausdorff";
+
+    auto type = calculateKernel || useMultiScaleKernel ? "kernel values" : "distances";
+
+    if( useMultiScaleKernel )
+      std::cerr << "* Calculating pairwise " << type << " with " << name << "\n";
+    else
+      std::cerr << "* Calculating pairwise " << type << " with " << name << " distance\n";
+    std::cerr << "* Calculating pairwise " << type << " with p=" << power << "...";
+  }
 
-    auto type = calculateKernel ? "kernel values" : "distances";
+  // Collect the diagrams of every dimension once, instead of looking
+  // them up for every pair of data sets. A data set without a diagram
+  // in some dimension uses an empty diagram. If no diagram has been
+  // loaded at all, the range of dimensions is empty, and all distances
+  // are zero.
+  unsigned numDimensions = minDimension <= maxDimension ? maxDimension - minDimension + 1 : 0;
 
-    std::cerr << "* Calculating pairwise " << type << " with " << name << " distance\n";
-    std::cerr << "* Calculating pairwise " << type << " with p=" << power << "...";
+  std::vector< std::vector<PersistenceDiagram> > diagrams( numDimensions );
+
+  for( unsigned d = 0; d < numDimensions; d++ )
+  {
+    auto dimension = minDimension + d;
+    auto&& row     = diagrams[d];
+
+    row.reserve( dataSets.size() );
+
+    for( auto&& sets : dataSets )
+    {
+      auto it = std::find_if( sets.begin(), sets.end(),
+                              [&dimension] ( const DataSet& dataSet )
+                              {
+                                return dataSet.dimension == dimension;
+                              } );
+
+      row.push_back( it != sets.end() ? it->persistenceDiagram : PersistenceDiagram() );
+    }
   }
 
-  std::vector< std::vector<double> > distances;
-  distances.resize( dataSets.size(), std::vector<double>( dataSets.size() ) );
+  aleph::math::SymmetricMatrix<double> distances( dataSets.size() );
 
+  // The functions of all data sets are calculated at once for every
+  // dimension. A data set without a diagram in some dimension uses an
+  // empty function, whose distance to any function is its norm.
+  if( useIndicatorFunctionDistance || useEnvelopeFunctionDistance || useMultiScaleKernel )
+  {
+    for( auto&& row : diagrams )
+    {
+      // FIXME: This is only required in order to ensure that the
+      // persistence indicator function has a finite integral; it
+      // can be solved more elegantly by using a special value to
+      // indicate infinite intervals.
+      for( auto&& diagram : row )
+        diagram.removeUnpaired();
+
+      // The kernel values of different dimensions are summed, which
+      // again results in a kernel.
+      if( useMultiScaleKernel )
+      {
+        auto G = aleph::makeMultiScaleGramMatrix<DataType>( sigma );
+        G.add( row.begin(), row.end() );
+
+        for( std::size_t i = 0; i < dataSets.size(); i++ )
+        {
+          for( std::size_t j = i; j < dataSets.size(); j++ )
+            distances(i,j) += G(i,j);
+        }
+
+        continue;
+      }
+
+      auto F = useIndicatorFunctionDistance ? aleph::persistenceIndicatorFunctions( row )
+                                            : aleph::Envelope()( row );
+
+      if( useIndicatorFunctionDistance && normalize )
+        F.normalize();
+
+      auto M = aleph::math::pairwiseDistances( F, power );
+
+      // Distances of indicator functions are not normalized by taking
+      // the root, in contrast to the ones of envelope functions.
+      for( std::size_t i = 0; i < dataSets.size(); i++ )
+      {
+        for( std::size_t j = i + 1; j < dataSets.size(); j++ )
+          distances(i,j) += useIndicatorFunctionDistance ? std::pow( M(i,j), power ) : M(i,j);
+      }
+    }
+  }
+  else
   {
     std::size_t n = dataSets.size();
     std::size_t m = dataSets.size() * ( dataSets.size() - 1 ) / 2;
@@ -610,24 +574,26 @@ int main( int argc, char** argv )
       auto row = std::size_t( double( n - 2 ) - std::floor( std::sqrt( -8*k + 4*n*(n-1) - 7 ) / 2.0 - 0.5 ) );
       auto col = std::size_t( k + row + 1 - n*(n-1)/2 + (n-row)*( (n-row)-1 ) / 2 );
 
-      double d = 0.0;
-
-      if( useIndicatorFunctionDistance )
-        d = distancePIF( dataSets.at(row), dataSets.at(col), minDimension, maxDimension, power, normalize );
-      else if( useEnvelopeFunctionDistance )
-        d = distanceEnvelopeFunctions( dataSets.at(row), dataSets.at(col), minDimension, maxDimension, power );
-      else
-        d = persistenceDiagramDistance( dataSets.at(row), dataSets.at(col), minDimension, maxDimension, power, functor );
+      distances(row, col) = persistenceDiagramDistance( diagrams, row, col, power, functor );
+    }
+  }
 
-      if( calculateKernel )
+  // Kernel values are derived from the distances, unless they have been
+  // calculated directly. The symmetric matrix only stores one triangle,
+  // so every entry is transformed exactly once.
+  if( calculateKernel && !useMultiScaleKernel )
+  {
+    for( std::size_t row = 0; row < dataSets.size(); row++ )
+    {
+      for( std::size_t col = row; col < dataSets.size(); col++ )
       {
-        d = -d;
+        double d = -distances(row, col);
+
         if( useExponentialFunction )
           d = std::exp( sigma * d );
-      }
 
-      distances[row][col] = d;
-      distances[col][row] = d;
+        distances(row, col) = d == 0.0 ? 0.0 : d;
+      }
     }
   }
 
@@ -635,7 +601,7 @@ int main( int argc, char** argv )
 
   std::cerr << "Storing matrix...";
 
-  storeMatrix( distances, std::cout );
+  std::cout << distances;
 
   std::cerr << "finished\n";
 
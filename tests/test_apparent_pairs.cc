@@ -0,0 +1,300 @@
+#include <aleph/containers/PointCloud.hh>
+
+#include <aleph/geometry/BruteForce.hh>
+#include <aleph/geometry/ManifoldSampling.hh>
+#include <aleph/geometry/VietorisRipsComplex.hh>
+
+#include <aleph/geometry/distances/Euclidean.hh>
+
+#include <tests/Base.hh>
+
+#include <aleph/persistentHomology/ApparentPairs.hh>
+#include <aleph/persistentHomology/Calculation.hh>
+#include <aleph/persistentHomology/Strategy.hh>
+
+#include <aleph/topology/Conversions.hh>
+#include <aleph/topology/RandomGraph.hh>
+#include <aleph/topology/Simplex.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace aleph;
+using namespace containers;
+using namespace geometry;
+using namespace topology;
+
+template <class T> std::vector< std::pair<T, T> > sortedPoints( const PersistenceDiagram<T>& D )
+{
+  std::vector< std::pair<T, T> > points;
+
+  for( auto&& p : D )
+    points.push_back( std::make_pair( p.x(), p.y() ) );
+
+  std::sort( points.begin(), points.end() );
+  return points;
+}
+
+/**
+  Calculates persistence diagrams with and without a threshold for their
+  persistence and checks that the diagrams contain the same points above
+  the threshold.
+*/
+
+template <class Simplex> void checkThreshold( const SimplicialComplex<Simplex>& K,
+                                              typename Simplex::DataType threshold,
+                                              bool dualize,
+                                              bool includeAllUnpairedCreators )
+{
+  using DataType = typename Simplex::DataType;
+
+  auto D1 = calculatePersistenceDiagrams( K, dualize, includeAllUnpairedCreators );
+  auto D2 = calculatePersistenceDiagrams( K, dualize, includeAllUnpairedCreators, 0, threshold );
+
+  for( auto&& D : D1 )
+  {
+    D.erase(
+      std::remove_if( D.begin(), D.end(),
+                      [&threshold] ( const typename PersistenceDiagram<DataType>::Point& p )
+                      {
+                        return !p.isUnpaired() && p.persistence() < threshold;
+                      } ),
+      D.end()
+    );
+  }
+
+  D1.erase( std::remove_if( D1.begin(), D1.end(), [] ( const PersistenceDiagram<DataType>& D ) { return D.empty(); } ), D1.end() );
+  D2.erase( std::remove_if( D2.begin(), D2.end(), [] ( const PersistenceDiagram<DataType>& D ) { return D.empty(); } ), D2.end() );
+
+  ALEPH_ASSERT_EQUAL( D1.size(), D2.size() );
+
+  for( std::size_t i = 0; i < D1.size(); i++ )
+  {
+    ALEPH_ASSERT_EQUAL( D1[i].dimension(), D2[i].dimension() );
+    ALEPH_ASSERT_THROW( sortedPoints( D1[i] ) == sortedPoints( D2[i] ) );
+  }
+}
+
+/**
+  Checks that all eliminated pairs are part of the persistence pairing of
+  a simplicial complex, and that reducing the remaining boundary matrix
+  yields the other pairs.
+*/
+
+template <class Simplex> void checkElimination( const SimplicialComplex<Simplex>& K )
+{
+  using Index = defaults::Index;
+
+  PersistencePairing<Index> eliminated;
+  std::vector<Index> indices;
+
+  auto M = eliminateApparentPairs<defaults::Representation>( K, eliminated, indices );
+
+  ALEPH_ASSERT_EQUAL( M.getNumColumns(), indices.size() );
+
+  auto pairing   = calculatePersistencePairing( makeBoundaryMatrix( K ), true );
+  auto remaining = calculatePersistencePairing( M, true );
+
+  std::vector< std::pair<Index, Index> > pairs( eliminated.begin(), eliminated.end() );
+
+  for( auto&& pair : remaining )
+    pairs.push_back( std::make_pair( indices[ pair.first ], pair.second < indices.size() ? indices[ pair.second ] : pair.second ) );
+
+  std::sort( pairs.begin(), pairs.end() );
+
+  ALEPH_ASSERT_EQUAL( pairs.size(), pairing.size() );
+  ALEPH_ASSERT_THROW( std::equal( pairs.begin(), pairs.end(), pairing.begin() ) );
+}
+
+void testElimination()
+{
+  ALEPH_TEST_BEGIN( "Elimination of apparent pairs" );
+
+  using DataType   = unsigned;
+  using VertexType = unsigned;
+  using Simplex    = Simplex<DataType, VertexType>;
+
+  std::vector<Simplex> simplices = {
+    Simplex( VertexType(0) ), Simplex( VertexType(1) ), Simplex( VertexType(2) ),
+    Simplex( {0,1}, 1 ), Simplex( {0,2}, 1 ), Simplex( {1,2}, 2 ),
+    Simplex( {0,1,2}, 3 )
+  };
+
+  // A filled triangle is eliminated completely, because all of its pairs
+  // are apparent.
+  {
+    SimplicialComplex<Simplex> K( simplices.begin(), simplices.end() );
+
+    PersistencePairing<defaults::Index> eliminated;
+    std::vector<defaults::Index> indices;
+
+    auto M = eliminateApparentPairs<defaults::Representation>( K, eliminated, indices );
+
+    ALEPH_ASSERT_EQUAL( M.getNumColumns(), 0 );
+    ALEPH_ASSERT_EQUAL( eliminated.size(), 4 );
+
+    checkElimination( K );
+  }
+
+  // For the boundary of the triangle, only the youngest edge remains; it
+  // creates an essential cycle.
+  {
+    SimplicialComplex<Simplex> K( simplices.begin(), simplices.end() - 1 );
+
+    PersistencePairing<defaults::Index> eliminated;
+    std::vector<defaults::Index> indices;
+
+    auto M = eliminateApparentPairs<defaults::Representation>( K, eliminated, indices );
+
+    ALEPH_ASSERT_EQUAL( M.getNumColumns(), 1 );
+    ALEPH_ASSERT_EQUAL( indices.front(),   5 );
+
+    checkElimination( K );
+  }
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testRipsComplex()
+{
+  ALEPH_TEST_BEGIN( "Persistence threshold for Vietoris--Rips complex" );
+
+  using Distance = distances::Euclidean<T>;
+
+  auto pc = sampleSphere<T>( 150, 1, T(1), 23 );
+  addGaussianNoise( pc, T(0.05), 42 );
+
+  BruteForce<PointCloud<T>, Distance> bruteForce( pc );
+
+  auto K = buildVietorisRipsComplex( bruteForce, T(0.6), 2 );
+
+  checkElimination( K );
+
+  // Almost all pairs of a Vietoris--Rips complex can be eliminated; the
+  // remaining columns mostly belong to triangles that create classes of
+  // the highest dimension.
+  {
+    PersistencePairing<defaults::Index> eliminated;
+    std::vector<defaults::Index> indices;
+
+    auto M         = eliminateApparentPairs<defaults::Representation>( K, eliminated, indices );
+    auto remaining = calculatePersistencePairing( M );
+
+    ALEPH_ASSERT_THROW( remaining.size() * 10 < eliminated.size() );
+  }
+
+  for( bool dualize : { true, false } )
+  {
+    for( bool includeAllUnpairedCreators : { false, true } )
+    {
+      checkThreshold( K, T(0.05), dualize, includeAllUnpairedCreators );
+      checkThreshold( K, T(0.50), dualize, includeAllUnpairedCreators );
+    }
+  }
+
+  // The circle is the only feature whose persistence is large
+  auto diagrams = calculatePersistenceDiagrams( K, true, false, 0, T(0.5) );
+
+  std::size_t numPoints = 0;
+  for( auto&& D : diagrams )
+    numPoints += D.size();
+
+  ALEPH_ASSERT_EQUAL( numPoints, 2 );
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testMemoryBudget()
+{
+  ALEPH_TEST_BEGIN( "Persistence threshold with memory budget" );
+
+  using Distance = distances::Euclidean<T>;
+
+  auto pc = sampleSphere<T>( 150, 1, T(1), 23 );
+  addGaussianNoise( pc, T(0.05), 42 );
+
+  BruteForce<PointCloud<T>, Distance> bruteForce( pc );
+
+  auto K = buildVietorisRipsComplex( bruteForce, T(0.6), 2 );
+
+  Strategy strategy;
+  strategy.eliminateApparentPairs = true;
+  strategy.dualize                = true;
+
+  auto estimateDualized = aleph::detail::estimateMemoryUsage<defaults::Representation>( K, strategy );
+
+  strategy.dualize = false;
+
+  auto estimate = aleph::detail::estimateMemoryUsage<defaults::Representation>( K, strategy );
+
+  // The columns and rows of the elimination may well require more memory
+  // than the dualization, so both estimates can be the same.
+  ALEPH_ASSERT_THROW( estimateDualized >= estimate );
+  ALEPH_ASSERT_THROW( estimate         >  K.memoryUsage() );
+
+  auto diagrams = calculatePersistenceDiagrams( K, true, false, 0, T(0.5) );
+
+  // Budgets that permit the calculation, with or without dualization,
+  // must not change the diagrams.
+  for( auto&& budget : { estimateDualized, estimate } )
+  {
+    auto D = calculatePersistenceDiagrams( K, true, false, budget, T(0.5) );
+
+    ALEPH_ASSERT_EQUAL( D.size(), diagrams.size() );
+
+    for( std::size_t i = 0; i < D.size(); i++ )
+      ALEPH_ASSERT_THROW( D[i] == diagrams[i] );
+  }
+
+  // Apparent pairs are eliminated in memory, so a budget that does not
+  // suffice for this is an error, as it is without a threshold.
+  bool thrown = false;
+
+  try
+  {
+    calculatePersistenceDiagrams( K, true, false, estimate - 1, T(0.5) );
+  }
+  catch( std::runtime_error& )
+  {
+    thrown = true;
+  }
+
+  ALEPH_ASSERT_THROW( thrown );
+  ALEPH_TEST_END();
+}
+
+void testRandomGraph()
+{
+  ALEPH_TEST_BEGIN( "Persistence threshold for weighted random graph" );
+
+  auto K = generateWeightedRandomGraph( 300, 0.02, 23 );
+
+  checkElimination( K );
+
+  for( bool dualize : { true, false } )
+  {
+    for( bool includeAllUnpairedCreators : { false, true } )
+    {
+      checkThreshold( K, 1u, dualize, includeAllUnpairedCreators );
+      checkThreshold( K, 2u, dualize, includeAllUnpairedCreators );
+    }
+  }
+
+  ALEPH_TEST_END();
+}
+
+int main( int, char** )
+{
+  testElimination();
+
+  testRipsComplex<float> ();
+  testRipsComplex<double>();
+
+  testMemoryBudget<float> ();
+  testMemoryBudget<double>();
+
+  testRandomGraph();
+}
@@ -0,0 +1,148 @@
+#include <tests/Base.hh>
+
+#include <aleph/math/CombinationRanking.hh>
+#include <aleph/math/Combinations.hh>
+
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+void testBinomialCoefficients()
+{
+  ALEPH_TEST_BEGIN( "Binomial coefficients" );
+
+  using namespace aleph::math;
+
+  ALEPH_ASSERT_EQUAL( binomialCoefficient( 0, 0 ),  1 );
+  ALEPH_ASSERT_EQUAL( binomialCoefficient( 5, 0 ),  1 );
+  ALEPH_ASSERT_EQUAL( binomialCoefficient( 5, 2 ), 10 );
+  ALEPH_ASSERT_EQUAL( binomialCoefficient( 5, 5 ),  1 );
+  ALEPH_ASSERT_EQUAL( binomialCoefficient( 3, 5 ),  0 );
+
+  ALEPH_ASSERT_EQUAL( binomialCoefficient( 66, 33 ), 7219428434016265740ull );
+
+  bool thrown = false;
+
+  try
+  {
+    binomialCoefficient( 100, 50 );
+  }
+  catch( std::overflow_error& )
+  {
+    thrown = true;
+  }
+
+  ALEPH_ASSERT_THROW( thrown );
+
+  ALEPH_TEST_END();
+}
+
+void testRanking()
+{
+  ALEPH_TEST_BEGIN( "Ranking and unranking of combinations" );
+
+  using namespace aleph::math;
+
+  for( unsigned n = 1; n <= 8; n++ )
+  {
+    for( unsigned k = 1; k <= n; k++ )
+    {
+      std::vector<unsigned> indices( n );
+      std::iota( indices.begin(), indices.end(), 0u );
+
+      std::vector<unsigned> combination;
+      std::uintmax_t rank = 0;
+
+      // The enumeration by for_each_combination() proceeds in
+      // lexicographical order, so it permits checking all ranks.
+      for_each_combination( indices.begin(), indices.begin() + k, indices.end(),
+        [&] ( std::vector<unsigned>::iterator first, std::vector<unsigned>::iterator last )
+        {
+          std::vector<unsigned> expected( first, last );
+
+          ALEPH_ASSERT_EQUAL( rankCombination( first, last, n ), rank );
+
+          std::vector<unsigned> unranked;
+          unrankCombination( rank, n, k, std::back_inserter( unranked ) );
+
+          ALEPH_ASSERT_THROW( unranked == expected );
+
+          if( rank > 0 )
+          {
+            ALEPH_ASSERT_THROW( nextCombination( combination.begin(), combination.end(), n ) );
+            ALEPH_ASSERT_THROW( combination == expected );
+          }
+          else
+            combination = expected;
+
+          ++rank;
+          return false;
+        }
+      );
+
+      ALEPH_ASSERT_EQUAL( rank, binomialCoefficient( n, k ) );
+      ALEPH_ASSERT_THROW( nextCombination( combination.begin(), combination.end(), n ) == false );
+    }
+  }
+
+  ALEPH_TEST_END();
+}
+
+void testParallelEnumeration()
+{
+  ALEPH_TEST_BEGIN( "Parallel enumeration of combinations" );
+
+  using namespace aleph::math;
+  using Iterator = std::vector<unsigned>::const_iterator;
+
+  unsigned n = 20;
+  unsigned k = 5;
+
+  for( std::size_t numChunks : { 1, 7, 100, 100000 } )
+  {
+    std::vector< std::vector<std::uintmax_t> > ranks( numChunks );
+
+    parallelForEachCombination( n, k, numChunks,
+      [&ranks, n] ( std::size_t chunk, Iterator first, Iterator last )
+      {
+        ranks[chunk].push_back( rankCombination( first, last, n ) );
+        return false;
+      }
+    );
+
+    std::vector<std::uintmax_t> allRanks;
+    for( auto&& chunk : ranks )
+      allRanks.insert( allRanks.end(), chunk.begin(), chunk.end() );
+
+    ALEPH_ASSERT_EQUAL( allRanks.size(), binomialCoefficient( n, k ) );
+
+    for( std::size_t i = 0; i < allRanks.size(); i++ )
+      ALEPH_ASSERT_EQUAL( allRanks[i], i );
+  }
+
+  // Early exit: every chunk stops after its first combination
+  {
+    std::size_t numChunks = 10;
+    std::vector<unsigned> calls( numChunks );
+
+    parallelForEachCombination( n, k, numChunks,
+      [&calls] ( std::size_t chunk, Iterator, Iterator )
+      {
+        ++calls[chunk];
+        return true;
+      }
+    );
+
+    for( auto&& c : calls )
+      ALEPH_ASSERT_EQUAL( c, 1 );
+  }
+
+  ALEPH_TEST_END();
+}
+
+int main( int, char** )
+{
+  testBinomialCoefficients();
+  testRanking();
+  testParallelEnumeration();
+}
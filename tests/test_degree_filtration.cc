@@ -0,0 +1,174 @@
+#include <tests/Base.hh>
+
+#include <aleph/geometry/RipsExpander.hh>
+
+#include <aleph/topology/Simplex.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <aleph/topology/filtrations/Data.hh>
+#include <aleph/topology/filtrations/Degree.hh>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace aleph;
+using namespace topology;
+using namespace filtrations;
+
+template <class T> void testDegrees()
+{
+  ALEPH_TEST_BEGIN( "Degree filtration: degrees" );
+
+  using DataType          = float;
+  using Simplex           = Simplex<DataType, T>;
+  using SimplicialComplex = SimplicialComplex<Simplex>;
+
+  // The vertices are not contiguous, and the last one is isolated, so
+  // it has to be reported with a degree of zero.
+  SimplicialComplex K( {
+      {0}, {1}, {2}, {5}, {7},
+      {0,1}, {1,2}, {0,2}, {2,5}
+    }
+  );
+
+  std::vector<unsigned> degrees;
+  filtrations::degrees( K, std::back_inserter( degrees ) );
+
+  ALEPH_ASSERT_THROW( degrees == std::vector<unsigned>( { 2, 2, 3, 1, 0 } ) );
+
+  SimplicialComplex L( { {2}, {3}, {4}, {2,3}, {3,4}, {2,4} } );
+
+  degrees.clear();
+  filtrations::degrees( L, std::back_inserter( degrees ) );
+
+  ALEPH_ASSERT_THROW( degrees == std::vector<unsigned>( { 2, 2, 2 } ) );
+  ALEPH_TEST_END();
+}
+
+template <class T> void testNDegrees()
+{
+  ALEPH_TEST_BEGIN( "Degree filtration: n-degrees" );
+
+  using DataType          = float;
+  using Simplex           = Simplex<DataType, T>;
+  using SimplicialComplex = SimplicialComplex<Simplex>;
+
+  SimplicialComplex K( {
+      {0}, {1}, {2}, {3}, {4},
+      {0,1}, {0,2}, {1,2}, {1,3}, {2,3}, {3,4},
+      {0,1,2}, {1,2,3}
+    }
+  );
+
+  K.sort();
+
+  for( std::size_t dimension = 0; dimension <= K.dimension(); dimension++ )
+  {
+    std::vector<unsigned> expected;
+    std::vector<unsigned> actual;
+
+    auto iterators = K.range( dimension );
+    for( auto it = iterators.first; it != iterators.second; ++it )
+      expected.push_back( n_degree( K, *it ) );
+
+    n_degrees( K, dimension, std::back_inserter( actual ) );
+
+    ALEPH_ASSERT_EQUAL( actual.size(), expected.size() );
+    ALEPH_ASSERT_THROW( actual == expected );
+  }
+
+  std::vector<unsigned> degrees;
+  n_degrees( K, 1, std::back_inserter( degrees ) );
+
+  ALEPH_ASSERT_EQUAL( std::count( degrees.begin(), degrees.end(), 2u ), 1 );
+  ALEPH_ASSERT_EQUAL( std::count( degrees.begin(), degrees.end(), 0u ), 1 );
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testFiltration()
+{
+  ALEPH_TEST_BEGIN( "Degree filtration: weights" );
+
+  using DataType          = float;
+  using Simplex           = Simplex<DataType, T>;
+  using SimplicialComplex = SimplicialComplex<Simplex>;
+
+  SimplicialComplex K( {
+      {0}, {1}, {2}, {3}, {4}, {5},
+      {0,1}, {0,2}, {1,2}, {1,3}, {2,3}, {3,4},
+      {0,1,2}, {1,2,3}
+    }
+  );
+
+  std::vector<unsigned> degrees_;
+  filtrations::degrees( K, std::back_inserter( degrees_ ) );
+
+  std::vector<DataType> degrees( degrees_.begin(), degrees_.end() );
+
+  ALEPH_ASSERT_EQUAL( degrees.size(), 6 );
+
+  auto max = [] ( DataType a, DataType b ) { return std::max( a, b ); };
+  auto sum = [] ( DataType a, DataType b ) { return a + b; };
+
+  geometry::RipsExpander<SimplicialComplex> expander;
+
+  auto L1 = degreeFiltration( K, degrees.begin(), degrees.end(), std::numeric_limits<DataType>::lowest(), max );
+  auto L2 = degreeFiltration( K, degrees.begin(), degrees.end(), DataType(0), sum );
+
+  auto M1 = expander.assignMaximumData( K, degrees.begin(), degrees.end() );
+  auto M2 = expander.assignData( K, degrees.begin(), degrees.end(), DataType(0), sum );
+
+  M1.sort( Data<Simplex>() );
+  M2.sort( Data<Simplex>() );
+
+  ALEPH_ASSERT_EQUAL( L1.size(), K.size() );
+  ALEPH_ASSERT_EQUAL( L2.size(), K.size() );
+
+  for( auto&& pair : { std::make_pair( &L1, &M1 ), std::make_pair( &L2, &M2 ) } )
+  {
+    auto&& L = *pair.first;
+    auto&& M = *pair.second;
+
+    for( std::size_t i = 0; i < L.size(); i++ )
+    {
+      ALEPH_ASSERT_THROW( L[i] == M[i] );
+      ALEPH_ASSERT_EQUAL( L[i].data(), M[i].data() );
+    }
+  }
+
+  // The isolated vertex has a degree of zero, so it comes first in the
+  // filtration.
+  ALEPH_ASSERT_THROW( L1[0] == Simplex( { T(5) } ) );
+  ALEPH_ASSERT_EQUAL( L1[0].data(), 0 );
+
+  bool thrown = false;
+
+  try
+  {
+    degreeFiltration( K, degrees.begin(), degrees.begin() + 3, DataType(0), sum );
+  }
+  catch( std::runtime_error& )
+  {
+    thrown = true;
+  }
+
+  ALEPH_ASSERT_THROW( thrown );
+  ALEPH_TEST_END();
+}
+
+int main( int, char** )
+{
+  testDegrees<unsigned>      ();
+  testDegrees<unsigned short>();
+
+  testNDegrees<unsigned>      ();
+  testNDegrees<unsigned short>();
+
+  testFiltration<unsigned>      ();
+  testFiltration<unsigned short>();
+}
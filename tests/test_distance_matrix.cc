@@ -0,0 +1,211 @@
+#include <aleph/containers/PointCloud.hh>
+
+#include <aleph/geometry/BruteForce.hh>
+#include <aleph/geometry/DistanceMatrix.hh>
+#include <aleph/geometry/VietorisRipsComplex.hh>
+
+#include <aleph/geometry/distances/Euclidean.hh>
+
+#include <aleph/math/MappedSymmetricMatrix.hh>
+#include <aleph/math/SymmetricMatrix.hh>
+
+#include <tests/Base.hh>
+
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cstdio>
+
+using namespace aleph::containers;
+using namespace aleph::geometry;
+using namespace aleph::math;
+using namespace aleph;
+
+template <class T> SymmetricMatrix<T> euclideanDistances( const PointCloud<T>& pc )
+{
+  SymmetricMatrix<T> M( pc.size() );
+
+  for( std::size_t i = 0; i < pc.size(); i++ )
+  {
+    for( std::size_t j = i; j < pc.size(); j++ )
+    {
+      auto p = pc[i];
+      auto q = pc[j];
+
+      T d = T();
+      for( std::size_t k = 0; k < p.size(); k++ )
+        d += ( p[k] - q[k] ) * ( p[k] - q[k] );
+
+      M(i,j) = std::sqrt( d );
+    }
+  }
+
+  return M;
+}
+
+template <class T> void testMappedMatrix()
+{
+  ALEPH_TEST_BEGIN( "Memory-mapped symmetric matrix" );
+
+  auto pc       = load<T>( CMAKE_SOURCE_DIR + std::string( "/tests/input/Iris_colon_separated.txt" ) );
+  auto M        = euclideanDistances( pc );
+  auto filename = std::string( "/tmp/Aleph_distance_matrix.bin" );
+
+  writeMappedSymmetricMatrix<T>( filename, M );
+
+  {
+    MappedSymmetricMatrix<T> N( filename );
+
+    ALEPH_ASSERT_EQUAL( N.numRows(), M.numRows() );
+    ALEPH_ASSERT_EQUAL( N.size(),    M.size() );
+
+    for( std::size_t i = 0; i < M.numRows(); i++ )
+      for( std::size_t j = 0; j < M.numRows(); j++ )
+        ALEPH_ASSERT_EQUAL( N(i,j), M(i,j) );
+
+    bool thrown = false;
+
+    try
+    {
+      N( M.numRows(), 0 );
+    }
+    catch( std::out_of_range& )
+    {
+      thrown = true;
+    }
+
+    ALEPH_ASSERT_THROW( thrown );
+  }
+
+  // Creating a new matrix and filling it; the changes have to be visible
+  // after opening the file again.
+  {
+    auto N = MappedSymmetricMatrix<T>::create( filename, 10 );
+
+    ALEPH_ASSERT_EQUAL( N.numRows(), 10 );
+    ALEPH_ASSERT_EQUAL( N(3,7), T(0) );
+
+    N(3,7) = T(2);
+    N(9,9) = T(1);
+  }
+
+  {
+    MappedSymmetricMatrix<T> N( filename );
+
+    ALEPH_ASSERT_EQUAL( N(7,3), T(2) );
+    ALEPH_ASSERT_EQUAL( N(9,9), T(1) );
+    ALEPH_ASSERT_EQUAL( N(0,0), T(0) );
+  }
+
+  // Invalid files -----------------------------------------------------
+
+  {
+    std::ofstream out( filename );
+    out << "This is not a matrix";
+  }
+
+  bool thrown = false;
+
+  try
+  {
+    MappedSymmetricMatrix<T> N( filename );
+  }
+  catch( std::runtime_error& )
+  {
+    thrown = true;
+  }
+
+  ALEPH_ASSERT_THROW( thrown );
+
+  // The element size is stored in the file, so it is impossible to
+  // open a matrix with an incorrect type.
+  writeMappedSymmetricMatrix<char>( filename, M );
+
+  thrown = false;
+
+  try
+  {
+    MappedSymmetricMatrix<T> N( filename );
+  }
+  catch( std::runtime_error& )
+  {
+    thrown = true;
+  }
+
+  ALEPH_ASSERT_THROW( thrown );
+
+  std::remove( filename.c_str() );
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testRipsComplex()
+{
+  ALEPH_TEST_BEGIN( "Vietoris--Rips complex from distance matrix" );
+
+  auto pc       = load<T>( CMAKE_SOURCE_DIR + std::string( "/tests/input/Iris_colon_separated.txt" ) );
+  auto M        = euclideanDistances( pc );
+  auto filename = std::string( "/tmp/Aleph_distance_matrix.bin" );
+
+  writeMappedSymmetricMatrix<T>( filename, M );
+
+  MappedSymmetricMatrix<T> N( filename );
+
+  auto edges = thresholdEdges( N, T(0.5) );
+
+  for( auto&& edge : edges )
+  {
+    ALEPH_ASSERT_THROW( std::get<0>( edge ) < std::get<1>( edge ) );
+    ALEPH_ASSERT_THROW( std::get<2>( edge ) < T(0.5) );
+  }
+
+  ALEPH_ASSERT_THROW( !edges.empty() );
+
+  using Distance = distances::Euclidean<T>;
+
+  BruteForce<PointCloud<T>, Distance> bruteForce( pc );
+  DistanceMatrix< MappedSymmetricMatrix<T> > distanceMatrix( N );
+
+  auto K = buildVietorisRipsComplex( bruteForce,     T(0.5), 2 );
+  auto L = buildVietorisRipsComplex( distanceMatrix, T(0.5), 2 );
+
+  ALEPH_ASSERT_EQUAL( K.size(), L.size() );
+
+  for( auto&& s : K )
+  {
+    auto it = L.find( s );
+
+    ALEPH_ASSERT_THROW( it != L.end() );
+    ALEPH_ASSERT_THROW( std::abs( it->data() - s.data() ) < T(1e-4) );
+  }
+
+  std::vector< std::vector<std::size_t> > indices;
+  std::vector< std::vector<T> > distances;
+
+  distanceMatrix.neighbourSearch( 3, indices, distances );
+
+  ALEPH_ASSERT_EQUAL( indices.size(), pc.size() );
+
+  for( std::size_t i = 0; i < indices.size(); i++ )
+  {
+    ALEPH_ASSERT_EQUAL( indices[i].size(), 3 );
+    ALEPH_ASSERT_EQUAL( distances[i].front(), T(0) );
+    ALEPH_ASSERT_THROW( std::is_sorted( distances[i].begin(), distances[i].end() ) );
+  }
+
+  std::remove( filename.c_str() );
+
+  ALEPH_TEST_END();
+}
+
+int main( int, char** )
+{
+  testMappedMatrix<float> ();
+  testMappedMatrix<double>();
+
+  testRipsComplex<float> ();
+  testRipsComplex<double>();
+}
@@ -0,0 +1,138 @@
+#include <aleph/containers/PointCloud.hh>
+
+#include <aleph/geometry/BruteForce.hh>
+#include <aleph/geometry/VietorisRipsComplex.hh>
+
+#include <aleph/geometry/distances/Euclidean.hh>
+
+#include <tests/Base.hh>
+
+#include <aleph/persistentHomology/Calculation.hh>
+#include <aleph/persistentHomology/Distributed.hh>
+#include <aleph/persistentHomology/algorithms/Twist.hh>
+
+#include <aleph/topology/Conversions.hh>
+#include <aleph/topology/RandomGraph.hh>
+
+#include <aleph/utilities/UnixSocketTransport.hh>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace aleph;
+using namespace containers;
+using namespace geometry;
+using namespace topology;
+using namespace utilities;
+
+template <class SimplicialComplex> void checkPairing( const SimplicialComplex& K, unsigned numProcesses, bool includeAllUnpairedCreators )
+{
+  using Index = defaults::Index;
+
+  auto expected = calculatePersistencePairing<persistentHomology::algorithms::Twist>( makeBoundaryMatrix( K ), includeAllUnpairedCreators );
+  auto n        = static_cast<Index>( K.size() );
+
+  auto pairing = runLocalProcesses( numProcesses,
+    [&] ( UnixSocketTransport& transport )
+    {
+      auto range = columnRange( n, transport.rank(), transport.size() );
+      auto B     = makeLocalBoundaryMatrix( K, range.first, range.second );
+
+      return calculatePersistencePairingDistributed( transport, std::move( B ), n, includeAllUnpairedCreators );
+    } );
+
+  ALEPH_ASSERT_EQUAL( pairing.size(), expected.size() );
+  ALEPH_ASSERT_THROW( pairing == expected );
+}
+
+template <class T> void testRipsComplex()
+{
+  ALEPH_TEST_BEGIN( "Distributed reduction of Vietoris--Rips complex" );
+
+  using Distance = distances::Euclidean<T>;
+
+  auto pc = load<T>( CMAKE_SOURCE_DIR + std::string( "/tests/input/Iris_colon_separated.txt" ) );
+
+  BruteForce<PointCloud<T>, Distance> bruteForce( pc );
+
+  auto K = buildVietorisRipsComplex( bruteForce, T(0.8), 2 );
+
+  for( unsigned numProcesses : { 1u, 2u, 3u, 5u } )
+  {
+    checkPairing( K, numProcesses, false );
+    checkPairing( K, numProcesses, true  );
+  }
+
+  ALEPH_TEST_END();
+}
+
+void testRandomGraph()
+{
+  ALEPH_TEST_BEGIN( "Distributed reduction of weighted random graph" );
+
+  auto K = generateWeightedRandomGraph( 300, 0.05, 23 );
+
+  checkPairing( K, 4, false );
+  checkPairing( K, 4, true  );
+
+  ALEPH_TEST_END();
+}
+
+void testSmallComplex()
+{
+  ALEPH_TEST_BEGIN( "Distributed reduction with more processes than columns" );
+
+  using Simplex = Simplex<float, unsigned>;
+
+  std::vector<Simplex> simplices = {
+    Simplex( 0u ), Simplex( 1u ), Simplex( 2u ),
+    Simplex( {0,1} ), Simplex( {0,2} ), Simplex( {1,2} ),
+    Simplex( {0,1,2} )
+  };
+
+  SimplicialComplex<Simplex> K( simplices.begin(), simplices.end() );
+
+  checkPairing( K, 10, false );
+  checkPairing( K, 10, true  );
+
+  ALEPH_TEST_END();
+}
+
+void testErrors()
+{
+  ALEPH_TEST_BEGIN( "Distributed reduction errors" );
+
+  bool thrown = false;
+
+  // A process that fails must not cause the other processes to wait
+  // indefinitely for its messages.
+  try
+  {
+    runLocalProcesses( 3,
+      [] ( UnixSocketTransport& transport )
+      {
+        if( transport.rank() == 1 )
+          throw std::runtime_error( "Failure" );
+
+        return transport.receive( 1 ).size();
+      } );
+  }
+  catch( std::runtime_error& )
+  {
+    thrown = true;
+  }
+
+  ALEPH_ASSERT_THROW( thrown );
+  ALEPH_TEST_END();
+}
+
+int main( int, char** )
+{
+  testRipsComplex<float> ();
+  testRipsComplex<double>();
+
+  testRandomGraph();
+  testSmallComplex();
+  testErrors();
+}
@@ -0,0 +1,239 @@
+#include <aleph/containers/PointCloud.hh>
+
+#include <aleph/geometry/BruteForce.hh>
+#include <aleph/geometry/VietorisRipsComplex.hh>
+
+#include <aleph/geometry/distances/Euclidean.hh>
+
+#include <tests/Base.hh>
+
+#include <aleph/persistentHomology/Calculation.hh>
+#include <aleph/persistentHomology/algorithms/Standard.hh>
+#include <aleph/persistentHomology/algorithms/Twist.hh>
+
+#include <aleph/topology/BoundaryMatrix.hh>
+#include <aleph/topology/Conversions.hh>
+
+#include <aleph/topology/representations/External.hh>
+#include <aleph/topology/representations/Vector.hh>
+
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace aleph;
+using namespace containers;
+using namespace geometry;
+using namespace topology;
+using namespace representations;
+
+using namespace aleph::persistentHomology::algorithms;
+
+template <class T> void testOperations()
+{
+  ALEPH_TEST_BEGIN( "External representation operations" );
+
+  // Only a handful of columns fit into the cache, so most operations
+  // have to read from and write to the file.
+  External<T> E( 1024 );
+  Vector<T>   V;
+
+  ALEPH_ASSERT_EQUAL( E.cacheSize(), 1024 );
+
+  T n = T(200);
+
+  E.setNumColumns( n );
+  V.setNumColumns( n );
+
+  std::mt19937 rng( 42 );
+  std::uniform_int_distribution<int> index( 0, int(n) - 1 );
+  std::uniform_int_distribution<int> operation( 0, 9 );
+
+  for( T j = T(0); j < n; j++ )
+  {
+    std::vector<T> column;
+    for( int k = 0; k < index( rng ) % 8; k++ )
+      column.push_back( T( index( rng ) ) );
+
+    std::sort( column.begin(), column.end() );
+    column.erase( std::unique( column.begin(), column.end() ), column.end() );
+
+    E.setColumn( j, column.begin(), column.end() );
+    V.setColumn( j, column.begin(), column.end() );
+  }
+
+  for( int k = 0; k < 5000; k++ )
+  {
+    auto source = T( index( rng ) );
+    auto target = T( index( rng ) );
+
+    if( source == target )
+      continue;
+
+    // Some sources are used frequently, mimicking pivot columns that
+    // are used for reducing many other columns.
+    if( operation( rng ) < 5 )
+      source = T( source % 10 );
+
+    if( operation( rng ) == 0 )
+    {
+      E.clearColumn( target );
+      V.clearColumn( target );
+    }
+    else
+    {
+      E.addColumns( source, target );
+      V.addColumns( source, target );
+    }
+
+    ALEPH_ASSERT_THROW( E.getMaximumIndex( target ) == V.getMaximumIndex( target ) );
+  }
+
+  for( T j = T(0); j < n; j++ )
+  {
+    ALEPH_ASSERT_THROW( E.getColumn( j )    == V.getColumn( j ) );
+    ALEPH_ASSERT_EQUAL( E.getDimension( j ),   V.getDimension( j ) );
+  }
+
+  ALEPH_ASSERT_THROW( E.numReads()  > 0 );
+  ALEPH_ASSERT_THROW( E.numWrites() > 0 );
+  ALEPH_ASSERT_THROW( E.diskUsage() > 0 );
+
+  // Copies must be independent of the original representation, as they
+  // use their own file.
+  {
+    auto F = E;
+
+    ALEPH_ASSERT_THROW( F == E );
+    ALEPH_ASSERT_EQUAL( F.cacheSize(), E.cacheSize() );
+
+    F.clearColumn( T(0) );
+    F.addColumns( T(1), T(2) );
+
+    ALEPH_ASSERT_THROW( E.getColumn( T(2) ) == V.getColumn( T(2) ) );
+  }
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testTriangle()
+{
+  ALEPH_TEST_BEGIN( "External representation of triangle" );
+
+  using Pairing = PersistencePairing<T>;
+
+  auto N = BoundaryMatrix< Vector<T> >::load( CMAKE_SOURCE_DIR + std::string( "/tests/input/Triangle.txt" ) );
+
+  // Without a cache, every column has to be stored in the file as soon
+  // as it is not used any more.
+  BoundaryMatrix< External<T> > M( External<T>( 0 ) );
+  M.setNumColumns( N.getNumColumns() );
+
+  for( T j = T(0); j < N.getNumColumns(); j++ )
+  {
+    auto column = N.getColumn( j );
+
+    M.setColumn( j, column.begin(), column.end() );
+    M.setDimension( j, N.getDimension( j ) );
+  }
+
+  ALEPH_ASSERT_THROW( M == BoundaryMatrix< External<T> >::load( CMAKE_SOURCE_DIR + std::string( "/tests/input/Triangle.txt" ) ) );
+
+  ALEPH_ASSERT_THROW( M == M.dualize().dualize() );
+  ALEPH_ASSERT_THROW( M != M.dualize() );
+
+  std::vector<Pairing> pairings = {
+    calculatePersistencePairing<Standard>( M ),
+    calculatePersistencePairing<Standard>( M.dualize() ),
+    calculatePersistencePairing<Twist>( M ),
+    calculatePersistencePairing<Twist>( M.dualize() )
+  };
+
+  auto expected = calculatePersistencePairing<Twist>( N );
+
+  for( auto&& pairing : pairings )
+    ALEPH_ASSERT_THROW( pairing == expected );
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testRipsComplex()
+{
+  ALEPH_TEST_BEGIN( "External representation of Vietoris--Rips complex" );
+
+  using Distance = distances::Euclidean<T>;
+
+  auto pc = load<T>( CMAKE_SOURCE_DIR + std::string( "/tests/input/Iris_colon_separated.txt" ) );
+
+  BruteForce<PointCloud<T>, Distance> bruteForce( pc );
+
+  auto K        = buildVietorisRipsComplex( bruteForce, T(0.8), 2 );
+  auto diagrams = calculatePersistenceDiagrams<Twist, Vector<unsigned> >( K );
+
+  auto M = makeBoundaryMatrix( K, BoundaryMatrix< External<unsigned> >( External<unsigned>( 16 * 1024 ) ) );
+  auto N = makeBoundaryMatrix< Vector<unsigned> >( K );
+
+  ALEPH_ASSERT_THROW( M.memoryUsage() < N.memoryUsage() );
+
+  ALEPH_ASSERT_THROW( calculatePersistencePairing<Standard>( M ) == calculatePersistencePairing<Standard>( N ) );
+  ALEPH_ASSERT_THROW( calculatePersistencePairing<Twist>( M )    == calculatePersistencePairing<Twist>( N ) );
+
+  for( bool dualize : { false, true } )
+  {
+    auto D = aleph::detail::calculatePersistenceDiagrams<Twist>( K, dualize, false, External<unsigned>( 16 * 1024 ) );
+
+    ALEPH_ASSERT_EQUAL( D.size(), diagrams.size() );
+
+    for( std::size_t i = 0; i < D.size(); i++ )
+      ALEPH_ASSERT_THROW( D.at(i) == diagrams.at(i) );
+  }
+
+  ALEPH_TEST_END();
+}
+
+void testErrors()
+{
+  ALEPH_TEST_BEGIN( "External representation errors" );
+
+  auto directory = External<unsigned>::defaultDirectory();
+  External<unsigned>::defaultDirectory() = CMAKE_SOURCE_DIR + std::string( "/tests/input/missing" );
+
+  External<unsigned> E( 0 );
+  E.setNumColumns( 2 );
+
+  std::vector<unsigned> column = { 0, 1 };
+
+  bool thrown = false;
+
+  // Storing the first column requires the file, which cannot be created
+  // in a missing directory.
+  try
+  {
+    E.setColumn( 0, column.begin(), column.end() );
+    E.setColumn( 1, column.begin(), column.end() );
+  }
+  catch( std::runtime_error& )
+  {
+    thrown = true;
+  }
+
+  External<unsigned>::defaultDirectory() = directory;
+
+  ALEPH_ASSERT_THROW( thrown );
+  ALEPH_TEST_END();
+}
+
+int main( int, char** )
+{
+  testOperations<unsigned>();
+  testOperations<long>    ();
+
+  testTriangle<unsigned>();
+  testTriangle<int>     ();
+
+  testRipsComplex<float> ();
+  testRipsComplex<double>();
+
+  testErrors();
+}
@@ -0,0 +1,237 @@
+#include <tests/Base.hh>
+
+#include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
+
+#include <aleph/persistentHomology/Calculation.hh>
+#include <aleph/persistentHomology/Function.hh>
+
+#include <aleph/topology/BoundaryMatrix.hh>
+#include <aleph/topology/Simplex.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <aleph/topology/filtrations/Data.hh>
+
+#include <aleph/topology/io/Function.hh>
+
+#include <aleph/topology/representations/Vector.hh>
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace aleph;
+using namespace topology;
+
+/**
+  Calculates the persistence diagram of a 1D function by converting it
+  into a simplicial complex and reducing its boundary matrix.
+*/
+
+template <class T, class Compare> PersistenceDiagram<T> calculateReferenceDiagram( const std::vector<T>& values, Compare compare )
+{
+  using Simplex           = Simplex<T, unsigned>;
+  using SimplicialComplex = SimplicialComplex<Simplex>;
+
+  auto K = io::loadFunction<SimplicialComplex>( values.begin(), values.end(),
+    [&compare] ( T x, T y )
+    {
+      return compare( x, y ) ? y : x;
+    }
+  );
+
+  K.sort( filtrations::Data<Simplex, Compare>() );
+
+  auto diagrams = calculatePersistenceDiagrams( K );
+
+  ALEPH_ASSERT_EQUAL( diagrams.size(), 1 );
+  return diagrams.front();
+}
+
+template <class T> std::vector<T> makeFunction( std::size_t n, int range, std::mt19937& rng )
+{
+  std::uniform_int_distribution<int> distribution( 0, range );
+
+  std::vector<T> values( n );
+  for( auto&& value : values )
+    value = T( distribution( rng ) );
+
+  return values;
+}
+
+template <class T> void testSimple()
+{
+  ALEPH_TEST_BEGIN( "1D function persistence: simple function" );
+
+  std::vector<T> values = { 3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5 };
+
+  auto D = calculateFunctionPersistenceDiagram( values );
+
+  ALEPH_ASSERT_EQUAL( D.dimension(), 0 );
+  ALEPH_ASSERT_EQUAL( D.size(), values.size() );
+  ALEPH_ASSERT_EQUAL( D.betti(), 1 );
+  ALEPH_ASSERT_THROW( D == calculateReferenceDiagram( values, std::less<T>() ) );
+
+  auto E = calculateFunctionPersistenceDiagram( values, std::greater<T>() );
+
+  ALEPH_ASSERT_EQUAL( E.size(), values.size() );
+  ALEPH_ASSERT_EQUAL( E.betti(), 1 );
+  ALEPH_ASSERT_THROW( E == calculateReferenceDiagram( values, std::greater<T>() ) );
+
+  ALEPH_ASSERT_THROW( calculateFunctionPersistenceDiagram( std::vector<T>() ).empty() );
+
+  auto F = calculateFunctionPersistenceDiagram( std::vector<T>( 1, T(2) ) );
+
+  ALEPH_ASSERT_EQUAL( F.size(),  1 );
+  ALEPH_ASSERT_EQUAL( F.betti(), 1 );
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testRandom()
+{
+  ALEPH_TEST_BEGIN( "1D function persistence: random functions" );
+
+  std::mt19937 rng( 42 );
+
+  // A small range of values results in many ties, which have to be
+  // resolved in the same manner as for the simplicial complex.
+  for( int range : { 3, 1000 } )
+  {
+    for( std::size_t n : { 2, 3, 17, 200 } )
+    {
+      auto values = makeFunction<T>( n, range, rng );
+
+      ALEPH_ASSERT_THROW( calculateFunctionPersistenceDiagram( values )                    == calculateReferenceDiagram( values, std::less<T>() ) );
+      ALEPH_ASSERT_THROW( calculateFunctionPersistenceDiagram( values, std::greater<T>() ) == calculateReferenceDiagram( values, std::greater<T>() ) );
+    }
+  }
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testBatch()
+{
+  ALEPH_TEST_BEGIN( "1D function persistence: batches" );
+
+  std::mt19937 rng( 23 );
+
+  std::vector<T> values;
+  std::vector<std::size_t> offsets = { 0 };
+
+  for( std::size_t i = 0; i < 500; i++ )
+  {
+    auto function = makeFunction<T>( i % 50, 20, rng );
+
+    values.insert( values.end(), function.begin(), function.end() );
+    offsets.push_back( values.size() );
+  }
+
+  auto diagrams = calculateFunctionPersistenceDiagrams( values, offsets );
+  auto reversed = calculateFunctionPersistenceDiagrams( values, offsets, std::greater<T>() );
+
+  ALEPH_ASSERT_EQUAL( diagrams.size(), offsets.size() - 1 );
+  ALEPH_ASSERT_EQUAL( reversed.size(), offsets.size() - 1 );
+
+  for( std::size_t i = 0; i < diagrams.size(); i++ )
+  {
+    std::vector<T> function( values.begin() + long( offsets[i] ), values.begin() + long( offsets[i+1] ) );
+
+    ALEPH_ASSERT_THROW( diagrams[i] == calculateFunctionPersistenceDiagram( function ) );
+    ALEPH_ASSERT_THROW( reversed[i] == calculateFunctionPersistenceDiagram( function, std::greater<T>() ) );
+  }
+
+  ALEPH_ASSERT_THROW( calculateFunctionPersistenceDiagrams( values, {} ).empty() );
+
+  bool thrown = false;
+
+  try
+  {
+    calculateFunctionPersistenceDiagrams( values, { 0, 5, 3, values.size() } );
+  }
+  catch( std::runtime_error& )
+  {
+    thrown = true;
+  }
+
+  ALEPH_ASSERT_THROW( thrown );
+
+  thrown = false;
+
+  try
+  {
+    calculateFunctionPersistenceDiagrams( values, { 0, 5 } );
+  }
+  catch( std::runtime_error& )
+  {
+    thrown = true;
+  }
+
+  ALEPH_ASSERT_THROW( thrown );
+  ALEPH_TEST_END();
+}
+
+template <class T> void testBoundaryMatrix()
+{
+  ALEPH_TEST_BEGIN( "1D function persistence: boundary matrix" );
+
+  using Representation = representations::Vector<unsigned>;
+
+  // All values of the file are considered to be a single function
+  auto filename = CMAKE_SOURCE_DIR + std::string( "/tests/input/Functions_Reeb.txt" );
+
+  std::vector<T> values;
+
+  {
+    std::ifstream in( filename );
+    std::copy( std::istream_iterator<T>( in ), std::istream_iterator<T>(), std::back_inserter( values ) );
+  }
+
+  BoundaryMatrix<Representation> boundaryMatrix;
+  std::vector<T> functionValues;
+
+  io::loadFunction( filename, boundaryMatrix, functionValues );
+
+  ALEPH_ASSERT_EQUAL( boundaryMatrix.getNumColumns(), 2 * values.size() - 1 );
+
+  auto D = calculatePersistenceDiagram( boundaryMatrix, functionValues );
+  auto E = calculateFunctionPersistenceDiagram( values );
+
+  // The points are reported in a different order because the columns
+  // of the boundary matrix are sorted by their values only.
+  std::vector< std::pair<T, T> > pointsD;
+  std::vector< std::pair<T, T> > pointsE;
+
+  for( auto&& p : D )
+    pointsD.push_back( std::make_pair( p.x(), p.y() ) );
+
+  for( auto&& p : E )
+    pointsE.push_back( std::make_pair( p.x(), p.y() ) );
+
+  std::sort( pointsD.begin(), pointsD.end() );
+  std::sort( pointsE.begin(), pointsE.end() );
+
+  ALEPH_ASSERT_EQUAL( D.betti(), 1 );
+  ALEPH_ASSERT_THROW( pointsD == pointsE );
+  ALEPH_TEST_END();
+}
+
+int main( int, char** )
+{
+  testSimple<float> ();
+  testSimple<double>();
+
+  testRandom<float> ();
+  testRandom<double>();
+
+  testBatch<float> ();
+  testBatch<double>();
+
+  testBoundaryMatrix<float> ();
+  testBoundaryMatrix<double>();
+}
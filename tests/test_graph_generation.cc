@@ -2,6 +2,8 @@
 #include <aleph/topology/RandomGraph.hh>
 
 #include <algorithm>
+#include <stdexcept>
+#include <vector>
 
 using Simplex = aleph::topology::Simplex<short, unsigned>;
 
@@ -55,6 +57,158 @@ void testWRG()
     ALEPH_ASSERT_THROW( maxEdgeWeight >= 1 );
   }
 
+  bool thrown = false;
+
+  try
+  {
+    aleph::topology::generateWeightedRandomGraph( 10, 1.0 );
+  }
+  catch( std::runtime_error& )
+  {
+    thrown = true;
+  }
+
+  ALEPH_ASSERT_THROW( thrown );
+
+  ALEPH_TEST_END();
+}
+
+void testSeeds()
+{
+  ALEPH_TEST_BEGIN( "Reproducibility of random graphs" );
+
+  auto K1 = aleph::topology::generateErdosRenyiGraph( 1000, 0.01, 23 );
+  auto K2 = aleph::topology::generateErdosRenyiGraph( 1000, 0.01, 23 );
+  auto K3 = aleph::topology::generateErdosRenyiGraph( 1000, 0.01, 42 );
+
+  ALEPH_ASSERT_THROW( K1 == K2 );
+  ALEPH_ASSERT_THROW( K1 != K3 );
+
+  auto L1 = aleph::topology::generateWeightedRandomGraph( 1000, 0.01, 23 );
+  auto L2 = aleph::topology::generateWeightedRandomGraph( 1000, 0.01, 23 );
+
+  ALEPH_ASSERT_EQUAL( L1.size(), L2.size() );
+  ALEPH_ASSERT_THROW( std::equal( L1.begin(), L1.end(), L2.begin(),
+                                  [] ( const aleph::topology::Simplex<unsigned, unsigned>& s,
+                                       const aleph::topology::Simplex<unsigned, unsigned>& t )
+                                  {
+                                    return s == t && s.data() == t.data();
+                                  } ) );
+
+  // The expected number of edges is 1000*999/2 * 0.01 = 4995, with
+  // a standard deviation of about 70.
+  auto numEdges = K1.size() - 1000;
+
+  ALEPH_ASSERT_THROW( numEdges > 4500 );
+  ALEPH_ASSERT_THROW( numEdges < 5500 );
+
+  ALEPH_TEST_END();
+}
+
+void testRGG()
+{
+  ALEPH_TEST_BEGIN( "Random geometric graph" );
+
+  auto K0 = aleph::topology::generateRandomGeometricGraph( 100, 0.0, 2, 23 );
+  auto K1 = aleph::topology::generateRandomGeometricGraph( 100, 0.1, 2, 23 );
+  auto K2 = aleph::topology::generateRandomGeometricGraph( 100, 2.0, 2, 23 );
+  auto K3 = aleph::topology::generateRandomGeometricGraph( 100, 0.5, 3, 23 );
+
+  ALEPH_ASSERT_EQUAL( K0.size(), 100 );
+  ALEPH_ASSERT_THROW( K1.size() > 100 );
+  ALEPH_ASSERT_EQUAL( K2.size(), 100 + 100*99 / 2 );
+  ALEPH_ASSERT_THROW( K3.size() > 100 );
+
+  for( auto&& K : { K1, K2, K3 } )
+  {
+    for( auto&& s : K )
+    {
+      if( s.dimension() == 1 )
+      {
+        ALEPH_ASSERT_THROW( s.data() > 0.0 );
+      }
+      else
+      {
+        ALEPH_ASSERT_EQUAL( s.data(), 0.0 );
+      }
+    }
+
+    ALEPH_ASSERT_THROW( std::is_sorted( K.begin(), K.end(), aleph::topology::filtrations::Data<aleph::topology::Simplex<double, unsigned> >() ) );
+  }
+
+  for( auto&& s : K1 )
+    ALEPH_ASSERT_THROW( s.data() <= 0.1 );
+
+  ALEPH_TEST_END();
+}
+
+void testBA()
+{
+  ALEPH_TEST_BEGIN( "Barabasi--Albert graph" );
+
+  auto K = aleph::topology::generateBarabasiAlbertGraph( 1000, 3, 23 );
+
+  unsigned numVertices = 0;
+  unsigned numEdges    = 0;
+
+  for( auto&& s : K )
+  {
+    if( s.dimension() == 0 )
+    {
+      ALEPH_ASSERT_EQUAL( s.data(), s[0] );
+      ++numVertices;
+    }
+    else
+    {
+      ALEPH_ASSERT_EQUAL( s.data(), std::max( s[0], s[1] ) );
+      ++numEdges;
+    }
+  }
+
+  ALEPH_ASSERT_EQUAL( numVertices, 1000 );
+  ALEPH_ASSERT_THROW( numEdges    <= 3000 );
+  ALEPH_ASSERT_THROW( numEdges    >  2500 );
+
+  ALEPH_TEST_END();
+}
+
+void testSBM()
+{
+  ALEPH_TEST_BEGIN( "Stochastic block model" );
+
+  std::vector<unsigned> sizes                      = { 10, 20 };
+  std::vector< std::vector<double> > probabilities = { { 1.0, 0.0 }, { 0.0, 1.0 } };
+
+  auto K = aleph::topology::generateStochasticBlockModel( sizes, probabilities, 23 );
+
+  ALEPH_ASSERT_EQUAL( K.size(), 30 + 10*9 / 2 + 20*19 / 2 );
+
+  for( auto&& s : K )
+  {
+    if( s.dimension() == 1 )
+    {
+      ALEPH_ASSERT_EQUAL( s[0] < 10, s[1] < 10 );
+    }
+  }
+
+  probabilities = { { 0.0, 1.0 }, { 1.0, 0.0 } };
+  K             = aleph::topology::generateStochasticBlockModel( sizes, probabilities, 23 );
+
+  ALEPH_ASSERT_EQUAL( K.size(), 30 + 10*20 );
+
+  bool thrown = false;
+
+  try
+  {
+    aleph::topology::generateStochasticBlockModel( sizes, { { 1.0 } } );
+  }
+  catch( std::runtime_error& )
+  {
+    thrown = true;
+  }
+
+  ALEPH_ASSERT_THROW( thrown );
+
   ALEPH_TEST_END();
 }
 
@@ -63,4 +217,8 @@ int main( int, char** )
 {
   testERG();
   testWRG();
+  testSeeds();
+  testRGG();
+  testBA();
+  testSBM();
 }
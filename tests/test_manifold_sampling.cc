@@ -0,0 +1,192 @@
+#include <tests/Base.hh>
+
+#include <aleph/geometry/ManifoldSampling.hh>
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+using namespace aleph::containers;
+using namespace aleph::geometry;
+
+template <class T> void testSphere()
+{
+  ALEPH_TEST_BEGIN( "Sphere sampling" );
+
+  for( std::size_t dimension : { 1, 2, 5 } )
+  {
+    auto pc = sampleSphere<T>( 1000, dimension, T(2), 23 );
+
+    ALEPH_ASSERT_EQUAL( pc.size(),      1000 );
+    ALEPH_ASSERT_EQUAL( pc.dimension(), dimension + 1 );
+
+    std::vector<double> mean( dimension + 1 );
+
+    for( std::size_t i = 0; i < pc.size(); i++ )
+    {
+      auto p      = pc[i];
+      double norm = 0.0;
+
+      for( std::size_t k = 0; k < p.size(); k++ )
+      {
+        norm    += double( p[k] ) * double( p[k] );
+        mean[k] += double( p[k] ) / double( pc.size() );
+      }
+
+      ALEPH_ASSERT_THROW( std::abs( std::sqrt( norm ) - 2.0 ) < 1e-4 );
+    }
+
+    // Points are distributed uniformly, so their mean is close to the
+    // centre of the sphere.
+    for( auto&& m : mean )
+      ALEPH_ASSERT_THROW( std::abs( m ) < 0.2 );
+  }
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testTori()
+{
+  ALEPH_TEST_BEGIN( "Torus sampling" );
+
+  T R = T(2);
+  T r = T(0.5);
+
+  auto torusDistance = [] ( double x, double y, double z, double R )
+  {
+    auto s = std::sqrt( x*x + y*y ) - R;
+    return std::sqrt( s*s + z*z );
+  };
+
+  auto pc = sampleTorus<T>( 1000, R, r, 23 );
+
+  for( std::size_t i = 0; i < pc.size(); i++ )
+  {
+    auto p = pc[i];
+    ALEPH_ASSERT_THROW( std::abs( torusDistance( p[0], p[1], p[2], R ) - r ) < 1e-4 );
+  }
+
+  auto linked = sampleLinkedTori<T>( 1000, R, r, 23 );
+
+  for( std::size_t i = 0; i < linked.size(); i++ )
+  {
+    auto p = linked[i];
+
+    // The second torus lies in the xz-plane and is shifted along the
+    // x-axis.
+    auto d = i < 500 ? torusDistance( p[0],     p[1], p[2], R )
+                     : torusDistance( p[0] - R, p[2], p[1], R );
+
+    ALEPH_ASSERT_THROW( std::abs( d - r ) < 1e-4 );
+  }
+
+  ALEPH_ASSERT_THROW( pc == sampleTorus<T>( 1000, R, r, 23 ) );
+  ALEPH_ASSERT_THROW( !( pc == sampleTorus<T>( 1000, R, r, 42 ) ) );
+
+  bool thrown = false;
+
+  try
+  {
+    sampleLinkedTori<T>( 10, R, R, 23 );
+  }
+  catch( std::runtime_error& )
+  {
+    thrown = true;
+  }
+
+  ALEPH_ASSERT_THROW( thrown );
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testOtherManifolds()
+{
+  ALEPH_TEST_BEGIN( "Klein bottle and Swiss roll sampling" );
+
+  T R = T(2);
+  T r = T(1);
+
+  auto klein = sampleKleinBottle<T>( 1000, R, r, 23 );
+
+  ALEPH_ASSERT_EQUAL( klein.dimension(), 4 );
+
+  for( std::size_t i = 0; i < klein.size(); i++ )
+  {
+    auto p = klein[i];
+    auto s = std::sqrt( double( p[0]*p[0] + p[1]*p[1] ) ) - R;
+
+    ALEPH_ASSERT_THROW( std::abs( std::sqrt( s*s + double( p[2]*p[2] + p[3]*p[3] ) ) - r ) < 1e-4 );
+  }
+
+  auto roll = sampleSwissRoll<T>( 1000, T(10), 23 );
+
+  for( std::size_t i = 0; i < roll.size(); i++ )
+  {
+    auto p = roll[i];
+    auto t = std::sqrt( double( p[0]*p[0] + p[2]*p[2] ) );
+
+    ALEPH_ASSERT_THROW( t >= 1.5 * M_PI - 1e-4 );
+    ALEPH_ASSERT_THROW( t <= 4.5 * M_PI + 1e-4 );
+    ALEPH_ASSERT_THROW( p[1] >= T(0) );
+    ALEPH_ASSERT_THROW( p[1] <= T(10) );
+  }
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testNoise()
+{
+  ALEPH_TEST_BEGIN( "Noise models" );
+
+  auto pc = sampleSphere<T>( 1000, 2, T(1), 23 );
+  auto p1 = pc;
+  auto p2 = pc;
+  auto p3 = pc;
+
+  addGaussianNoise( p1, T(0.1), 42 );
+  addUniformNoise(  p2, T(0.1), 42 );
+  addOutliers(      p3, 0.1,    42 );
+
+  ALEPH_ASSERT_THROW( !( pc == p1 ) );
+  ALEPH_ASSERT_THROW( !( pc == p2 ) );
+  ALEPH_ASSERT_THROW( !( pc == p3 ) );
+
+  std::size_t numOutliers = 0;
+
+  for( std::size_t i = 0; i < pc.size(); i++ )
+  {
+    auto p = pc[i];
+    auto q = p2[i];
+    auto o = p3[i];
+
+    for( std::size_t k = 0; k < p.size(); k++ )
+    {
+      ALEPH_ASSERT_THROW( std::abs( p[k] - q[k] ) <= T(0.1) + T(1e-6) );
+      ALEPH_ASSERT_THROW( o[k] >= T(-1) - T(1e-6) );
+      ALEPH_ASSERT_THROW( o[k] <= T( 1) + T(1e-6) );
+    }
+
+    if( p != o )
+      ++numOutliers;
+  }
+
+  ALEPH_ASSERT_THROW( numOutliers >  50 );
+  ALEPH_ASSERT_THROW( numOutliers < 150 );
+
+  ALEPH_TEST_END();
+}
+
+int main( int, char** )
+{
+  testSphere<float> ();
+  testSphere<double>();
+
+  testTori<float> ();
+  testTori<double>();
+
+  testOtherManifolds<float> ();
+  testOtherManifolds<double>();
+
+  testNoise<float> ();
+  testNoise<double>();
+}
@@ -0,0 +1,314 @@
+#include <tests/Base.hh>
+
+#include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
+
+#include <aleph/persistentHomology/ConnectedComponents.hh>
+#include <aleph/persistentHomology/Function.hh>
+
+#include <aleph/topology/ContourTree.hh>
+#include <aleph/topology/Mesh.hh>
+#include <aleph/topology/MergeTree.hh>
+#include <aleph/topology/ScalarGraph.hh>
+#include <aleph/topology/Simplex.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <aleph/topology/filtrations/Data.hh>
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace aleph;
+using namespace topology;
+
+using DataType = double;
+
+template <class T> std::vector< std::pair<T, T> > sortedPoints( const PersistenceDiagram<T>& D )
+{
+  std::vector< std::pair<T, T> > points;
+
+  for( auto&& p : D )
+    points.push_back( std::make_pair( p.x(), p.y() ) );
+
+  std::sort( points.begin(), points.end() );
+  return points;
+}
+
+/**
+  Creates a triangulated grid whose vertices have pseudo-random values.
+  The functor determines the weights of all other simplices, and the
+  comparison functor determines their order.
+*/
+
+template <class Functor, class Compare> SimplicialComplex< Simplex<DataType, unsigned> > makeGrid( unsigned n, const std::vector<DataType>& values, Functor f, Compare )
+{
+  using Simplex = Simplex<DataType, unsigned>;
+
+  auto make = [&values, &f] ( std::vector<unsigned> vertices )
+  {
+    auto data = values[ vertices.front() ];
+    for( auto&& v : vertices )
+      data = f( data, values[v] );
+
+    return Simplex( vertices.begin(), vertices.end(), data );
+  };
+
+  std::vector<Simplex> simplices;
+
+  for( unsigned i = 0; i < n; i++ )
+  {
+    for( unsigned j = 0; j < n; j++ )
+    {
+      auto v = i * n + j;
+
+      simplices.push_back( make( { v } ) );
+
+      if( j + 1 < n )
+        simplices.push_back( make( { v, v + 1 } ) );
+
+      if( i + 1 < n )
+        simplices.push_back( make( { v, v + n } ) );
+
+      if( i + 1 < n && j + 1 < n )
+      {
+        simplices.push_back( make( { v, v + n + 1 } ) );
+        simplices.push_back( make( { v, v + 1, v + n + 1 } ) );
+        simplices.push_back( make( { v, v + n, v + n + 1 } ) );
+      }
+    }
+  }
+
+  SimplicialComplex<Simplex> K( simplices.begin(), simplices.end() );
+  K.sort( filtrations::Data<Simplex, Compare>() );
+
+  return K;
+}
+
+std::vector<DataType> makeValues( std::size_t n, int range, unsigned seed )
+{
+  std::mt19937 rng( seed );
+  std::uniform_int_distribution<int> distribution( 0, range );
+
+  std::vector<DataType> values( n );
+  for( auto&& value : values )
+    value = DataType( distribution( rng ) );
+
+  return values;
+}
+
+void testPath()
+{
+  ALEPH_TEST_BEGIN( "Merge trees of a path" );
+
+  std::vector<DataType> values = { 3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5 };
+  std::vector< std::pair<unsigned, unsigned> > edges;
+
+  for( unsigned i = 0; i + 1 < values.size(); i++ )
+    edges.push_back( std::make_pair( i, i + 1 ) );
+
+  ScalarGraph<DataType> G( values, edges );
+
+  ALEPH_ASSERT_EQUAL( G.size(),     values.size() );
+  ALEPH_ASSERT_EQUAL( G.numEdges(), edges.size()  );
+
+  auto J = calculateJoinTree( G );
+  auto S = calculateSplitTree( G );
+
+  ALEPH_ASSERT_EQUAL( J.arcs().size(), values.size() - 1 );
+  ALEPH_ASSERT_EQUAL( S.arcs().size(), values.size() - 1 );
+
+  // The global maximum is the root of the join tree, and vice versa.
+  // Of the two minima, the one with the smaller index comes last when
+  // sweeping over superlevel sets, because ties are reversed as well.
+  ALEPH_ASSERT_THROW( J.isRoot(5) );
+  ALEPH_ASSERT_THROW( S.isRoot(1) );
+
+  // Both vertices with a value of 1 are minima, and their components
+  // merge at vertex 2. The component of vertex 1 is extended by vertex
+  // 0 before, which is removed in the reduced tree.
+  ALEPH_ASSERT_EQUAL( J.parent(1), 0 );
+  ALEPH_ASSERT_EQUAL( J.parent(0), 2 );
+  ALEPH_ASSERT_EQUAL( J.parent(3), 2 );
+
+  auto arcs = J.reducedArcs();
+
+  ALEPH_ASSERT_THROW( std::find( arcs.begin(), arcs.end(), std::make_pair( 1u, 2u ) ) != arcs.end() );
+  ALEPH_ASSERT_THROW( std::find( arcs.begin(), arcs.end(), std::make_pair( 3u, 2u ) ) != arcs.end() );
+
+  // The diagrams coincide with the ones of the sweep for 1D functions,
+  // except for the points on the diagonal.
+  auto removeDiagonal = [] ( PersistenceDiagram<DataType> D )
+  {
+    D.removeDiagonal();
+    return D;
+  };
+
+  ALEPH_ASSERT_THROW( sortedPoints( J.persistenceDiagram() ) == sortedPoints( removeDiagonal( calculateFunctionPersistenceDiagram( values ) ) ) );
+  ALEPH_ASSERT_THROW( sortedPoints( S.persistenceDiagram() ) == sortedPoints( removeDiagonal( calculateFunctionPersistenceDiagram( values, std::greater<DataType>() ) ) ) );
+
+  // The contour tree of a tree is the tree itself
+  auto C = calculateContourTree( G );
+
+  std::set< std::pair<unsigned, unsigned> > expected;
+  std::set< std::pair<unsigned, unsigned> > actual;
+
+  for( auto&& edge : edges )
+  {
+    if( J.precedes( edge.first, edge.second ) )
+      expected.insert( edge );
+    else
+      expected.insert( std::make_pair( edge.second, edge.first ) );
+  }
+
+  actual.insert( C.arcs().begin(), C.arcs().end() );
+
+  ALEPH_ASSERT_THROW( actual == expected );
+  ALEPH_TEST_END();
+}
+
+void testGrid()
+{
+  ALEPH_TEST_BEGIN( "Merge trees of a grid" );
+
+  auto max = [] ( DataType x, DataType y ) { return std::max( x, y ); };
+  auto min = [] ( DataType x, DataType y ) { return std::min( x, y ); };
+
+  unsigned n = 40;
+
+  // A small range of values results in many ties, which have to be
+  // resolved consistently for the merge trees and the complexes.
+  for( int range : { 5, 1000 } )
+  {
+    auto values = makeValues( n * n, range, 23 );
+
+    auto K = makeGrid( n, values, max, std::less<DataType>() );
+    auto L = makeGrid( n, values, min, std::greater<DataType>() );
+    auto G = makeScalarGraph( K );
+
+    ALEPH_ASSERT_EQUAL( G.size(),     n * n );
+    ALEPH_ASSERT_EQUAL( G.numEdges(), 3 * ( n - 1 ) * ( n - 1 ) + 2 * ( n - 1 ) );
+
+    auto expectedJ = std::get<0>( calculateZeroDimensionalPersistenceDiagram( K ) );
+    auto expectedS = std::get<0>( calculateZeroDimensionalPersistenceDiagram( L ) );
+
+    auto J1 = calculateJoinTree( G, 1 );
+    auto S1 = calculateSplitTree( G, 1 );
+
+    ALEPH_ASSERT_THROW( sortedPoints( J1.persistenceDiagram() ) == sortedPoints( expectedJ ) );
+    ALEPH_ASSERT_THROW( sortedPoints( S1.persistenceDiagram() ) == sortedPoints( expectedS ) );
+
+    // The augmented merge trees are unique, so stitching the trees of
+    // several domains must result in the same trees.
+    for( unsigned numDomains : { 2u, 3u, 7u, 64u } )
+    {
+      auto J = calculateJoinTree( G, numDomains );
+      auto S = calculateSplitTree( G, numDomains );
+
+      ALEPH_ASSERT_THROW( J.arcs() == J1.arcs() );
+      ALEPH_ASSERT_THROW( S.arcs() == S1.arcs() );
+    }
+
+    // The grid is simply connected, so the leaves of its contour tree are
+    // the leaves of the merge trees, i.e. the minima and the maxima.
+    auto C = calculateContourTree( G, 3 );
+
+    ALEPH_ASSERT_EQUAL( C.arcs().size(), G.size() - 1 );
+
+    std::vector<unsigned> degree( G.size() );
+
+    for( auto&& arc : C.reducedArcs() )
+    {
+      ALEPH_ASSERT_THROW( J1.precedes( arc.first, arc.second ) );
+
+      ++degree[ arc.first  ];
+      ++degree[ arc.second ];
+    }
+
+    auto numLeaves = std::count( degree.begin(), degree.end(), 1u );
+
+    auto numChildrenJ = J1.numChildren();
+    auto numChildrenS = S1.numChildren();
+
+    auto numMinima = std::count( numChildrenJ.begin(), numChildrenJ.end(), 0u );
+    auto numMaxima = std::count( numChildrenS.begin(), numChildrenS.end(), 0u );
+
+    ALEPH_ASSERT_EQUAL( numLeaves, numMinima + numMaxima );
+  }
+
+  ALEPH_TEST_END();
+}
+
+void testMesh()
+{
+  ALEPH_TEST_BEGIN( "Merge trees of a mesh" );
+
+  Mesh<double> M;
+
+  M.addVertex( 0.0, 0.0, 0.0, 0.0 );
+  M.addVertex( 1.0, 0.0, 0.0, 1.0 );
+  M.addVertex( 2.0, 0.0, 0.0, 0.0 );
+  M.addVertex( 0.0, 1.0, 0.0, 1.0 );
+  M.addVertex( 1.0, 1.0, 0.0, 2.0 );
+  M.addVertex( 2.0, 1.0, 0.0, 1.0 );
+  M.addVertex( 0.0, 2.0, 0.0, 0.0 );
+  M.addVertex( 1.0, 2.0, 0.0, 1.0 );
+  M.addVertex( 2.0, 2.0, 0.0, 0.0 );
+
+  std::vector< std::vector<unsigned> > faces = {
+    { 0, 1, 4 }, { 0, 4, 3 }, { 1, 2, 4 }, { 2, 5, 4 },
+    { 4, 5, 8 }, { 4, 8, 7 }, { 3, 4, 6 }, { 4, 7, 6 }
+  };
+
+  for( auto&& face : faces )
+    M.addFace( face.begin(), face.end() );
+
+  auto G = makeScalarGraph( M );
+
+  ALEPH_ASSERT_EQUAL( G.size(),     9  );
+  ALEPH_ASSERT_EQUAL( G.numEdges(), 16 );
+
+  auto J = calculateJoinTree( G );
+  auto S = calculateSplitTree( G );
+
+  // The four corners are minima, whose components merge at the first
+  // three vertices in the middle of the sides.
+  ALEPH_ASSERT_THROW( J.criticalVertices() == std::vector<unsigned>( { 0, 1, 2, 3, 4, 5, 6, 8 } ) );
+  ALEPH_ASSERT_EQUAL( J.reducedArcs().size(), 7 );
+
+  // The centre is the only maximum, and there are no saddles
+  ALEPH_ASSERT_THROW( S.criticalVertices() == std::vector<unsigned>( { 0, 4 } ) );
+  ALEPH_ASSERT_EQUAL( S.reducedArcs().size(), 1 );
+
+  auto D = J.persistenceDiagram();
+  auto E = S.persistenceDiagram();
+
+  ALEPH_ASSERT_EQUAL( D.size(),  4 );
+  ALEPH_ASSERT_EQUAL( D.betti(), 1 );
+  ALEPH_ASSERT_EQUAL( E.size(),  1 );
+  ALEPH_ASSERT_EQUAL( E.betti(), 1 );
+
+  for( auto&& p : D )
+  {
+    if( !p.isUnpaired() )
+    {
+      ALEPH_ASSERT_EQUAL( p.x(), 0.0 );
+      ALEPH_ASSERT_EQUAL( p.y(), 1.0 );
+    }
+  }
+
+  auto C = calculateContourTree( G );
+
+  ALEPH_ASSERT_EQUAL( C.arcs().size(), 8 );
+
+  ALEPH_TEST_END();
+}
+
+int main( int, char** )
+{
+  testPath();
+  testGrid();
+  testMesh();
+}
@@ -147,9 +147,35 @@ void test3()
     ALEPH_ASSERT_EQUAL( l4.size(), 8 );
   }
 
-  aleph::topology::MorseSmaleComplex<decltype(M)> msc;
+  using MorseSmaleComplex = aleph::topology::MorseSmaleComplex<decltype(M)>;
+  using Type              = MorseSmaleComplex::Type;
+
+  MorseSmaleComplex msc;
   msc( M );
 
+  ALEPH_ASSERT_EQUAL( msc.vertices().size(), 9 );
+
+  // The corners are minima, the centre is the only maximum, while the
+  // lower links of all other vertices on the boundary are split.
+  ALEPH_ASSERT_THROW( msc.criticalPoints( Type::Minimum ) == std::vector<std::size_t>( { 0, 2, 6, 8 } ) );
+  ALEPH_ASSERT_THROW( msc.criticalPoints( Type::Maximum ) == std::vector<std::size_t>( { 4 } ) );
+  ALEPH_ASSERT_THROW( msc.criticalPoints( Type::Saddle )  == std::vector<std::size_t>( { 1, 3, 5, 7 } ) );
+  ALEPH_ASSERT_THROW( msc.criticalPoints( Type::Regular ).empty() );
+
+  ALEPH_ASSERT_EQUAL( msc.multiplicity(1), 1 );
+  ALEPH_ASSERT_EQUAL( msc.multiplicity(4), 0 );
+
+  // Ties are broken by the IDs of the vertices, so the first corner is
+  // reached from the centre.
+  ALEPH_ASSERT_EQUAL( msc.ascendingManifold(0), 0 );
+  ALEPH_ASSERT_EQUAL( msc.ascendingManifold(1), 0 );
+  ALEPH_ASSERT_EQUAL( msc.ascendingManifold(4), 0 );
+  ALEPH_ASSERT_EQUAL( msc.ascendingManifold(5), 2 );
+  ALEPH_ASSERT_EQUAL( msc.ascendingManifold(7), 6 );
+
+  for( auto&& v : msc.vertices() )
+    ALEPH_ASSERT_EQUAL( msc.descendingManifold(v), 4 );
+
   ALEPH_TEST_END();
 }
 
@@ -1,10 +1,12 @@
 #include <tests/Base.hh>
 
+#include <aleph/persistenceDiagrams/Entropy.hh>
 #include <aleph/persistenceDiagrams/Envelope.hh>
 #include <aleph/persistenceDiagrams/Mean.hh>
 #include <aleph/persistenceDiagrams/Norms.hh>
 #include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
 #include <aleph/persistenceDiagrams/PersistenceIndicatorFunction.hh>
+#include <aleph/persistenceDiagrams/Statistics.hh>
 
 #include <aleph/persistenceDiagrams/distances/Bottleneck.hh>
 #include <aleph/persistenceDiagrams/distances/Hausdorff.hh>
@@ -12,12 +14,15 @@
 #include <aleph/persistenceDiagrams/distances/PointSet.hh>
 #include <aleph/persistenceDiagrams/distances/Wasserstein.hh>
 
+#include <aleph/persistenceDiagrams/kernels/GramMatrix.hh>
 #include <aleph/persistenceDiagrams/kernels/KernelEmbedding.hh>
 #include <aleph/persistenceDiagrams/kernels/MultiScaleKernel.hh>
 
 #include <algorithm>
+#include <iterator>
 #include <limits>
 #include <random>
+#include <stdexcept>
 #include <vector>
 
 #include <cmath>
@@ -109,6 +114,67 @@ template <class T> void testEnvelope()
   ALEPH_TEST_END();
 }
 
+template <class T> void testEnvelopes()
+{
+  ALEPH_TEST_BEGIN( "Persistence diagram envelopes (batch)" );
+
+  using PersistenceDiagram = aleph::PersistenceDiagram<T>;
+
+  PersistenceDiagram D1;
+  D1.add( T(0), T(1) );
+  D1.add( T(1), T(4) );
+  D1.add( T(2), T(4) );
+  D1.add( T(3) );
+
+  PersistenceDiagram D2;
+
+  PersistenceDiagram D3;
+  D3.add( T(0), T(3) );
+  D3.add( T(2), T(3) );
+
+  aleph::Envelope envelope;
+  auto F = envelope( std::vector<PersistenceDiagram>( { D1, D2, D3 } ) );
+
+  ALEPH_ASSERT_EQUAL( F.size(),  3 );
+  ALEPH_ASSERT_EQUAL( F.size(0), 3 );
+  ALEPH_ASSERT_EQUAL( F.size(1), 0 );
+  ALEPH_ASSERT_EQUAL( F.size(2), 2 );
+
+  // The breakpoints coincide with the ones of the individual envelope
+  {
+    auto f = envelope( D1 );
+
+    std::vector<T> domain;
+    std::vector<T> image;
+
+    f.domain( std::back_inserter( domain ) );
+    f.image( std::back_inserter( image ) );
+
+    ALEPH_ASSERT_THROW( std::equal( domain.begin(), domain.end(), F.domain(0) ) );
+    ALEPH_ASSERT_THROW( std::equal( image.begin(),  image.end(),  F.image(0) ) );
+  }
+
+  // The envelope of the first diagram rises from 1 to 3 over [1,5] and
+  // falls to 2 over [5,6].
+  ALEPH_ASSERT_THROW( std::abs( F.distance( 0, 1 ) - T(10.5) ) < 1e-5 );
+  ALEPH_ASSERT_THROW( std::abs( F.distance( 1, 0 ) - T(10.5) ) < 1e-5 );
+  ALEPH_ASSERT_THROW( std::abs( F.distance( 0, 1, T(2) ) - std::sqrt( T(52) / T(3) + T(19) / T(3) ) ) < 1e-5 );
+
+  // The envelopes of the first and the last diagram cross each other
+  // at 11/3, where the sign of their difference changes.
+  ALEPH_ASSERT_THROW( std::abs( F.distance( 0, 2 ) - T(43) / T(6) ) < 1e-5 );
+  ALEPH_ASSERT_EQUAL( F.distance( 2, 2 ), T() );
+
+  auto M = aleph::math::pairwiseDistances( F, T(1) );
+
+  ALEPH_ASSERT_EQUAL( M.numRows(), 3 );
+  ALEPH_ASSERT_EQUAL( M(0,1), F.distance( 0, 1 ) );
+  ALEPH_ASSERT_EQUAL( M(2,0), F.distance( 0, 2 ) );
+  ALEPH_ASSERT_EQUAL( M(1,1), T() );
+
+  ALEPH_TEST_END();
+}
+
 template <class T> void testFrechetMean()
 {
   using PersistenceDiagram = aleph::PersistenceDiagram<T>;
@@ -253,6 +319,58 @@ template <class T> void testMultiScaleKernel()
   ALEPH_TEST_END();
 }
 
+template <class T> void testGramMatrix()
+{
+  ALEPH_TEST_BEGIN( "Gram matrix" );
+
+  std::vector< aleph::PersistenceDiagram<T> > diagrams;
+
+  for( unsigned n : { 0, 1, 5, 10, 20, 15, 7, 30, 12, 3, 25, 8, 17, 9, 11, 6, 14, 2, 19, 4 } )
+    diagrams.push_back( createRandomPersistenceDiagram<T>( n ) );
+
+  auto G = aleph::makeLinearGramMatrix<T>( 1.0, 1.0, 2.0 );
+  auto H = aleph::makeMultiScaleGramMatrix<T>( 2.0 );
+
+  // Adding diagrams in several steps must only extend the matrix, and
+  // the blocks of the new rows need not be aligned with the old ones.
+  G.add( diagrams.begin(), diagrams.begin() + 3 );
+  G.add( diagrams[3] );
+  G.add( diagrams.begin() + 4, diagrams.end() );
+  H.add( diagrams.begin(), diagrams.end() );
+
+  ALEPH_ASSERT_EQUAL( G.size(), diagrams.size() );
+  ALEPH_ASSERT_EQUAL( H.size(), diagrams.size() );
+
+  auto w = aleph::detail::DefaultWeightFunction( 1.0, 2.0 );
+  auto k = aleph::detail::DefaultKernel( 1.0 );
+
+  auto close = [] ( double x, double y )
+  {
+    return std::abs( x - y ) <= 1e-9 * std::max( 1.0, std::abs( x ) );
+  };
+
+  for( std::size_t i = 0; i < diagrams.size(); i++ )
+  {
+    for( std::size_t j = 0; j < diagrams.size(); j++ )
+    {
+      ALEPH_ASSERT_THROW( close( G(i,j), aleph::linearKernel( diagrams[i], diagrams[j], w, k ) ) );
+      ALEPH_ASSERT_THROW( close( H(i,j), aleph::multiScaleKernel( diagrams[i], diagrams[j], 2.0 ) ) );
+      ALEPH_ASSERT_THROW( close( G.distance(i,j), aleph::pseudoMetric( diagrams[i], diagrams[j], w, k ) ) );
+      ALEPH_ASSERT_EQUAL( G(i,j), G(j,i) );
+    }
+  }
+
+  auto M = H.matrix();
+
+  ALEPH_ASSERT_EQUAL( M.numRows(), diagrams.size() );
+  ALEPH_ASSERT_EQUAL( M(3,7), H(7,3) );
+  ALEPH_ASSERT_EQUAL( H.distance(5,5), 0.0 );
+
+  ALEPH_ASSERT_THROW( close( H.distance(1,2), aleph::multiScalePseudoMetric( diagrams[1], diagrams[2], 2.0 ) ) );
+
+  ALEPH_TEST_END();
+}
+
 template <class T> void testNearestNeighbourDistance()
 {
   ALEPH_TEST_BEGIN( "Nearest neighbour distance" );
@@ -268,6 +386,70 @@ template <class T> void testNearestNeighbourDistance()
   ALEPH_TEST_END();
 }
 
+template <class T> void testPersistenceIndicatorFunctions()
+{
+  ALEPH_TEST_BEGIN( "Persistence indicator functions (batch)" );
+
+  using PersistenceDiagram = aleph::PersistenceDiagram<T>;
+
+  unsigned numSamples = 20;
+  unsigned sampleSize = 50;
+
+  std::vector<PersistenceDiagram> diagrams;
+  diagrams.reserve( numSamples );
+
+  for( unsigned i = 0; i < numSamples; i++ )
+    diagrams.emplace_back( createRandomPersistenceDiagram<T>( sampleSize ) );
+
+  auto F = aleph::persistenceIndicatorFunctions( diagrams );
+
+  ALEPH_ASSERT_EQUAL( F.size(), numSamples );
+
+  // Between two breakpoints, every function takes the same value as the
+  // individual persistence indicator function.
+  for( unsigned i = 0; i < numSamples; i++ )
+  {
+    auto f = aleph::persistenceIndicatorFunction( diagrams.at(i) );
+    auto x = F.domain(i);
+    auto y = F.image(i);
+
+    ALEPH_ASSERT_EQUAL( F.size(i), 2 * sampleSize );
+    ALEPH_ASSERT_EQUAL( y[ F.size(i) - 1 ], T() );
+
+    for( std::size_t j = 0; j + 1 < F.size(i); j++ )
+      ALEPH_ASSERT_EQUAL( f( ( x[j] + x[j+1] ) / 2 ), y[j] );
+  }
+
+  PersistenceDiagram D1;
+  D1.add( T(0), T(1) );
+  D1.add( T(4), T(5) );
+
+  PersistenceDiagram D2;
+  D2.add( T(0), T(2) );
+
+  PersistenceDiagram D3;
+  D3.add( T(0), T(2) );
+  D3.add( T(1), T(3) );
+
+  auto G = aleph::persistenceIndicatorFunctions( std::vector<PersistenceDiagram>( { D1, D2, D3 } ) );
+
+  // The functions differ by one over [1,2] and [4,5]
+  ALEPH_ASSERT_EQUAL( G.distance( 0, 1 ), T(2) );
+  ALEPH_ASSERT_THROW( std::abs( G.distance( 0, 1, T(2) ) - std::sqrt( T(2) ) ) < 1e-6 );
+  ALEPH_ASSERT_EQUAL( G.distance( 0, 0 ), T() );
+
+  G.normalize();
+
+  ALEPH_ASSERT_EQUAL( G.image(2)[0], T(0.5) );
+  ALEPH_ASSERT_EQUAL( G.image(2)[1], T(1)   );
+  ALEPH_ASSERT_EQUAL( G.image(2)[2], T(0.5) );
+
+  // Functions whose values do not vary are not changed
+  ALEPH_ASSERT_EQUAL( G.image(1)[0], T(1) );
+
+  ALEPH_TEST_END();
+}
+
 template <class T> void testPointSetDistances()
 {
   ALEPH_TEST_BEGIN( "Point set distances" );
@@ -315,6 +497,127 @@ template <class T> void testPointSetDistances()
   ALEPH_TEST_END();
 }
 
+template <class T> void testStatistics()
+{
+  ALEPH_TEST_BEGIN( "Persistence diagram statistics" );
+
+  using PersistenceDiagram = aleph::PersistenceDiagram<T>;
+  using Statistics         = aleph::PersistenceDiagramStatistics<T>;
+
+  auto D1 = createRandomPersistenceDiagram<T>( 100 );
+  auto D2 = createRandomPersistenceDiagram<T>( 50 );
+
+  // The statistics of a single diagram coincide with the ones of the
+  // individual functions.
+  for( double p : { 1.0, 2.0, 2.5 } )
+  {
+    Statistics statistics( p );
+    statistics( D1 );
+
+    ALEPH_ASSERT_EQUAL( statistics.numDiagrams(), 1 );
+    ALEPH_ASSERT_EQUAL( statistics.numPoints(),   D1.size() );
+    ALEPH_ASSERT_EQUAL( statistics.betti(),       0 );
+
+    ALEPH_ASSERT_THROW( std::abs( statistics.totalPersistence() - aleph::totalPersistence( D1, p ) ) < 1e-4 );
+    ALEPH_ASSERT_THROW( std::abs( statistics.pNorm()            - aleph::pNorm( D1, p ) )            < 1e-4 );
+    ALEPH_ASSERT_THROW( std::abs( statistics.persistentEntropy() - aleph::persistentEntropy( D1 ) )  < 1e-4 );
+
+    ALEPH_ASSERT_EQUAL( statistics.infinityNorm(), aleph::infinityNorm( D1 ) );
+  }
+
+  // Points below the diagonal have negative persistence, which is used
+  // with its sign for the total persistence, but not for the norms.
+  {
+    PersistenceDiagram D;
+    D.add( T(0), T(2) );
+    D.add( T(3), T(1) );
+
+    for( double p : { 1.0, 2.0, 3.0 } )
+    {
+      Statistics statistics( p );
+      statistics( D );
+
+      ALEPH_ASSERT_THROW( std::abs( statistics.totalPersistence() - aleph::totalPersistence( D, p ) ) < 1e-8 );
+      ALEPH_ASSERT_THROW( std::abs( statistics.averagePersistence() ) < 1e-8 );
+
+      ALEPH_ASSERT_EQUAL( statistics.infinityNorm(), 2.0 );
+    }
+  }
+
+  // Quantiles are within the relative accuracy of the sketch
+  {
+    Statistics statistics;
+    statistics( D1 );
+
+    std::vector<double> persistence;
+
+    for( auto&& point : D1 )
+      persistence.push_back( point.persistence() );
+
+    std::sort( persistence.begin(), persistence.end() );
+
+    for( double q : { 0.0, 0.25, 0.5, 0.75, 1.0 } )
+    {
+      auto expected = persistence[ std::size_t( q * double( persistence.size() - 1 ) ) ];
+      auto actual   = statistics.quantile( q );
+
+      ALEPH_ASSERT_THROW( std::abs( actual - expected ) <= 0.0101 * expected );
+    }
+  }
+
+  // Merging partial statistics is equivalent to accumulating everything
+  // at once; unpaired points are counted as well.
+  {
+    PersistenceDiagram D3;
+    D3.add( T(0) );
+    D3.add( T(1), T(1) );
+
+    Statistics S;
+    S( D1 );
+    S( D2 );
+    S( D3 );
+
+    Statistics S1;
+    Statistics S2;
+    S1( D1 );
+    S2( D2 );
+    S2( D3 );
+    S1.merge( S2 );
+
+    ALEPH_ASSERT_EQUAL( S1.numDiagrams(), 3 );
+    ALEPH_ASSERT_EQUAL( S1.numPoints(),   D1.size() + D2.size() + D3.size() );
+    ALEPH_ASSERT_EQUAL( S1.betti(),       1 );
+    ALEPH_ASSERT_EQUAL( S1.numPoints(),   S.numPoints() );
+    ALEPH_ASSERT_EQUAL( S1.infinityNorm(), S.infinityNorm() );
+
+    for( double q : { 0.1, 0.5, 0.9 } )
+      ALEPH_ASSERT_EQUAL( S1.quantile( q ), S.quantile( q ) );
+
+    ALEPH_ASSERT_THROW( std::isinf( S1.totalPersistence() ) );
+  }
+
+  // Merging requires the same power
+  {
+    Statistics S1( 1.0 );
+    Statistics S2( 2.0 );
+
+    bool thrown = false;
+
+    try
+    {
+      S1.merge( S2 );
+    }
+    catch( std::runtime_error& )
+    {
+      thrown = true;
+    }
+
+    ALEPH_ASSERT_THROW( thrown );
+  }
+
+  ALEPH_TEST_END();
+}
+
 template <class T> void testWassersteinDistance()
 {
   ALEPH_TEST_BEGIN( "Wasserstein distance" );
@@ -366,9 +669,15 @@ int main(int, char**)
   testEnvelope<float> ();
   testEnvelope<double>();
 
+  testEnvelopes<float> ();
+  testEnvelopes<double>();
+
   testFrechetMean<float> ();
   testFrechetMean<double>();
 
+  testGramMatrix<float> ();
+  testGramMatrix<double>();
+
   testHausdorffDistance<float> ();
   testHausdorffDistance<double>();
 
@@ -384,9 +693,15 @@ int main(int, char**)
   testPersistenceIndicatorFunction<float> ();
   testPersistenceIndicatorFunction<double>();
 
+  testPersistenceIndicatorFunctions<float> ();
+  testPersistenceIndicatorFunctions<double>();
+
   testPointSetDistances<float> ();
   testPointSetDistances<double>();
 
+  testStatistics<float> ();
+  testStatistics<double>();
+
   testWassersteinDistance<float> ();
   testWassersteinDistance<double>();
 }
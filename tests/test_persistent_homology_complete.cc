@@ -15,10 +15,14 @@
 #include <aleph/topology/Simplex.hh>
 #include <aleph/topology/SimplicialComplex.hh>
 
+#include <aleph/topology/representations/External.hh>
 #include <aleph/topology/representations/List.hh>
 #include <aleph/topology/representations/Set.hh>
 #include <aleph/topology/representations/Vector.hh>
 
+#include <aleph/utilities/Profiler.hh>
+
+#include <stdexcept>
 #include <vector>
 
 using namespace aleph::persistentHomology::algorithms;
@@ -104,22 +108,134 @@ template <class T> void test()
   auto diagrams3 = testInternal<representations::List<Index> >( K );
   auto diagrams1 = testInternal<representations::Set<Index> >( K );
   auto diagrams2 = testInternal<representations::Vector<Index> >( K );
+  auto diagrams4 = testInternal<representations::External<Index> >( K );
 
   ALEPH_ASSERT_THROW( diagrams1.size() == diagrams2.size() );
   ALEPH_ASSERT_THROW( diagrams2.size() == diagrams3.size() );
+  ALEPH_ASSERT_THROW( diagrams3.size() == diagrams4.size() );
 
   for( std::size_t i = 0; i < diagrams1.size(); i++ )
   {
     auto&& D1 = diagrams1.at(i);
     auto&& D2 = diagrams2.at(i);
     auto&& D3 = diagrams3.at(i);
+    auto&& D4 = diagrams4.at(i);
 
     ALEPH_ASSERT_THROW( D1.dimension() == D2.dimension() );
     ALEPH_ASSERT_THROW( D2.dimension() == D3.dimension() );
+    ALEPH_ASSERT_THROW( D3.dimension() == D4.dimension() );
     ALEPH_ASSERT_THROW( D1 == D2 );
     ALEPH_ASSERT_THROW( D2 == D3 );
+    ALEPH_ASSERT_THROW( D3 == D4 );
+  }
+
+  ALEPH_TEST_END();
+}
+
+/**
+  Calculates persistence diagrams with a memory budget and reports the
+  peak memory usage of the boundary matrix during the reduction, which
+  is obtained from the profiler.
+*/
+
+template <class Representation, class SimplicialComplex> std::size_t reductionMemoryUsage( const SimplicialComplex& K, std::size_t memoryBudget )
+{
+  auto&& profiler = utilities::Profiler::instance();
+
+  profiler.clear();
+  profiler.setEnabled();
+
+  calculatePersistenceDiagrams<Twist, Representation>( K, true, false, memoryBudget );
+
+  profiler.setEnabled( false );
+
+  auto memory = profiler.memory();
+  auto it     = memory.find( "calculatePersistenceDiagrams/calculatePersistencePairing/reduction/boundaryMatrix" );
+
+  return it != memory.end() ? it->second : 0;
+}
+
+template <class T> void testMemoryBudget()
+{
+  ALEPH_TEST_BEGIN( "Memory budget" );
+
+  using PointCloud   = PointCloud<T>;
+  using Distance     = Euclidean<T>;
+  using Wrapper      = BruteForce<PointCloud, Distance>;
+  using RipsSkeleton = RipsSkeleton<Wrapper>;
+
+  PointCloud pointCloud = load<T>( CMAKE_SOURCE_DIR + std::string( "/tests/input/Iris_colon_separated.txt" ) );
+
+  Wrapper wrapper( pointCloud );
+  RipsSkeleton ripsSkeleton;
+
+  auto K = ripsSkeleton( wrapper, 1.0 );
+
+  using Simplex = typename decltype(K)::ValueType;
+  using Index   = typename Simplex::VertexType;
+  using Set     = representations::Set<Index>;
+  using Vector  = representations::Vector<Index>;
+
+  auto estimateDualized  = aleph::detail::estimateMemoryUsage<Set>( K, true );
+  auto estimateSet       = aleph::detail::estimateMemoryUsage<Set>( K, false );
+  auto estimateVector    = aleph::detail::estimateMemoryUsage<Vector>( K, false );
+
+  ALEPH_ASSERT_THROW( estimateDualized > estimateSet );
+  ALEPH_ASSERT_THROW( estimateSet      > estimateVector );
+  ALEPH_ASSERT_THROW( estimateVector   > K.memoryUsage() );
+
+  // Switching to the compact representation must actually reduce the
+  // memory usage of the matrix. For the default representation, which
+  // is compact already, the budget of the non-dualized matrix is the
+  // smallest one that does not require external storage.
+  {
+    auto memorySet     = reductionMemoryUsage<Set>( K, estimateSet );
+    auto memoryCompact = reductionMemoryUsage<Set>( K, estimateVector );
+
+    ALEPH_ASSERT_THROW( memorySet     > 0 );
+    ALEPH_ASSERT_THROW( memoryCompact > 0 );
+    ALEPH_ASSERT_THROW( memoryCompact < memorySet );
+    ALEPH_ASSERT_THROW( memoryCompact == reductionMemoryUsage<Vector>( K, estimateVector ) );
+  }
+
+  auto diagrams = calculatePersistenceDiagrams<Twist, Set>( K );
+
+  // Every budget that permits the calculation must result in the same
+  // diagrams, regardless of the strategy that is being used.
+  for( auto&& budget : { estimateDualized, estimateSet, estimateVector } )
+  {
+    auto D = calculatePersistenceDiagrams<Twist, Set>( K, true, false, budget );
+
+    ALEPH_ASSERT_EQUAL( D.size(), diagrams.size() );
+
+    for( std::size_t i = 0; i < D.size(); i++ )
+      ALEPH_ASSERT_THROW( D.at(i) == diagrams.at(i) );
+  }
+
+  // If not even the compact representation fits, the matrix is stored
+  // on disk, and the calculation only fails if the metadata of all of
+  // its columns exceed the budget.
+  {
+    auto D = calculatePersistenceDiagrams<Twist, Set>( K, true, false, estimateVector - 1 );
+
+    ALEPH_ASSERT_EQUAL( D.size(), diagrams.size() );
+
+    for( std::size_t i = 0; i < D.size(); i++ )
+      ALEPH_ASSERT_THROW( D.at(i) == diagrams.at(i) );
   }
 
+  bool thrown = false;
+
+  try
+  {
+    calculatePersistenceDiagrams<Twist, Set>( K, true, false, K.memoryUsage() );
+  }
+  catch( std::runtime_error& )
+  {
+    thrown = true;
+  }
+
+  ALEPH_ASSERT_THROW( thrown );
   ALEPH_TEST_END();
 }
 
@@ -127,4 +243,7 @@ int main()
 {
   test<float> ();
   test<double>();
+
+  testMemoryBudget<float> ();
+  testMemoryBudget<double>();
 }
@@ -0,0 +1,186 @@
+#include <tests/Base.hh>
+
+#include <aleph/utilities/Pipeline.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cstddef>
+
+using namespace aleph::utilities;
+
+void testQueue()
+{
+  ALEPH_TEST_BEGIN( "Bounded queue" );
+
+  BoundedQueue<int> queue( 2 );
+
+  ALEPH_ASSERT_EQUAL( queue.capacity(), 2 );
+
+  std::thread producer( [&queue] ()
+  {
+    for( int i = 0; i < 100; i++ )
+      queue.push( i );
+
+    queue.close();
+  } );
+
+  std::vector<int> values;
+  int value = 0;
+
+  while( queue.pop( value ) )
+    values.push_back( value );
+
+  producer.join();
+
+  ALEPH_ASSERT_EQUAL( values.size(), 100 );
+
+  for( int i = 0; i < 100; i++ )
+    ALEPH_ASSERT_EQUAL( values[ std::size_t(i) ], i );
+
+  // A closed queue does not accept any more values
+  ALEPH_ASSERT_THROW( !queue.push( 0 ) );
+  ALEPH_ASSERT_THROW( !queue.pop( value ) );
+
+  ALEPH_TEST_END();
+}
+
+void testOrder()
+{
+  ALEPH_TEST_BEGIN( "Pipeline order" );
+
+  for( std::size_t numWorkers : { 1, 2, 4, 8 } )
+  {
+    Pipeline pipeline( numWorkers, 3 );
+
+    ALEPH_ASSERT_EQUAL( pipeline.numWorkers(), numWorkers );
+    ALEPH_ASSERT_EQUAL( pipeline.capacity(),   3 );
+
+    std::size_t n = 200;
+
+    std::atomic<std::size_t> numPending( 0 );
+    std::size_t maxPending = 0;
+
+    std::vector<std::size_t> indices;
+    std::vector<std::string> results;
+
+    pipeline( n,
+              [&] ( std::size_t i )
+              {
+                maxPending = std::max( maxPending, ++numPending );
+                return std::to_string( i );
+              },
+              [] ( std::string& s )
+              {
+                // Varying costs ensure that results are completed out
+                // of order.
+                std::this_thread::sleep_for( std::chrono::microseconds( std::stoul( s ) % 7 * 50 ) );
+                return s + "!";
+              },
+              [&] ( std::size_t i, std::string& s )
+              {
+                --numPending;
+
+                indices.push_back( i );
+                results.push_back( s );
+              } );
+
+    ALEPH_ASSERT_EQUAL( indices.size(), n );
+    ALEPH_ASSERT_EQUAL( results.size(), n );
+
+    for( std::size_t i = 0; i < n; i++ )
+    {
+      ALEPH_ASSERT_EQUAL( indices[i], i );
+      ALEPH_ASSERT_THROW( results[i] == std::to_string( i ) + "!" );
+    }
+
+    // The number of inputs that are in the pipeline is bounded
+    ALEPH_ASSERT_THROW( maxPending <= pipeline.capacity() );
+  }
+
+  // Empty pipelines do not call any functor
+  {
+    Pipeline pipeline;
+    bool called = false;
+
+    pipeline( 0,
+              [&] ( std::size_t i )              { called = true; return i; },
+              [&] ( std::size_t& i )             { called = true; return i; },
+              [&] ( std::size_t, std::size_t& )  { called = true; } );
+
+    ALEPH_ASSERT_THROW( !called );
+    ALEPH_ASSERT_THROW( pipeline.numWorkers() >= 1 );
+  }
+
+  ALEPH_TEST_END();
+}
+
+void testErrors()
+{
+  ALEPH_TEST_BEGIN( "Pipeline errors" );
+
+  Pipeline pipeline( 4, 8 );
+
+  // Every stage may fail at some input; the pipeline has to stop and
+  // report the error instead of waiting forever.
+  for( int stage = 0; stage < 3; stage++ )
+  {
+    std::size_t numWritten = 0;
+    bool thrown            = false;
+
+    try
+    {
+      pipeline( 1000,
+                [&] ( std::size_t i )
+                {
+                  if( stage == 0 && i == 100 )
+                    throw std::runtime_error( "read" );
+
+                  return i;
+                },
+                [&] ( std::size_t& i )
+                {
+                  if( stage == 1 && i == 100 )
+                    throw std::runtime_error( "compute" );
+
+                  return 2 * i;
+                },
+                [&] ( std::size_t i, std::size_t& j )
+                {
+                  if( stage == 2 && i == 100 )
+                    throw std::runtime_error( "write" );
+
+                  ALEPH_ASSERT_EQUAL( j, 2 * i );
+                  ++numWritten;
+                } );
+    }
+    catch( std::runtime_error& e )
+    {
+      thrown = true;
+
+      ALEPH_ASSERT_THROW( std::string( e.what() ) == ( stage == 0 ? "read" : stage == 1 ? "compute" : "write" ) );
+    }
+
+    // Results that precede the error are written, unless the pipeline
+    // has been stopped before they were computed.
+    ALEPH_ASSERT_THROW( thrown );
+    ALEPH_ASSERT_THROW( numWritten <= 100 );
+
+    if( stage == 2 )
+      ALEPH_ASSERT_EQUAL( numWritten, 100 );
+  }
+
+  ALEPH_TEST_END();
+}
+
+int main( int, char** )
+{
+  testQueue();
+  testOrder();
+  testErrors();
+}
@@ -101,15 +101,64 @@ template <class T> void testAccess()
   ALEPH_TEST_END();
 }
 
+template <class T> void testView()
+{
+  ALEPH_TEST_BEGIN( "Point cloud view" );
+
+  std::vector<T> data = { T(1), T(2),
+                          T(3), T(4),
+                          T(5), T(6) };
+
+  {
+    PointCloud<T> pc( 3, 2, data.data() );
+
+    ALEPH_ASSERT_THROW( pc.owner() == false );
+    ALEPH_ASSERT_THROW( pc.data()  == data.data() );
+    ALEPH_ASSERT_EQUAL( pc.size(),      3 );
+    ALEPH_ASSERT_EQUAL( pc.dimension(), 2 );
+
+    // Changes to the point cloud have to be visible in the wrapped
+    // array, and vice versa.
+    pc.set( 1, {7,8} );
+
+    ALEPH_ASSERT_THROW( data[2] == T(7) );
+    ALEPH_ASSERT_THROW( data[3] == T(8) );
+
+    data[5] = T(9);
+
+    ALEPH_ASSERT_THROW( pc[2] == std::vector<T>( { T(5), T(9) } ) );
+
+    auto copy = pc;
+
+    ALEPH_ASSERT_THROW( copy.owner() );
+    ALEPH_ASSERT_THROW( copy.data() != data.data() );
+    ALEPH_ASSERT_THROW( copy        == pc );
+
+    auto moved = std::move( pc );
+
+    ALEPH_ASSERT_THROW( moved.owner() == false );
+    ALEPH_ASSERT_THROW( moved.data()  == data.data() );
+  }
+
+  // The wrapped array must still be valid after the point cloud has
+  // been destroyed.
+  ALEPH_ASSERT_THROW( data.size() == 6 );
+  ALEPH_ASSERT_THROW( data[0]     == T(1) );
+
+  ALEPH_TEST_END();
+}
+
 int main()
 {
   std::cerr << "-- float\n";
 
   testFormats<float> ();
   testAccess<float>  ();
+  testView<float>    ();
 
   std::cerr << "-- double\n";
 
   testFormats<double>();
   testAccess<double> ();
+  testView<double>   ();
 }
@@ -0,0 +1,184 @@
+#include <tests/Base.hh>
+
+#include <aleph/persistentHomology/Calculation.hh>
+
+#include <aleph/topology/Simplex.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <aleph/utilities/Profiler.hh>
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace aleph::utilities;
+
+void testZones()
+{
+  ALEPH_TEST_BEGIN( "Profiler zones" );
+
+  auto&& profiler = Profiler::instance();
+
+  profiler.clear();
+  profiler.setEnabled();
+
+  {
+    ALEPH_PROFILE_ZONE( "outer" );
+
+    for( unsigned i = 0; i < 3; i++ )
+    {
+      ALEPH_PROFILE_ZONE( "inner" );
+    }
+  }
+
+  auto statistics = profiler.statistics();
+
+  ALEPH_ASSERT_EQUAL( statistics.size(), 2 );
+  ALEPH_ASSERT_EQUAL( statistics.at( "outer" ).count, 1 );
+  ALEPH_ASSERT_EQUAL( statistics.at( "outer/inner" ).count, 3 );
+
+  ALEPH_ASSERT_THROW( statistics.at( "outer/inner" ).min <= statistics.at( "outer/inner" ).max );
+  ALEPH_ASSERT_THROW( statistics.at( "outer/inner" ).total <= statistics.at( "outer" ).total );
+
+  profiler.setEnabled( false );
+  profiler.clear();
+
+  {
+    ALEPH_PROFILE_ZONE( "disabled" );
+  }
+
+  ALEPH_ASSERT_THROW( profiler.statistics().empty() );
+
+  ALEPH_TEST_END();
+}
+
+void testPipeline()
+{
+  ALEPH_TEST_BEGIN( "Profiler pipeline" );
+
+  using Simplex           = aleph::topology::Simplex<double, unsigned>;
+  using SimplicialComplex = aleph::topology::SimplicialComplex<Simplex>;
+
+  std::vector<Simplex> simplices
+    = { {0}, {1}, {2}, {0,1}, {0,2}, {1,2} };
+
+  SimplicialComplex K( simplices.begin(), simplices.end() );
+
+  auto&& profiler = Profiler::instance();
+
+  profiler.clear();
+  profiler.setEnabled();
+
+  auto diagrams = aleph::calculatePersistenceDiagrams( K );
+
+  profiler.setEnabled( false );
+
+  ALEPH_ASSERT_THROW( diagrams.empty() == false );
+
+  auto statistics = profiler.statistics();
+
+  std::vector<std::string> zones = {
+    "calculatePersistenceDiagrams",
+    "calculatePersistenceDiagrams/makeBoundaryMatrix",
+    "calculatePersistenceDiagrams/dualize",
+    "calculatePersistenceDiagrams/calculatePersistencePairing",
+    "calculatePersistenceDiagrams/calculatePersistencePairing/reduction",
+    "calculatePersistenceDiagrams/calculatePersistencePairing/pairing",
+    "calculatePersistenceDiagrams/makePersistenceDiagrams"
+  };
+
+  for( auto&& zone : zones )
+    ALEPH_ASSERT_THROW( statistics.find( zone ) != statistics.end() );
+
+  auto memory = profiler.memory();
+
+  std::vector<std::string> structures = {
+    "calculatePersistenceDiagrams/simplicialComplex",
+    "calculatePersistenceDiagrams/makeBoundaryMatrix/boundaryMatrix",
+    "calculatePersistenceDiagrams/dualize/dualMatrix",
+    "calculatePersistenceDiagrams/dualize/boundaryMatrix",
+    "calculatePersistenceDiagrams/calculatePersistencePairing/reduction/boundaryMatrix"
+  };
+
+  for( auto&& structure : structures )
+  {
+    ALEPH_ASSERT_THROW( memory.find( structure ) != memory.end() );
+    ALEPH_ASSERT_THROW( memory.at( structure ) > 0 );
+  }
+
+  std::ostringstream json;
+  std::ostringstream trace;
+
+  profiler.writeJSON( json );
+  profiler.writeChromeTrace( trace );
+
+  ALEPH_ASSERT_THROW( json.str().find( "\"calculatePersistenceDiagrams/calculatePersistencePairing/reduction\"" ) != std::string::npos );
+  ALEPH_ASSERT_THROW( json.str().find( "\"memory\"" )                                                            != std::string::npos );
+  ALEPH_ASSERT_THROW( trace.str().find( "\"traceEvents\"" )                                                       != std::string::npos );
+  ALEPH_ASSERT_THROW( trace.str().find( "\"name\": \"reduction\"" )                                               != std::string::npos );
+
+  ALEPH_TEST_END();
+}
+
+void testThreads()
+{
+  ALEPH_TEST_BEGIN( "Profiler threads" );
+
+  auto&& profiler = Profiler::instance();
+
+  profiler.clear();
+  profiler.setEnabled();
+
+  unsigned numThreads = 4;
+  unsigned numZones   = 1000;
+
+  std::vector<std::thread> threads;
+
+  for( unsigned i = 0; i < numThreads; i++ )
+  {
+    threads.emplace_back( [numZones] ()
+    {
+      for( unsigned j = 0; j < numZones; j++ )
+      {
+        ALEPH_PROFILE_ZONE( "worker" );
+        ALEPH_PROFILE_MEMORY( "data", j );
+      }
+    } );
+  }
+
+  // Querying the data while other threads record zones must not result
+  // in inconsistent data.
+  for( unsigned i = 0; i < 100; i++ )
+  {
+    auto statistics = profiler.statistics();
+    auto memory     = profiler.memory();
+
+    if( statistics.find( "worker" ) != statistics.end() )
+      ALEPH_ASSERT_THROW( statistics.at( "worker" ).count <= numThreads * numZones );
+
+    std::ostringstream json;
+    profiler.writeJSON( json );
+  }
+
+  for( auto&& thread : threads )
+    thread.join();
+
+  profiler.setEnabled( false );
+
+  auto statistics = profiler.statistics();
+
+  ALEPH_ASSERT_EQUAL( statistics.at( "worker" ).count, numThreads * numZones );
+  ALEPH_ASSERT_EQUAL( profiler.memory().at( "worker/data" ), numZones - 1 );
+
+  profiler.clear();
+
+  ALEPH_TEST_END();
+}
+
+int main( int, char** )
+{
+  testZones();
+  testPipeline();
+  testThreads();
+}
@@ -0,0 +1,209 @@
+#include <aleph/containers/PointCloud.hh>
+
+#include <aleph/geometry/BruteForce.hh>
+#include <aleph/geometry/VietorisRipsComplex.hh>
+
+#include <aleph/geometry/distances/Euclidean.hh>
+
+#include <tests/Base.hh>
+
+#include <aleph/persistentHomology/Calculation.hh>
+#include <aleph/persistentHomology/Progressive.hh>
+
+#include <aleph/topology/RandomGraph.hh>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace aleph;
+using namespace containers;
+using namespace geometry;
+using namespace topology;
+
+template <class T> std::vector< std::pair<T, T> > sortedPoints( const PersistenceDiagram<T>& D )
+{
+  std::vector< std::pair<T, T> > points;
+
+  for( auto&& p : D )
+    points.push_back( std::make_pair( p.x(), p.y() ) );
+
+  std::sort( points.begin(), points.end() );
+  return points;
+}
+
+template <class T> void assertEqualDiagrams( const std::vector< PersistenceDiagram<T> >& D1,
+                                             const std::vector< PersistenceDiagram<T> >& D2 )
+{
+  ALEPH_ASSERT_EQUAL( D1.size(), D2.size() );
+
+  for( std::size_t i = 0; i < D1.size(); i++ )
+  {
+    ALEPH_ASSERT_EQUAL( D1[i].dimension(), D2[i].dimension() );
+    ALEPH_ASSERT_THROW( sortedPoints( D1[i] ) == sortedPoints( D2[i] ) );
+  }
+}
+
+/**
+  Checks that partial diagrams only contain pairs whose destroyers have
+  been processed, and that all of these pairs are also present in the
+  final diagrams.
+*/
+
+template <class T> void assertPartialDiagrams( const std::vector< PersistenceDiagram<T> >& partial,
+                                               const std::vector< PersistenceDiagram<T> >& complete,
+                                               T threshold )
+{
+  for( auto&& D : partial )
+  {
+    auto it = std::find_if( complete.begin(), complete.end(),
+                            [&D] ( const PersistenceDiagram<T>& E )
+                            {
+                              return D.dimension() == E.dimension();
+                            } );
+
+    ALEPH_ASSERT_THROW( it != complete.end() );
+
+    auto points = sortedPoints( *it );
+
+    for( auto&& p : D )
+    {
+      ALEPH_ASSERT_THROW( p.x() <= threshold );
+
+      if( !p.isUnpaired() )
+      {
+        ALEPH_ASSERT_THROW( p.y() <= threshold );
+        ALEPH_ASSERT_THROW( std::binary_search( points.begin(), points.end(), std::make_pair( p.x(), p.y() ) ) );
+      }
+    }
+  }
+
+  // Conversely, every pair of the complete diagrams that is destroyed
+  // below the threshold must already be known.
+  for( auto&& E : complete )
+  {
+    std::size_t numPairs = 0;
+    for( auto&& p : E )
+      numPairs += !p.isUnpaired() && p.y() <= threshold;
+
+    std::size_t numPartialPairs = 0;
+    for( auto&& D : partial )
+    {
+      if( D.dimension() == E.dimension() )
+      {
+        for( auto&& p : D )
+          numPartialPairs += !p.isUnpaired();
+      }
+    }
+
+    ALEPH_ASSERT_EQUAL( numPairs, numPartialPairs );
+  }
+}
+
+template <class T> void testRipsComplex()
+{
+  ALEPH_TEST_BEGIN( "Progressive persistence of Vietoris--Rips complex" );
+
+  using Distance = distances::Euclidean<T>;
+
+  auto pc = load<T>( CMAKE_SOURCE_DIR + std::string( "/tests/input/Iris_colon_separated.txt" ) );
+
+  BruteForce<PointCloud<T>, Distance> bruteForce( pc );
+
+  auto K        = buildVietorisRipsComplex( bruteForce, T(0.8), 2 );
+  auto complete = calculatePersistenceDiagrams( K, false );
+
+  ALEPH_ASSERT_THROW( !complete.empty() );
+
+  std::size_t numBlocks = 0;
+
+  auto diagrams = calculatePersistenceDiagramsProgressively( K,
+    [&] ( const ProgressivePersistence< typename decltype(K)::ValueType >& progressive )
+    {
+      assertPartialDiagrams( progressive.diagrams(), complete, progressive.threshold() );
+
+      ++numBlocks;
+      return false;
+    },
+    100 );
+
+  ALEPH_ASSERT_THROW( numBlocks > 1 );
+  ALEPH_ASSERT_THROW( numBlocks <= K.size() / 100 + 1 );
+
+  assertEqualDiagrams( diagrams, complete );
+  assertEqualDiagrams( diagrams, calculatePersistenceDiagrams( K ) );
+
+  // Stopping early --------------------------------------------------
+
+  T threshold     = T(0.3);
+  T stopThreshold = T();
+
+  auto partial = calculatePersistenceDiagramsProgressively( K,
+    [&threshold, &stopThreshold] ( const ProgressivePersistence< typename decltype(K)::ValueType >& progressive )
+    {
+      stopThreshold = progressive.threshold();
+      return stopThreshold >= threshold;
+    },
+    50 );
+
+  ALEPH_ASSERT_THROW( stopThreshold >= threshold );
+  ALEPH_ASSERT_THROW( stopThreshold < K.at( K.size() - 1 ).data() );
+
+  assertPartialDiagrams( partial, complete, stopThreshold );
+
+  {
+    ProgressivePersistence< typename decltype(K)::ValueType > progressive( K );
+    progressive.advanceTo( threshold );
+
+    ALEPH_ASSERT_THROW( progressive.numProcessed() < K.size() );
+    ALEPH_ASSERT_THROW( progressive.threshold() <= threshold );
+    ALEPH_ASSERT_THROW( threshold < K.at( progressive.numProcessed() ).data() );
+
+    assertPartialDiagrams( progressive.diagrams(), complete, threshold );
+  }
+
+  ALEPH_TEST_END();
+}
+
+void testRandomGraph()
+{
+  ALEPH_TEST_BEGIN( "Progressive persistence of weighted random graph" );
+
+  // The weights of the graph contain many ties, so blocks have to be
+  // extended in order to contain all edges of the same weight.
+  auto K = generateWeightedRandomGraph( 500, 0.05, 42 );
+
+  for( bool includeAllUnpairedCreators : { false, true } )
+  {
+    auto complete = calculatePersistenceDiagrams( K, false, includeAllUnpairedCreators );
+
+    ProgressivePersistence< typename decltype(K)::ValueType > progressive( K, includeAllUnpairedCreators );
+
+    ALEPH_ASSERT_EQUAL( progressive.numProcessed(), 0 );
+    ALEPH_ASSERT_THROW( !progressive.done() );
+
+    while( progressive.advance( 1 ) )
+    {
+      auto threshold = progressive.threshold();
+
+      ALEPH_ASSERT_THROW( threshold < K.at( progressive.numProcessed() ).data() );
+      assertPartialDiagrams( progressive.diagrams(), complete, threshold );
+    }
+
+    ALEPH_ASSERT_THROW( progressive.done() );
+    ALEPH_ASSERT_EQUAL( progressive.numProcessed(), K.size() );
+
+    assertEqualDiagrams( progressive.diagrams(), complete );
+  }
+
+  ALEPH_TEST_END();
+}
+
+int main( int, char** )
+{
+  testRipsComplex<float> ();
+  testRipsComplex<double>();
+
+  testRandomGraph();
+}
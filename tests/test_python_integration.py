@@ -63,3 +63,75 @@ def sorting_function(s,t):
 M.sort( sorting_function )
 
 print(M)
+
+try:
+  import numpy as np
+
+  X = np.random.uniform( size=(10,2) )
+  P = PointCloud( X )
+
+  assert not P.owner, "Point cloud must wrap contiguous arrays"
+  assert len(P) == 10
+
+  X[0,0] = 4711
+  assert np.asarray( P )[0,0] == 4711, "Point cloud must be a view"
+
+  D = PersistenceDiagram( np.array( [ [0.0, 1.0], [0.5, 2.0] ] ) )
+  Y = np.asarray( D )
+
+  assert len(D) == 2
+  assert Y.shape == (2,2)
+  assert Y[1,1] == 2.0
+
+except ImportError:
+  pass
+
+diagrams = calculatePersistenceDiagramsBatch( [K, L, M] )
+
+assert len(diagrams) == 3
+assert [ len(D) for D in diagrams[0] ] == [ len(D) for D in calculatePersistenceDiagrams(K) ]
+
+D0 = [ D[0] for D in diagrams ]
+
+# Distance matrices are returned as NumPy arrays
+try:
+  B = bottleneckDistanceMatrix( D0 )
+  W = wassersteinDistanceMatrix( D0, p=2 )
+  S = multiScaleKernelMatrix( D0, 1.0 )
+
+  for i in range(3):
+    assert B[i][i] == 0.0
+    for j in range(3):
+      assert B[i][j] == B[j][i]
+      assert B[i][j] == bottleneckDistance( D0[i], D0[j] )
+      assert S[i][j] == multiScaleKernel( D0[i], D0[j], 1.0 )
+
+except ImportError:
+  pass
+
+# Bulk construction of simplicial complexes from arrays
+try:
+  import numpy as np
+
+  V = [ np.array( [ [0], [1], [2] ] ), np.array( [ [0,1], [0,2], [1,2] ] ) ]
+  W = [ np.array( [0.0, 0.0, 0.0] ), np.array( [1.0, 2.0, 3.0] ) ]
+
+  N = SimplicialComplex.fromArrays( V, W )
+
+  assert len(N) == 6
+  assert N.dimension == 1
+  assert Simplex( [1,2] ) in N
+
+  V_, W_ = N.toArrays()
+
+  assert len(V_) == 2
+  assert ( V_[1] == V[1] ).all()
+  assert ( W_[1] == W[1] ).all()
+
+  E = SimplicialComplex.fromEdgeList( np.array( [ [0,1], [1,2] ] ), np.array( [0.5, 1.5] ) )
+
+  assert len(E) == 5
+  assert E[4].weight == 1.5
+
+except ImportError:
+  pass
@@ -0,0 +1,268 @@
+#include <aleph/containers/PointCloud.hh>
+
+#include <aleph/geometry/BruteForce.hh>
+#include <aleph/geometry/VietorisRipsComplex.hh>
+
+#include <aleph/geometry/distances/Euclidean.hh>
+
+#include <tests/Base.hh>
+
+#include <aleph/persistentHomology/Calculation.hh>
+#include <aleph/persistentHomology/Strategy.hh>
+
+#include <aleph/persistentHomology/algorithms/Automatic.hh>
+#include <aleph/persistentHomology/algorithms/Standard.hh>
+#include <aleph/persistentHomology/algorithms/Twist.hh>
+
+#include <aleph/topology/RandomGraph.hh>
+#include <aleph/topology/Simplex.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <aleph/topology/filtrations/Data.hh>
+
+#include <aleph/utilities/Profiler.hh>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace aleph;
+using namespace containers;
+using namespace geometry;
+using namespace topology;
+
+using namespace aleph::persistentHomology::algorithms;
+
+template <class SimplicialComplex> void checkDiagrams( const SimplicialComplex& K )
+{
+  for( bool includeAllUnpairedCreators : { false, true } )
+  {
+    auto expected = calculatePersistenceDiagrams( K, true, includeAllUnpairedCreators );
+    auto diagrams = calculatePersistenceDiagrams<Automatic>( K, true, includeAllUnpairedCreators );
+
+    ALEPH_ASSERT_EQUAL( diagrams.size(), expected.size() );
+
+    for( std::size_t i = 0; i < diagrams.size(); i++ )
+    {
+      ALEPH_ASSERT_EQUAL( diagrams[i].dimension(), expected[i].dimension() );
+      ALEPH_ASSERT_THROW( diagrams[i] == expected[i] );
+    }
+  }
+}
+
+/** Creates a triangulated grid whose vertices have pseudo-random values */
+SimplicialComplex< Simplex<double, unsigned> > makeGrid( unsigned n )
+{
+  using Simplex = Simplex<double, unsigned>;
+
+  auto value = [n] ( unsigned i, unsigned j )
+  {
+    return double( ( ( i * n + j ) * 7919u ) % 1009u );
+  };
+
+  auto make = [&value, n] ( std::vector<unsigned> vertices )
+  {
+    double data = 0.0;
+    for( auto&& v : vertices )
+      data = std::max( data, value( v / n, v % n ) );
+
+    return Simplex( vertices.begin(), vertices.end(), data );
+  };
+
+  std::vector<Simplex> simplices;
+
+  for( unsigned i = 0; i < n; i++ )
+  {
+    for( unsigned j = 0; j < n; j++ )
+    {
+      auto v = i * n + j;
+
+      simplices.push_back( make( { v } ) );
+
+      if( j + 1 < n )
+        simplices.push_back( make( { v, v + 1 } ) );
+
+      if( i + 1 < n )
+        simplices.push_back( make( { v, v + n } ) );
+
+      if( i + 1 < n && j + 1 < n )
+      {
+        simplices.push_back( make( { v, v + n + 1 } ) );
+        simplices.push_back( make( { v, v + 1, v + n + 1 } ) );
+        simplices.push_back( make( { v, v + n, v + n + 1 } ) );
+      }
+    }
+  }
+
+  SimplicialComplex<Simplex> K( simplices.begin(), simplices.end() );
+  K.sort( filtrations::Data<Simplex>() );
+
+  return K;
+}
+
+void testStatistics()
+{
+  ALEPH_TEST_BEGIN( "Complex statistics" );
+
+  auto K          = makeGrid( 10 );
+  auto statistics = collectStatistics( K );
+
+  ALEPH_ASSERT_EQUAL( statistics.dimension(), 2 );
+  ALEPH_ASSERT_EQUAL( statistics.size(), K.size() );
+  ALEPH_ASSERT_EQUAL( statistics.numSimplices[0], 100 );
+  ALEPH_ASSERT_EQUAL( statistics.numSimplices[1], 90 + 90 + 81 );
+  ALEPH_ASSERT_EQUAL( statistics.numSimplices[2], 2 * 81 );
+  ALEPH_ASSERT_EQUAL( statistics.numEntries, 2 * 261 + 3 * 162 );
+  ALEPH_ASSERT_THROW( statistics.profile() == "100 261 162" );
+
+  ALEPH_ASSERT_THROW( statistics.density() < 1.0 );
+  ALEPH_ASSERT_THROW( statistics.averageColumnLength() > 1.0 );
+
+  ComplexStatistics empty;
+
+  ALEPH_ASSERT_EQUAL( empty.dimension(), 0 );
+  ALEPH_ASSERT_THROW( empty.density() == 0.0 );
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testSelection()
+{
+  ALEPH_TEST_BEGIN( "Strategy selection" );
+
+  // Graphs ------------------------------------------------------------
+
+  {
+    auto K        = generateWeightedRandomGraph( 200, 0.05, 23 );
+    auto strategy = selectStrategy( collectStatistics( K ) );
+
+    ALEPH_ASSERT_THROW( strategy.eliminateApparentPairs );
+    ALEPH_ASSERT_THROW( !strategy.dualize );
+    ALEPH_ASSERT_THROW( strategy.algorithm == "Standard" );
+
+    checkDiagrams( K );
+  }
+
+  // Meshes ------------------------------------------------------------
+
+  {
+    auto K        = makeGrid( 20 );
+    auto strategy = selectStrategy( collectStatistics( K ) );
+
+    ALEPH_ASSERT_THROW( strategy.eliminateApparentPairs );
+    ALEPH_ASSERT_THROW( !strategy.dualize );
+    ALEPH_ASSERT_THROW( strategy.algorithm == "Standard" );
+
+    checkDiagrams( K );
+  }
+
+  // Dense Vietoris--Rips complexes ------------------------------------
+
+  {
+    using Distance = distances::Euclidean<T>;
+
+    auto pc = load<T>( CMAKE_SOURCE_DIR + std::string( "/tests/input/Iris_colon_separated.txt" ) );
+
+    BruteForce<PointCloud<T>, Distance> bruteForce( pc );
+
+    auto K        = buildVietorisRipsComplex( bruteForce, T(1.0), 2 );
+    auto strategy = selectStrategy( collectStatistics( K ) );
+
+    ALEPH_ASSERT_THROW( !strategy.eliminateApparentPairs );
+    ALEPH_ASSERT_THROW( strategy.dualize );
+    ALEPH_ASSERT_THROW( strategy.algorithm == "Twist" );
+
+    checkDiagrams( K );
+  }
+
+  ALEPH_TEST_END();
+}
+
+/** Reduction algorithm that is not known to the library */
+class Custom : public Twist
+{
+};
+
+void testReporting()
+{
+  ALEPH_TEST_BEGIN( "Strategy reporting" );
+
+  using namespace aleph::utilities;
+
+  auto K = makeGrid( 5 );
+
+  auto&& profiler = Profiler::instance();
+
+  profiler.clear();
+  profiler.setEnabled();
+
+  calculatePersistenceDiagrams<Automatic>( K );
+
+  // A sufficient memory budget does not change the strategy, whereas a
+  // budget that is too small for the elimination of apparent pairs
+  // requires storing the complete matrix on disk.
+  {
+    ALEPH_PROFILE_ZONE( "budget" );
+    calculatePersistenceDiagrams<Automatic>( K, true, false, std::size_t(1) << 30 );
+  }
+
+  {
+    ALEPH_PROFILE_ZONE( "smallBudget" );
+
+    auto strategy = selectStrategy( collectStatistics( K ) );
+    auto estimate = aleph::detail::estimateMemoryUsage<aleph::defaults::Representation>( K, strategy );
+
+    calculatePersistenceDiagrams<Automatic>( K, true, false, estimate - 1 );
+  }
+
+  // The strategy always names the reduction algorithm that is used
+  {
+    ALEPH_PROFILE_ZONE( "standard" );
+    calculatePersistenceDiagrams<Standard>( K );
+  }
+
+  {
+    ALEPH_PROFILE_ZONE( "threshold" );
+    calculatePersistenceDiagrams<Standard>( K, true, false, 0, 1.0 );
+  }
+
+  {
+    ALEPH_PROFILE_ZONE( "custom" );
+    calculatePersistenceDiagrams<Custom>( K, false );
+  }
+
+  profiler.setEnabled( false );
+
+  auto annotations = profiler.annotations();
+
+  ALEPH_ASSERT_THROW( annotations.at( "calculatePersistenceDiagrams/strategy" )         == "apparent pairs, Standard, not dualized" );
+  ALEPH_ASSERT_THROW( annotations.at( "calculatePersistenceDiagrams/dimensionProfile" ) == "25 56 32" );
+  ALEPH_ASSERT_THROW( annotations.at( "budget/calculatePersistenceDiagrams/strategy" )      == "apparent pairs, Standard, not dualized" );
+  ALEPH_ASSERT_THROW( annotations.at( "smallBudget/calculatePersistenceDiagrams/strategy" ) == "Twist, not dualized" );
+  ALEPH_ASSERT_THROW( annotations.at( "standard/calculatePersistenceDiagrams/strategy" )    == "Standard, dualized" );
+  ALEPH_ASSERT_THROW( annotations.at( "threshold/calculatePersistenceDiagrams/strategy" )   == "apparent pairs, Standard, dualized" );
+  ALEPH_ASSERT_THROW( annotations.at( "custom/calculatePersistenceDiagrams/strategy" )      == "custom, not dualized" );
+  ALEPH_ASSERT_THROW( annotations.find( "calculatePersistenceDiagrams/averageColumnLength" ) != annotations.end() );
+
+  std::ostringstream json;
+  profiler.writeJSON( json );
+
+  ALEPH_ASSERT_THROW( json.str().find( "\"annotations\"" )                         != std::string::npos );
+  ALEPH_ASSERT_THROW( json.str().find( "\"apparent pairs, Standard, not dualized\"" ) != std::string::npos );
+
+  profiler.clear();
+
+  ALEPH_ASSERT_THROW( profiler.annotations().empty() );
+
+  ALEPH_TEST_END();
+}
+
+int main( int, char** )
+{
+  testStatistics();
+
+  testSelection<float> ();
+  testSelection<double>();
+
+  testReporting();
+}
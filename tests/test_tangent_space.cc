@@ -2,11 +2,18 @@
 
 #include <aleph/containers/PointCloud.hh>
 
+#include <aleph/geometry/BruteForce.hh>
 #include <aleph/geometry/TangentSpace.hh>
 
+#include <aleph/geometry/distances/Euclidean.hh>
+
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #include <cmath>
+#include <cstddef>
 
 using namespace aleph;
 using namespace containers;
@@ -60,6 +67,113 @@ template <class T> void test()
 #endif
 }
 
+template <class T> void testRegression()
+{
+  ALEPH_TEST_BEGIN( "Tangent space: recorded curvature values" );
+
+#ifdef ALEPH_WITH_EIGEN
+#if EIGEN_VERSION_AT_LEAST(3,3,0)
+  using PointCloud = PointCloud<T>;
+
+  PointCloud pc = load<T>( CMAKE_SOURCE_DIR + std::string( "/tests/input/Iris_colon_separated.txt" ) );
+
+  TangentSpace ts;
+  auto curvature = ts( pc, 10 );
+
+  ALEPH_ASSERT_EQUAL( curvature.size(), pc.size() );
+
+  // Values of the original, sequential implementation for some of the
+  // points; they were calculated from the data set in double precision.
+  std::vector<std::size_t> indices = { 0, 37, 74, 111, 149 };
+  std::vector<double> expected     = {
+    0.45493140148535915,
+    8.4183692485724926,
+    1.3304240958838649,
+    4.4468717253011949,
+    0.32119961185248064
+  };
+
+  // Loading the data in single precision already changes the values
+  // slightly.
+  double tolerance = sizeof(T) < sizeof(double) ? 1e-4 : 1e-6;
+
+  for( std::size_t i = 0; i < indices.size(); i++ )
+  {
+    auto c = double( curvature[ indices[i] ] );
+    ALEPH_ASSERT_THROW( std::abs( c - expected[i] ) <= tolerance * expected[i] );
+  }
+
+  for( auto&& c : curvature )
+    ALEPH_ASSERT_THROW( std::isfinite( c ) && c >= 0 );
+#endif
+#endif
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testNeighbourhoods()
+{
+  ALEPH_TEST_BEGIN( "Tangent space: shared neighbourhoods" );
+
+#ifdef ALEPH_WITH_EIGEN
+#if EIGEN_VERSION_AT_LEAST(3,3,0)
+  using PointCloud        = PointCloud<T>;
+  using Distance          = distances::Euclidean<T>;
+  using NearestNeighbours = BruteForce<PointCloud, Distance>;
+
+  PointCloud pc = load<T>( CMAKE_SOURCE_DIR + std::string( "/tests/input/Iris_colon_separated.txt" ) );
+
+  unsigned k = 10;
+
+  // The points of this data set are four-dimensional. Their first three
+  // coordinates are used as well, so that spheres are also fitted with
+  // fixed-size matrices.
+  PointCloud qc( pc.size(), 3 );
+
+  for( std::size_t i = 0; i < pc.size(); i++ )
+  {
+    auto p = pc[i];
+    qc.set( i, p.begin(), p.begin() + 3 );
+  }
+
+  for( auto&& cloud : { pc, qc } )
+  {
+    std::vector< std::vector<std::size_t> > indices;
+    std::vector< std::vector<T> > distances;
+
+    NearestNeighbours nearestNeighbours( cloud );
+    nearestNeighbours.neighbourSearch( k, indices, distances );
+
+    TangentSpace ts;
+
+    auto curvature = ts( cloud, k );
+    auto shared    = ts( cloud, indices );
+
+    ALEPH_ASSERT_EQUAL( curvature.size(), cloud.size() );
+    ALEPH_ASSERT_THROW( curvature == shared );
+  }
+
+  {
+    TangentSpace ts;
+    bool thrown = false;
+
+    try
+    {
+      ts( qc, std::vector< std::vector<std::size_t> >( qc.size(), { qc.size() } ) );
+    }
+    catch( std::runtime_error& )
+    {
+      thrown = true;
+    }
+
+    ALEPH_ASSERT_THROW( thrown );
+  }
+#endif
+#endif
+
+  ALEPH_TEST_END();
+}
+
 int main( int, char** )
 {
   testCircle<float> ();
@@ -67,4 +181,10 @@ int main( int, char** )
 
   test<float> ();
   test<double>();
+
+  testRegression<float> ();
+  testRegression<double>();
+
+  testNeighbourhoods<float> ();
+  testNeighbourhoods<double>();
 }
@@ -1,5 +1,6 @@
 #include <tests/Base.hh>
 
+#include <aleph/topology/DenseUnionFind.hh>
 #include <aleph/topology/UnionFind.hh>
 
 #include <iterator>
@@ -64,6 +65,40 @@ template <class T> void test()
   ALEPH_TEST_END();
 }
 
+template <class T> void testDense()
+{
+  ALEPH_TEST_BEGIN( "Dense Union--Find (" + std::string( typeid(T).name() ) + ")" );
+
+  DenseUnionFind<T> uf( 9 );
+
+  ALEPH_ASSERT_EQUAL( uf.size(), 9 );
+
+  for( T vertex = 0; vertex < 9; vertex++ )
+    ALEPH_ASSERT_EQUAL( uf.find(vertex), vertex );
+
+  uf.merge(1,2);
+  uf.merge(5,6);
+  uf.merge(5,8);
+  uf.merge(3,4);
+  uf.merge(1,5);
+
+  // Merges are directional, so the root of the second vertex remains
+  ALEPH_ASSERT_EQUAL( uf.find(1), 8 );
+  ALEPH_ASSERT_EQUAL( uf.find(2), 8 );
+  ALEPH_ASSERT_EQUAL( uf.find(6), 8 );
+  ALEPH_ASSERT_EQUAL( uf.find(3), 4 );
+  ALEPH_ASSERT_EQUAL( uf.find(7), 7 );
+
+  uf.reset( 4 );
+
+  ALEPH_ASSERT_EQUAL( uf.size(), 4 );
+
+  for( T vertex = 0; vertex < 4; vertex++ )
+    ALEPH_ASSERT_EQUAL( uf.find(vertex), vertex );
+
+  ALEPH_TEST_END();
+}
+
 int main(int, char**)
 {
   test<unsigned short>();
@@ -72,4 +107,8 @@ int main(int, char**)
   test<unsigned>      ();
   test<long>          ();
   test<unsigned long> ();
+
+  testDense<unsigned short>();
+  testDense<unsigned>      ();
+  testDense<unsigned long> ();
 }